@@ -15,6 +15,13 @@
 #include "uart.h"
 #include "verify.h"
 
+#ifndef OTA_LZ
+#define OTA_LZ 0
+#endif
+#if OTA_LZ
+#include "lz.h"
+#endif
+
 /*
  * Plan 001 Phase 1.8 — bootloader OTA receiver.
  *
@@ -22,7 +29,8 @@
  *
  *   Host ──> Device  PING                 (no payload)
  *   Device ─> Host   PONG                 (no payload)
- *   Host ──> Device  OTA_BEGIN            payload = u8 slot, u32 total_size
+ *   Host ──> Device  OTA_BEGIN            payload = u8 slot, u32 total_size,
+ *                                          optional u8 flags (OTA_BEGIN_F_*)
  *   Device ─> Host   ACK / NACK
  *   Host ──> Device  OTA_CHUNK            payload = u32 offset, then data
  *   Device ─> Host   ACK / NACK
@@ -46,10 +54,17 @@
  *     active. The decision tree in main.c::pick_active_slot() resolves that
  *     by picking the higher monotonic_counter, which is by construction the
  *     freshly-OTA'd slot.
+ *
+ * Compressed transfers (OTA_LZ=1 builds only, as sector 0 has little room
+ * for the decoder; see the loader Makefile): with OTA_BEGIN_F_LZ the
+ * chunks carry one lib/lz stream, in order, and each chunk's offset is its
+ * position in that stream. total_size stays the decompressed image size;
+ * the decompressed bytes go to the slot as each chunk is fed in.
  */
 
 #define OTA_CHUNK_HEADER_BYTES   4u                              /* offset */
 #define OTA_CHUNK_MAX_DATA       (FRAME_MAX_PAYLOAD - OTA_CHUNK_HEADER_BYTES)
+#define OTA_BEGIN_FLAGS          (OTA_LZ ? OTA_BEGIN_F_LZ : 0u)  /* supported */
 
 /* Framing decoder needs a payload buffer; sized for the largest frame. */
 static uint8_t s_decoder_payload[FRAME_MAX_PAYLOAD];
@@ -71,10 +86,19 @@ typedef struct {
     uint8_t          last_rx_seq;     /* most recent SEQ we ACK'd */
     uint8_t          have_last_rx_seq;
     uint32_t         max_seen_counter;/* metadata monotonic floor */
+#if OTA_LZ
+    uint8_t          lz;              /* OTA_BEGIN_F_LZ transfer */
+    uint32_t         lz_in;           /* compressed bytes fed so far */
+#endif
 } ota_session_t;
 
 static ota_session_t s_sess;
 
+#if OTA_LZ
+static lz_decoder_t s_lz;
+static uint8_t      s_lz_window[LZ_WINDOW_MAX];
+#endif
+
 /* ------------------------------------------------------------------------
  * Wire helpers
  * ------------------------------------------------------------------------ */
@@ -99,15 +123,18 @@ static void uart_write_bytes(const uint8_t *buf, size_t len)
 static void send_frame(uint8_t seq, frame_type_t type,
                        const uint8_t *payload, size_t len)
 {
-    /* Encoded buffer is small enough to live on the stack — sector-0
-     * bootloader has no spare BSS and a 1-frame buffer is the only
-     * outbound state we need. */
-    static uint8_t out_buf[FRAME_MAX_ENCODED_SIZE];
-    int n = frame_encode(seq, type, payload, len, out_buf, sizeof(out_buf));
-    if (n < 0) {
+    /* Stream the frame through a few bytes of stack instead of a
+     * worst-case FRAME_MAX_ENCODED_SIZE buffer — the sector-0 bootloader
+     * has no spare BSS, and the replies here are a handful of bytes. */
+    uint8_t chunk[16];
+    const frame_iov_t iov = { payload, len };
+    frame_encoder_t enc;
+    if (frame_encoder_begin(&enc, seq, type, &iov, 1) != FRAME_OK) {
         return;
     }
-    uart_write_bytes(out_buf, (size_t)n);
+    while (!frame_encoder_done(&enc)) {
+        uart_write_bytes(chunk, frame_encoder_pull(&enc, chunk, sizeof(chunk)));
+    }
 }
 
 static void send_ack(uint8_t seq)   { send_frame(seq, FRAME_TYPE_ACK,  NULL, 0); }
@@ -225,6 +252,39 @@ static int swap_active_slot(flash_slot_id_t target, flash_slot_id_t previous,
  * Frame handlers
  * ------------------------------------------------------------------------ */
 
+/* Program image bytes [offset, offset + len) of the target slot. */
+static int slot_write(uint32_t offset, const uint8_t *data, size_t len)
+{
+    if ((uint64_t)offset + (uint64_t)len > (uint64_t)s_sess.expected_size) {
+        return 0;
+    }
+    uint32_t addr = flash_slot_base_address(s_sess.target_slot) + offset;
+    if (flash_slot_validate_range(addr, len) != ERR_OK) {
+        return 0;
+    }
+
+    err_t rc = flash_unlock();
+    if (rc != ERR_OK) {
+        return 0;
+    }
+    rc = flash_write_bytes(addr, data, len);
+    flash_lock();
+    if (rc != ERR_OK) {
+        return 0;
+    }
+    s_sess.received_bytes += (uint32_t)len;
+    return 1;
+}
+
+#if OTA_LZ
+/* Decompressed bytes land in order, right after the previous run. */
+static int ota_lz_sink(const uint8_t *bytes, size_t n, void *user)
+{
+    (void)user;
+    return slot_write(s_sess.received_bytes, bytes, n) ? 0 : 1;
+}
+#endif
+
 static int handle_ota_begin(const uint8_t *p, size_t n, uint8_t seq)
 {
     if (n < 1u + 4u) {
@@ -236,7 +296,12 @@ static int handle_ota_begin(const uint8_t *p, size_t n, uint8_t seq)
                           | ((uint32_t)p[2] << 8)
                           | ((uint32_t)p[3] << 16)
                           | ((uint32_t)p[4] << 24);
+    uint8_t  flags        = (n > 5u) ? p[5] : 0u;
 
+    if ((flags & ~OTA_BEGIN_FLAGS) != 0u) {
+        send_nack(seq);
+        return 0;
+    }
     if (slot_id != (uint8_t)FLASH_SLOT_A && slot_id != (uint8_t)FLASH_SLOT_B) {
         send_nack(seq);
         return 0;
@@ -267,6 +332,11 @@ static int handle_ota_begin(const uint8_t *p, size_t n, uint8_t seq)
     s_sess.target_slot    = target;
     s_sess.expected_size  = total_size;
     s_sess.received_bytes = 0u;
+#if OTA_LZ
+    s_sess.lz             = (flags & OTA_BEGIN_F_LZ) ? 1u : 0u;
+    s_sess.lz_in          = 0u;
+    (void)lz_decoder_init(&s_lz, s_lz_window, sizeof(s_lz_window), ota_lz_sink, NULL);
+#endif
     s_sess.state          = OTA_STATE_RECEIVING;
     send_ack(seq);
     return 1;
@@ -289,28 +359,24 @@ static int handle_ota_chunk(const uint8_t *p, size_t n, uint8_t seq)
     size_t   data_len = n - OTA_CHUNK_HEADER_BYTES;
     const uint8_t *data = p + OTA_CHUNK_HEADER_BYTES;
 
-    if ((uint64_t)offset + (uint64_t)data_len > (uint64_t)s_sess.expected_size) {
-        send_nack(seq);
-        return 0;
-    }
-    uint32_t addr = flash_slot_base_address(s_sess.target_slot) + offset;
-    if (flash_slot_validate_range(addr, data_len) != ERR_OK) {
-        send_nack(seq);
-        return 0;
-    }
-
-    err_t rc = flash_unlock();
-    if (rc != ERR_OK) {
-        send_nack(seq);
-        return 0;
+#if OTA_LZ
+    if (s_sess.lz) {
+        /* The stream must arrive in order; a decode or flash error leaves
+         * the decoder failed, so every later chunk is NACKed too. */
+        if (offset != s_sess.lz_in ||
+            lz_decoder_feed(&s_lz, data, data_len) != LZ_OK) {
+            send_nack(seq);
+            return 0;
+        }
+        s_sess.lz_in += (uint32_t)data_len;
+        send_ack(seq);
+        return 1;
     }
-    rc = flash_write_bytes(addr, data, data_len);
-    flash_lock();
-    if (rc != ERR_OK) {
+#endif
+    if (!slot_write(offset, data, data_len)) {
         send_nack(seq);
         return 0;
     }
-    s_sess.received_bytes += (uint32_t)data_len;
     send_ack(seq);
     return 1;
 }
@@ -322,6 +388,14 @@ static void handle_ota_end(uint8_t seq)
         s_sess.state = OTA_STATE_HALT;
         return;
     }
+#if OTA_LZ
+    if (s_sess.lz && lz_decoder_finish(&s_lz) != LZ_OK) {
+        uart_puts("OTA: END inside an lz item\r\n");
+        send_status(seq, OTA_STATUS_WRITE_FAILED);
+        s_sess.state = OTA_STATE_HALT;
+        return;
+    }
+#endif
     if (s_sess.received_bytes != s_sess.expected_size) {
         uart_puts("OTA: END but size mismatch\r\n");
         send_status(seq, OTA_STATUS_WRITE_FAILED);
@@ -33,6 +33,13 @@ typedef enum {
     OTA_STATUS_ROLLBACK_REJECTED = 4,
 } ota_status_t;
 
+/*
+ * Optional sixth OTA_BEGIN byte (absent = 0). Flags this build does not
+ * support are NACKed.
+ */
+#define OTA_BEGIN_F_LZ  0x01u   /* OTA_CHUNK data is one lib/lz stream;
+                                 * needs OTA_LZ=1 (see ota.c) */
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,18 +9,69 @@
  * docs/wiki/plans/002-dsp-baseband/software-modem.md.
  *
  * CLI:
- *   modem run [--mod bpsk] [--snr <dB>] [--bits <N>]
+ *   modem run [--mod bpsk|fsk4|dbpsk] [--snr <dB>] [--bits <N>] [--evm]
+ *             [--shape [--isi] [--eq] | --cfo <f> | --chan <preset>]
+ *             [--capture <sym>|err]
  *       One BER measurement at a fixed Eb/N0; prints bits, errors, measured
  *       BER, closed-form theory BER, total cycles / Mcycles, and cycles/bit.
- *   modem sweep --snr <lo>:<hi>:<step> [--bits <N>]
+ *       --cfo adds a carrier offset of f cycles/symbol and recovers it with
+ *       the Costas loop. --chan runs the same I/Q receiver through one of the
+ *       impairment presets below (lib/channel impair.h); --cfo then overrides
+ *       the preset's offset. On the shaped chain, --isi adds a static echo
+ *       at sample rate and --eq runs the T/2 LMS equaliser (lib/modem
+ *       lms_eq.h) after the matched filter; either implies --shape. --evm
+ *       slices through the EVM/MER estimator (lib/modem evm.h) and adds a
+ *       MER / EVM / constellation report. --mod fsk4 swaps the whole chain
+ *       for non-coherent 4-FSK (lib/modem fsk.h: 16 samples/symbol, Goertzel
+ *       detector) on the same AWGN channel and Eb/N0 scale, for a BER and
+ *       cycles/bit comparison; it takes none of the other options.
+ *       --mod dbpsk differentially encodes the bits and detects them
+ *       non-coherently (lib/modem dbpsk.h) on the I/Q chain, with no AGC or
+ *       Costas loop; it takes --cfo/--chan/--capture (AWGN alone without
+ *       them), not --shape/--isi/--eq/--evm.
+ *       --capture freezes a window of samples around one symbol's decision
+ *       instant, or the first symbol in error, in a snapshot ring (lib/modem
+ *       capture.h): matched-filter output on --shape (an eye diagram; not
+ *       with --eq), post-Costas I/Q on --cfo/--chan (a constellation).
+ *   modem sweep --snr <lo>:<hi>:<step> [--mod bpsk|fsk4|dbpsk] [--bits <N>]
+ *             [--shape [--isi] [--eq] | --cfo <f> | --chan <preset>]
  *       An ASCII BER-vs-Eb/N0 table, one row per SNR point.
+ *   modem bench [--n <samples>]
+ *       Per-kernel DSP micro-benchmarks: cycles/sample and the sample rate
+ *       the core could sustain running that kernel alone; then cycles per
+ *       256/1024-point FFT and per Welch segment, and direct vs overlap-save
+ *       FIR cost across tap counts (lib/dsp fastconv.h crossover); then
+ *       the transmit waveform at 8x..64x through half-band and compensated
+ *       CIC stages (lib/dsp halfband.h, cic.h) against one RRC at SPS 8, in
+ *       cycles per output sample, plus the matching decimators; last, the
+ *       four framing CRC-16 engines (lib/framing framing.h) in cycles/byte
+ *       against the UART byte time, and a full-size frame through the
+ *       encoder and decoder.
+ *   modem psd [--n <nfft>] [--segs <K>] [--rows <R>]
+ *       Welch spectrum (lib/dsp psd.h) of the --shape TX waveform over K
+ *       Hann-windowed, half-overlapped nfft-point segments, printed as R rows
+ *       over 0..Fs/2 with 99% occupied bandwidth and adjacent-channel leakage.
+ *   modem dump
+ *       Stream the last --capture window to the host as binary lib/framing
+ *       frames; tools/capture_view.py draws the eye or constellation.
+ *   modem link [--frames <N>] [--delay <ms>] [--jitter <ms>] [--loss <%>]
+ *              [--corrupt <%>]
+ *       N frames through the stop-and-wait frame_link (lib/framing) over a
+ *       simulated serial line in SRAM with the given one-way delay, jitter,
+ *       frame loss and byte corruption, then the link statistics: RTT
+ *       min/avg/max, the adaptive RTO, retransmits, duplicate drops and CRC
+ *       errors. 'modem link stats' prints them again.
  *
  * Cycle counts come from the Cortex-M4 DWT cycle counter (same pattern as
  * drivers/src/spi_perf.c); the core runs at rcc_get_sysclk() (100 MHz).
+ * Built with SAT_STATS=1, `modem run` adds the q15 clamps per stage and
+ * `modem sweep` a clamp column (lib/dsp fixed.h), to size headroom.
  */
 
+#include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "stm32f4xx.h"
 
@@ -37,13 +88,30 @@
 #include "uart.h"
 
 /* Software modem core (Plan 002 B0.1/B0.2; RRC pulse shaping B0.4). */
+#include "agc.h"
 #include "awgn.h"
 #include "bpsk.h"
+#include "capture.h"
+#include "cic.h"
+#include "cordic.h"
+#include "costas.h"
+#include "dbpsk.h"
+#include "evm.h"
+#include "fastconv.h"
+#include "fft.h"
 #include "fixed.h"
+#include "framing.h"
+#include "fsk.h"
+#include "goertzel.h"
+#include "halfband.h"
+#include "impair.h"
+#include "lms_eq.h"
+#include "nco.h"
 #include "prbs.h"
+#include "psd.h"
 #include "rrc.h"
 
-/* "modem run --snr 5.5 --bits 1000000 --shape" is ~42 chars; 64 leaves headroom. */
+/* "modem run --snr 6 --chan rice --cfo 0.001 --evm" is ~48 chars; 64 leaves headroom. */
 #define MODEM_CMD_SIZE 64
 
 /* Defaults chosen so a bare `modem run` reproduces the issue's example. */
@@ -63,6 +131,61 @@
 #define MODEM_SHAPE_SPS   4u
 #define MODEM_SHAPE_SPAN  8u
 
+/* Shaped-chain options, from --shape / --isi / --eq. */
+#define MODEM_SHAPE_ON   (1u << 0)
+#define MODEM_SHAPE_ISI  (1u << 1)
+#define MODEM_SHAPE_EQ   (1u << 2)
+
+/*
+ * --isi echo: 0.88 direct, 0.40 at 3/4 symbol, -0.25 at 2 symbols (unit
+ * energy), at half amplitude so the smeared waveform stays inside q15. The
+ * AWGN stage is told about the 6.02 dB back-off so Eb/N0 keeps its meaning.
+ * The 3/4-symbol ray falls between symbol instants, and the matched filter
+ * alone loses several dB to the ISI it leaves.
+ */
+#define MODEM_ISI_BACKOFF_DB  6.02f
+#define MODEM_ISI_HIST        16u   /* power of two > longest lag */
+
+/*
+ * --eq: the lms_eq defaults (16 T/2 taps, mu 2^-7, leak 2^-14), trained on
+ * the first MODEM_EQ_TRAIN_SYMS symbols then decision-directed. The decision
+ * level is the matched-filter peak: full scale, or half behind --isi.
+ */
+#define MODEM_EQ_TRAIN_SYMS  500u
+
+/*
+ * Carrier-recovery config for the I/Q (--cfo / --chan) chain: Costas loop bandwidth/damping
+ * and the channel's starting phase. BnT = 0.005 pulls in a 1e-3 cycles/symbol
+ * offset in a few hundred symbols, well inside the first block.
+ */
+#define MODEM_COSTAS_BNT    0.005f
+#define MODEM_COSTAS_ZETA   0.707f
+#define MODEM_CFO_PHASE_RAD 0.3f
+
+/*
+ * --mod fsk4: 4 tones on bins 2..5 of a 16-sample symbol (Fs/8..5Fs/16, clear
+ * of DC and Nyquist), at the amplitude that makes Eb one full-scale BPSK
+ * sample so the two chains share an Eb/N0 axis.
+ */
+#define MODEM_FSK_M     4u
+#define MODEM_FSK_N     16u
+#define MODEM_FSK_BIN0  2u
+
+/* --mod values. */
+#define MODEM_MOD_BPSK  0
+#define MODEM_MOD_FSK4  1
+#define MODEM_MOD_DBPSK 2
+
+/*
+ * --capture: a MODEM_CAPTURE_LEN-sample window, half of it before the
+ * trigger, held in the lib/modem snapshot ring. `modem dump` sends it as
+ * FRAME_TYPE_CAPTURE frames of up to MODEM_CAPTURE_CHUNK samples.
+ */
+#define MODEM_CAPTURE_LEN      512u
+#define MODEM_CAPTURE_PRE      (MODEM_CAPTURE_LEN / 2u)
+#define MODEM_CAPTURE_CHUNK    128u
+#define MODEM_CAPTURE_VERSION  1u
+
 static cli_context_t g_cli;
 static char g_cmd_buffer[MODEM_CMD_SIZE];
 static volatile uint8_t command_pending = 0;
@@ -180,15 +303,45 @@ typedef struct {
     uint64_t errors;
     double   theory;
     uint8_t  shaped;          /* 1 if RRC pulse shaping was applied       */
+    uint8_t  equalised;       /* 1 if the LMS equaliser ran (--eq)        */
+    float    eq_mse_db;       /* final smoothed equaliser MSE (dB)        */
+    uint8_t  carrier;         /* 1 if the I/Q (AGC + Costas) chain was used */
+    uint8_t  differential;    /* 1 if the I/Q chain ran DBPSK (no sync)   */
+    float    freq_est;        /* Costas frequency estimate (cycles/sym)   */
+    uint32_t slips;           /* channel clock-drift slips (I/Q chain)    */
     uint32_t gen_cycles;      /* PRBS bit-stream generation               */
     uint32_t mod_cycles;      /* bit -> symbol (BPSK map)                 */
     uint32_t shape_cycles;    /* symbols -> oversampled waveform (TX RRC) */
     uint32_t channel_cycles;  /* samples -> noisy samples (AWGN)          */
     uint32_t match_cycles;    /* matched filter (RX RRC)                  */
+    uint32_t sync_cycles;     /* AGC + carrier recovery (Costas loop)     */
     uint32_t demod_cycles;    /* sample at symbol instant -> rx bit       */
+    uint32_t eq_cycles;       /* LMS equaliser + slice (--eq)             */
     uint32_t check_cycles;    /* rx bit vs tx bit -> error count          */
+    uint32_t capture_cycles;  /* snapshot ring stores (--capture)         */
+    uint32_t mod_sat;         /* q15 clamps per stage (SAT_STATS=1 builds; */
+    uint32_t shape_sat;       /*   always 0 otherwise, see fixed.h)        */
+    uint32_t channel_sat;
+    uint32_t match_sat;
+    uint32_t sync_sat;
+    uint32_t eq_sat;
 } modem_result_t;
 
+/*
+ * A --capture request and what the chain made of it. The chain arms the ring,
+ * sets sps (samples per symbol in it) and, with on_err, sym once the first
+ * symbol in error has triggered it.
+ */
+typedef struct {
+    capture_t* ring;
+    uint32_t   sym;       /* trigger symbol                        */
+    uint8_t    on_err;    /* 1: trigger on the first bit error     */
+    uint8_t    sps;
+} modem_capture_t;
+
+static capture_t g_capture_ring;
+static modem_capture_t g_capture = {&g_capture_ring, 0u, 0u, 0u};
+
 /*
  * Storing every symbol for a 100k-bit run would need ~200 KB (> 128 KB SRAM),
  * so the chain runs block-by-block.  Each block walks five separately-timed
@@ -223,20 +376,34 @@ static inline uint32_t dwt_now(void) {
     return DWT->CYCCNT;
 }
 
+/*
+ * q15 clamps since *mark, moving the mark up. The chains call it right after
+ * each stage that can saturate; it is the constant 0 unless the build has
+ * SAT_STATS=1 (lib/dsp fixed.h).
+ */
+static inline uint32_t sat_since(uint32_t* mark) {
+    uint32_t now  = q15_sat_count();
+    uint32_t diff = now - *mark;
+    *mark = now;
+    return diff;
+}
+
 /*
  * Run the unshaped PRBS -> BPSK -> AWGN -> slice -> compare chain for nbits,
  * timing the five stages separately.  One symbol is one sample (no pulse
  * shaping).  No printing happens inside the timed regions.  This is the default
  * path; its cycle/BER numbers feed the calibrated B0.3 HIL baselines, so it is
- * left byte-for-byte as it was.
+ * left as it was unless evm is non-NULL (--evm), which slices through the
+ * EVM estimator instead.
  */
 static modem_result_t modem_run_chain(prbs_poly_t poly, uint16_t seed,
-                                      float snr_db, uint32_t nbits) {
+                                      float snr_db, uint32_t nbits, evm_t* evm) {
     prbs_t      tx;
     awgn_prng_t rng;
 
     prbs_init(&tx, poly, seed);
     awgn_prng_seed(&rng, seed);
+    evm_reset(evm);
 
     /* Enable and zero the DWT cycle counter (same pattern as spi_perf.c). */
     CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
@@ -245,6 +412,7 @@ static modem_result_t modem_run_chain(prbs_poly_t poly, uint16_t seed,
 
     uint32_t gen_cycles = 0, mod_cycles = 0, channel_cycles = 0,
              demod_cycles = 0, check_cycles = 0;
+    uint32_t channel_sat = 0, sat_mark = q15_sat_count();
     uint64_t errors = 0;
 
     uint32_t remaining = nbits;
@@ -262,10 +430,15 @@ static modem_result_t modem_run_chain(prbs_poly_t poly, uint16_t seed,
         /* Stage 2 — channel: add AWGN over the whole block. */
         uint32_t t2 = dwt_now();
         channel_awgn_apply(g_sym_block, n, snr_db, &rng);
+        channel_sat += sat_since(&sat_mark);
 
         /* Stage 3 — demod: slice noisy symbols -> rx bits. */
         uint32_t t3 = dwt_now();
-        bpsk_slice_block(g_sym_block, g_rx_block, n);
+        if (evm != NULL) {
+            evm_slice_block(evm, g_sym_block, NULL, g_rx_block, n);
+        } else {
+            bpsk_slice_block(g_sym_block, g_rx_block, n);
+        }
 
         /* Stage 4 — check: compare rx bits against the tx bits. */
         uint32_t t4 = dwt_now();
@@ -291,21 +464,72 @@ static modem_result_t modem_run_chain(prbs_poly_t poly, uint16_t seed,
     r.errors         = errors;
     r.theory         = channel_awgn_theory_ber(snr_db);
     r.shaped         = 0u;
+    r.equalised      = 0u;
+    r.eq_mse_db      = 0.0f;
+    r.carrier        = 0u;
+    r.differential   = 0u;
+    r.freq_est       = 0.0f;
+    r.slips          = 0u;
     r.gen_cycles     = gen_cycles;
     r.mod_cycles     = mod_cycles;
     r.shape_cycles   = 0u;
     r.channel_cycles = channel_cycles;
     r.match_cycles   = 0u;
+    r.sync_cycles    = 0u;
     r.demod_cycles   = demod_cycles;
+    r.eq_cycles      = 0u;
     r.check_cycles   = check_cycles;
+    r.capture_cycles = 0u;
+    r.mod_sat        = 0u;
+    r.shape_sat      = 0u;
+    r.channel_sat    = channel_sat;
+    r.match_sat      = 0u;
+    r.sync_sat       = 0u;
+    r.eq_sat         = 0u;
     return r;
 }
 
+/* --isi echo state: taps (q15, half amplitude) and the sample history ring. */
+static const struct {
+    uint8_t lag;
+    q15_t   h;
+} g_isi_taps[] = {
+    {0u, 14418},    /* 0.5 *  0.88 */
+    {3u, 6554},     /* 0.5 *  0.40 */
+    {8u, -4096},    /* 0.5 * -0.25 */
+};
+static q15_t   g_isi_hist[MODEM_ISI_HIST];
+static uint8_t g_isi_pos;
+
+static void modem_isi_reset(void) {
+    for (size_t k = 0; k < MODEM_ISI_HIST; k++) {
+        g_isi_hist[k] = 0;
+    }
+    g_isi_pos = 0u;
+}
+
+/* Apply the --isi echo in place; the history carries across blocks. */
+static void modem_isi_apply(q15_t* x, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        g_isi_pos = (uint8_t)((g_isi_pos - 1u) & (MODEM_ISI_HIST - 1u));
+        g_isi_hist[g_isi_pos] = x[i];
+        int32_t acc = 1 << (Q15_SHIFT - 1);
+        for (size_t t = 0; t < sizeof(g_isi_taps) / sizeof(g_isi_taps[0]); t++) {
+            acc += (int32_t)g_isi_taps[t].h *
+                   g_isi_hist[(g_isi_pos + g_isi_taps[t].lag) & (MODEM_ISI_HIST - 1u)];
+        }
+        x[i] = q15_sat(acc >> Q15_SHIFT);
+    }
+}
+
+static lms_eq_t g_eq;
+
 /*
  * Run the shaped chain for nbits: PRBS -> BPSK -> RRC TX shape -> AWGN (at
  * sample rate) -> RRC matched filter -> decimate at symbol instants -> slice ->
  * compare.  Seven stages are timed separately (gen/mod/shape/channel/match/
- * demod/check).  The AWGN seam is unchanged — it just sees SPS x more samples.
+ * demod/check), eight with --eq.  The AWGN seam is unchanged — it just sees SPS
+ * x more samples.
  *
  * Symbol k peaks in the matched-filter output at absolute sample index
  * k*SPS + chain_delay, so we sample there.  A reference PRBS (seeded identically
@@ -314,39 +538,83 @@ static modem_result_t modem_run_chain(prbs_poly_t poly, uint16_t seed,
  * symbol FIFO (the same technique tests/lib/dsp/test_rrc.c uses).  Each payload
  * symbol is followed through the filters by trailing zero symbols so the last
  * one flushes out and is decided.  No printing inside the timed regions.
+ *
+ * opts (MODEM_SHAPE_*) adds MODEM_SHAPE_ISI (the echo, timed with the channel) and
+ * MODEM_SHAPE_EQ. With the equaliser, demod keeps two samples per symbol (the
+ * peak and SPS/2 later, compacted in place at the front of g_samp_block) and a
+ * separately timed eq stage runs lms_eq_step() and slices. Equaliser output m
+ * is symbol m - delay, so the first `delay` outputs are dropped and the tail
+ * grows by as many symbols; a second PRBS supplies the training symbols. The
+ * training symbols are scored like the rest, so the BER includes convergence.
+ * The chain delay and the block length are both multiples of SPS, so a
+ * symbol's pair never straddles two blocks.
+ *
+ * cap (NULL: off; not with MODEM_SHAPE_EQ, whose pairs overwrite the block)
+ * keeps matched-filter samples in the snapshot ring, numbered from the start
+ * of the run, so symbol k's decision instant is sample k*SPS + chain_delay.
+ * A given symbol triggers it up front; with on_err the check stage triggers
+ * it at the first error. The block is pushed after the check, in a stage of
+ * its own, so a trigger found in a block still sees that block's samples.
  */
 static modem_result_t modem_run_chain_shaped(prbs_poly_t poly, uint16_t seed,
-                                             float snr_db, uint32_t nbits) {
+                                             float snr_db, uint32_t nbits,
+                                             uint8_t opts, evm_t* evm,
+                                             modem_capture_t* cap) {
     prbs_t       tx;
+    prbs_t       trn;
     prbs_check_t chk;
     awgn_prng_t  rng;
 
     prbs_init(&tx, poly, seed);
+    prbs_init(&trn, poly, seed);
     prbs_check_init(&chk, poly, seed);
     awgn_prng_seed(&rng, seed);
+    evm_reset(evm);
 
     rrc_design(&g_tx_rrc, MODEM_SHAPE_BETA, MODEM_SHAPE_SPS, MODEM_SHAPE_SPAN);
     rrc_design(&g_rx_rrc, MODEM_SHAPE_BETA, MODEM_SHAPE_SPS, MODEM_SHAPE_SPAN);
 
+    const uint8_t  isi = (opts & MODEM_SHAPE_ISI) != 0u;
+    const uint8_t  eq  = (opts & MODEM_SHAPE_EQ) != 0u;
+    const float    chan_snr_db = isi ? snr_db + MODEM_ISI_BACKOFF_DB : snr_db;
+    modem_isi_reset();
+    lms_eq_init(&g_eq, LMS_EQ_DEFAULT_TAPS, 2u, LMS_EQ_DEFAULT_MU_SHIFT,
+                LMS_EQ_DEFAULT_LEAK_SHIFT, isi ? 0.5f : 1.0f);
+    const uint32_t eq_delay = eq ? (uint32_t)lms_eq_delay(&g_eq) : 0u;
+
     const uint32_t sps = MODEM_SHAPE_SPS;
     const size_t   delay_samples = rrc_chain_delay(&g_tx_rrc);
 
     /* Pad with one chain delay (rounded up to whole symbols) plus one symbol so
-     * the final payload symbol flushes through both filters to the decimator. */
-    size_t tail_syms   = delay_samples / sps + 1u;
+     * the final payload symbol flushes through both filters to the decimator,
+     * plus the equaliser's decision delay. */
+    size_t tail_syms   = delay_samples / sps + 1u + eq_delay;
     uint32_t total_syms = nbits + (uint32_t)tail_syms;
 
+    if (cap != NULL) {
+        capture_arm(cap->ring, MODEM_CAPTURE_LEN, MODEM_CAPTURE_PRE);
+        cap->sps = (uint8_t)sps;
+        if (!cap->on_err) {
+            capture_trigger(cap->ring, cap->sym * sps + (uint32_t)delay_samples);
+        }
+    }
+
     CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
     DWT->CYCCNT = 0;
     DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
     uint32_t gen_cycles = 0, mod_cycles = 0, shape_cycles = 0, channel_cycles = 0,
-             match_cycles = 0, demod_cycles = 0, check_cycles = 0;
+             match_cycles = 0, demod_cycles = 0, eq_cycles = 0, check_cycles = 0,
+             capture_cycles = 0;
+    uint32_t shape_sat = 0, channel_sat = 0, match_sat = 0, eq_sat = 0;
+    uint32_t sat_mark = q15_sat_count();
     uint64_t errors = 0;
+    const uint8_t trig_err = (cap != NULL) && cap->on_err;
 
     size_t sample_base = 0;                 /* abs index of g_samp_block[0]      */
     size_t next_peak   = delay_samples;     /* abs sample index of next symbol   */
     uint32_t produced  = 0;                 /* decimated payload symbols so far  */
+    uint32_t eq_out    = 0;                 /* equaliser outputs so far          */
 
     uint32_t sym_done = 0;
     while (sym_done < total_syms) {
@@ -380,34 +648,77 @@ static modem_result_t modem_run_chain_shaped(prbs_poly_t poly, uint16_t seed,
         /* Stage 2 — shape: n symbols -> n*SPS oversampled samples (TX RRC). */
         uint32_t t2 = dwt_now();
         rrc_tx_shape(&g_tx_rrc, g_sym_block, n, g_samp_block);
+        shape_sat += sat_since(&sat_mark);
 
-        /* Stage 3 — channel: AWGN over the whole oversampled block. */
+        /* Stage 3 — channel: (echo, then) AWGN over the whole oversampled block. */
         uint32_t t3 = dwt_now();
-        channel_awgn_apply(g_samp_block, (size_t)n * sps, snr_db, &rng);
+        if (isi) {
+            modem_isi_apply(g_samp_block, (size_t)n * sps);
+        }
+        channel_awgn_apply(g_samp_block, (size_t)n * sps, chan_snr_db, &rng);
+        channel_sat += sat_since(&sat_mark);
 
         /* Stage 4 — match: RX matched filter, in place. */
         uint32_t t4 = dwt_now();
         rrc_rx_match(&g_rx_rrc, g_samp_block, (size_t)n * sps, g_samp_block);
+        match_sat += sat_since(&sat_mark);
 
-        /* Stage 5 — demod: slice the matched-filter output at symbol instants. */
+        /* Stage 5 — demod: slice the matched-filter output at symbol instants,
+         * or with --eq keep the T/2 pair for the equaliser. */
         uint32_t t5 = dwt_now();
         uint32_t dec_n = 0;
+        uint32_t pairs = 0;
         for (uint32_t p = 0; p < n * sps; p++) {
             size_t abs = sample_base + p;
-            if (abs == next_peak && (produced + dec_n) < nbits) {
-                g_rx_block[dec_n++] = bpsk_slice(g_samp_block[p]);
-                next_peak += sps;
+            if (abs != next_peak) {
+                continue;
             }
+            if (eq) {
+                g_samp_block[2u * pairs]      = g_samp_block[p];
+                g_samp_block[2u * pairs + 1u] = g_samp_block[p + sps / 2u];
+                pairs++;
+            } else if ((produced + dec_n) < nbits) {
+                g_rx_block[dec_n++] = (evm != NULL) ? evm_slice(evm, g_samp_block[p], 0)
+                                                    : bpsk_slice(g_samp_block[p]);
+            }
+            next_peak += sps;
         }
 
-        /* Stage 6 — check: compare decimated rx bits against the reference. */
+        /* Stage 6 — eq: equalise each pair (training, then decision-directed), slice. */
         uint32_t t6 = dwt_now();
+        for (uint32_t j = 0; j < pairs; j++) {
+            uint32_t m = eq_out++;
+            q15_t ref;
+            const q15_t* train = NULL;
+            if (m >= eq_delay && m - eq_delay < MODEM_EQ_TRAIN_SYMS) {
+                ref   = prbs_next_bit(&trn) ? g_eq.level : (q15_t)-g_eq.level;
+                train = &ref;
+            }
+            q15_t y = lms_eq_step(&g_eq, &g_samp_block[2u * j], train);
+            if (m >= eq_delay && (produced + dec_n) < nbits) {
+                g_rx_block[dec_n++] = (evm != NULL) ? evm_slice(evm, y, 0) : bpsk_slice(y);
+            }
+        }
+        eq_sat += sat_since(&sat_mark);
+
+        /* Stage 7 — check: compare decimated rx bits against the reference. */
+        uint32_t t7 = dwt_now();
         for (uint32_t i = 0; i < dec_n; i++) {
             if (!prbs_check_bit(&chk, g_rx_block[i])) {
                 errors++;
+                if (trig_err &&
+                    capture_trigger(cap->ring, (produced + i) * sps + (uint32_t)delay_samples)) {
+                    cap->sym = produced + i;
+                }
             }
         }
-        uint32_t t7 = dwt_now();
+        uint32_t t8 = dwt_now();
+
+        /* Stage 8 — capture (--capture): the block into the snapshot ring. */
+        if (cap != NULL) {
+            capture_push(cap->ring, g_samp_block, NULL, (size_t)n * sps);
+            capture_cycles += dwt_now() - t8;
+        }
 
         gen_cycles     += t1 - t0;
         mod_cycles     += t2 - t1;
@@ -415,7 +726,8 @@ static modem_result_t modem_run_chain_shaped(prbs_poly_t poly, uint16_t seed,
         channel_cycles += t4 - t3;
         match_cycles   += t5 - t4;
         demod_cycles   += t6 - t5;
-        check_cycles   += t7 - t6;
+        eq_cycles      += t7 - t6;
+        check_cycles   += t8 - t7;
 
         produced    += dec_n;
         sample_base += (size_t)n * sps;
@@ -427,118 +739,1400 @@ static modem_result_t modem_run_chain_shaped(prbs_poly_t poly, uint16_t seed,
     r.errors         = errors;
     r.theory         = channel_awgn_theory_ber(snr_db);
     r.shaped         = 1u;
+    r.equalised      = eq;
+    r.eq_mse_db      = eq ? lms_eq_mse_db(&g_eq) : 0.0f;
+    r.carrier        = 0u;
+    r.differential   = 0u;
+    r.freq_est       = 0.0f;
+    r.slips          = 0u;
     r.gen_cycles     = gen_cycles;
     r.mod_cycles     = mod_cycles;
     r.shape_cycles   = shape_cycles;
     r.channel_cycles = channel_cycles;
     r.match_cycles   = match_cycles;
+    r.sync_cycles    = 0u;
     r.demod_cycles   = demod_cycles;
+    r.eq_cycles      = eq_cycles;
     r.check_cycles   = check_cycles;
+    r.capture_cycles = capture_cycles;
+    r.mod_sat        = 0u;
+    r.shape_sat      = shape_sat;
+    r.channel_sat    = channel_sat;
+    r.match_sat      = match_sat;
+    r.sync_sat       = 0u;
+    r.eq_sat         = eq_sat;
     return r;
 }
 
-/* ------------------------------------------------------------------ */
-/* CLI command                                                        */
-/* ------------------------------------------------------------------ */
-
-static void print_run_usage(void) {
-    printf("Usage:\n");
-    printf("  modem run [--mod bpsk] [--snr <dB>] [--bits <N>] [--shape]\n");
-    printf("  modem sweep --snr <lo>:<hi>:<step> [--bits <N>] [--shape]\n");
-    printf("  --shape: RRC pulse shaping (b=0.35, sps=4, span=8) at sample rate\n");
-}
+/*
+ * I/Q chain (--cfo / --chan): one sample per symbol, but complex. The BPSK
+ * symbols go out on I with Q zeroed and pass through the impairment engine
+ * configured by *chan (lib/channel impair.h) with its AWGN stage at this
+ * Eb/N0 (N0/2 per dimension, so Eb/N0 keeps its meaning); --cfo alone is
+ * AWGN plus a carrier offset of cfo cycles/symbol. Then the AGC brings the
+ * level to its -12 dBFS target, and the Costas loop de-rotates before the
+ * slicer looks at I. The loop is designed for the post-AGC symbol amplitude,
+ * which is the target power less the noise share at this Eb/N0. The loop's pull-in is scored like
+ * any other symbol, so the BER includes the acquisition transient (a few
+ * hundred symbols at the default bandwidth). The Q rail reuses g_samp_block.
+ *
+ * A clock-drift stage delays the stream by channel_impair_delay() samples, so
+ * rx bit k is compared with tx bit k - delay through a small ring of recent
+ * tx bits and the first `delay` outputs are not scored. With no timing
+ * recovery at one sample per symbol, the drift shows up as the ISI of
+ * sampling between symbols, and every slip misaligns the rest of the run.
+ *
+ * cap (NULL: off) keeps the de-rotated I/Q in the snapshot ring, one sample
+ * per symbol, triggered as on the shaped chain (rx symbol k is sample k).
+ *
+ * diff (--mod dbpsk) differentially encodes the bits before the BPSK map and
+ * replaces sync + slice with the delay-and-multiply detector: the carrier
+ * phase and offset are left in the samples (and in the capture, a rotating
+ * constellation) and the theory is the DBPSK closed form. The detector needs
+ * no level, so the AGC is skipped too.
+ */
+#define MODEM_TX_RING 8u   /* >= CHANNEL_IMPAIR_CLK_DELAY + 1, power of two */
+
+static modem_result_t modem_run_chain_iq(prbs_poly_t poly, uint16_t seed,
+                                         float snr_db, uint32_t nbits,
+                                         const channel_impair_cfg_t* chan, evm_t* evm,
+                                         modem_capture_t* cap, uint8_t diff) {
+    prbs_t           tx;
+    channel_impair_t imp;
+    costas_t         loop;
+    agc_t            agc;
+    dbpsk_t          dbpsk;
+    uint8_t          tx_ring[MODEM_TX_RING];
+
+    channel_impair_cfg_t cfg = *chan;
+    cfg.seed    = seed;
+    cfg.ebn0_db = snr_db;
+    cfg.stages |= CHANNEL_IMP_AWGN;
 
-/* Confirm an optional "--mod" value is bpsk (the only modulation in B0). */
-static int mod_is_ok(const char* args) {
-    const char* m = find_flag(args, "--mod");
-    if (m == NULL) {
-        return 1; /* default: bpsk */
+    prbs_init(&tx, poly, seed);
+    evm_reset(evm);
+    channel_impair_init(&imp, &cfg);
+    const uint32_t delay = (uint32_t)channel_impair_delay(&imp);
+    agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT,
+             AGC_DEFAULT_MU_SHIFT);
+
+    float sigma   = channel_awgn_sigma(snr_db);
+    float sym_amp = AGC_DEFAULT_TARGET_RMS *
+                    sqrtf(2.0f / (1.0f + 2.0f * sigma * sigma));
+    costas_init(&loop, COSTAS_BPSK, MODEM_COSTAS_BNT, MODEM_COSTAS_ZETA, sym_amp);
+    dbpsk_init(&dbpsk);
+
+    q15_t* q_block = g_samp_block;
+
+    if (cap != NULL) {
+        capture_arm(cap->ring, MODEM_CAPTURE_LEN, MODEM_CAPTURE_PRE);
+        cap->sps = 1u;
+        if (!cap->on_err) {
+            capture_trigger(cap->ring, cap->sym);
+        }
     }
-    return (m[0] == 'b' && m[1] == 'p' && m[2] == 's' && m[3] == 'k' &&
-            (m[4] == '\0' || m[4] == ' '));
-}
 
-/* "--shape" is a valueless toggle: present -> shaped chain, absent -> default. */
-static int shape_requested(const char* args) {
-    return find_flag(args, "--shape") != NULL;
-}
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-/* Dispatch to the shaped or unshaped chain based on the --shape toggle. */
-static modem_result_t modem_run_dispatch(float snr_db, uint32_t nbits, int shaped) {
-    if (shaped) {
-        return modem_run_chain_shaped(MODEM_POLY, MODEM_SEED, snr_db, nbits);
+    uint32_t gen_cycles = 0, mod_cycles = 0, channel_cycles = 0,
+             sync_cycles = 0, demod_cycles = 0, check_cycles = 0,
+             capture_cycles = 0;
+    uint32_t channel_sat = 0, sync_sat = 0, sat_mark = q15_sat_count();
+    uint64_t errors = 0;
+    const uint8_t trig_err = (cap != NULL) && cap->on_err;
+
+    uint32_t remaining = nbits;
+    while (remaining > 0u) {
+        uint32_t n = (remaining < MODEM_BLOCK) ? remaining : MODEM_BLOCK;
+
+        /* Stage 0 — gen: PRBS bit stream. */
+        uint32_t t0 = dwt_now();
+        prbs_next_bits(&tx, g_tx_block, n);
+
+        /* Stage 1 — mod: bits -> (DBPSK: phase changes ->) symbols on I. */
+        uint32_t t1 = dwt_now();
+        if (diff) {
+            dbpsk_mod_block(&dbpsk, g_tx_block, g_sym_block, n);
+        } else {
+            bpsk_map_block(g_tx_block, g_sym_block, n);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            q_block[i] = 0;
+        }
+
+        /* Stage 2 — channel: every enabled impairment, AWGN included. */
+        uint32_t t2 = dwt_now();
+        channel_impair_apply(&imp, g_sym_block, q_block, n);
+        channel_sat += sat_since(&sat_mark);
+
+        /* Stage 3 — sync: AGC levels, then the Costas loop de-rotates. */
+        uint32_t t3 = dwt_now();
+        if (!diff) {
+            agc_run_iq(&agc, g_sym_block, q_block, n);
+            costas_run(&loop, g_sym_block, q_block, n);
+            sync_sat += sat_since(&sat_mark);
+        }
+
+        /* Stage 4 — demod: slice I -> rx bits (--evm: Q is its error). */
+        uint32_t t4 = dwt_now();
+        if (diff) {
+            dbpsk_demod_block(&dbpsk, g_sym_block, q_block, g_rx_block, n);
+        } else if (evm != NULL) {
+            evm_slice_block(evm, g_sym_block, q_block, g_rx_block, n);
+        } else {
+            bpsk_slice_block(g_sym_block, g_rx_block, n);
+        }
+
+        /* Stage 5 — check: rx bit k against tx bit k - delay. */
+        uint32_t t5 = dwt_now();
+        uint32_t block_errors = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t bit = nbits - remaining + i;
+            tx_ring[bit & (MODEM_TX_RING - 1u)] = g_tx_block[i];
+            if (bit >= delay &&
+                g_rx_block[i] != tx_ring[(bit - delay) & (MODEM_TX_RING - 1u)]) {
+                block_errors++;
+                if (trig_err && capture_trigger(cap->ring, bit)) {
+                    cap->sym = bit;
+                }
+            }
+        }
+        uint32_t t6 = dwt_now();
+
+        /* Stage 6 — capture (--capture): I/Q into the snapshot ring. */
+        if (cap != NULL) {
+            capture_push(cap->ring, g_sym_block, q_block, n);
+            capture_cycles += dwt_now() - t6;
+        }
+
+        gen_cycles     += t1 - t0;
+        mod_cycles     += t2 - t1;
+        channel_cycles += t3 - t2;
+        sync_cycles    += t4 - t3;
+        demod_cycles   += t5 - t4;
+        check_cycles   += t6 - t5;
+        errors         += block_errors;
+        remaining      -= n;
     }
-    return modem_run_chain(MODEM_POLY, MODEM_SEED, snr_db, nbits);
-}
 
-/* Sum of all timed stages (shaped stages are zero on the unshaped path). */
-static uint32_t modem_total_cycles(const modem_result_t* r) {
-    return r->gen_cycles + r->mod_cycles + r->shape_cycles + r->channel_cycles +
-           r->match_cycles + r->demod_cycles + r->check_cycles;
+    modem_result_t r;
+    r.bits           = (nbits > delay) ? nbits - delay : 0u;
+    r.errors         = errors;
+    if (diff) {
+        r.theory = (cfg.stages & CHANNEL_IMP_FADING)
+                       ? dbpsk_fading_theory_ber(snr_db, cfg.k_factor)
+                       : dbpsk_theory_ber(snr_db);
+    } else {
+        r.theory = (cfg.stages & CHANNEL_IMP_FADING)
+                       ? channel_fading_theory_ber(snr_db, cfg.k_factor)
+                       : channel_awgn_theory_ber(snr_db);
+    }
+    r.shaped         = 0u;
+    r.equalised      = 0u;
+    r.eq_mse_db      = 0.0f;
+    r.carrier        = !diff;
+    r.differential   = diff;
+    r.freq_est       = diff ? 0.0f : costas_freq(&loop);
+    r.slips          = imp.slips;
+    r.gen_cycles     = gen_cycles;
+    r.mod_cycles     = mod_cycles;
+    r.shape_cycles   = 0u;
+    r.channel_cycles = channel_cycles;
+    r.match_cycles   = 0u;
+    r.sync_cycles    = sync_cycles;
+    r.demod_cycles   = demod_cycles;
+    r.eq_cycles      = 0u;
+    r.check_cycles   = check_cycles;
+    r.capture_cycles = capture_cycles;
+    r.mod_sat        = 0u;
+    r.shape_sat      = 0u;
+    r.channel_sat    = channel_sat;
+    r.match_sat      = 0u;
+    r.sync_sat       = sync_sat;
+    r.eq_sat         = 0u;
+    return r;
 }
 
-static int cmd_modem_run(const char* args) {
-    if (!mod_is_ok(args)) {
-        printf("Only --mod bpsk is supported.\n");
-        return 1;
+/* ------------------------------------------------------------------ */
+/* FSK chain (--mod fsk4)                                             */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Bits per FSK block: as many whole symbols as fill g_samp_block, which the
+ * tones are written to (512 bits = 256 symbols = 4096 samples at 4-FSK,
+ * N = 16).
+ */
+#define MODEM_FSK_BLOCK_BITS \
+    (MODEM_BLOCK * MODEM_SHAPE_SPS / MODEM_FSK_N * 2u)
+
+static fsk_t g_fsk;
+
+/*
+ * Run PRBS -> 4-FSK -> AWGN -> Goertzel detect -> compare for nbits (rounded
+ * down to whole symbols), with the same five timed stages as the BPSK chain.
+ * The channel adds the same per-sample noise for a given Eb/N0, so BER and
+ * cycles/bit line up against `modem run` directly; FSK spends N/log2(M) = 8
+ * samples per bit where BPSK spends one.
+ */
+static modem_result_t modem_run_chain_fsk(prbs_poly_t poly, uint16_t seed,
+                                          float snr_db, uint32_t nbits) {
+    prbs_t      tx;
+    awgn_prng_t rng;
+
+    prbs_init(&tx, poly, seed);
+    awgn_prng_seed(&rng, seed);
+    const uint8_t bps = fsk_init(&g_fsk, MODEM_FSK_M, MODEM_FSK_N, MODEM_FSK_BIN0,
+                                 fsk_unit_eb_amp(MODEM_FSK_M, MODEM_FSK_N));
+    nbits -= nbits % bps;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t gen_cycles = 0, mod_cycles = 0, channel_cycles = 0,
+             demod_cycles = 0, check_cycles = 0;
+    uint32_t mod_sat = 0, channel_sat = 0, sat_mark = q15_sat_count();
+    uint64_t errors = 0;
+
+    uint32_t remaining = nbits;
+    while (remaining > 0u) {
+        uint32_t n = (remaining < MODEM_FSK_BLOCK_BITS) ? remaining : MODEM_FSK_BLOCK_BITS;
+
+        uint32_t t0 = dwt_now();
+        prbs_next_bits(&tx, g_tx_block, n);
+
+        uint32_t t1 = dwt_now();
+        size_t ns = fsk_modulate(&g_fsk, g_tx_block, n, g_samp_block);
+        mod_sat += sat_since(&sat_mark);
+
+        uint32_t t2 = dwt_now();
+        channel_awgn_apply(g_samp_block, ns, snr_db, &rng);
+        channel_sat += sat_since(&sat_mark);
+
+        uint32_t t3 = dwt_now();
+        fsk_demodulate(&g_fsk, g_samp_block, ns, g_rx_block);
+
+        uint32_t t4 = dwt_now();
+        uint32_t block_errors = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            if (g_rx_block[i] != g_tx_block[i]) {
+                block_errors++;
+            }
+        }
+        uint32_t t5 = dwt_now();
+
+        gen_cycles     += t1 - t0;
+        mod_cycles     += t2 - t1;
+        channel_cycles += t3 - t2;
+        demod_cycles   += t4 - t3;
+        check_cycles   += t5 - t4;
+        errors         += block_errors;
+        remaining      -= n;
     }
 
-    float    snr_db = MODEM_DEFAULT_SNR_DB;
-    uint32_t nbits  = MODEM_DEFAULT_RUN_BITS;
+    modem_result_t r;
+    r.bits           = nbits;
+    r.errors         = errors;
+    r.theory         = fsk_theory_ber(MODEM_FSK_M, snr_db);
+    r.shaped         = 0u;
+    r.equalised      = 0u;
+    r.eq_mse_db      = 0.0f;
+    r.carrier        = 0u;
+    r.differential   = 0u;
+    r.freq_est       = 0.0f;
+    r.slips          = 0u;
+    r.gen_cycles     = gen_cycles;
+    r.mod_cycles     = mod_cycles;
+    r.shape_cycles   = 0u;
+    r.channel_cycles = channel_cycles;
+    r.match_cycles   = 0u;
+    r.sync_cycles    = 0u;
+    r.demod_cycles   = demod_cycles;
+    r.eq_cycles      = 0u;
+    r.check_cycles   = check_cycles;
+    r.capture_cycles = 0u;
+    r.mod_sat        = mod_sat;
+    r.shape_sat      = 0u;
+    r.channel_sat    = channel_sat;
+    r.match_sat      = 0u;
+    r.sync_sat       = 0u;
+    r.eq_sat         = 0u;
+    return r;
+}
 
-    const char* v = find_flag(args, "--snr");
-    if (v != NULL && parse_float(v, &snr_db) == NULL) {
-        printf("Invalid --snr value.\n");
+/* ------------------------------------------------------------------ */
+/* Spectrum (modem psd)                                               */
+/* ------------------------------------------------------------------ */
+
+/*
+ * `modem psd` streams the --shape transmitter's waveform (PRBS -> BPSK -> TX
+ * RRC) into a Welch accumulator (lib/dsp psd.h) and prints its spectrum plus
+ * the two figures a spectrum mask is written against: 99% occupied bandwidth
+ * and adjacent-channel leakage. The waveform is real, so only 0..Fs/2 is
+ * shown (the negative half mirrors it). Frequencies are in symbol-rate units,
+ * Rs = Fs / MODEM_SHAPE_SPS; the RRC band edge sits at (1 + beta) / 2 Rs.
+ */
+#define MODEM_PSD_DEFAULT_N     1024u
+#define MODEM_PSD_DEFAULT_SEGS  64u
+#define MODEM_PSD_DEFAULT_ROWS  32u
+#define MODEM_PSD_MAX_SEGS      4096u
+#define MODEM_PSD_FLOOR_DB      (-80.0f)   /* bar scale: 0 chars at the floor */
+#define MODEM_PSD_BAR           40u
+
+/* 99% of a beta = 0.35 raised-cosine spectrum lies within +/-0.583 Rs. */
+#define MODEM_PSD_OBW99_RS      1.167f
+
+static psd_t g_psd;   /* ~14 KB of .bss at PSD_MAX_N */
+
+static int cmd_modem_psd(const char* args) {
+    uint32_t nfft = MODEM_PSD_DEFAULT_N;
+    uint32_t segs = MODEM_PSD_DEFAULT_SEGS;
+    uint32_t rows = MODEM_PSD_DEFAULT_ROWS;
+
+    const char* v = find_flag(args, "--n");
+    if ((v != NULL && parse_uint(v, &nfft) == NULL) || nfft > PSD_MAX_N ||
+        psd_init(&g_psd, (uint16_t)nfft) == 0u) {
+        printf("--n must be a power of two, %u..%u\n", (unsigned)FFT_MIN_N,
+               (unsigned)PSD_MAX_N);
         return 1;
     }
-    v = find_flag(args, "--bits");
-    if (v != NULL && parse_uint(v, &nbits) == NULL) {
-        printf("Invalid --bits value.\n");
+    v = find_flag(args, "--segs");
+    if (v != NULL && (parse_uint(v, &segs) == NULL || segs == 0u ||
+                      segs > MODEM_PSD_MAX_SEGS)) {
+        printf("--segs must be 1..%u\n", (unsigned)MODEM_PSD_MAX_SEGS);
         return 1;
     }
-    if (nbits == 0u) {
-        printf("--bits must be > 0.\n");
+    const uint32_t half = nfft / 2u;
+    v = find_flag(args, "--rows");
+    if (v != NULL && (parse_uint(v, &rows) == NULL || rows == 0u)) {
+        printf("Invalid --rows value.\n");
         return 1;
     }
+    if (rows > half) {
+        rows = half;
+    }
 
-    int shaped = shape_requested(args);
-    modem_result_t r = modem_run_dispatch(snr_db, nbits, shaped);
+    prbs_t prbs;
+    prbs_init(&prbs, MODEM_POLY, MODEM_SEED);
+    rrc_design(&g_tx_rrc, MODEM_SHAPE_BETA, MODEM_SHAPE_SPS, MODEM_SHAPE_SPAN);
 
-    uint32_t total_cycles = modem_total_cycles(&r);
-    double   ber = (r.bits > 0u) ? (double)r.errors / (double)r.bits : 0.0;
-    double   nbf = (r.bits > 0u) ? (double)r.bits : 1.0;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-    printf("Eb/N0=%.2f dB  bits=%lu  errors=%lu  shaping=%s\n",
-           (double)snr_db, (unsigned long)r.bits, (unsigned long)r.errors,
-           shaped ? "rrc" : "off");
-    printf("  BER=%.3e  theory=%.3e\n", ber, r.theory);
-    printf("  total : cycles=%lu  Mcycles=%.3f  cyc/bit=%.1f\n",
-           (unsigned long)total_cycles, (double)total_cycles / 1.0e6,
-           (double)total_cycles / nbf);
-    printf("  gen   : cycles=%lu  cyc/bit=%.1f\n",
-           (unsigned long)r.gen_cycles, (double)r.gen_cycles / nbf);
-    printf("  mod   : cycles=%lu  cyc/bit=%.1f\n",
-           (unsigned long)r.mod_cycles, (double)r.mod_cycles / nbf);
-    if (shaped) {
-        printf("  shape : cycles=%lu  cyc/bit=%.1f\n",
-               (unsigned long)r.shape_cycles, (double)r.shape_cycles / nbf);
+    /* Push hop-sized pieces so the run stops at exactly `segs` segments. */
+    const size_t nsamp = (size_t)MODEM_BLOCK * MODEM_SHAPE_SPS;
+    uint32_t cycles = 0u;
+    uint32_t pushed = 0u;
+    while (g_psd.segments < segs) {
+        prbs_next_bits(&prbs, g_tx_block, MODEM_BLOCK);
+        bpsk_map_block(g_tx_block, g_sym_block, MODEM_BLOCK);
+        rrc_tx_shape(&g_tx_rrc, g_sym_block, MODEM_BLOCK, g_samp_block);
+        for (size_t off = 0; off < nsamp && g_psd.segments < segs; off += g_psd.hop) {
+            uint32_t t0 = dwt_now();
+            psd_push(&g_psd, &g_samp_block[off], NULL, g_psd.hop);
+            cycles += dwt_now() - t0;
+            pushed += g_psd.hop;
+        }
     }
-    printf("  chan  : cycles=%lu  cyc/bit=%.1f\n",
-           (unsigned long)r.channel_cycles, (double)r.channel_cycles / nbf);
-    if (shaped) {
-        printf("  match : cycles=%lu  cyc/bit=%.1f\n",
-               (unsigned long)r.match_cycles, (double)r.match_cycles / nbf);
+
+    /* Rows average their bins; levels are relative to the strongest row. */
+    const float rs_per_bin = (float)MODEM_SHAPE_SPS / (float)nfft;
+    float peak = 0.0f;
+    for (uint32_t r = 0; r < rows; r++) {
+        uint32_t k0 = r * half / rows, k1 = (r + 1u) * half / rows;
+        float d = psd_band(&g_psd, (int32_t)k0, (int32_t)k1 - 1) / (float)(k1 - k0);
+        if (d > peak) {
+            peak = d;
+        }
     }
-    printf("  demod : cycles=%lu  cyc/bit=%.1f\n",
-           (unsigned long)r.demod_cycles, (double)r.demod_cycles / nbf);
-    printf("  check : cycles=%lu  cyc/bit=%.1f\n",
-           (unsigned long)r.check_cycles, (double)r.check_cycles / nbf);
+    printf("  f/Rs  |   dB   |  (TX waveform, rrc b=%.2f sps=%u)\n",
+           (double)MODEM_SHAPE_BETA, (unsigned)MODEM_SHAPE_SPS);
+    printf("--------+--------+\n");
+    printf_dma_flush();
+    for (uint32_t r = 0; r < rows; r++) {
+        uint32_t k0 = r * half / rows, k1 = (r + 1u) * half / rows;
+        float d  = psd_band(&g_psd, (int32_t)k0, (int32_t)k1 - 1) / (float)(k1 - k0);
+        float db = (d > 0.0f && peak > 0.0f) ? 10.0f * log10f(d / peak)
+                                              : MODEM_PSD_FLOOR_DB;
+        if (db < MODEM_PSD_FLOOR_DB) {
+            db = MODEM_PSD_FLOOR_DB;
+        }
+        char bar[MODEM_PSD_BAR + 1u];
+        uint32_t len = (uint32_t)((db - MODEM_PSD_FLOOR_DB) / -MODEM_PSD_FLOOR_DB *
+                                  (float)MODEM_PSD_BAR + 0.5f);
+        for (uint32_t c = 0; c < len; c++) {
+            bar[c] = '#';
+        }
+        bar[len] = '\0';
+        printf(" %6.3f | %6.1f | %s\n", (double)((float)(k0 + k1) * 0.5f * rs_per_bin),
+               (double)db, bar);
+        printf_dma_flush();
+    }
+
+    /*
+     * ACLR: the upper adjacent channel, one channel spacing ((1 + beta) Rs)
+     * up and cut off at Fs/2, against the channel itself.
+     */
+    float    total = psd_total(&g_psd);
+    uint16_t h     = psd_occupied_bins(&g_psd, 0.99f);
+    int32_t  edge  = (int32_t)((1.0f + MODEM_SHAPE_BETA) * 0.5f / rs_per_bin + 0.5f);
+    int32_t  adj_hi = 3 * edge;
+    if (adj_hi > (int32_t)half - 1) {
+        adj_hi = (int32_t)half - 1;
+    }
+    float main_p = psd_band(&g_psd, -edge, edge);
+    float adj_p  = psd_band(&g_psd, edge + 1, adj_hi);
+    printf("  total=%.2f dBFS  OBW99=%.3f Rs (theory %.3f)  ACLR=%.1f dBc\n",
+           (double)((total > 0.0f) ? 10.0f * log10f(total) : MODEM_PSD_FLOOR_DB),
+           (double)((float)(2u * h + 1u) * rs_per_bin), (double)MODEM_PSD_OBW99_RS,
+           (double)((adj_p > 0.0f && main_p > 0.0f) ? 10.0f * log10f(adj_p / main_p)
+                                                    : MODEM_PSD_FLOOR_DB));
+    printf("  nfft=%lu  segments=%lu  hann, 50%% overlap  psd cyc/sample=%.1f\n",
+           (unsigned long)nfft, (unsigned long)g_psd.segments,
+           (double)cycles / (double)pushed);
     return 0;
 }
 
-static int cmd_modem_sweep(const char* args) {
-    const char* v = find_flag(args, "--snr");
-    if (v == NULL) {
+/* ------------------------------------------------------------------ */
+/* Kernel micro-benchmarks                                            */
+/* ------------------------------------------------------------------ */
+
+/*
+ * `modem bench` times each sample-path kernel in isolation over one block so
+ * new DSP blocks get a cycles/sample figure (and hence the sample rate the
+ * F411 can sustain) without being wired into the BER chain first. The kernels
+ * share g_samp_block: its first half is the input, its second half the
+ * secondary output where a kernel has one (e.g. the mixer's Q rail).
+ */
+#define MODEM_BENCH_MAX  (MODEM_BLOCK * MODEM_SHAPE_SPS / 2u)
+
+static nco_t g_bench_nco;
+static channel_fading_t g_bench_fading;
+static lms_eq_t g_bench_eq;
+static fastconv_t g_bench_fc;
+static goertzel_bank_t g_bench_goertzel;
+
+static q15_t* bench_in(void)  { return &g_samp_block[0]; }
+static q15_t* bench_aux(void) { return &g_samp_block[MODEM_BENCH_MAX]; }
+
+static void bench_nco_gen(size_t n) {
+    nco_generate(&g_bench_nco, bench_in(), n);
+}
+
+static void bench_mix_up(size_t n) {
+    nco_mix_up(&g_bench_nco, bench_in(), bench_in(), n);
+}
+
+static void bench_mix_down(size_t n) {
+    nco_mix_down(&g_bench_nco, bench_in(), bench_in(), bench_aux(), n);
+}
+
+static void bench_cordic_vec(size_t n) {
+    q15_t* in = bench_in();
+    q15_t* aux = bench_aux();
+    for (size_t k = 0; k + 1u < n; k += 2u) {
+        cordic_vector(in[k], in[k + 1u], CORDIC_ITER_Q15, &aux[k], &aux[k + 1u]);
+    }
+}
+
+static void bench_cordic_rot(size_t n) {
+    cordic_rotate_block(bench_in(), bench_aux(), n / 2u, 0x2345, CORDIC_ITER_Q15);
+}
+
+static void bench_agc(size_t n) {
+    agc_t agc;
+    agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT,
+             AGC_DEFAULT_MU_SHIFT);
+    agc_run_iq(&agc, bench_in(), bench_aux(), n);
+}
+
+static void bench_costas(size_t n) {
+    costas_t loop;
+    costas_init(&loop, COSTAS_BPSK, MODEM_COSTAS_BNT, MODEM_COSTAS_ZETA, 1.0f);
+    costas_run(&loop, bench_in(), bench_aux(), n);
+}
+
+static void bench_fading(size_t n) {
+    channel_fading_apply(&g_bench_fading, bench_in(), bench_aux(), n);
+}
+
+static void bench_lms(size_t n) {
+    lms_eq_run(&g_bench_eq, bench_in(), bench_aux(), n / 2u, NULL);
+}
+
+static void bench_goertzel(size_t n) {
+    goertzel_reset(&g_bench_goertzel);
+    goertzel_run(&g_bench_goertzel, bench_in(), n);
+}
+
+static void bench_rrc(size_t n) {
+    rrc_rx_match(&g_rx_rrc, bench_in(), n, bench_in());
+}
+
+typedef struct {
+    const char* name;
+    void (*run)(size_t n);
+} modem_bench_t;
+
+static const modem_bench_t g_benches[] = {
+    {"nco",     bench_nco_gen},
+    {"mixup",   bench_mix_up},
+    {"mixdown", bench_mix_down},
+    {"cvector", bench_cordic_vec},   /* per I/Q pair: 2 samples/call */
+    {"crotate", bench_cordic_rot},   /* per I/Q pair: 2 samples/call */
+    {"agc_iq",  bench_agc},          /* per I/Q sample                */
+    {"costas",  bench_costas},       /* per I/Q symbol                */
+    {"fading",  bench_fading},       /* per I/Q sample, M = 8, K = 0  */
+    {"rrc33",   bench_rrc},
+    {"lms16",   bench_lms},          /* per T/2 sample: 2 samples/symbol */
+    {"goertz4", bench_goertzel},     /* 4-tone bank, the fsk4 detector  */
+};
+
+/*
+ * Multirate chain for `modem bench`: shape at SPS 4, then raise the rate with
+ * half-bands and a compensated CIC instead of designing one RRC at the final
+ * rate (rrc_design() stops at SPS 8). The RRC band edge (1 + beta) / 2 Rs is
+ * the passband every stage must keep: 0.084 cycles/sample at 8x, 0.042 at 16x.
+ */
+#define MODEM_MR_SYMS    32u
+#define MODEM_MR_FPASS8  ((1.0f + MODEM_SHAPE_BETA) / (4.0f * MODEM_SHAPE_SPS))
+#define MODEM_MR_CIC_N   4u
+#define MODEM_MR_COMP    9u
+
+static halfband_t g_bench_hb;
+static halfband_t g_bench_hb2;
+static cic_comp_t g_bench_comp;
+static cic_t      g_bench_cic;
+static rrc_t      g_bench_rrc8;
+
+/* Deterministic, full-scale-ish test signal so data-dependent paths are hit. */
+static void bench_fill(size_t n) {
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, MODEM_SEED);
+    q15_t* in = bench_in();
+    for (size_t i = 0; i < n; i++) {
+        in[i] = (q15_t)(awgn_prng_u32(&rng) >> 17);
+    }
+}
+
+static void bench_print_transform(const char* name, uint16_t n, uint32_t cycles,
+                                  double sysclk_mhz) {
+    printf(" %s%-5u | %8lu | %9.1f | %6.2f\n", name, (unsigned)n,
+           (unsigned long)cycles, (double)cycles / sysclk_mhz,
+           (double)cycles / ((double)n * (double)fft_log2(n)));
+    printf_dma_flush();
+}
+
+/*
+ * Long-FIR crossover: the same random taps through fastconv's direct form and
+ * its overlap-save path, per tap count. The FFT path is timed over whole
+ * transforms (a multiple of 2L samples) so a partial last frame does not
+ * skew it. The first count where overlap-save wins is the measured value
+ * for FASTCONV_CROSSOVER_TAPS.
+ */
+static void bench_fir_crossover(void) {
+    static const uint16_t taps[] = {16u, 32u, 48u, 64u, 96u, 128u, 192u, 256u};
+    uint16_t crossover = 0u;
+
+    printf("\nfir taps | direct cyc/sample | ols cyc/sample (N)\n");
+    printf("---------+-------------------+-------------------\n");
+    printf_dma_flush();
+    for (size_t t = 0; t < sizeof(taps) / sizeof(taps[0]); t++) {
+        bench_fill(taps[t]);
+        fastconv_init(&g_bench_fc, bench_in(), taps[t], FASTCONV_DIRECT);
+        bench_fill(MODEM_BENCH_MAX);
+        uint32_t t0 = dwt_now();
+        fastconv_run(&g_bench_fc, bench_in(), bench_aux(), MODEM_BENCH_MAX);
+        double direct = (double)(dwt_now() - t0) / (double)MODEM_BENCH_MAX;
+
+        bench_fill(taps[t]);
+        fastconv_init(&g_bench_fc, bench_in(), taps[t], FASTCONV_FFT);
+        size_t step = 2u * (size_t)g_bench_fc.hop;
+        size_t n = (MODEM_BENCH_MAX / step) * step;
+        bench_fill(MODEM_BENCH_MAX);
+        t0 = dwt_now();
+        fastconv_run(&g_bench_fc, bench_in(), bench_aux(), n);
+        double ols = (double)(dwt_now() - t0) / (double)n;
+
+        if (crossover == 0u && ols < direct) {
+            crossover = taps[t];
+        }
+        printf(" %7u | %17.1f | %10.1f (%u)\n", (unsigned)taps[t], direct, ols,
+               (unsigned)g_bench_fc.nfft);
+        printf_dma_flush();
+    }
+    if (crossover != 0u) {
+        printf("ols wins from %u taps (FASTCONV_CROSSOVER_TAPS=%u)\n",
+               (unsigned)crossover, (unsigned)FASTCONV_CROSSOVER_TAPS);
+    } else {
+        printf("direct wins at every length (FASTCONV_CROSSOVER_TAPS=%u)\n",
+               (unsigned)FASTCONV_CROSSOVER_TAPS);
+    }
+}
+
+/*
+ * Print one multirate row: cycles since t0 over nout output samples at the
+ * given oversampling.
+ */
+static void bench_print_multirate(const char* name, uint32_t sps, uint32_t t0,
+                                  size_t nout, double sysclk_mhz) {
+    double cpo = (double)(dwt_now() - t0) / (double)nout;
+    printf(" %-17s | %3lux | %7.2f | %8.3f\n", name, (unsigned long)sps, cpo,
+           (cpo > 0.0) ? sysclk_mhz / cpo : 0.0);
+    printf_dma_flush();
+}
+
+/*
+ * Symbols -> waveform at 8x..64x, cycles per output sample, against one RRC
+ * at SPS 8 (65 taps). Every chain starts from the same MODEM_MR_SYMS symbols;
+ * the staging reuses g_sym_block (symbols, SPS-4 and 8x samples) and
+ * g_samp_block (the wide outputs). Then the RX direction: half-band and CIC
+ * decimators, per output sample.
+ */
+static void bench_multirate(double sysclk_mhz) {
+    q15_t* sym = &g_sym_block[0];
+    q15_t* s4  = &g_sym_block[MODEM_MR_SYMS];
+    q15_t* s8  = &g_sym_block[MODEM_MR_SYMS * (1u + MODEM_SHAPE_SPS)];
+    const size_t n4 = MODEM_MR_SYMS * MODEM_SHAPE_SPS;
+
+    bench_fill(MODEM_MR_SYMS);
+    for (size_t k = 0; k < MODEM_MR_SYMS; k++) {
+        sym[k] = (bench_in()[k] & 1) ? Q15_MAX : Q15_MIN;
+    }
+    rrc_design(&g_tx_rrc, MODEM_SHAPE_BETA, MODEM_SHAPE_SPS, MODEM_SHAPE_SPAN);
+    rrc_design(&g_bench_rrc8, MODEM_SHAPE_BETA, 2u * MODEM_SHAPE_SPS, MODEM_SHAPE_SPAN);
+    halfband_design(&g_bench_hb, MODEM_MR_FPASS8, HALFBAND_INTERP);
+    halfband_design(&g_bench_hb2, MODEM_MR_FPASS8 / 2.0f, HALFBAND_INTERP);
+    cic_comp_design(&g_bench_comp, MODEM_MR_CIC_N, 8u, MODEM_MR_COMP, MODEM_MR_FPASS8);
+
+    printf("\nshape chain       |  sps | cyc/out | max Msps  (hb %u+%u taps, comp %u, cic N=%u)\n",
+           (unsigned)g_bench_hb.ntaps, (unsigned)g_bench_hb2.ntaps,
+           (unsigned)MODEM_MR_COMP, (unsigned)MODEM_MR_CIC_N);
+    printf("------------------+------+---------+----------\n");
+    printf_dma_flush();
+
+    uint32_t t0 = dwt_now();
+    rrc_tx_shape(&g_bench_rrc8, sym, MODEM_MR_SYMS, bench_in());
+    bench_print_multirate("rrc (sps 8)", 8u, t0, 2u * n4, sysclk_mhz);
+
+    t0 = dwt_now();
+    rrc_tx_shape(&g_tx_rrc, sym, MODEM_MR_SYMS, s4);
+    halfband_interpolate(&g_bench_hb, s4, n4, s8);
+    bench_print_multirate("rrc4+hb", 8u, t0, 2u * n4, sysclk_mhz);
+
+    t0 = dwt_now();
+    rrc_tx_shape(&g_tx_rrc, sym, MODEM_MR_SYMS, s4);
+    halfband_interpolate(&g_bench_hb, s4, n4, s8);
+    halfband_interpolate(&g_bench_hb2, s8, 2u * n4, bench_in());
+    bench_print_multirate("rrc4+hb+hb", 16u, t0, 4u * n4, sysclk_mhz);
+
+    for (uint8_t r = 4u; r <= 8u; r = (uint8_t)(r * 2u)) {
+        cic_init(&g_bench_cic, MODEM_MR_CIC_N, r, CIC_INTERP);
+        t0 = dwt_now();
+        rrc_tx_shape(&g_tx_rrc, sym, MODEM_MR_SYMS, s4);
+        halfband_interpolate(&g_bench_hb, s4, n4, s8);
+        cic_comp_run(&g_bench_comp, s8, 2u * n4, s8);
+        cic_interpolate(&g_bench_cic, s8, 2u * n4, bench_in());
+        bench_print_multirate((r == 4u) ? "rrc4+hb+comp+cic4" : "rrc4+hb+comp+cic8",
+                              8u * r, t0, 2u * n4 * r, sysclk_mhz);
+    }
+
+    /* RX direction, in place over the 64x waveform just made. */
+    halfband_design(&g_bench_hb, MODEM_MR_FPASS8 / 8.0f, HALFBAND_DECIM);
+    t0 = dwt_now();
+    size_t nout = halfband_decimate(&g_bench_hb, bench_in(), MODEM_BENCH_MAX, bench_aux());
+    bench_print_multirate("hb decim 64->32", 32u, t0, nout, sysclk_mhz);
+
+    cic_init(&g_bench_cic, MODEM_MR_CIC_N, 8u, CIC_DECIM);
+    t0 = dwt_now();
+    nout = cic_decimate(&g_bench_cic, bench_in(), MODEM_BENCH_MAX, bench_aux());
+    bench_print_multirate("cic8 decim 64->8", 8u, t0, nout, sysclk_mhz);
+}
+
+/*
+ * Framing CRC-16 engines for `modem bench` (lib/framing framing.h): one
+ * full-size payload through each, in cycles/byte and bytes/cycle, and the
+ * share of a UART byte time (10 bits) that leaves at MODEM_CRC_BENCH_BAUD.
+ * The engine the frame encoder/decoder were built with is starred.
+ */
+#define MODEM_CRC_BENCH_BAUD 921600u
+
+typedef uint16_t (*bench_crc_fn_t)(uint16_t crc, const uint8_t* buf, size_t len);
+
+static const struct {
+    const char*    name;
+    bench_crc_fn_t fn;
+    uint8_t        engine;
+} g_crc_benches[] = {
+    {"bitwise", frame_crc16_update_bitwise, FRAME_CRC16_BITWISE},
+    {"nibble",  frame_crc16_update_nibble,  FRAME_CRC16_NIBBLE},
+    {"table",   frame_crc16_update_table,   FRAME_CRC16_TABLE},
+    {"slice4",  frame_crc16_update_slice4,  FRAME_CRC16_SLICE4},
+};
+
+static void bench_crc16(double sysclk_mhz) {
+    const uint8_t* buf = (const uint8_t*)bench_in();
+    const double byte_cycles = sysclk_mhz * 1.0e6 * 10.0 / (double)MODEM_CRC_BENCH_BAUD;
+
+    bench_fill(FRAME_MAX_PAYLOAD / 2u);
+    printf("\ncrc16     | cyc/byte | bytes/cyc | MB/s    | %% of byte @ %lu baud\n",
+           (unsigned long)MODEM_CRC_BENCH_BAUD);
+    printf("----------+----------+-----------+---------+--------------------\n");
+    printf_dma_flush();
+    for (size_t e = 0; e < sizeof(g_crc_benches) / sizeof(g_crc_benches[0]); e++) {
+        uint32_t t0 = dwt_now();
+        volatile uint16_t crc = g_crc_benches[e].fn(FRAME_CRC16_INIT, buf, FRAME_MAX_PAYLOAD);
+        uint32_t cycles = dwt_now() - t0;
+        (void)crc;
+
+        double cpb = (double)cycles / (double)FRAME_MAX_PAYLOAD;
+        printf(" %-8s%c| %8.2f | %9.3f | %7.1f | %6.1f%%\n", g_crc_benches[e].name,
+               (g_crc_benches[e].engine == frame_crc16_engine()) ? '*' : ' ', cpb,
+               (cpb > 0.0) ? 1.0 / cpb : 0.0, (cpb > 0.0) ? sysclk_mhz / cpb : 0.0,
+               100.0 * cpb / byte_cycles);
+        printf_dma_flush();
+    }
+}
+
+/*
+ * Frame codec for `modem bench`: one full-size frame through frame_encode()
+ * and the decoder, clean (no FLAG/ESC in the payload) and random (~0.8%), in
+ * cycles per payload byte, as built (FRAME_SWAR, FRAME_CRC16_ENGINE).
+ */
+static size_t g_bench_rx_len;
+
+static void bench_frame_rx(uint8_t seq, frame_type_t type, const uint8_t* payload,
+                           size_t len, void* user) {
+    (void)seq;
+    (void)type;
+    (void)payload;
+    (void)user;
+    g_bench_rx_len = len;
+}
+
+static void bench_frame_codec(double sysclk_mhz) {
+    uint8_t* payload = (uint8_t*)bench_in();
+    uint8_t* rx_buf  = payload + FRAME_MAX_PAYLOAD;
+    uint8_t* wire    = (uint8_t*)bench_aux();
+    const double byte_cycles = sysclk_mhz * 1.0e6 * 10.0 / (double)MODEM_CRC_BENCH_BAUD;
+
+    printf("\nframe     | enc cyc/B | dec cyc/B | %% of byte @ %lu baud\n",
+           (unsigned long)MODEM_CRC_BENCH_BAUD);
+    printf("----------+-----------+-----------+--------------------\n");
+    printf_dma_flush();
+    for (int clean = 1; clean >= 0; clean--) {
+        bench_fill(FRAME_MAX_PAYLOAD / 2u);
+        for (size_t k = 0; clean && k < FRAME_MAX_PAYLOAD; k++) {
+            if (payload[k] == FRAME_FLAG || payload[k] == FRAME_ESC) {
+                payload[k] = 0x41u;
+            }
+        }
+
+        uint32_t t0 = dwt_now();
+        int n = frame_encode(0u, FRAME_TYPE_DATA, payload, FRAME_MAX_PAYLOAD, wire,
+                             MODEM_BENCH_MAX * sizeof(q15_t));
+        uint32_t enc = dwt_now() - t0;
+
+        frame_decoder_t d;
+        frame_decoder_init(&d, bench_frame_rx, NULL, NULL, rx_buf, FRAME_MAX_PAYLOAD);
+        g_bench_rx_len = 0u;
+        t0 = dwt_now();
+        frame_decoder_feed(&d, wire, (n > 0) ? (size_t)n : 0u);
+        uint32_t dec = dwt_now() - t0;
+        if (g_bench_rx_len != FRAME_MAX_PAYLOAD) {
+            printf(" frame round trip failed\n");
+            return;
+        }
+
+        double ecpb = (double)enc / (double)FRAME_MAX_PAYLOAD;
+        double dcpb = (double)dec / (double)FRAME_MAX_PAYLOAD;
+        printf(" %-9s| %9.2f | %9.2f | %6.1f%%\n", clean ? "clean" : "random", ecpb, dcpb,
+               100.0 * (ecpb + dcpb) / byte_cycles);
+        printf_dma_flush();
+    }
+}
+
+static int cmd_modem_bench(const char* args) {
+    uint32_t n = MODEM_BENCH_MAX;
+    const char* v = find_flag(args, "--n");
+    if (v != NULL && (parse_uint(v, &n) == NULL || n == 0u || n > MODEM_BENCH_MAX)) {
+        printf("--n must be 1..%lu\n", (unsigned long)MODEM_BENCH_MAX);
+        return 1;
+    }
+
+    nco_init(&g_bench_nco, 0.2f, 0u);
+    channel_fading_init(&g_bench_fading, 5e-4f, 0.0f, 0u, MODEM_SEED);
+    rrc_design(&g_rx_rrc, MODEM_SHAPE_BETA, MODEM_SHAPE_SPS, MODEM_SHAPE_SPAN);
+    lms_eq_init(&g_bench_eq, LMS_EQ_DEFAULT_TAPS, 2u, LMS_EQ_DEFAULT_MU_SHIFT,
+                LMS_EQ_DEFAULT_LEAK_SHIFT, 0.5f);
+    static const uint16_t fsk_bins[MODEM_FSK_M] = {2u, 3u, 4u, 5u};
+    goertzel_init_bins(&g_bench_goertzel, fsk_bins, MODEM_FSK_M, MODEM_FSK_N);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    double sysclk_mhz = (double)rcc_get_sysclk() / 1.0e6;
+    printf("kernel   | cyc/sample | max Msps @ %.0f MHz  (n=%lu)\n",
+           sysclk_mhz, (unsigned long)n);
+    printf("---------+------------+-----------\n");
+    printf_dma_flush();
+
+    for (size_t b = 0; b < sizeof(g_benches) / sizeof(g_benches[0]); b++) {
+        bench_fill(n);
+        uint32_t t0 = dwt_now();
+        g_benches[b].run(n);
+        uint32_t cycles = dwt_now() - t0;
+
+        double cps = (double)cycles / (double)n;
+        printf(" %-8s| %10.2f | %9.3f\n", g_benches[b].name, cps,
+               (cps > 0.0) ? sysclk_mhz / cps : 0.0);
+        printf_dma_flush();
+    }
+
+    /*
+     * Block transforms are timed per call, not per sample (--n does not apply):
+     * forward FFTs on interleaved I/Q from bench_in(), and one Welch segment
+     * (window + 1024-point FFT + |X|^2 accumulate), triggered by the sample
+     * that completes it.
+     */
+    printf("\ntransform | cycles   | us        | cyc/(N log2 N)\n");
+    printf("----------+----------+-----------+---------------\n");
+    printf_dma_flush();
+    static const uint16_t fft_sizes[] = {256u, 1024u};
+    for (size_t b = 0; b < sizeof(fft_sizes) / sizeof(fft_sizes[0]); b++) {
+        int8_t exp;
+        bench_fill(2u * fft_sizes[b]);
+        uint32_t t0 = dwt_now();
+        fft_q15(bench_in(), fft_sizes[b], &exp);
+        bench_print_transform("fft", fft_sizes[b], dwt_now() - t0, sysclk_mhz);
+    }
+    bench_fill(2u * PSD_MAX_N);
+    psd_init(&g_psd, PSD_MAX_N);
+    psd_push(&g_psd, bench_in(), &bench_in()[PSD_MAX_N], PSD_MAX_N - 1u);
+    uint32_t t0 = dwt_now();
+    psd_push(&g_psd, &bench_in()[PSD_MAX_N - 1u], &bench_in()[2u * PSD_MAX_N - 1u], 1u);
+    bench_print_transform("psd", PSD_MAX_N, dwt_now() - t0, sysclk_mhz);
+
+    bench_fir_crossover();
+    bench_multirate(sysclk_mhz);
+    bench_crc16(sysclk_mhz);
+    bench_frame_codec(sysclk_mhz);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* CLI command                                                        */
+/* ------------------------------------------------------------------ */
+
+/*
+ * --chan presets for the I/Q chain. AWGN is always added at the run's Eb/N0
+ * (the chain sets it); everything else is per preset. Levels are relative to
+ * the unit-amplitude (full-scale) symbols the chain transmits.
+ */
+typedef struct {
+    const char*          name;
+    channel_impair_cfg_t cfg;
+} modem_chan_preset_t;
+
+static const modem_chan_preset_t g_chan_presets[] = {
+    /* AWGN only, through the I/Q receiver. */
+    { "awgn",  { .stages = CHANNEL_IMP_AWGN } },
+    /* Static 3-ray echo: ~2 dB of ISI loss at 6 dB Eb/N0, no equaliser. */
+    { "mp",    { .stages   = CHANNEL_IMP_MULTIPATH,
+                 .mp_ntaps = 3,
+                 .mp_taps  = { { 0.95f, 0.0f }, { 0.2f, -0.15f }, { -0.08f, 0.05f } } } },
+    /* Oscillator: 1e-3 cycles/symbol offset plus Wiener phase noise. */
+    { "pn",    { .stages     = CHANNEL_IMP_CFO | CHANNEL_IMP_PHASE_NOISE,
+                 .cfo        = 1e-3f,
+                 .phase0_rad = MODEM_CFO_PHASE_RAD,
+                 .pn_rms_rad = 0.01f } },
+    /* Front-end DC offset, 10% of full scale, both rails. */
+    { "dc",    { .stages = CHANNEL_IMP_DC, .dc_i = 0.1f, .dc_q = -0.1f } },
+    /* Hot 8-bit ADC clipping at 75% of full scale (BPSK barely notices). */
+    { "adc",   { .stages     = CHANNEL_IMP_CLIP | CHANNEL_IMP_ADC,
+                 .clip_level = 0.75f,
+                 .adc_bits   = 8u } },
+    /*
+     * 5 ppm sample clock: half a symbol of drift per 100k symbols, so with no
+     * timing recovery the BER climbs as the sampling instant walks off-centre.
+     */
+    { "drift", { .stages = CHANNEL_IMP_CLOCK, .clock_ppm = 5.0f } },
+    /*
+     * Flat fading at 5e-4 cycles/symbol Doppler; theory is coherent BPSK with
+     * ideal channel knowledge. Rician K = 10 tracks it from ~5 dB. In Rayleigh
+     * the deep fades make the Costas loop slip half-cycles, inverting every bit
+     * until the next slip, so BER stays near 0.5 — the case for DBPSK.
+     */
+    { "rice",  { .stages = CHANNEL_IMP_FADING, .fd_norm = 5e-4f, .k_factor = 10.0f } },
+    { "rayl",  { .stages = CHANNEL_IMP_FADING, .fd_norm = 5e-4f } },
+    /* Every static impairment at once, milder. */
+    { "all",   { .stages     = 0xFFu,
+                 .mp_ntaps   = 2,
+                 .mp_taps    = { { 0.95f, 0.0f }, { 0.15f, 0.1f } },
+                 .cfo        = 5e-4f,
+                 .phase0_rad = MODEM_CFO_PHASE_RAD,
+                 .pn_rms_rad = 0.005f,
+                 .clock_ppm  = 1.0f,
+                 .dc_i       = 0.05f,
+                 .dc_q       = 0.05f,
+                 .clip_level = 0.9f,
+                 .adc_bits   = 10u } },
+};
+
+#define MODEM_NUM_CHAN_PRESETS (sizeof(g_chan_presets) / sizeof(g_chan_presets[0]))
+
+static void print_run_usage(void) {
+    printf("Usage:\n");
+    printf("  modem run [--mod bpsk|fsk4|dbpsk] [--snr <dB>] [--bits <N>] [--evm] [--shape [--isi] [--eq] | --cfo <f> | --chan <p>] [--capture <sym>|err]\n");
+    printf("  modem sweep --snr <lo>:<hi>:<step> [--mod bpsk|fsk4|dbpsk] [--bits <N>] [--shape [--isi] [--eq] | --cfo <f> | --chan <p>]\n");
+    printf("  modem bench [--n <samples>]\n");
+    printf("  modem psd [--n <nfft>] [--segs <K>] [--rows <R>]\n");
+    printf("  modem dump\n");
+    printf("  modem link [--frames <N>] [--delay <ms>] [--jitter <ms>] [--loss <%%>] [--corrupt <%%>] | modem link stats\n");
+    printf("  --shape: RRC pulse shaping (b=0.35, sps=4, span=8) at sample rate\n");
+    printf("  --isi: static 3-ray echo at sample rate; --eq: T/2 LMS equaliser (imply --shape)\n");
+    printf("  --mod fsk4: non-coherent 4-FSK, 16 samples/symbol, Goertzel detector (no other options)\n");
+    printf("  --mod dbpsk: differential BPSK, delay-and-multiply detector, no carrier recovery (--cfo/--chan/--capture only)\n");
+    printf("  --evm: MER/EVM and constellation statistics from the slicer\n");
+    printf("  --cfo: carrier offset in cycles/symbol, tracked by a Costas loop\n");
+    printf("  --capture: %u samples around symbol <sym> or the first error (--shape without --eq, or --cfo/--chan); 'modem dump' streams them\n",
+           (unsigned)MODEM_CAPTURE_LEN);
+    printf("  --chan: impairment preset:");
+    for (size_t k = 0; k < MODEM_NUM_CHAN_PRESETS; k++) {
+        printf(" %s", g_chan_presets[k].name);
+    }
+    printf("\n");
+}
+
+/*
+ * "--shape", "--isi" and "--eq" are valueless toggles. Returns the
+ * MODEM_SHAPE_* mask, 0 for the default chain; the echo and the equaliser only
+ * exist on the shaped chain, so either implies it.
+ */
+static uint8_t shape_requested(const char* args) {
+    uint8_t opts = 0u;
+    if (find_flag(args, "--isi") != NULL) {
+        opts |= MODEM_SHAPE_ISI;
+    }
+    if (find_flag(args, "--eq") != NULL) {
+        opts |= MODEM_SHAPE_EQ;
+    }
+    if (opts != 0u || find_flag(args, "--shape") != NULL) {
+        opts |= MODEM_SHAPE_ON;
+    }
+    return opts;
+}
+
+/* Report name for a MODEM_SHAPE_* mask. */
+static const char* shape_name(uint8_t opts) {
+    static const char* const names[] = {"rrc", "rrc+isi", "rrc+eq", "rrc+isi+eq"};
+    if (opts == 0u) {
+        return "off";
+    }
+    return names[(opts >> 1) & 3u];
+}
+
+/* Does the whitespace-delimited token at s equal word? */
+static int token_is(const char* s, const char* word) {
+    while (*word != '\0' && *s == *word) {
+        s++;
+        word++;
+    }
+    return *word == '\0' && (*s == '\0' || *s == ' ');
+}
+
+/*
+ * Parse an optional "--mod": MODEM_MOD_BPSK (the default), MODEM_MOD_FSK4 or
+ * MODEM_MOD_DBPSK, -1 if unknown. The FSK chain is its own transmitter and
+ * detector, so it takes none of the BPSK chain's --shape/--cfo/--chan/--evm/
+ * --capture options. DBPSK runs on the I/Q chain at one sample per symbol
+ * and slices nothing, so it keeps --cfo/--chan/--capture and drops
+ * --shape/--isi/--eq/--evm.
+ */
+static int mod_requested(const char* args) {
+    const char* m = find_flag(args, "--mod");
+    if (m == NULL || token_is(m, "bpsk")) {
+        return MODEM_MOD_BPSK;
+    }
+    if (token_is(m, "dbpsk")) {
+        if (shape_requested(args) || find_flag(args, "--evm") != NULL) {
+            return -1;
+        }
+        return MODEM_MOD_DBPSK;
+    }
+    if (!token_is(m, "fsk4")) {
+        return -1;
+    }
+    if (find_flag(args, "--shape") != NULL || find_flag(args, "--isi") != NULL ||
+        find_flag(args, "--eq") != NULL || find_flag(args, "--cfo") != NULL ||
+        find_flag(args, "--chan") != NULL || find_flag(args, "--evm") != NULL ||
+        find_flag(args, "--capture") != NULL) {
+        return -1;
+    }
+    return MODEM_MOD_FSK4;
+}
+
+/*
+ * Parse the I/Q-chain flags into *cfg: an optional "--chan <preset>" and an
+ * optional "--cfo <f>" (cycles/symbol), which adds or overrides the carrier
+ * offset. *name is the preset name for the report. Returns 0 if neither is
+ * present, 1 if *cfg is ready, -1 if malformed or combined with --shape (the
+ * I/Q chain is symbol-rate only).
+ */
+static int chan_requested(const char* args, channel_impair_cfg_t* cfg,
+                          const char** name) {
+    const char* p = find_flag(args, "--chan");
+    const char* v = find_flag(args, "--cfo");
+    if (p == NULL && v == NULL) {
+        return 0;
+    }
+    if (shape_requested(args)) {
+        return -1;
+    }
+
+    const modem_chan_preset_t* preset = &g_chan_presets[0];
+    if (p != NULL) {
+        preset = NULL;
+        for (size_t k = 0; k < MODEM_NUM_CHAN_PRESETS; k++) {
+            if (token_is(p, g_chan_presets[k].name)) {
+                preset = &g_chan_presets[k];
+                break;
+            }
+        }
+        if (preset == NULL) {
+            return -1;
+        }
+    }
+    *cfg  = preset->cfg;
+    *name = preset->name;
+
+    if (v != NULL) {
+        float cfo = 0.0f;
+        if (parse_float(v, &cfo) == NULL || cfo <= -0.5f || cfo >= 0.5f) {
+            return -1;
+        }
+        cfg->stages    |= CHANNEL_IMP_CFO;
+        cfg->cfo        = cfo;
+        cfg->phase0_rad = MODEM_CFO_PHASE_RAD;
+    }
+    return 1;
+}
+
+/*
+ * Parse an optional "--capture <sym>|err" into g_capture. Returns 0 if absent,
+ * 1 if set, -1 if malformed or on a chain without a capture point (the plain
+ * chain, and --eq, which compacts the matched-filter block in place).
+ */
+static int capture_requested(const char* args, uint8_t shaped, int iq) {
+    const char* v = find_flag(args, "--capture");
+    if (v == NULL) {
+        return 0;
+    }
+    if ((shaped & MODEM_SHAPE_EQ) != 0u || (!shaped && !iq)) {
+        return -1;
+    }
+    g_capture.sym    = 0u;
+    g_capture.on_err = (uint8_t)token_is(v, "err");
+    if (!g_capture.on_err && parse_uint(v, &g_capture.sym) == NULL) {
+        return -1;
+    }
+    return 1;
+}
+
+/*
+ * Dispatch to the FSK, shaped, I/Q or plain chain from the flags (chan NULL:
+ * no I/Q; evm NULL: plain slicer; cap NULL: no capture). DBPSK always takes
+ * the I/Q chain, on the plain AWGN preset when no channel was asked for.
+ */
+static modem_result_t modem_run_dispatch(int mod, float snr_db, uint32_t nbits,
+                                         uint8_t shaped,
+                                         const channel_impair_cfg_t* chan, evm_t* evm,
+                                         modem_capture_t* cap) {
+    if (mod == MODEM_MOD_FSK4) {
+        return modem_run_chain_fsk(MODEM_POLY, MODEM_SEED, snr_db, nbits);
+    }
+    if (mod == MODEM_MOD_DBPSK) {
+        return modem_run_chain_iq(MODEM_POLY, MODEM_SEED, snr_db, nbits,
+                                  (chan != NULL) ? chan : &g_chan_presets[0].cfg,
+                                  NULL, cap, 1u);
+    }
+    if (chan != NULL) {
+        return modem_run_chain_iq(MODEM_POLY, MODEM_SEED, snr_db, nbits, chan, evm, cap,
+                                  0u);
+    }
+    if (shaped) {
+        return modem_run_chain_shaped(MODEM_POLY, MODEM_SEED, snr_db, nbits, shaped, evm,
+                                      cap);
+    }
+    return modem_run_chain(MODEM_POLY, MODEM_SEED, snr_db, nbits, evm);
+}
+
+/* Sum of all timed stages (shaped stages are zero on the unshaped path). */
+static uint32_t modem_total_cycles(const modem_result_t* r) {
+    return r->gen_cycles + r->mod_cycles + r->shape_cycles + r->channel_cycles +
+           r->match_cycles + r->sync_cycles + r->demod_cycles + r->eq_cycles +
+           r->check_cycles + r->capture_cycles;
+}
+
+/* Sum of the per-stage q15 clamp counts (0 unless built with SAT_STATS=1). */
+static uint32_t modem_total_sat(const modem_result_t* r) {
+    return r->mod_sat + r->shape_sat + r->channel_sat + r->match_sat + r->sync_sat +
+           r->eq_sat;
+}
+
+static int cmd_modem_run(const char* args) {
+    int mod = mod_requested(args);
+    if (mod < 0) {
+        printf("Invalid --mod: bpsk, fsk4 without --shape/--isi/--eq/--cfo/--chan/--evm/--capture, or dbpsk without --shape/--isi/--eq/--evm.\n");
+        return 1;
+    }
+
+    float    snr_db = MODEM_DEFAULT_SNR_DB;
+    uint32_t nbits  = MODEM_DEFAULT_RUN_BITS;
+
+    const char* v = find_flag(args, "--snr");
+    if (v != NULL && parse_float(v, &snr_db) == NULL) {
+        printf("Invalid --snr value.\n");
+        return 1;
+    }
+    v = find_flag(args, "--bits");
+    if (v != NULL && parse_uint(v, &nbits) == NULL) {
+        printf("Invalid --bits value.\n");
+        return 1;
+    }
+    if (nbits == 0u) {
+        printf("--bits must be > 0.\n");
+        return 1;
+    }
+
+    uint8_t shaped = shape_requested(args);
+    channel_impair_cfg_t chan;
+    const char* chan_name = NULL;
+    int iq = chan_requested(args, &chan, &chan_name);
+    if (iq < 0) {
+        printf("Invalid --cfo/--chan: need -0.5 < f < 0.5 and a known preset, without --shape/--isi/--eq.\n");
+        return 1;
+    }
+    int want_cap = capture_requested(args, shaped, iq || mod == MODEM_MOD_DBPSK);
+    if (want_cap < 0) {
+        printf("Invalid --capture: <sym> or err, with --shape (not --eq) or --cfo/--chan.\n");
+        return 1;
+    }
+    static evm_t evm;
+    int want_evm = find_flag(args, "--evm") != NULL;
+    modem_result_t r = modem_run_dispatch(mod, snr_db, nbits, shaped, iq ? &chan : NULL,
+                                          want_evm ? &evm : NULL,
+                                          want_cap ? &g_capture : NULL);
+
+    uint32_t total_cycles = modem_total_cycles(&r);
+    double   ber = (r.bits > 0u) ? (double)r.errors / (double)r.bits : 0.0;
+    double   nbf = (r.bits > 0u) ? (double)r.bits : 1.0;
+
+    printf("Eb/N0=%.2f dB  bits=%lu  errors=%lu  shaping=%s\n",
+           (double)snr_db, (unsigned long)r.bits, (unsigned long)r.errors,
+           shape_name(shaped));
+    if (mod == MODEM_MOD_FSK4) {
+        printf("  mod=fsk4  N=%u samples/sym  tones on bins %u..%u  non-coherent\n",
+               (unsigned)MODEM_FSK_N, (unsigned)MODEM_FSK_BIN0,
+               (unsigned)(MODEM_FSK_BIN0 + MODEM_FSK_M - 1u));
+    }
+    if (r.differential) {
+        printf("  mod=dbpsk  chan=%s  cfo=%.6f cyc/sym  delay-and-multiply, no carrier recovery  slips=%lu\n",
+               iq ? chan_name : g_chan_presets[0].name, iq ? (double)chan.cfo : 0.0,
+               (unsigned long)r.slips);
+    }
+    printf("  BER=%.3e  theory=%.3e\n", ber, r.theory);
+    if (r.equalised) {
+        printf("  eq=lms %u taps T/2  train=%lu sym  mse=%.1f dB\n",
+               (unsigned)LMS_EQ_DEFAULT_TAPS, (unsigned long)MODEM_EQ_TRAIN_SYMS,
+               (double)r.eq_mse_db);
+    }
+    if (r.carrier) {
+        printf("  chan=%s  cfo=%.6f cyc/sym  costas est=%.6f cyc/sym  slips=%lu\n",
+               chan_name, (double)chan.cfo, (double)r.freq_est,
+               (unsigned long)r.slips);
+    }
+    evm_stats_t st;
+    if (want_evm && evm_report(&evm, &st)) {
+        printf("  MER=%.2f dB  EVM=%.2f%% rms, %.1f%% peak  est Eb/N0=%.2f dB  (%lu sym)\n",
+               (double)st.mer_db, (double)st.evm_rms_pct, (double)st.evm_peak_pct,
+               (double)st.ebn0_db, (unsigned long)st.symbols);
+        printf("  constellation: centroid=%.4f  I std=%.4f  Q rms=%.4f  (x FS)  clipped=%.1f%%\n",
+               (double)st.centroid, (double)st.i_std, (double)st.q_rms,
+               (double)st.clip_pct);
+    }
+    if (want_cap) {
+        if (capture_state(&g_capture_ring) == CAPTURE_DONE) {
+            printf("  capture: %u samples, sps=%u, trigger sym %lu%s  ('modem dump' to stream)\n",
+                   (unsigned)capture_read(&g_capture_ring, g_samp_block, NULL, NULL),
+                   (unsigned)g_capture.sps, (unsigned long)g_capture.sym,
+                   g_capture.on_err ? " (first error)" : "");
+        } else {
+            printf("  capture: not triggered (%s)\n",
+                   g_capture.on_err ? "no bit errors" : "symbol past the end of the run");
+        }
+    }
+    printf("  total : cycles=%lu  Mcycles=%.3f  cyc/bit=%.1f\n",
+           (unsigned long)total_cycles, (double)total_cycles / 1.0e6,
+           (double)total_cycles / nbf);
+    printf("  gen   : cycles=%lu  cyc/bit=%.1f\n",
+           (unsigned long)r.gen_cycles, (double)r.gen_cycles / nbf);
+    printf("  mod   : cycles=%lu  cyc/bit=%.1f\n",
+           (unsigned long)r.mod_cycles, (double)r.mod_cycles / nbf);
+    if (shaped) {
+        printf("  shape : cycles=%lu  cyc/bit=%.1f\n",
+               (unsigned long)r.shape_cycles, (double)r.shape_cycles / nbf);
+    }
+    printf("  chan  : cycles=%lu  cyc/bit=%.1f\n",
+           (unsigned long)r.channel_cycles, (double)r.channel_cycles / nbf);
+    if (shaped) {
+        printf("  match : cycles=%lu  cyc/bit=%.1f\n",
+               (unsigned long)r.match_cycles, (double)r.match_cycles / nbf);
+    }
+    if (r.carrier) {
+        printf("  sync  : cycles=%lu  cyc/bit=%.1f\n",
+               (unsigned long)r.sync_cycles, (double)r.sync_cycles / nbf);
+    }
+    printf("  demod : cycles=%lu  cyc/bit=%.1f\n",
+           (unsigned long)r.demod_cycles, (double)r.demod_cycles / nbf);
+    if (r.equalised) {
+        printf("  eq    : cycles=%lu  cyc/sym=%.1f\n",
+               (unsigned long)r.eq_cycles, (double)r.eq_cycles / nbf);
+    }
+    printf("  check : cycles=%lu  cyc/bit=%.1f\n",
+           (unsigned long)r.check_cycles, (double)r.check_cycles / nbf);
+    if (want_cap) {
+        printf("  capt  : cycles=%lu  cyc/bit=%.1f\n",
+               (unsigned long)r.capture_cycles, (double)r.capture_cycles / nbf);
+    }
+#ifdef Q15_SAT_STATS
+    /* Clamped samples per stage that can saturate, only for the stages run. */
+    printf("  sat   : total=%lu", (unsigned long)modem_total_sat(&r));
+    if (mod == MODEM_MOD_FSK4) {
+        printf("  mod=%lu", (unsigned long)r.mod_sat);
+    }
+    if (shaped) {
+        printf("  shape=%lu", (unsigned long)r.shape_sat);
+    }
+    printf("  chan=%lu", (unsigned long)r.channel_sat);
+    if (shaped) {
+        printf("  match=%lu", (unsigned long)r.match_sat);
+    }
+    if (r.carrier) {
+        printf("  sync=%lu", (unsigned long)r.sync_sat);
+    }
+    if (r.equalised) {
+        printf("  eq=%lu", (unsigned long)r.eq_sat);
+    }
+    printf("  clamps\n");
+#endif
+    return 0;
+}
+
+/*
+ * Capture frames for `modem dump`: FRAME_TYPE_CAPTURE, seq counting from 0,
+ * little-endian fields. One header, then the window in order:
+ *
+ *   header:  [0][version][sps][rails][count u16][trig u16][sym u32][on_err]
+ *   samples: [1][offset u16] then per sample I q15 (and Q q15 if rails == 2)
+ *
+ * trig is the trigger's offset in the window; it is a decision instant, so
+ * on the shaped chain the symbol peaks sit at trig + k*sps.
+ */
+#define MODEM_CAPTURE_HDR_LEN      13u
+#define MODEM_CAPTURE_IQ_MAX       (MODEM_CAPTURE_CHUNK * 4u)
+#define MODEM_TX_HALF              64u
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/*
+ * Send one frame as raw bytes on the UART DMA, past printf (whose _putchar
+ * would turn 0x0A into CR LF). The streaming encoder fills one half of a
+ * ping-pong buffer while the DMA drains the other, so no worst-case encode
+ * buffer is needed; it returns once the last byte has gone.
+ */
+static void modem_send_frame(uint8_t seq, const frame_iov_t* iov, size_t iov_cnt) {
+    static uint8_t tx[2][MODEM_TX_HALF];
+    frame_encoder_t enc;
+    if (frame_encoder_begin(&enc, seq, FRAME_TYPE_CAPTURE, iov, iov_cnt) != FRAME_OK) {
+        return;
+    }
+    uint8_t half = 0u;
+    while (!frame_encoder_done(&enc)) {
+        size_t n = frame_encoder_pull(&enc, tx[half], MODEM_TX_HALF);
+        while (uart_is_tx_busy()) {
+        }
+        uart_write_dma((const char*)tx[half], (uint16_t)n);
+        half ^= 1u;
+    }
+    while (uart_is_tx_busy()) {
+    }
+}
+
+static int cmd_modem_dump(const char* args) {
+    (void)args;
+    q15_t* ci = &g_samp_block[0];
+    q15_t* cq = &g_samp_block[CAPTURE_RING];
+    uint16_t trig = 0;
+    size_t count = capture_read(&g_capture_ring, ci, cq, &trig);
+    if (count == 0u) {
+        printf("No capture: run 'modem run ... --capture <sym>|err' first.\n");
+        return 1;
+    }
+    const uint8_t rails = g_capture_ring.has_q ? 2u : 1u;
+    uint8_t hdr[MODEM_CAPTURE_HDR_LEN];
+    static uint8_t iq[MODEM_CAPTURE_IQ_MAX];
+
+    /* Drain the console first: the frames go out on the same DMA stream. */
+    printf_dma_flush();
+
+    hdr[0] = 0u;
+    hdr[1] = MODEM_CAPTURE_VERSION;
+    hdr[2] = g_capture.sps;
+    hdr[3] = rails;
+    put_u16(&hdr[4], (uint16_t)count);
+    put_u16(&hdr[6], trig);
+    put_u16(&hdr[8], (uint16_t)g_capture.sym);
+    put_u16(&hdr[10], (uint16_t)(g_capture.sym >> 16));
+    hdr[12] = g_capture.on_err;
+    const frame_iov_t hdr_iov = {hdr, MODEM_CAPTURE_HDR_LEN};
+    modem_send_frame(0u, &hdr_iov, 1u);
+
+    /*
+     * Sample frames: a 3-byte prefix, then the samples. One rail goes out
+     * straight from the capture buffer (q15 is little-endian in memory, as
+     * on the wire); two rails are interleaved into iq first.
+     */
+    uint8_t seq = 1u;
+    for (size_t off = 0; off < count; off += MODEM_CAPTURE_CHUNK) {
+        size_t m = (count - off < MODEM_CAPTURE_CHUNK) ? count - off : MODEM_CAPTURE_CHUNK;
+        uint8_t prefix[3];
+        prefix[0] = 1u;
+        put_u16(&prefix[1], (uint16_t)off);
+        frame_iov_t iov[2] = {{prefix, sizeof(prefix)}, {(const uint8_t*)&ci[off], m * 2u}};
+        if (rails == 2u) {
+            for (size_t k = 0; k < m; k++) {
+                put_u16(&iq[4u * k], (uint16_t)ci[off + k]);
+                put_u16(&iq[4u * k + 2u], (uint16_t)cq[off + k]);
+            }
+            iov[1].base = iq;
+            iov[1].len  = m * 4u;
+        }
+        modem_send_frame(seq++, iov, 2u);
+    }
+    return 0;
+}
+
+static int cmd_modem_sweep(const char* args) {
+    const char* v = find_flag(args, "--snr");
+    if (v == NULL) {
         printf("sweep requires --snr <lo>:<hi>:<step>\n");
         return 1;
     }
@@ -560,6 +2154,12 @@ static int cmd_modem_sweep(const char* args) {
         return 1;
     }
 
+    int mod = mod_requested(args);
+    if (mod < 0) {
+        printf("Invalid --mod: bpsk, fsk4 without --shape/--isi/--eq/--cfo/--chan, or dbpsk without --shape/--isi/--eq.\n");
+        return 1;
+    }
+
     uint32_t nbits = MODEM_DEFAULT_SWEEP_BITS;
     v = find_flag(args, "--bits");
     if (v != NULL && (parse_uint(v, &nbits) == NULL || nbits == 0u)) {
@@ -567,27 +2167,336 @@ static int cmd_modem_sweep(const char* args) {
         return 1;
     }
 
-    int shaped = shape_requested(args);
+    uint8_t shaped = shape_requested(args);
+    channel_impair_cfg_t chan;
+    const char* chan_name = NULL;
+    int iq = chan_requested(args, &chan, &chan_name);
+    if (iq < 0) {
+        printf("Invalid --cfo/--chan: need -0.5 < f < 0.5 and a known preset, without --shape/--isi/--eq.\n");
+        return 1;
+    }
 
-    printf("Eb/N0(dB) |  errors |       BER  |    theory  | tot cyc/bit  (shaping=%s)\n",
-           shaped ? "rrc" : "off");
+#ifdef Q15_SAT_STATS
+    printf("Eb/N0(dB) |  errors |       BER  |    theory  | tot cyc/bit |   clamps  (shaping=%s%s)\n",
+#else
+    printf("Eb/N0(dB) |  errors |       BER  |    theory  | tot cyc/bit  (shaping=%s%s)\n",
+#endif
+           shape_name(shaped),
+           (mod == MODEM_MOD_FSK4) ? ", mod=fsk4" : (mod == MODEM_MOD_DBPSK) ? ", mod=dbpsk" : "");
     printf("----------+---------+------------+------------+------------\n");
     printf_dma_flush();
 
     /* Add a small epsilon so the inclusive endpoint isn't lost to rounding. */
     for (float snr = lo; snr <= hi + step * 0.001f; snr += step) {
-        modem_result_t r = modem_run_dispatch(snr, nbits, shaped);
+        modem_result_t r = modem_run_dispatch(mod, snr, nbits, shaped, iq ? &chan : NULL,
+                                              NULL, NULL);
         double nbf = (r.bits > 0u) ? (double)r.bits : 1.0;
         double ber = (r.bits > 0u) ? (double)r.errors / (double)r.bits : 0.0;
         uint32_t total = modem_total_cycles(&r);
+#ifdef Q15_SAT_STATS
+        printf("  %6.2f  | %7lu | %.3e | %.3e | %10.1f  | %8lu\n",
+               (double)snr, (unsigned long)r.errors, ber, r.theory,
+               (double)total / nbf, (unsigned long)modem_total_sat(&r));
+#else
         printf("  %6.2f  | %7lu | %.3e | %.3e | %10.1f\n",
                (double)snr, (unsigned long)r.errors, ber, r.theory,
                (double)total / nbf);
+#endif
         printf_dma_flush();
     }
     return 0;
 }
 
+/* ------------------------------------------------------------------ */
+/* Reliable link over a simulated serial line (modem link)            */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Two ends of a frame_link in SRAM: A sends DATA frames with the stop-and-
+ * wait link under test, B de-duplicates them (frame_link_on_rx()) and
+ * answers ACK, or NACK on a CRC error. Each direction is a FIFO of whole
+ * encoded frames that come out delay + [0, jitter] ms after they went in
+ * (never before the one ahead, like a serial line), after being dropped
+ * or having one byte flipped at the requested rates. Timing is systick
+ * milliseconds, so RTT and RTO are real time.
+ */
+#define MODEM_LINK_PAYLOAD        64u
+#define MODEM_LINK_WIRE_MAX       (2u + 2u * (FRAME_FIXED_OVERHEAD + MODEM_LINK_PAYLOAD))
+#define MODEM_LINK_QUEUE          4u      /* frames in flight per direction */
+#define MODEM_LINK_DEFAULT_FRAMES 100u
+#define MODEM_LINK_DEFAULT_DELAY  20u
+#define MODEM_LINK_INITIAL_RTO    1000u   /* until the first RTT sample */
+#define MODEM_LINK_RETRIES        8u
+
+typedef struct {
+    uint32_t due_ms;
+    uint16_t len;
+    uint8_t  bytes[MODEM_LINK_WIRE_MAX];
+} modem_wire_frame_t;
+
+typedef struct {
+    modem_wire_frame_t q[MODEM_LINK_QUEUE];
+    uint8_t  head;
+    uint8_t  count;
+    uint8_t  cur[MODEM_LINK_WIRE_MAX];   /* frame being assembled from write() chunks */
+    uint16_t cur_len;
+    uint32_t last_due_ms;
+} modem_wire_t;
+
+typedef struct {
+    uint32_t delay_ms;
+    uint32_t jitter_ms;
+    uint32_t loss_q16;       /* probability * 65536 */
+    uint32_t corrupt_q16;
+    uint32_t rng;
+    modem_wire_t to_b;
+    modem_wire_t to_a;
+    frame_link_t a;          /* sender under test */
+    frame_link_t b;          /* receiver: dedup and rx error counts */
+    frame_decoder_t dec_a;
+    frame_decoder_t dec_b;
+    uint8_t buf_a[MODEM_LINK_PAYLOAD];
+    uint8_t buf_b[MODEM_LINK_PAYLOAD];
+
+    /* Last run, for 'modem link stats'. */
+    uint8_t  valid;
+    uint32_t frames;
+    uint32_t delivered;
+    uint32_t failed;
+    uint32_t elapsed_ms;
+} modem_link_sim_t;
+
+static modem_link_sim_t g_link;
+
+static uint32_t link_rand(void) {
+    g_link.rng ^= g_link.rng << 13;
+    g_link.rng ^= g_link.rng >> 17;
+    g_link.rng ^= g_link.rng << 5;
+    return g_link.rng;
+}
+
+/* Put one whole frame on the line, unless it is lost; maybe corrupt it. */
+static void link_wire_push(modem_wire_t* w, const uint8_t* bytes, size_t len) {
+    if ((link_rand() & 0xFFFFu) < g_link.loss_q16 || w->count == MODEM_LINK_QUEUE) {
+        return;
+    }
+    modem_wire_frame_t* f = &w->q[(w->head + w->count) % MODEM_LINK_QUEUE];
+    for (size_t k = 0; k < len; k++) {
+        f->bytes[k] = bytes[k];
+    }
+    f->len = (uint16_t)len;
+    if ((link_rand() & 0xFFFFu) < g_link.corrupt_q16 && len > 2u) {
+        f->bytes[1u + link_rand() % (len - 2u)] ^= 0x10u;   /* inside the FLAGs */
+    }
+    uint32_t due = systick_get_ms() + g_link.delay_ms;
+    if (g_link.jitter_ms > 0u) {
+        due += link_rand() % (g_link.jitter_ms + 1u);
+    }
+    if (w->count > 0u && (int32_t)(due - w->last_due_ms) < 0) {
+        due = w->last_due_ms;
+    }
+    f->due_ms = due;
+    w->last_due_ms = due;
+    w->count++;
+}
+
+/* Feed every frame that has arrived by now into the far end's decoder. */
+static void link_wire_deliver(modem_wire_t* w, frame_decoder_t* d) {
+    uint32_t now = systick_get_ms();
+    while (w->count > 0u && (int32_t)(now - w->q[w->head].due_ms) >= 0) {
+        modem_wire_frame_t* f = &w->q[w->head];
+        w->head = (uint8_t)((w->head + 1u) % MODEM_LINK_QUEUE);
+        w->count--;
+        frame_decoder_feed(d, f->bytes, f->len);
+    }
+}
+
+/* A's transport: frame_link streams in chunks; the line carries whole frames. */
+static int link_a_write(const uint8_t* bytes, size_t n, void* user) {
+    (void)user;
+    modem_wire_t* w = &g_link.to_b;
+    for (size_t k = 0; k < n; k++) {
+        if (w->cur_len < MODEM_LINK_WIRE_MAX) {
+            w->cur[w->cur_len++] = bytes[k];
+        }
+        if (bytes[k] == FRAME_FLAG && w->cur_len > 1u) {
+            link_wire_push(w, w->cur, w->cur_len);
+            w->cur_len = 0u;
+        }
+    }
+    return 0;
+}
+
+static uint32_t link_now_ms(void* user) {
+    (void)user;
+    return systick_get_ms();
+}
+
+static void link_b_reply(frame_type_t type, uint8_t seq) {
+    uint8_t buf[2u + 2u * FRAME_FIXED_OVERHEAD];
+    int n = frame_encode(seq, type, NULL, 0u, buf, sizeof(buf));
+    if (n > 0) {
+        link_wire_push(&g_link.to_a, buf, (size_t)n);
+    }
+}
+
+static void link_b_rx(uint8_t seq, frame_type_t type, const uint8_t* payload,
+                      size_t len, void* user) {
+    (void)type;
+    (void)payload;
+    (void)len;
+    (void)user;
+    if (frame_link_on_rx(&g_link.b, seq)) {
+        g_link.delivered++;
+    }
+    link_b_reply(FRAME_TYPE_ACK, seq);
+}
+
+static void link_b_err(frame_err_t err, void* user) {
+    (void)user;
+    frame_link_on_rx_error(&g_link.b, err);
+    if (err == FRAME_ERR_CRC) {
+        link_b_reply(FRAME_TYPE_NACK, g_link.b.rx_last_seq);
+    }
+}
+
+static void link_a_rx(uint8_t seq, frame_type_t type, const uint8_t* payload,
+                      size_t len, void* user) {
+    (void)payload;
+    (void)len;
+    (void)user;
+    if (type == FRAME_TYPE_ACK) {
+        (void)frame_link_on_ack(&g_link.a, seq);
+    } else if (type == FRAME_TYPE_NACK) {
+        (void)frame_link_on_nack(&g_link.a, seq);
+    }
+}
+
+static void link_a_err(frame_err_t err, void* user) {
+    (void)user;
+    frame_link_on_rx_error(&g_link.a, err);
+}
+
+static void link_print_stats(void) {
+    frame_link_stats_t a;
+    frame_link_stats_t b;
+    frame_link_get_stats(&g_link.a, &a);
+    frame_link_get_stats(&g_link.b, &b);
+    uint32_t ms = (g_link.elapsed_ms > 0u) ? g_link.elapsed_ms : 1u;
+    printf("frames %lu: delivered %lu, failed %lu in %lu ms (%lu B/s)\n",
+           (unsigned long)g_link.frames, (unsigned long)g_link.delivered,
+           (unsigned long)g_link.failed, (unsigned long)g_link.elapsed_ms,
+           (unsigned long)((uint64_t)g_link.delivered * MODEM_LINK_PAYLOAD * 1000u / ms));
+    printf("RTT min/avg/max %lu/%lu/%lu ms over %lu samples; SRTT %lu, RTTVAR %lu, RTO %lu ms\n",
+           (unsigned long)a.rtt_min_ms, (unsigned long)a.rtt_avg_ms,
+           (unsigned long)a.rtt_max_ms, (unsigned long)a.rtt_samples,
+           (unsigned long)a.srtt_ms, (unsigned long)a.rttvar_ms, (unsigned long)a.rto_ms);
+    printf("tx %lu, retransmits %lu (timeouts %lu), duplicate drops %lu, CRC errors %lu, other rx errors %lu\n",
+           (unsigned long)a.tx_frames, (unsigned long)a.retransmits,
+           (unsigned long)a.timeouts, (unsigned long)b.rx_duplicates,
+           (unsigned long)(a.crc_errors + b.crc_errors),
+           (unsigned long)(a.rx_errors + b.rx_errors));
+}
+
+/* Parse "--<key> <pct>" into a probability * 65536; 0 if absent, -1 if bad. */
+static int link_pct_flag(const char* args, const char* key, uint32_t* q16) {
+    float pct = 0.0f;
+    const char* v = find_flag(args, key);
+    *q16 = 0u;
+    if (v == NULL) {
+        return 0;
+    }
+    if (parse_float(v, &pct) == NULL || pct < 0.0f || pct > 100.0f) {
+        return -1;
+    }
+    *q16 = (uint32_t)(pct * 655.36f);
+    return 0;
+}
+
+static int cmd_modem_link(const char* args) {
+    if (args[0] == 's' && args[1] == 't' && args[2] == 'a' && args[3] == 't' &&
+        args[4] == 's' && (args[5] == '\0' || args[5] == ' ')) {
+        if (!g_link.valid) {
+            printf("No link run yet: try 'modem link --loss 5'.\n");
+            return 1;
+        }
+        link_print_stats();
+        return 0;
+    }
+
+    uint32_t frames = MODEM_LINK_DEFAULT_FRAMES;
+    uint32_t delay  = MODEM_LINK_DEFAULT_DELAY;
+    uint32_t jitter = 0u;
+    const char* v = find_flag(args, "--frames");
+    if (v != NULL && (parse_uint(v, &frames) == NULL || frames == 0u)) {
+        printf("Invalid --frames value.\n");
+        return 1;
+    }
+    v = find_flag(args, "--delay");
+    if (v != NULL && parse_uint(v, &delay) == NULL) {
+        printf("Invalid --delay value.\n");
+        return 1;
+    }
+    v = find_flag(args, "--jitter");
+    if (v != NULL && parse_uint(v, &jitter) == NULL) {
+        printf("Invalid --jitter value.\n");
+        return 1;
+    }
+    uint32_t loss = 0u, corrupt = 0u;
+    if (link_pct_flag(args, "--loss", &loss) < 0 ||
+        link_pct_flag(args, "--corrupt", &corrupt) < 0) {
+        printf("Invalid --loss/--corrupt: a percentage, 0..100.\n");
+        return 1;
+    }
+
+    memset(&g_link, 0, sizeof(g_link));
+    g_link.delay_ms    = delay;
+    g_link.jitter_ms   = jitter;
+    g_link.loss_q16    = loss;
+    g_link.corrupt_q16 = corrupt;
+    g_link.rng         = 0x2545F491u;
+    g_link.frames      = frames;
+    frame_link_init(&g_link.a, link_a_write, link_now_ms, NULL,
+                    MODEM_LINK_INITIAL_RTO, MODEM_LINK_RETRIES);
+    frame_link_init(&g_link.b, link_a_write, link_now_ms, NULL,
+                    MODEM_LINK_INITIAL_RTO, MODEM_LINK_RETRIES);
+    frame_decoder_init(&g_link.dec_a, link_a_rx, link_a_err, NULL,
+                       g_link.buf_a, sizeof(g_link.buf_a));
+    frame_decoder_init(&g_link.dec_b, link_b_rx, link_b_err, NULL,
+                       g_link.buf_b, sizeof(g_link.buf_b));
+
+    printf("link: %lu x %u B frames, delay %lu+0..%lu ms each way, initial RTO %u ms\n",
+           (unsigned long)frames, (unsigned)MODEM_LINK_PAYLOAD, (unsigned long)delay,
+           (unsigned long)jitter, (unsigned)MODEM_LINK_INITIAL_RTO);
+    printf_dma_flush();
+
+    static uint8_t payload[MODEM_LINK_PAYLOAD];
+    uint32_t resolved = 0u;
+    uint32_t t0 = systick_get_ms();
+    while (resolved < frames) {
+        link_wire_deliver(&g_link.to_b, &g_link.dec_b);
+        link_wire_deliver(&g_link.to_a, &g_link.dec_a);
+        if (g_link.a.state == FRAME_LINK_IDLE) {
+            if (g_link.a.stats.tx_frames > resolved) {
+                resolved++;   /* ACKed, or failed below */
+            }
+            if (resolved < frames) {
+                for (size_t k = 0; k < MODEM_LINK_PAYLOAD; k++) {
+                    payload[k] = (uint8_t)(resolved + k);
+                }
+                (void)frame_link_send(&g_link.a, FRAME_TYPE_DATA, payload, MODEM_LINK_PAYLOAD);
+            }
+        }
+        if (frame_link_tick(&g_link.a) < 0) {
+            g_link.failed++;
+        }
+    }
+    g_link.elapsed_ms = systick_elapsed_since(t0);
+    g_link.valid = 1u;
+    link_print_stats();
+    return 0;
+}
+
 /* "modem ..." top-level command: dispatch on the first sub-token. */
 static int cmd_modem(const char* args) {
     args = skip_ws(args);
@@ -599,12 +2508,28 @@ static int cmd_modem(const char* args) {
         args[4] == 'p' && (args[5] == '\0' || args[5] == ' ')) {
         return cmd_modem_sweep(skip_ws(args + 5));
     }
+    if (args[0] == 'b' && args[1] == 'e' && args[2] == 'n' && args[3] == 'c' &&
+        args[4] == 'h' && (args[5] == '\0' || args[5] == ' ')) {
+        return cmd_modem_bench(skip_ws(args + 5));
+    }
+    if (args[0] == 'p' && args[1] == 's' && args[2] == 'd' &&
+        (args[3] == '\0' || args[3] == ' ')) {
+        return cmd_modem_psd(skip_ws(args + 3));
+    }
+    if (args[0] == 'd' && args[1] == 'u' && args[2] == 'm' && args[3] == 'p' &&
+        (args[4] == '\0' || args[4] == ' ')) {
+        return cmd_modem_dump(skip_ws(args + 4));
+    }
+    if (args[0] == 'l' && args[1] == 'i' && args[2] == 'n' && args[3] == 'k' &&
+        (args[4] == '\0' || args[4] == ' ')) {
+        return cmd_modem_link(skip_ws(args + 4));
+    }
     print_run_usage();
     return 1;
 }
 
 static const cli_command_t commands[] = {
-    {"modem", "BPSK modem sim: run|sweep (see 'modem')", cmd_modem},
+    {"modem", "BPSK/4-FSK modem sim: run|sweep|bench|psd|dump|link (see 'modem')", cmd_modem},
 };
 
 /* ------------------------------------------------------------------ */
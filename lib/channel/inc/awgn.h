@@ -68,7 +68,8 @@ double channel_awgn_theory_ber(float ebn0_db);
 /*
  * Add AWGN to a block of q15 samples in place. The noise standard deviation is
  * derived from ebn0_db via channel_awgn_sigma() and applied on the q15 scale;
- * each noisy sample is saturated into the q15 range.
+ * each noisy sample is saturated into the q15 range (counted in a SAT_STATS=1
+ * build, see fixed.h).
  */
 void channel_awgn_apply(q15_t *samples, size_t n, float ebn0_db, awgn_prng_t *rng);
 
@@ -0,0 +1,50 @@
+#ifndef LIB_CHANNEL_CFO_H
+#define LIB_CHANNEL_CFO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "nco.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Carrier frequency/phase offset impairment for the software channel (Plan 002
+ * sub-track B0). See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Two boards never share a crystal: the receiver's local oscillator sits a few
+ * tens of ppm away from the transmitter's and at an arbitrary starting phase.
+ * At complex baseband that is a slow rotation of every sample,
+ *
+ *     r[n] = s[n] * e^{j (2*pi*f*n + phi0)},   f = carrier offset / fs,
+ *
+ * which this module applies to an I/Q block in place, using the lib/dsp NCO
+ * as the rotator. Real-valued (BPSK) transmitters pass a zeroed Q rail; after
+ * the rotation the energy is spread across both rails, so AWGN must then be
+ * added to I and Q separately (channel_awgn_apply() on each rail gives the
+ * correct N0/2 per dimension).
+ *
+ * Deterministic and stateful: consecutive blocks continue the same rotation,
+ * so a long run can be processed in MODEM_BLOCK-sized pieces.
+ */
+
+typedef struct {
+    nco_t rot;   /* accumulated channel phase and per-sample offset */
+} channel_cfo_t;
+
+/*
+ * Configure an offset of freq_norm (cycles per sample, f / fs) with initial
+ * phase phase_rad (radians, any value; wraps).
+ */
+void channel_cfo_init(channel_cfo_t *cfo, float freq_norm, float phase_rad);
+
+/* Rotate n I/Q samples in place and advance the channel phase. */
+void channel_cfo_apply(channel_cfo_t *cfo, q15_t *i, q15_t *q, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_CHANNEL_CFO_H */
@@ -0,0 +1,97 @@
+#ifndef LIB_CHANNEL_FADING_H
+#define LIB_CHANNEL_FADING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "nco.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Flat (frequency-nonselective) Rayleigh / Rician fading for the software
+ * channel (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * A moving receiver sees the transmitted signal through a complex gain g[k]
+ * that wanders with the Doppler spread. The diffuse part is generated with the
+ * Zheng-Xiao sum-of-sinusoids model (IEEE Comm. Letters, 2002), an improved
+ * Jakes simulator with randomised arrival angles:
+ *
+ *     X_c[k] = sqrt(1/M) * sum_n cos(2*pi*fd*k*cos(a_n) + phi_n)
+ *     X_s[k] = sqrt(1/M) * sum_n cos(2*pi*fd*k*sin(a_n) + psi_n)
+ *     a_n    = (2*pi*n - pi + theta) / (4*M),   n = 1..M
+ *
+ * with theta, phi_n, psi_n uniform per seed. X_c + j*X_s has unit mean power,
+ * a Rayleigh envelope and autocorrelation J0(2*pi*fd*tau). The Rician case
+ * adds a line-of-sight ray arriving at 45 degrees:
+ *
+ *     g[k] = sqrt(1/(K+1)) * (X_c + j*X_s)
+ *          + sqrt(K/(K+1)) * e^{j(2*pi*fd*k*cos(pi/4) + phi_0)}
+ *
+ * so E|g|^2 = 1 for every K and K = 0 is Rayleigh.
+ *
+ * Each sinusoid is a 32-bit phase accumulator read through the lib/dsp NCO
+ * sine table, so the model is integer-only. Since fd is far below the sample
+ * rate, g is only evaluated at knots CHANNEL_FADING_MAX_SPAN samples apart or
+ * less (chosen at init so the phase moves < 0.1 rad between knots) and
+ * linearly interpolated in between, which keeps the per-sample cost at a few
+ * multiplies. Gains are q15-scaled int32 (1.0 == 32768) because a Rayleigh
+ * peak easily exceeds 1.
+ */
+
+#define CHANNEL_FADING_MAX_PATHS      16u
+#define CHANNEL_FADING_DEFAULT_PATHS  8u
+
+/* Knot spacing upper bound, in samples (power of two). */
+#define CHANNEL_FADING_MAX_SPAN       16u
+
+typedef struct {
+    uint8_t  paths;                              /* M sinusoids per rail    */
+    int32_t  diff_amp;                           /* sqrt(1/(M(K+1))), q15   */
+    int32_t  los_amp;                            /* sqrt(K/(K+1)), q15      */
+    uint32_t ph_c[CHANNEL_FADING_MAX_PATHS];     /* in-phase sinusoids      */
+    uint32_t st_c[CHANNEL_FADING_MAX_PATHS];
+    uint32_t ph_s[CHANNEL_FADING_MAX_PATHS];     /* quadrature sinusoids    */
+    uint32_t st_s[CHANNEL_FADING_MAX_PATHS];
+    uint32_t ph_los;
+    uint32_t st_los;
+
+    /* knot interpolation */
+    uint8_t  span_shift;                         /* log2(knot spacing)      */
+    uint32_t pos;                                /* sample index in span    */
+    int32_t  g0_re, g0_im;                       /* gain at current knot    */
+    int32_t  g1_re, g1_im;                       /* gain at next knot       */
+} channel_fading_t;
+
+/*
+ * Configure a fader: doppler is the maximum Doppler shift fd / fs in cycles
+ * per sample (|doppler| < 0.5), k_factor the Rician K (linear, 0 = Rayleigh),
+ * paths the sinusoids per rail (0 selects CHANNEL_FADING_DEFAULT_PATHS; capped
+ * at CHANNEL_FADING_MAX_PATHS). The seed fixes the realisation.
+ */
+void channel_fading_init(channel_fading_t *f, float doppler, float k_factor,
+                         uint8_t paths, uint32_t seed);
+
+/* Produce the next n complex gains (q15-scaled int32, 1.0 == 32768). */
+void channel_fading_gain(channel_fading_t *f, int32_t *g_re, int32_t *g_im,
+                         size_t n);
+
+/* Multiply n I/Q samples by the next n gains in place, saturating to q15. */
+void channel_fading_apply(channel_fading_t *f, q15_t *i, q15_t *q, size_t n);
+
+/*
+ * BPSK BER with coherent detection and ideal channel knowledge, averaged over
+ * the fading at mean Eb/N0 ebn0_db. K = 0 uses the Rayleigh closed form
+ * 0.5 * (1 - sqrt(g / (1 + g))); K > 0 integrates Craig's form of Q() against
+ * the Rician moment-generating function.
+ */
+double channel_fading_theory_ber(float ebn0_db, float k_factor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_CHANNEL_FADING_H */
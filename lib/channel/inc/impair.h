@@ -0,0 +1,163 @@
+#ifndef LIB_CHANNEL_IMPAIR_H
+#define LIB_CHANNEL_IMPAIR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "awgn.h"
+#include "cfo.h"
+#include "fading.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Composable channel impairment engine for the software modem (Plan 002
+ * sub-track B0). See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * channel_awgn_apply() alone describes an ideal channel. This module chains
+ * the non-idealities a real two-board link adds, in the order they occur
+ * physically, over a complex (I/Q) block in place:
+ *
+ *   multipath FIR ─▶ fading ─▶ AWGN ─▶ CFO + phase noise ─▶ sample-clock drift
+ *     (propagation)  (motion)  (RX noise)  (RX oscillator)   (RX ADC clock)
+ *                 ─▶ DC offset ─▶ clipping ─▶ ADC quantisation
+ *                       (RX front end / converter)
+ *
+ * Everything is configured by one channel_impair_cfg_t; a stage runs only if
+ * its CHANNEL_IMP_* bit is set in cfg.stages, so an all-zero mask is a
+ * bit-exact pass-through and each stage can be measured in isolation. All
+ * randomness (AWGN, phase noise) comes from PRNG streams seeded from
+ * cfg.seed, so a given config and seed reproduce the same waveform on host
+ * and target. State carries across calls, so a long run can be fed in
+ * MODEM_BLOCK-sized pieces.
+ *
+ * Stage notes
+ * -----------
+ * - Multipath: complex FIR, taps one sample apart (up to CHANNEL_MP_MAX_TAPS),
+ *   q15 coefficients. Static.
+ * - Fading: flat Rayleigh/Rician complex gain from fading.h at Doppler
+ *   fd_norm and Rician K; unit mean power, so Eb/N0 is the average over fades.
+ * - AWGN: channel_awgn_apply()'s scaling on each rail, i.e. N0/2 per
+ *   dimension at the configured Eb/N0 for unit-energy symbols.
+ * - Phase noise: Wiener (random-walk) phase with the given per-sample RMS
+ *   increment, added on top of the CFO rotation. Its spectrum falls at
+ *   20 dB/decade like a free-running oscillator's.
+ * - Clock drift: the ADC samples the waveform at t_k = k * (1 + ppm * 1e-6)
+ *   via 4-point cubic (Lagrange) interpolation over a short history; ppm > 0
+ *   is a slow ADC clock. The interpolator needs look-ahead, so the stage adds
+ *   CHANNEL_IMPAIR_CLK_DELAY samples of latency. Output
+ *   count equals input count, so once the drift has used up the history the
+ *   stage re-centres by one whole sample — a slip, exactly what an elastic
+ *   buffer does. `slips` counts them.
+ * - DC offset, clipping (symmetric, at clip_level of full scale) and
+ *   quantisation (to adc_bits, round-to-nearest) saturate into q15.
+ *
+ * Channel-side float is allowed here as in awgn.c (the FPU does it cheaply on
+ * target); the receiver algorithms under test stay integer.
+ */
+
+#define CHANNEL_IMP_MULTIPATH    (1u << 0)
+#define CHANNEL_IMP_AWGN         (1u << 1)
+#define CHANNEL_IMP_CFO          (1u << 2)
+#define CHANNEL_IMP_PHASE_NOISE  (1u << 3)
+#define CHANNEL_IMP_CLOCK        (1u << 4)
+#define CHANNEL_IMP_DC           (1u << 5)
+#define CHANNEL_IMP_CLIP         (1u << 6)
+#define CHANNEL_IMP_ADC          (1u << 7)
+#define CHANNEL_IMP_FADING       (1u << 8)
+
+#define CHANNEL_MP_MAX_TAPS  8u
+
+/* Clock-drift interpolator history (power of two) and its nominal latency. */
+#define CHANNEL_CLK_HIST          8u
+#define CHANNEL_IMPAIR_CLK_DELAY  4u
+
+typedef struct {
+    float re;
+    float im;
+} channel_cplx_t;
+
+typedef struct {
+    uint32_t       stages;        /* CHANNEL_IMP_* mask                      */
+    uint32_t       seed;          /* PRNG seed for AWGN and phase noise      */
+
+    uint8_t        mp_ntaps;      /* multipath: tap count (<= MP_MAX_TAPS)   */
+    channel_cplx_t mp_taps[CHANNEL_MP_MAX_TAPS];
+
+    float          fd_norm;       /* fading: max Doppler, cycles per sample  */
+    float          k_factor;      /* fading: Rician K, linear (0 = Rayleigh) */
+
+    float          ebn0_db;       /* AWGN: Eb/N0 for unit-energy symbols     */
+
+    float          cfo;           /* carrier offset, cycles per sample       */
+    float          phase0_rad;    /* initial carrier phase                   */
+    float          pn_rms_rad;    /* phase noise: RMS per-sample increment   */
+
+    float          clock_ppm;     /* ADC clock error, parts per million      */
+
+    float          dc_i;          /* DC offset per rail, fraction of FS      */
+    float          dc_q;
+
+    float          clip_level;    /* clip |x| at this fraction of FS (<= 1)  */
+    uint8_t        adc_bits;      /* quantise to this many bits (1..16)      */
+} channel_impair_cfg_t;
+
+typedef struct {
+    channel_impair_cfg_t cfg;
+
+    /* multipath */
+    q15_t    mp_re[CHANNEL_MP_MAX_TAPS];
+    q15_t    mp_im[CHANNEL_MP_MAX_TAPS];
+    q15_t    mp_dl_i[CHANNEL_MP_MAX_TAPS];   /* delay lines, newest at [0] */
+    q15_t    mp_dl_q[CHANNEL_MP_MAX_TAPS];
+
+    channel_fading_t fading;
+
+    /* noise sources: independent streams from one seed */
+    awgn_prng_t awgn_rng;
+    awgn_prng_t pn_rng;
+    float       awgn_scale;                  /* sigma on the q15 scale     */
+
+    /* oscillator */
+    channel_cfo_t osc;
+    uint32_t      pn_phase;                  /* accumulated phase noise    */
+    float         pn_scale;                  /* rad -> phase-word units    */
+
+    /* clock drift */
+    q15_t    clk_hist_i[CHANNEL_CLK_HIST];
+    q15_t    clk_hist_q[CHANNEL_CLK_HIST];
+    uint32_t clk_w;                          /* next history write index   */
+    int64_t  clk_delay;                      /* read delay, Q32 samples    */
+    int64_t  clk_step;                       /* delay change per sample    */
+    uint32_t slips;
+
+    /* front end */
+    q15_t    dc_i;
+    q15_t    dc_q;
+    q15_t    clip;
+    uint8_t  adc_shift;                      /* 16 - adc_bits              */
+} channel_impair_t;
+
+/*
+ * Prepare an engine from cfg (copied). Out-of-range fields are clamped:
+ * mp_ntaps to CHANNEL_MP_MAX_TAPS, adc_bits to 1..16, clip_level to (0, 1].
+ */
+void channel_impair_init(channel_impair_t *ch, const channel_impair_cfg_t *cfg);
+
+/* Apply every enabled stage, in order, to n I/Q samples in place. */
+void channel_impair_apply(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n);
+
+/*
+ * Latency the enabled stages add, in samples (receivers aligning against the
+ * transmitted stream skip this many outputs). Multipath tap 0 is the direct
+ * path, so only the clock stage contributes.
+ */
+size_t channel_impair_delay(const channel_impair_t *ch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_CHANNEL_IMPAIR_H */
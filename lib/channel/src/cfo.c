@@ -0,0 +1,29 @@
+#include "cfo.h"
+
+void channel_cfo_init(channel_cfo_t *cfo, float freq_norm, float phase_rad)
+{
+    if (cfo == NULL) {
+        return;
+    }
+    /*
+     * A phase in turns maps onto the 32-bit word exactly like a frequency in
+     * cycles/sample, so the NCO's converter doubles as the phase converter.
+     * Wrap to [-0.5, 0.5) turns first to keep the conversion in range.
+     */
+    float turns = phase_rad / 6.283185307179586f;
+    turns -= (float)(int32_t)turns;
+    if (turns >= 0.5f) {
+        turns -= 1.0f;
+    } else if (turns < -0.5f) {
+        turns += 1.0f;
+    }
+    nco_init(&cfo->rot, freq_norm, nco_freq_to_step(turns));
+}
+
+void channel_cfo_apply(channel_cfo_t *cfo, q15_t *i, q15_t *q, size_t n)
+{
+    if (cfo == NULL) {
+        return;
+    }
+    nco_mix_complex(&cfo->rot, i, q, n);
+}
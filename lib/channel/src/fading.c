@@ -0,0 +1,172 @@
+#include "fading.h"
+#include "awgn.h"
+#include <math.h>
+
+#define FAD_PI            3.14159265358979323846
+#define FAD_TWO_POW_32    4294967296.0
+
+/* Max phase advance of any sinusoid between knots: 1/64 cycle (~0.1 rad). */
+#define FAD_KNOT_CYCLES   (1.0 / 64.0)
+
+/* Simpson intervals for the Rician BER integral (even). */
+#define FAD_CRAIG_STEPS   128
+
+/* Cycles per sample -> 32-bit phase step (signed frequencies wrap). */
+static uint32_t fad_step(double cycles)
+{
+    return (uint32_t)(int64_t)llrint(cycles * FAD_TWO_POW_32);
+}
+
+/* Gain at the current phases, q15-scaled int32. */
+static void fad_eval(const channel_fading_t *f, int32_t *re, int32_t *im)
+{
+    int32_t acc_c = 0, acc_s = 0;
+    for (size_t n = 0; n < f->paths; n++) {
+        acc_c += nco_cos(f->ph_c[n]);
+        acc_s += nco_cos(f->ph_s[n]);
+    }
+    int64_t gr = ((int64_t)acc_c * f->diff_amp) >> Q15_SHIFT;
+    int64_t gi = ((int64_t)acc_s * f->diff_amp) >> Q15_SHIFT;
+    if (f->los_amp != 0) {
+        gr += ((int64_t)nco_cos(f->ph_los) * f->los_amp) >> Q15_SHIFT;
+        gi += ((int64_t)nco_sin(f->ph_los) * f->los_amp) >> Q15_SHIFT;
+    }
+    *re = (int32_t)gr;
+    *im = (int32_t)gi;
+}
+
+/* Advance every sinusoid to the next knot. */
+static void fad_advance(channel_fading_t *f)
+{
+    for (size_t n = 0; n < f->paths; n++) {
+        f->ph_c[n] += f->st_c[n];
+        f->ph_s[n] += f->st_s[n];
+    }
+    f->ph_los += f->st_los;
+}
+
+void channel_fading_init(channel_fading_t *f, float doppler, float k_factor,
+                         uint8_t paths, uint32_t seed)
+{
+    if (f == NULL) {
+        return;
+    }
+    if (paths == 0u) {
+        paths = CHANNEL_FADING_DEFAULT_PATHS;
+    } else if (paths > CHANNEL_FADING_MAX_PATHS) {
+        paths = CHANNEL_FADING_MAX_PATHS;
+    }
+    if (k_factor < 0.0f) {
+        k_factor = 0.0f;
+    }
+    f->paths = paths;
+
+    double fd = fabs((double)doppler);
+    uint32_t span = CHANNEL_FADING_MAX_SPAN;
+    uint8_t shift = 0u;
+    while ((1u << shift) < span && fd * (double)(2u << shift) <= FAD_KNOT_CYCLES) {
+        shift++;
+    }
+    f->span_shift = shift;
+    span = 1u << shift;
+
+    double k = (double)k_factor;
+    f->diff_amp = (int32_t)lrint(32768.0 * sqrt(1.0 / ((double)paths * (k + 1.0))));
+    f->los_amp  = (int32_t)lrint(32768.0 * sqrt(k / (k + 1.0)));
+
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, seed);
+    double theta = ((double)awgn_prng_u32(&rng) / FAD_TWO_POW_32 - 0.5) * 2.0 * FAD_PI;
+    for (size_t n = 0; n < paths; n++) {
+        double a = (2.0 * FAD_PI * (double)(n + 1u) - FAD_PI + theta) / (4.0 * paths);
+        f->st_c[n] = fad_step((double)doppler * cos(a) * span);
+        f->st_s[n] = fad_step((double)doppler * sin(a) * span);
+        f->ph_c[n] = awgn_prng_u32(&rng);
+        f->ph_s[n] = awgn_prng_u32(&rng);
+    }
+    f->st_los = fad_step((double)doppler * cos(FAD_PI / 4.0) * span);
+    f->ph_los = awgn_prng_u32(&rng);
+
+    f->pos = 0u;
+    fad_eval(f, &f->g0_re, &f->g0_im);
+    fad_advance(f);
+    fad_eval(f, &f->g1_re, &f->g1_im);
+}
+
+/* Interpolated gain for the current sample, then step. */
+static inline void fad_next(channel_fading_t *f, int32_t *re, int32_t *im)
+{
+    const uint8_t sh = f->span_shift;
+    *re = f->g0_re + (((f->g1_re - f->g0_re) * (int32_t)f->pos) >> sh);
+    *im = f->g0_im + (((f->g1_im - f->g0_im) * (int32_t)f->pos) >> sh);
+    if (++f->pos == (1u << sh)) {
+        f->pos   = 0u;
+        f->g0_re = f->g1_re;
+        f->g0_im = f->g1_im;
+        fad_advance(f);
+        fad_eval(f, &f->g1_re, &f->g1_im);
+    }
+}
+
+void channel_fading_gain(channel_fading_t *f, int32_t *g_re, int32_t *g_im,
+                         size_t n)
+{
+    if (f == NULL || g_re == NULL || g_im == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        fad_next(f, &g_re[k], &g_im[k]);
+    }
+}
+
+static inline q15_t fad_sat(int64_t x)
+{
+    if (x > Q15_MAX) {
+        return Q15_MAX;
+    }
+    if (x < Q15_MIN) {
+        return Q15_MIN;
+    }
+    return (q15_t)x;
+}
+
+void channel_fading_apply(channel_fading_t *f, q15_t *i, q15_t *q, size_t n)
+{
+    if (f == NULL || i == NULL || q == NULL) {
+        return;
+    }
+    const int64_t half = 1 << (Q15_SHIFT - 1);
+    for (size_t k = 0; k < n; k++) {
+        int32_t gr, gi;
+        fad_next(f, &gr, &gi);
+        int64_t xr = i[k], xi = q[k];
+        i[k] = fad_sat((xr * gr - xi * gi + half) >> Q15_SHIFT);
+        q[k] = fad_sat((xr * gi + xi * gr + half) >> Q15_SHIFT);
+    }
+}
+
+/* Rician MGF of the per-bit SNR, M(s) = E[e^{s*gamma}], at mean snr g. */
+static double fad_rician_mgf(double s, double g, double k)
+{
+    double d = 1.0 + k - s * g;
+    return (1.0 + k) / d * exp(k * s * g / d);
+}
+
+double channel_fading_theory_ber(float ebn0_db, float k_factor)
+{
+    double g = pow(10.0, (double)ebn0_db / 10.0);
+    double k = (k_factor > 0.0f) ? (double)k_factor : 0.0;
+    if (k == 0.0) {
+        return 0.5 * (1.0 - sqrt(g / (1.0 + g)));
+    }
+
+    /* Pb = (1/pi) * int_0^{pi/2} M(-1 / sin^2(t)) dt, Simpson's rule. */
+    const double h = (FAD_PI / 2.0) / FAD_CRAIG_STEPS;
+    double sum = 0.0;
+    for (int n = 1; n <= FAD_CRAIG_STEPS; n++) {   /* integrand is 0 at t = 0 */
+        double sn = sin(n * h);
+        double w  = (n == FAD_CRAIG_STEPS) ? 1.0 : ((n & 1) ? 4.0 : 2.0);
+        sum += w * fad_rician_mgf(-1.0 / (sn * sn), g, k);
+    }
+    return sum * h / 3.0 / FAD_PI;
+}
@@ -0,0 +1,278 @@
+#include "impair.h"
+#include <math.h>
+
+#define IMP_TWO_PI     6.283185307179586f
+#define IMP_ONE_Q32    ((int64_t)1 << 32)
+
+/*
+ * Clock-drift read window, in samples behind the newest history entry. The
+ * cubic interpolator needs one sample before and two after the read point, so
+ * with CHANNEL_CLK_HIST = 8 the delay may range over [2, 6); it starts centred
+ * at CHANNEL_IMPAIR_CLK_DELAY.
+ */
+#define IMP_CLK_DELAY_MIN  ((int64_t)2 << 32)
+#define IMP_CLK_DELAY_MAX  ((int64_t)6 << 32)
+
+/* Independent phase-noise and fading streams: fixed offsets from the seed. */
+#define IMP_PN_SEED_XOR    0x9E3779B9u
+#define IMP_FAD_SEED_XOR   0x85EBCA6Bu
+
+/* Saturate a 64-bit q15-scaled value (multipath accumulator) to q15. */
+static q15_t q15_sat64(int64_t x)
+{
+    if (x > Q15_MAX) {
+        Q15_SAT_HIT();
+        return Q15_MAX;
+    }
+    if (x < Q15_MIN) {
+        Q15_SAT_HIT();
+        return Q15_MIN;
+    }
+    return (q15_t)x;
+}
+
+void channel_impair_init(channel_impair_t *ch, const channel_impair_cfg_t *cfg)
+{
+    if (ch == NULL || cfg == NULL) {
+        return;
+    }
+    ch->cfg = *cfg;
+    channel_impair_cfg_t *c = &ch->cfg;
+
+    if (c->mp_ntaps > CHANNEL_MP_MAX_TAPS) {
+        c->mp_ntaps = CHANNEL_MP_MAX_TAPS;
+    }
+    for (size_t k = 0; k < CHANNEL_MP_MAX_TAPS; k++) {
+        int used = (k < c->mp_ntaps);
+        ch->mp_re[k]   = used ? q15_from_float(c->mp_taps[k].re) : 0;
+        ch->mp_im[k]   = used ? q15_from_float(c->mp_taps[k].im) : 0;
+        ch->mp_dl_i[k] = 0;
+        ch->mp_dl_q[k] = 0;
+    }
+
+    channel_fading_init(&ch->fading, c->fd_norm, c->k_factor, 0u,
+                        c->seed ^ IMP_FAD_SEED_XOR);
+
+    awgn_prng_seed(&ch->awgn_rng, c->seed);
+    ch->awgn_scale = channel_awgn_sigma(c->ebn0_db) * 32768.0f;
+    awgn_prng_seed(&ch->pn_rng, c->seed ^ IMP_PN_SEED_XOR);
+
+    channel_cfo_init(&ch->osc, c->cfo, c->phase0_rad);
+    ch->pn_phase = 0u;
+    ch->pn_scale = c->pn_rms_rad * (4294967296.0f / IMP_TWO_PI);
+
+    for (size_t k = 0; k < CHANNEL_CLK_HIST; k++) {
+        ch->clk_hist_i[k] = 0;
+        ch->clk_hist_q[k] = 0;
+    }
+    ch->clk_w     = 0u;
+    ch->clk_delay = (int64_t)CHANNEL_IMPAIR_CLK_DELAY << 32;
+    ch->clk_step  = (int64_t)llrint((double)c->clock_ppm * 1e-6 * 4294967296.0);
+    ch->slips     = 0u;
+
+    ch->dc_i = q15_from_float(c->dc_i);
+    ch->dc_q = q15_from_float(c->dc_q);
+
+    float clip = c->clip_level;
+    if (clip <= 0.0f || clip > 1.0f) {
+        clip = 1.0f;
+    }
+    ch->clip = q15_from_float(clip);
+
+    uint8_t bits = c->adc_bits;
+    if (bits < 1u) {
+        bits = 1u;
+    } else if (bits > 16u) {
+        bits = 16u;
+    }
+    ch->adc_shift = (uint8_t)(16u - bits);
+}
+
+/* --- stages -------------------------------------------------------------- */
+
+static void stage_multipath(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n)
+{
+    const size_t taps = ch->cfg.mp_ntaps;
+    for (size_t k = 0; k < n; k++) {
+        for (size_t t = taps - 1u; t > 0u; t--) {
+            ch->mp_dl_i[t] = ch->mp_dl_i[t - 1u];
+            ch->mp_dl_q[t] = ch->mp_dl_q[t - 1u];
+        }
+        ch->mp_dl_i[0] = i[k];
+        ch->mp_dl_q[0] = q[k];
+
+        /* y = sum h[t] * x[k - t], complex; 64-bit so 8 full-scale taps fit. */
+        int64_t acc_i = 0, acc_q = 0;
+        for (size_t t = 0; t < taps; t++) {
+            int32_t xr = ch->mp_dl_i[t], xi = ch->mp_dl_q[t];
+            int32_t hr = ch->mp_re[t],   hi = ch->mp_im[t];
+            acc_i += (int64_t)(hr * xr) - (int64_t)(hi * xi);
+            acc_q += (int64_t)(hr * xi) + (int64_t)(hi * xr);
+        }
+        const int64_t half = 1 << (Q15_SHIFT - 1);
+        i[k] = q15_sat64((acc_i + half) >> Q15_SHIFT);
+        q[k] = q15_sat64((acc_q + half) >> Q15_SHIFT);
+    }
+}
+
+/*
+ * Complex AWGN. Same scaling as channel_awgn_apply(), but the I and Q draws
+ * interleave per sample so the waveform does not depend on block size.
+ */
+static void stage_awgn(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n)
+{
+    const float scale = ch->awgn_scale;
+    for (size_t k = 0; k < n; k++) {
+        float ni = awgn_prng_gauss(&ch->awgn_rng) * scale;
+        float nq = awgn_prng_gauss(&ch->awgn_rng) * scale;
+        i[k] = q15_sat((q31_t)i[k] + (q31_t)lrintf(ni));
+        q[k] = q15_sat((q31_t)q[k] + (q31_t)lrintf(nq));
+    }
+}
+
+static void stage_oscillator(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n)
+{
+    const int cfo = (ch->cfg.stages & CHANNEL_IMP_CFO) != 0u;
+    const int pn  = (ch->cfg.stages & CHANNEL_IMP_PHASE_NOISE) != 0u;
+    nco_t *rot = &ch->osc.rot;
+
+    for (size_t k = 0; k < n; k++) {
+        uint32_t phase = 0u;
+        if (cfo) {
+            phase = rot->phase;
+            rot->phase += rot->step;
+        }
+        if (pn) {
+            float step = awgn_prng_gauss(&ch->pn_rng) * ch->pn_scale;
+            ch->pn_phase += (uint32_t)(int32_t)lrintf(step);
+            phase += ch->pn_phase;
+        }
+        nco_rotate_iq(phase, &i[k], &q[k]);
+    }
+}
+
+/* 4-point Lagrange interpolation between y0 and y1 at mu in [0, 1). */
+static q15_t cubic_interp(q15_t ym1, q15_t y0, q15_t y1, q15_t y2, float mu)
+{
+    float mm1 = mu - 1.0f, mm2 = mu - 2.0f, mp1 = mu + 1.0f;
+    float v = -(float)ym1 * mu * mm1 * mm2 * (1.0f / 6.0f)
+            + (float)y0 * mp1 * mm1 * mm2 * 0.5f
+            - (float)y1 * mp1 * mu * mm2 * 0.5f
+            + (float)y2 * mp1 * mu * mm1 * (1.0f / 6.0f);
+    return q15_sat((q31_t)lrintf(v));
+}
+
+static void stage_clock(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n)
+{
+    const uint32_t mask = CHANNEL_CLK_HIST - 1u;
+    for (size_t k = 0; k < n; k++) {
+        ch->clk_hist_i[ch->clk_w & mask] = i[k];
+        ch->clk_hist_q[ch->clk_w & mask] = q[k];
+        ch->clk_w++;
+
+        /*
+         * Read point: `delay` samples behind the newest entry, which sits at
+         * virtual index HIST in a window whose entry v lives at ring slot
+         * (w - 1 - HIST + v). A slow ADC clock (ppm > 0: longer sample
+         * period) reads ever closer to the newest sample, a fast one ever
+         * further behind; when the window runs out, slip one sample.
+         */
+        ch->clk_delay -= ch->clk_step;
+        if (ch->clk_delay < IMP_CLK_DELAY_MIN) {
+            ch->clk_delay += IMP_ONE_Q32;
+            ch->slips++;
+        } else if (ch->clk_delay >= IMP_CLK_DELAY_MAX) {
+            ch->clk_delay -= IMP_ONE_Q32;
+            ch->slips++;
+        }
+
+        int64_t r  = ((int64_t)CHANNEL_CLK_HIST << 32) - ch->clk_delay;
+        uint32_t v = (uint32_t)(r >> 32);
+        float mu   = (float)((uint32_t)r >> 8) * (1.0f / 16777216.0f);
+        uint32_t base = ch->clk_w - 1u - CHANNEL_CLK_HIST;
+
+        i[k] = cubic_interp(ch->clk_hist_i[(base + v - 1u) & mask],
+                            ch->clk_hist_i[(base + v)      & mask],
+                            ch->clk_hist_i[(base + v + 1u) & mask],
+                            ch->clk_hist_i[(base + v + 2u) & mask], mu);
+        q[k] = cubic_interp(ch->clk_hist_q[(base + v - 1u) & mask],
+                            ch->clk_hist_q[(base + v)      & mask],
+                            ch->clk_hist_q[(base + v + 1u) & mask],
+                            ch->clk_hist_q[(base + v + 2u) & mask], mu);
+    }
+}
+
+/* DC offset, clipping and quantisation, fused: one pass over the block. */
+static void stage_front_end(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n)
+{
+    const uint32_t st = ch->cfg.stages;
+    const int dc   = (st & CHANNEL_IMP_DC) != 0u;
+    const int clip = (st & CHANNEL_IMP_CLIP) != 0u;
+    const int adc  = (st & CHANNEL_IMP_ADC) != 0u && ch->adc_shift > 0u;
+    const q31_t lim   = ch->clip;
+    const uint8_t sh  = ch->adc_shift;
+    const q31_t round = adc ? (1 << (sh - 1u)) : 0;
+
+    for (size_t k = 0; k < n; k++) {
+        q31_t v[2] = {i[k], q[k]};
+        for (int r = 0; r < 2; r++) {
+            q31_t x = v[r];
+            if (dc) {
+                x += (r == 0) ? ch->dc_i : ch->dc_q;
+            }
+            if (clip) {
+                if (x > lim) {
+                    x = lim;
+                } else if (x < -lim) {
+                    x = -lim;
+                }
+            }
+            x = q15_sat(x);
+            if (adc) {
+                /* Round to the nearest code, then saturate at the top code. */
+                x = ((x + round) >> sh) << sh;
+                if (x > Q15_MAX) {
+                    x = Q15_MAX & ~((1 << sh) - 1);
+                }
+            }
+            v[r] = x;
+        }
+        i[k] = (q15_t)v[0];
+        q[k] = (q15_t)v[1];
+    }
+}
+
+void channel_impair_apply(channel_impair_t *ch, q15_t *i, q15_t *q, size_t n)
+{
+    if (ch == NULL || i == NULL || q == NULL) {
+        return;
+    }
+    const uint32_t st = ch->cfg.stages;
+
+    if ((st & CHANNEL_IMP_MULTIPATH) && ch->cfg.mp_ntaps > 0u) {
+        stage_multipath(ch, i, q, n);
+    }
+    if (st & CHANNEL_IMP_FADING) {
+        channel_fading_apply(&ch->fading, i, q, n);
+    }
+    if (st & CHANNEL_IMP_AWGN) {
+        stage_awgn(ch, i, q, n);
+    }
+    if (st & (CHANNEL_IMP_CFO | CHANNEL_IMP_PHASE_NOISE)) {
+        stage_oscillator(ch, i, q, n);
+    }
+    if (st & CHANNEL_IMP_CLOCK) {
+        stage_clock(ch, i, q, n);
+    }
+    if (st & (CHANNEL_IMP_DC | CHANNEL_IMP_CLIP | CHANNEL_IMP_ADC)) {
+        stage_front_end(ch, i, q, n);
+    }
+}
+
+size_t channel_impair_delay(const channel_impair_t *ch)
+{
+    if (ch == NULL || (ch->cfg.stages & CHANNEL_IMP_CLOCK) == 0u) {
+        return 0u;
+    }
+    return CHANNEL_IMPAIR_CLK_DELAY;
+}
@@ -0,0 +1,115 @@
+#ifndef LIB_DSP_CIC_H
+#define LIB_DSP_CIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cascaded integrator-comb (CIC) interpolator / decimator and its droop
+ * compensation FIR, the last (widest-ratio) stage of the software modem's
+ * multirate chain (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * An N-stage CIC of rate R is the boxcar filter (1 - z^-R)/(1 - z^-1) raised
+ * to the N-th power. It is built as N integrators at the high rate and N
+ * single-delay combs at the low rate, with no multiplies at all: an
+ * interpolator costs about N adds per output sample whatever R is. Its
+ * response
+ *
+ *     |H(f)| = |sin(pi f) / (R sin(pi f / R))|^N     (f: low-rate cycles/sample)
+ *
+ * has nulls on every image of DC, which is where the images of a narrow band
+ * land, but it droops across the passband. cic_comp_t is a short linear-phase
+ * FIR, run at the low rate, that inverts the droop over (0, fpass). It is
+ * designed by least squares, with the band from 0.5 - fpass up to 0.5 pushed
+ * towards zero.
+ *
+ * Fixed point: the registers are 32-bit and wrap modulo 2^32, which is
+ * harmless. A CIC's output is exact in modular arithmetic as long as the
+ * final value fits the register. The DC gain is R^(N-1) for an interpolator
+ * and R^N for a decimator. R is a power of two, so the output is just a
+ * rounding shift back to q15: unity gain, with DC bit-exact. That caps the
+ * gain at 2^CIC_MAX_GROWTH: (N-1)·log2 R <= 16 interpolating, N·log2 R <= 16
+ * decimating.
+ *
+ * The compensator taps are q14 (range +/-2), because the inverse droop lifts
+ * the gain above 1 near fpass. Its outputs are rounded and saturated.
+ */
+
+#define CIC_MAX_STAGES     5u
+#define CIC_MAX_RATE       64u
+#define CIC_MAX_GROWTH     16u    /* register bits above q15 */
+#define CIC_COMP_MAX_TAPS  31u    /* odd */
+
+typedef enum {
+    CIC_INTERP = 0,   /* 1 input -> R outputs */
+    CIC_DECIM  = 1    /* R inputs -> 1 output */
+} cic_role_t;
+
+typedef struct {
+    uint32_t integ[CIC_MAX_STAGES];   /* integrators (high rate, modular)    */
+    uint32_t comb[CIC_MAX_STAGES];    /* comb delays (low rate, modular)     */
+    uint8_t  stages;                  /* N                                   */
+    uint8_t  rate;                    /* R, a power of two                   */
+    uint8_t  shift;                   /* log2 of the DC gain                 */
+    uint8_t  role;                    /* cic_role_t                          */
+    uint8_t  phase;                   /* decimator: inputs since last output */
+} cic_t;
+
+/*
+ * Configure an N-stage, rate-R CIC: N in 1..CIC_MAX_STAGES, R a power of two
+ * in 2..CIC_MAX_RATE, with a DC gain of at most 2^CIC_MAX_GROWTH. The state
+ * is zeroed. Returns R, or 0 if invalid (c untouched).
+ */
+uint8_t cic_init(cic_t *c, uint8_t stages, uint8_t rate, cic_role_t role);
+
+/* Zero the integrators, combs and decimator phase. */
+void cic_reset(cic_t *c);
+
+/*
+ * Interpolate n inputs to n * R outputs. out must not overlap in. Returns
+ * n * R, or 0 if c is not an interpolator.
+ */
+size_t cic_interpolate(cic_t *c, const q15_t *in, size_t n, q15_t *out);
+
+/*
+ * Decimate n inputs, writing one output per R inputs. The phase carries
+ * across calls. out may equal in. Returns the number of outputs written, or
+ * 0 if c is not a decimator.
+ */
+size_t cic_decimate(cic_t *c, const q15_t *in, size_t n, q15_t *out);
+
+/* Normalised CIC magnitude (1 at DC) at f cycles per low-rate sample. */
+float cic_gain(uint8_t stages, uint8_t rate, float f);
+
+typedef struct {
+    q15_t    taps[CIC_COMP_MAX_TAPS];     /* q14                            */
+    q15_t    z[2u * CIC_COMP_MAX_TAPS];   /* mirrored delay line            */
+    uint16_t pos;
+    uint8_t  ntaps;
+} cic_comp_t;
+
+/*
+ * Design the droop compensator for an N-stage, rate-R CIC: ntaps odd in
+ * 3..CIC_COMP_MAX_TAPS, passband edge fpass in (0, 0.25) cycles per low-rate
+ * sample. The state is zeroed. Returns ntaps, or 0 if invalid (cc untouched).
+ */
+uint8_t cic_comp_design(cic_comp_t *cc, uint8_t stages, uint8_t rate,
+                        uint8_t ntaps, float fpass);
+
+/* Zero the compensator's delay line. */
+void cic_comp_reset(cic_comp_t *cc);
+
+/* Filter n samples (out may equal in). Group delay (ntaps - 1) / 2. */
+void cic_comp_run(cic_comp_t *cc, const q15_t *in, size_t n, q15_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_CIC_H */
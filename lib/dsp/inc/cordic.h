@@ -0,0 +1,90 @@
+#ifndef LIB_DSP_CORDIC_H
+#define LIB_DSP_CORDIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fixed-point CORDIC for the receiver loops (Plan 002 sub-track B0): phase
+ * detection, magnitude for AGC/EVM, and complex rotation for carrier
+ * correction, all in shift-and-add integer arithmetic so no float trig runs
+ * in the sample path. See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Two modes share one iteration kernel:
+ *
+ *   vectoring  (i, q)       -> |(i, q)|, atan2(q, i)   drive q to zero
+ *   rotation   (i, q), phi  -> (i, q) * e^{j phi}      drive the angle to zero
+ *
+ * Angle format
+ * ------------
+ * Angles are q15 "binary radians": the full q15 range [-1.0, +1.0) maps to
+ * [-pi, +pi), so one LSB is pi/32768 (~96 urad) and angles wrap for free in
+ * 16-bit two's complement (Q15_MIN is both -pi and +pi). This is exactly the
+ * top 16 bits of an nco_t phase word, so CORDIC_ANGLE_FROM_PHASE() bridges the
+ * two without a multiply.
+ *
+ * Precision
+ * ---------
+ * Internally the vector carries 14 guard bits below q15 and the angle
+ * accumulator uses the NCO's 32-bit turn (2^32 == 2*pi). After n iterations
+ * the residual angle is bounded by atan(2^-(n-1)) ~ 2^-(n-1) rad, so
+ * CORDIC_ITER_Q15 (16) iterations reach q15 resolution for angles and
+ * magnitudes; fewer iterations trade accuracy (about 6 dB per iteration) for
+ * cycles. The CORDIC gain (~1.6468) is compensated with one multiply by a
+ * per-iteration-count constant, so outputs are true magnitudes.
+ *
+ * Magnitudes and rotated vectors can exceed full scale (|(1, 1)| = sqrt(2));
+ * such outputs saturate rather than wrap, like the rest of fixed.h.
+ *
+ * Pure integer, no peripheral access; compiles on host and target.
+ */
+
+/* Iteration count that reaches q15 output resolution. */
+#define CORDIC_ITER_Q15  16u
+
+/* Upper bound on iterations; beyond this the guard bits are exhausted. */
+#define CORDIC_MAX_ITER  20u
+
+/* q15 angle <-> 32-bit NCO phase word (both wrap at one full turn). */
+#define CORDIC_ANGLE_FROM_PHASE(p)  ((q15_t)((uint32_t)(p) >> 16))
+#define CORDIC_ANGLE_TO_PHASE(a)    ((uint32_t)(uint16_t)(a) << 16)
+
+/*
+ * Vectoring mode: magnitude and angle of (i, q) in one pass. Either output
+ * pointer may be NULL. atan2(0, 0) is reported as angle 0, magnitude 0.
+ * iters is clamped to [1, CORDIC_MAX_ITER].
+ */
+void cordic_vector(q15_t i, q15_t q, unsigned iters, q15_t *mag, q15_t *angle);
+
+/* atan2(q, i) as a q15 angle (convenience wrapper over cordic_vector). */
+q15_t cordic_atan2(q15_t q, q15_t i, unsigned iters);
+
+/* sqrt(i^2 + q^2), saturated to Q15_MAX. */
+q15_t cordic_mag(q15_t i, q15_t q, unsigned iters);
+
+/*
+ * Rotation mode: rotate (*i, *q) by angle in place, i.e. multiply the complex
+ * sample by e^{j angle}. Gain-compensated; results saturate.
+ */
+void cordic_rotate(q15_t *i, q15_t *q, q15_t angle, unsigned iters);
+
+/* sin and cos of a q15 angle (rotation of (1, 0)); either pointer may be NULL. */
+void cordic_sincos(q15_t angle, unsigned iters, q15_t *sin_out, q15_t *cos_out);
+
+/*
+ * Block rotation of n I/Q pairs by a fixed angle, in place: the carrier
+ * de-rotation primitive. i and q must not be NULL.
+ */
+void cordic_rotate_block(q15_t *i, q15_t *q, size_t n, q15_t angle,
+                         unsigned iters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_CORDIC_H */
@@ -0,0 +1,57 @@
+#ifndef LIB_DSP_DOT_H
+#define LIB_DSP_DOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * q15 dot-product kernel shared by every FIR-shaped loop in the modem (RRC
+ * shaping / matched filter, LMS equaliser). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * On a core with the DSP extension (Cortex-M4: __ARM_FEATURE_DSP) the inner
+ * loop uses SMLALD, which multiplies two packed q15 pairs and adds both
+ * products into a 64-bit accumulator in one instruction, four samples per
+ * iteration. Elsewhere (host tests) it is the plain C loop; both return the
+ * exact same sum.
+ *
+ * Both vectors must be contiguous. Filters keep a mirrored delay line (each
+ * sample written at pos and pos + ntaps) so the newest-first window is always
+ * one contiguous run; the pointers need only 16-bit alignment (the M4 allows
+ * unaligned word loads).
+ */
+
+/*
+ * Sum of a[k] * b[k] for k < n as an exact 64-bit integer (q30 scale for q15
+ * inputs). Returns 0 for n == 0.
+ */
+int64_t dot_q15(const q15_t *a, const q15_t *b, size_t n);
+
+/*
+ * Round a q30-scale accumulator back to q15 (+1<<14, >>15) with saturation;
+ * a clamp counts towards q15_sat_count() in a -DQ15_SAT_STATS build.
+ */
+static inline q15_t dot_round_q15(int64_t acc)
+{
+    int64_t y = (acc + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
+    if (y > (int64_t)Q15_MAX) {
+        Q15_SAT_HIT();
+        return Q15_MAX;
+    }
+    if (y < (int64_t)Q15_MIN) {
+        Q15_SAT_HIT();
+        return Q15_MIN;
+    }
+    return (q15_t)y;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_DOT_H */
@@ -0,0 +1,112 @@
+#ifndef LIB_DSP_FASTCONV_H
+#define LIB_DSP_FASTCONV_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Long real q15 FIR filters by FFT overlap-save, with a direct-form fallback,
+ * for the software modem (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * A direct FIR costs one MAC per tap per sample. Overlap-save filters a frame
+ * of N samples with one forward FFT, N complex multiplies by the filter's
+ * precomputed spectrum H, and one inverse FFT; the first M - 1 outputs are
+ * circular wrap-around and are discarded, so each frame yields L = N - M + 1
+ * new samples at a cost that grows with log N rather than with M. Two more
+ * tricks halve it again for real signals:
+ *
+ *   - Two frames per transform. The filter is real, so filtering a + i*b
+ *     gives (a * h) + i*(b * h): consecutive frames go in the real and
+ *     imaginary rails of one complex FFT and come back separated.
+ *   - Frame size per filter. fastconv_init() picks the N in [2M, FFT_MAX_N]
+ *     minimising N*log2(N) / (N - M + 1), the per-sample transform work.
+ *
+ * Below FASTCONV_CROSSOVER_TAPS the FFT's fixed cost loses to the MAC loop, so
+ * FASTCONV_AUTO runs the direct form there (the same dot_q15() kernel and
+ * mirrored delay line as rrc.c, bit-identical to it). `modem bench` times
+ * both paths across tap counts and prints the measured crossover.
+ *
+ * The stream is sample-aligned either way: fastconv_run() returns exactly
+ * the n outputs for its n inputs with no added latency (a short call just
+ * transforms a mostly-zero frame), so the two modes are interchangeable.
+ * Output scaling matches the direct form: y = round(sum h[k] x[n-k] >> 15),
+ * saturated.
+ *
+ * Accuracy: the FFT path carries three roundings (forward FFT, spectrum
+ * product, inverse FFT), each block-floating-point scaled to its own peak,
+ * so its error tracks the signal: ~57 dB below it at full scale (~14 LSB rms
+ * for the 129-tap RRC at 0.3 FS) and under half an LSB on quiet input. Use
+ * FASTCONV_DIRECT where bit-exactness matters (tests/lib/dsp/test_fastconv.c
+ * holds both bounds).
+ */
+
+/* Longest filter accepted (either path). */
+#define FASTCONV_MAX_TAPS  256u
+
+/*
+ * Tap count from which FASTCONV_AUTO uses overlap-save. Default from a
+ * Cortex-M4 cycle model (~1.75 cycles/tap direct vs the 256/512-point FFT
+ * cost); `modem bench` measures the real figure — override with -D.
+ */
+#ifndef FASTCONV_CROSSOVER_TAPS
+#define FASTCONV_CROSSOVER_TAPS  64u
+#endif
+
+typedef enum {
+    FASTCONV_AUTO = 0,   /* direct below the crossover, FFT at or above it */
+    FASTCONV_DIRECT,
+    FASTCONV_FFT,
+} fastconv_mode_t;
+
+typedef struct {
+    q15_t    taps[FASTCONV_MAX_TAPS];
+    q15_t    z[2u * FASTCONV_MAX_TAPS];  /* direct: mirrored delay line       */
+    q15_t    hist[FASTCONV_MAX_TAPS];    /* FFT: last M - 1 inputs, oldest first */
+    q15_t    h_spec[2u * FFT_MAX_N];     /* FFT: H = FFT(h), true = h_spec * 2^h_exp */
+    q15_t    work[2u * FFT_MAX_N];       /* FFT: frame, transformed in place  */
+    int32_t  h_peak;                     /* largest |component| of h_spec     */
+    int8_t   h_exp;
+    uint8_t  use_fft;                    /* resolved mode                     */
+    uint16_t ntaps;                      /* M                                 */
+    uint16_t nfft;                       /* N (FFT path)                      */
+    uint16_t hop;                        /* L = N - M + 1 (FFT path)          */
+    uint16_t pos;                        /* direct: newest sample index in z  */
+} fastconv_t;
+
+/*
+ * Load M = ntaps real q15 taps (1..FASTCONV_MAX_TAPS) and resolve the mode;
+ * for the FFT path this picks N and transforms the taps once. The history is
+ * zeroed. Returns M, or 0 if a parameter is invalid (fc untouched).
+ */
+uint16_t fastconv_init(fastconv_t *fc, const q15_t *taps, uint16_t ntaps,
+                       fastconv_mode_t mode);
+
+/* Zero the history (taps and mode kept). */
+void fastconv_reset(fastconv_t *fc);
+
+/*
+ * Filter n samples from in to out (out may equal in). Any n; state carries
+ * across calls, so a stream may be split anywhere — bit-identically in direct
+ * form, sample-aligned and within the accuracy bound on the FFT path (frame
+ * boundaries move, so the roundings do too).
+ */
+void fastconv_run(fastconv_t *fc, const q15_t *in, q15_t *out, size_t n);
+
+/* 1 if fc runs overlap-save, 0 if direct form. */
+static inline uint8_t fastconv_is_fft(const fastconv_t *fc)
+{
+    return fc->use_fft;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_FASTCONV_H */
@@ -0,0 +1,68 @@
+#ifndef LIB_DSP_FFT_H
+#define LIB_DSP_FFT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * In-place fixed-point complex FFT for the software modem (Plan 002 sub-track
+ * B0). See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Data is interleaved q15 complex, x[2k] = re, x[2k + 1] = im, N points in
+ * 2N q15 values, transformed in place; the output is in natural bin order.
+ *
+ * Algorithm: decimation-in-frequency radix-2^2 — each stage is a radix-4
+ * butterfly that writes its outputs in radix-2 order, so a single bit-reverse
+ * pass (table-driven) at the end puts every size in natural order. When log2 N
+ * is odd, a final twiddle-free radix-2 stage closes the transform. Twiddles
+ * and the bit-reverse table live in flash (fft_tables.c, generated by
+ * lib/dsp/tables/gen_fft_tables.py) for FFT_MAX_N and are strided for smaller
+ * sizes.
+ *
+ * Block floating point: an N-point transform can grow a value N-fold, far
+ * beyond q15. Before each stage the peak component of the whole block (the
+ * previous stage tracks it for free) picks the smallest right shift that
+ * keeps the stage from overflowing — 0..3 bits for radix-4, 0..2 for radix-2
+ * — so quiet inputs keep their precision and loud ones never wrap. The shifts
+ * add up to a block exponent: the true transform is out * 2^exp.
+ *
+ * Forward: X[k] = sum_n x[n] * e^(-2*pi*i*n*k/N) (unnormalised). Inverse:
+ * x[n] = (1/N) * sum_k X[k] * e^(+2*pi*i*n*k/N), computed as the conjugate of
+ * the forward transform of the conjugate; its exponent includes the -log2 N.
+ */
+
+#define FFT_MAX_LOG2  10u
+#define FFT_MAX_N     (1u << FFT_MAX_LOG2)
+#define FFT_MIN_N     4u
+
+/* Flash tables (fft_tables.c): one period of sin, FFT_MAX_LOG2-bit reverse. */
+extern const q15_t    fft_sin_table[FFT_MAX_N];
+extern const uint16_t fft_bitrev_table[FFT_MAX_N];
+
+/*
+ * Forward FFT of n complex points in place (n a power of two in
+ * [FFT_MIN_N, FFT_MAX_N]). *exp receives the block exponent (true X = x *
+ * 2^exp). Returns 1, or 0 if n is unsupported or a pointer is NULL (x is
+ * then untouched).
+ */
+uint8_t fft_q15(q15_t *x, size_t n, int8_t *exp);
+
+/*
+ * Inverse FFT of n complex points in place, 1/N included: the true time
+ * sequence is x * 2^exp, where exp may be negative. Returns as fft_q15().
+ */
+uint8_t fft_q15_inverse(q15_t *x, size_t n, int8_t *exp);
+
+/* log2 n if n is a supported size, else 0. */
+uint8_t fft_log2(size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_FFT_H */
@@ -23,6 +23,15 @@ extern "C" {
  * This header is pure integer arithmetic (plus optional float<->q15 helpers
  * that the host tests and golden-vector generators use); it pulls in no libm
  * and no peripheral, so it compiles unchanged on host and target.
+ *
+ * Saturation telemetry: a clamp is silent, so a config that drives the sample
+ * path into the rails loses SNR without saying so. Built with -DQ15_SAT_STATS
+ * (make SAT_STATS=1), every clamp in q15_sat() and dot_round_q15() - and so in
+ * q15_add(), q15_mul(), rrc_push() and channel_awgn_apply() - bumps one global
+ * counter (defined in src/fixed.c). Callers read q15_sat_count() around a
+ * stage and report the difference. Without the flag Q15_SAT_HIT() is empty
+ * and q15_sat_count() is the constant 0, so the helpers compile to exactly
+ * what they were and the report code folds away.
  */
 
 typedef int16_t q15_t;
@@ -33,13 +42,33 @@ typedef int32_t q31_t;
 #define Q15_MAX   ((q15_t)0x7FFF)   /* alias of Q15_ONE for clarity       */
 #define Q15_SHIFT 15
 
+#ifdef Q15_SAT_STATS
+extern uint32_t q15_sat_events;
+#define Q15_SAT_HIT() ((void)q15_sat_events++)
+
+/* Clamps since start-up (wraps); compare two readings. */
+static inline uint32_t q15_sat_count(void)
+{
+    return q15_sat_events;
+}
+#else
+#define Q15_SAT_HIT() ((void)0)
+
+static inline uint32_t q15_sat_count(void)
+{
+    return 0u;
+}
+#endif
+
 /* Saturate a 32-bit intermediate down to the q15 range (no wraparound). */
 static inline q15_t q15_sat(q31_t x)
 {
     if (x > (q31_t)Q15_MAX) {
+        Q15_SAT_HIT();
         return Q15_MAX;
     }
     if (x < (q31_t)Q15_MIN) {
+        Q15_SAT_HIT();
         return Q15_MIN;
     }
     return (q15_t)x;
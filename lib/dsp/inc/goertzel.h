@@ -0,0 +1,84 @@
+#ifndef LIB_DSP_GOERTZEL_H
+#define LIB_DSP_GOERTZEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Goertzel tone-detector bank for the software modem (Plan 002 sub-track B0).
+ * See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * When only a handful of frequencies matter — the M tones of an FSK symbol,
+ * a pilot, a DTMF digit — an FFT computes N bins to use M. The Goertzel
+ * recursion evaluates one DFT bin as a second-order IIR resonator:
+ *
+ *     s[n] = x[n] + 2*cos(w) * s[n-1] - s[n-2]
+ *
+ * one multiply per sample per tone, and after the block
+ *
+ *     |X(w)|^2 = s1^2 + s2^2 - 2*cos(w) * s1 * s2     (s1 = s[N-1], s2 = s[N-2])
+ *
+ * which is the DFT bin energy with the phase discarded — exactly what a
+ * non-coherent detector wants. M tones cost M*N MACs per block against
+ * ~N*log2(N) complex butterflies plus a bit-reverse for the FFT, so for
+ * M < log2 N the bank wins outright; w need not be a bin centre either.
+ *
+ * Fixed point: the coefficient 2*cos(w) is q14 (range +/-2). The resonator
+ * gains ~N / (2 sin w) on tone and at worst (w -> 0, pi) N*(N+1)/2, so the
+ * states are int32 and the coefficient product is 64-bit (one SMULL on the
+ * M4); blocks up to GOERTZEL_MAX_N full-scale samples cannot overflow.
+ * Energies are int64 in q15^2 units: a full-scale on-bin tone over N samples
+ * gives (N * 32767 / 2)^2.
+ *
+ * libm (cosf) is used only at init, same as the RRC tap design.
+ */
+
+#define GOERTZEL_MAX_TONES  16u
+#define GOERTZEL_MAX_N      256u    /* N*(N+1)/2 * 2^15 < 2^31 */
+
+typedef struct {
+    int32_t  s1[GOERTZEL_MAX_TONES];
+    int32_t  s2[GOERTZEL_MAX_TONES];
+    int32_t  coeff[GOERTZEL_MAX_TONES];   /* 2*cos(w), q14 (+2.0 at DC) */
+    uint8_t  ntones;
+    uint16_t count;                       /* samples since reset */
+} goertzel_bank_t;
+
+/*
+ * Set up ntones (1..GOERTZEL_MAX_TONES) resonators at freqs[k] cycles/sample
+ * (0 <= f <= 0.5) and reset. Returns ntones, or 0 if invalid (g untouched).
+ */
+uint8_t goertzel_init(goertzel_bank_t *g, const float *freqs, uint8_t ntones);
+
+/*
+ * Same, at DFT bin centres: tone k at bins[k] / n cycles/sample. Integer bins
+ * over an n-sample block are mutually orthogonal, the FSK case.
+ */
+uint8_t goertzel_init_bins(goertzel_bank_t *g, const uint16_t *bins,
+                           uint8_t ntones, uint16_t n);
+
+/* Clear the resonator states for the next block. */
+void goertzel_reset(goertzel_bank_t *g);
+
+/*
+ * Feed n samples to every tone. Blocks may be fed in pieces; the total since
+ * the last reset should stay <= GOERTZEL_MAX_N.
+ */
+void goertzel_run(goertzel_bank_t *g, const q15_t *x, size_t n);
+
+/* |X|^2 of tone k over the samples since reset (q15^2 units, >= 0). */
+int64_t goertzel_power(const goertzel_bank_t *g, uint8_t k);
+
+/* Index of the strongest tone (lowest index on a tie); 0 if none set up. */
+uint8_t goertzel_argmax(const goertzel_bank_t *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_GOERTZEL_H */
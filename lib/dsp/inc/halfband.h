@@ -0,0 +1,103 @@
+#ifndef LIB_DSP_HALFBAND_H
+#define LIB_DSP_HALFBAND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Half-band 2x interpolator / decimator for the software modem's multirate
+ * chain (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Shaping at SPS = 4 and then raising the rate in cheap 2x steps costs far
+ * less than one RRC at the final rate: each step only has to reject the one
+ * image its zero-stuffing creates, and the band it must keep shrinks by half
+ * at every stage, so later stages get shorter, not longer.
+ *
+ * A half-band lowpass (cutoff Fs/4) of length 4K-1 has centre tap exactly
+ * 1/2 and every other tap exactly zero, which splits its two polyphase
+ * branches into:
+ *
+ *   - a pure delay (the centre tap): no multiplies at all;
+ *   - a symmetric 2K-tap FIR on the "side" taps.
+ *
+ * Interpolating, one input makes two outputs: the side FIR and a delayed copy
+ * of the input (bit-exact, since 2 * 1/2 = 1). Decimating, one output takes
+ * the side FIR over the even inputs plus half of one odd input. Either way
+ * it costs 2K MACs per input pair, not 4K-1 per output. The side FIR runs on
+ * the shared dot_q15() kernel (dot.h) over a mirrored delay line, the same as
+ * rrc.c.
+ *
+ * Design: Kaiser-windowed sinc for HALFBAND_ATTEN_DB of stopband rejection.
+ * The length is the shortest 4K-1 that meets the spec for a passband edge
+ * fpass (cycles per high-rate sample): the transition runs from fpass to
+ * 0.5 - fpass. The side taps are normalised to sum to exactly 1/2, so the
+ * DC gain is 1 and the Fs/2 gain is 0. The interpolator's taps are doubled
+ * to make up for the zero-stuffing, which gives it unity passband gain too.
+ *
+ * Taps are q15 and outputs are rounded and saturated. A full-scale
+ * worst-case input can overshoot by the side taps' small negative sum.
+ */
+
+#define HALFBAND_ATTEN_DB  70.0f
+#define HALFBAND_MAX_TAPS  63u                        /* 4K - 1, K <= 16 */
+#define HALFBAND_MAX_SIDE  ((HALFBAND_MAX_TAPS + 1u) / 2u)
+
+typedef enum {
+    HALFBAND_INTERP = 0,   /* 1 input -> 2 outputs */
+    HALFBAND_DECIM  = 1    /* 2 inputs -> 1 output */
+} halfband_role_t;
+
+typedef struct {
+    q15_t   taps[HALFBAND_MAX_SIDE];      /* the 2K nonzero off-centre taps   */
+    q15_t   z[2u * HALFBAND_MAX_SIDE];    /* mirrored delay line (side FIR)   */
+    q15_t   zc[HALFBAND_MAX_SIDE / 2u];   /* decimator: odd-phase ring (K)    */
+    uint8_t pos;
+    uint8_t cpos;
+    uint8_t nside;                        /* 2K                               */
+    uint8_t ntaps;                        /* 4K - 1                           */
+    uint8_t role;                         /* halfband_role_t                  */
+    uint8_t phase;                        /* decimator: 1 after an even input */
+} halfband_t;
+
+/*
+ * Design a half-band stage with passband edge fpass in (0, 0.25) cycles per
+ * high-rate sample (the output rate when interpolating, the input rate when
+ * decimating). The state is zeroed. Returns the prototype length 4K-1, or 0
+ * if a parameter is out of range or the spec needs more than
+ * HALFBAND_MAX_TAPS taps (hb is left untouched).
+ */
+uint8_t halfband_design(halfband_t *hb, float fpass, halfband_role_t role);
+
+/* Zero the delay lines and decimator phase (the taps are kept). */
+void halfband_reset(halfband_t *hb);
+
+/*
+ * Interpolate n inputs to 2n outputs. out must not overlap in. Returns 2n,
+ * or 0 if hb is not an interpolator.
+ */
+size_t halfband_interpolate(halfband_t *hb, const q15_t *in, size_t n, q15_t *out);
+
+/*
+ * Decimate n inputs, writing one output per even/odd input pair. The phase
+ * carries across calls, so n may be odd. out may equal in. Returns the number
+ * of outputs written, or 0 if hb is not a decimator.
+ */
+size_t halfband_decimate(halfband_t *hb, const q15_t *in, size_t n, q15_t *out);
+
+/* Group delay in high-rate samples: (ntaps - 1) / 2, i.e. 2K - 1. */
+static inline size_t halfband_delay(const halfband_t *hb)
+{
+    return (size_t)hb->nside - 1u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_HALFBAND_H */
@@ -0,0 +1,130 @@
+#ifndef LIB_DSP_NCO_H
+#define LIB_DSP_NCO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Numerically controlled oscillator (NCO) and digital up/down-converter for
+ * passband operation of the software modem (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * The planned PWM-DAC link needs a real carrier, so the shaped baseband is
+ * mixed up to an intermediate frequency (IF) on TX and back down on RX:
+ *
+ *   TX:  bb[n] ──▶ x ──▶ if[n] = bb[n] * cos(w n)
+ *                  ▲
+ *                 NCO
+ *   RX:  if[n] ──▶ x ──▶ i[n] =  if[n] * cos(w n)   ──▶ RRC matched filter
+ *              └─▶ x ──▶ q[n] = -if[n] * sin(w n)
+ *
+ * Phase representation
+ * --------------------
+ * The oscillator is a 32-bit phase accumulator: one full turn (2*pi) is 2^32,
+ * so the phase wraps for free in unsigned arithmetic and the frequency
+ * resolution is fs / 2^32 (~0.02 mHz at 100 kHz). Each output sample reads
+ *
+ *   bits 31..30  quadrant
+ *   bits 29..22  index into a quarter-wave table (NCO_QTABLE_SIZE entries)
+ *   bits 21..7   15-bit fraction for linear interpolation
+ *
+ * Only sin(0..pi/2) is stored (257 q15 entries, 514 B of flash, generated by
+ * lib/dsp/tables/gen_sin_table.py); the other quadrants are mirror images.
+ * Linear interpolation buys ~+30 dB of spur-free dynamic range over phase
+ * truncation at the cost of one multiply per lookup, leaving the q15 output
+ * quantisation as the dominant spur source (tests/lib/dsp/test_nco.c measures
+ * SFDR > 80 dBc).
+ *
+ * Mixer scaling
+ * -------------
+ * Up-conversion multiplies by cos alone, so a real baseband signal lands at
+ * +/-IF with half its power in each sideband (amplitude unchanged, passband
+ * energy per bit halved). Down-conversion also uses unity gain: the recovered
+ * baseband sits at half scale (the other half went to the 2*IF image, which the
+ * RRC matched filter rejects). The textbook x2 gain is deliberately omitted —
+ * bb + image can reach 2x the input before the low-pass filter and would
+ * saturate q15. Sign-based slicing is scale-invariant, and a later AGC stage
+ * restores level where it matters.
+ *
+ * Pure integer sample path plus one float helper (frequency -> step, used at
+ * configuration time); no peripheral access, compiles on host and target.
+ */
+
+/* Quarter-wave table geometry: 2^8 entries per quadrant (1024 per turn). */
+#define NCO_QTABLE_BITS  8u
+#define NCO_QTABLE_SIZE  (1u << NCO_QTABLE_BITS)
+
+/* Quarter-wave q15 sine table, NCO_QTABLE_SIZE + 1 entries (in flash). */
+extern const q15_t nco_sin_qtable[NCO_QTABLE_SIZE + 1u];
+
+/* Phase-accumulator value of a quarter turn (pi/2). */
+#define NCO_PHASE_QUARTER  0x40000000u
+
+typedef struct {
+    uint32_t phase;   /* current phase, 2^32 == one turn                 */
+    uint32_t step;    /* phase increment per sample (frequency word)      */
+} nco_t;
+
+/*
+ * Convert a normalised frequency (cycles per sample, i.e. f / fs) into a
+ * 32-bit phase step. Accepts [-0.5, +0.5); negative frequencies wrap to the
+ * equivalent two's-complement step (a negative rotation).
+ */
+uint32_t nco_freq_to_step(float freq_norm);
+
+/* Initialise an NCO at freq_norm (f / fs) with starting phase phase0. */
+void nco_init(nco_t *nco, float freq_norm, uint32_t phase0);
+
+/* Retune without disturbing the phase (phase-continuous frequency change). */
+void nco_set_freq(nco_t *nco, float freq_norm);
+
+/* Interpolated q15 sin / cos of an absolute phase (2^32 == 2*pi). */
+q15_t nco_sin(uint32_t phase);
+q15_t nco_cos(uint32_t phase);
+
+/*
+ * Emit the current sin/cos pair, then advance the phase by one step.
+ * Either output pointer may be NULL when only one component is needed.
+ */
+void nco_next(nco_t *nco, q15_t *sin_out, q15_t *cos_out);
+
+/* Fill n samples of cos(w n) (a real tone) into out, advancing the NCO. */
+void nco_generate(nco_t *nco, q15_t *out, size_t n);
+
+/*
+ * Up-convert n real baseband samples to the NCO frequency:
+ * out[k] = bb[k] * cos(phase_k). out may equal bb.
+ */
+void nco_mix_up(nco_t *nco, const q15_t *bb, q15_t *out, size_t n);
+
+/*
+ * Down-convert n real passband samples into I/Q baseband:
+ * i_out[k] = in[k] * cos(phase_k), q_out[k] = -in[k] * sin(phase_k).
+ * i_out may equal in; q_out may be NULL for a real (I-only) receiver.
+ */
+void nco_mix_down(nco_t *nco, const q15_t *in, q15_t *i_out, q15_t *q_out,
+                  size_t n);
+
+/*
+ * Rotate one complex sample in place by an absolute phase:
+ * (i + jq) * e^{j phase}. Pass the negated phase to de-rotate.
+ */
+void nco_rotate_iq(uint32_t phase, q15_t *i, q15_t *q);
+
+/*
+ * Complex mixer: multiply n I/Q samples in place by e^{j w k}, advancing the
+ * NCO. A positive frequency shifts the spectrum up, a negative one down; unlike
+ * the real mixers above there is no image and no gain loss.
+ */
+void nco_mix_complex(nco_t *nco, q15_t *i, q15_t *q, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_NCO_H */
@@ -0,0 +1,91 @@
+#ifndef LIB_DSP_PSD_H
+#define LIB_DSP_PSD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Welch power-spectral-density accumulator for the software modem (Plan 002
+ * sub-track B0). See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Samples stream in (complex I/Q, or real with q == NULL) in chunks of any
+ * size. Every nfft samples form a segment; segments overlap by half (hop =
+ * nfft/2), are Hann-windowed and transformed with fft_q15(), and |X[k]|^2 —
+ * rescaled by the block exponent — is summed per bin in float. Averaging K
+ * segments cuts the variance of each bin estimate ~K-fold; the window keeps
+ * one strong bin's sidelobes (-31 dB first, falling 18 dB/octave) from
+ * burying the adjacent channel.
+ *
+ * Scaling: psd_bin() is the share of mean signal power in bin k, in units of
+ * full scale squared (a full-scale complex tone totals 1.0, a full-scale real
+ * one 0.5), so summing a band gives the power in that band directly:
+ *
+ *     P[k] = sum_seg |X_seg[k]|^2 / (segments * nfft * sum w[n]^2)
+ *
+ * which by Parseval sums over all k to the mean |x|^2 of the windowed data.
+ *
+ * Bins are in FFT order: k = 0 is DC, k < nfft/2 positive frequencies (k/nfft
+ * cycles per sample), k >= nfft/2 negative. Band helpers take signed bin
+ * indices and wrap.
+ *
+ * The window is built from the FFT's flash sine table (no libm); the
+ * accumulator is about 14 KB at PSD_MAX_N, meant to be a static, not a stack
+ * local.
+ */
+
+#define PSD_MAX_N  FFT_MAX_N
+
+typedef struct {
+    q15_t    win[PSD_MAX_N];        /* Hann window, q15                      */
+    q15_t    hist[2u * PSD_MAX_N];  /* pending samples, interleaved I/Q      */
+    q15_t    work[2u * PSD_MAX_N];  /* windowed segment, transformed in place*/
+    float    acc[PSD_MAX_N];        /* sum |X[k]|^2 (q15 units squared)      */
+    float    win_pow;               /* sum w[n]^2, w as a fraction of 1      */
+    uint32_t segments;              /* segments accumulated                  */
+    uint16_t nfft;
+    uint16_t hop;                   /* nfft / 2                              */
+    uint16_t fill;                  /* samples held in hist                  */
+} psd_t;
+
+/*
+ * Set up for nfft-point segments (a power of two in [FFT_MIN_N, PSD_MAX_N])
+ * and clear the accumulators. Returns nfft, or 0 if it is unsupported.
+ */
+uint16_t psd_init(psd_t *psd, uint16_t nfft);
+
+/* Drop accumulated segments and pending samples; keep nfft and the window. */
+void psd_reset(psd_t *psd);
+
+/*
+ * Feed n samples. q may be NULL for a real signal (Q = 0). Each completed
+ * segment is transformed and accumulated immediately.
+ */
+void psd_push(psd_t *psd, const q15_t *i, const q15_t *q, size_t n);
+
+/* Power in bin k (0..nfft-1), fraction of FS^2. 0 before the first segment. */
+float psd_bin(const psd_t *psd, uint16_t k);
+
+/* Power in bins k_lo..k_hi inclusive, signed (-nfft/2..nfft/2-1), wrapping. */
+float psd_band(const psd_t *psd, int32_t k_lo, int32_t k_hi);
+
+/* Total power, all bins. */
+float psd_total(const psd_t *psd);
+
+/*
+ * Occupied bandwidth about DC: the smallest h such that bins -h..h hold at
+ * least `fraction` of the total (0.99 for the usual 99% OBW). The band is
+ * (2h + 1) / nfft cycles per sample wide. 0 if nothing is accumulated.
+ */
+uint16_t psd_occupied_bins(const psd_t *psd, float fraction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_DSP_PSD_H */
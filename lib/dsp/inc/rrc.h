@@ -43,7 +43,10 @@ extern "C" {
  *     saturation in practice).
  *   - The FIR accumulator is 64-bit: a worst-case dot product over up to ~129
  *     taps can reach ~2^34, which overflows q31. Each output is rounded
- *     (+1<<14 before >>15) and saturated back to q15.
+ *     (+1<<14 before >>15) and saturated back to q15; a SAT_STATS=1 build
+ *     counts the clamps (fixed.h).
+ *   - The MACs run in the shared dot_q15() kernel (dot.h, SMLALD on target)
+ *     over a mirrored delay line, so the window is always contiguous.
  *
  * Pure C plus libm (sinf/cosf/sqrtf for tap design, same as lib/channel); no
  * peripheral access, so it compiles unchanged on host and target.
@@ -65,7 +68,8 @@ extern "C" {
  */
 typedef struct {
     q15_t    taps[RRC_MAX_TAPS];
-    q15_t    z[RRC_MAX_TAPS];   /* circular delay line; z[pos] is newest      */
+    q15_t    z[2u * RRC_MAX_TAPS]; /* mirrored delay line: z[pos] is newest,
+                                    z[pos + ntaps] its copy                   */
     uint16_t pos;
     uint8_t  ntaps;            /* sps*span + 1                                */
     uint8_t  sps;             /* samples per symbol (upsampling factor)       */
@@ -0,0 +1,238 @@
+#include "cic.h"
+#include "dot.h"
+#include <math.h>
+
+#define CIC_PI          3.14159265358979323846
+#define CIC_COMP_SHIFT  14       /* q14 compensator taps */
+#define CIC_COMP_GRID   128u     /* least-squares points per band */
+#define CIC_COMP_STOP_W 0.1      /* stopband weight against the passband's 1 */
+
+static uint8_t cic_log2(uint8_t r)
+{
+    uint8_t b = 0u;
+    while ((1u << b) < r) {
+        b++;
+    }
+    return ((1u << b) == r) ? b : 0u;
+}
+
+uint8_t cic_init(cic_t *c, uint8_t stages, uint8_t rate, cic_role_t role)
+{
+    const uint8_t lr = cic_log2(rate);
+    if (c == NULL || stages == 0u || stages > CIC_MAX_STAGES || rate < 2u ||
+        rate > CIC_MAX_RATE || lr == 0u ||
+        (role != CIC_INTERP && role != CIC_DECIM)) {
+        return 0u;
+    }
+    const uint8_t shift = (uint8_t)(((role == CIC_INTERP) ? stages - 1u : stages) * lr);
+    if (shift > CIC_MAX_GROWTH) {
+        return 0u;
+    }
+    c->stages = stages;
+    c->rate   = rate;
+    c->shift  = shift;
+    c->role   = (uint8_t)role;
+    cic_reset(c);
+    return rate;
+}
+
+void cic_reset(cic_t *c)
+{
+    if (c == NULL) {
+        return;
+    }
+    for (uint8_t k = 0; k < CIC_MAX_STAGES; k++) {
+        c->integ[k] = 0u;
+        c->comb[k]  = 0u;
+    }
+    c->phase = 0u;
+}
+
+/*
+ * Undo the DC gain: the register holds the true output times 2^shift (mod
+ * 2^32, but the true value fits), so round, shift back and saturate the
+ * half-LSB that rounding can add at full scale.
+ */
+static inline q15_t cic_out(uint32_t v, uint8_t shift)
+{
+    int32_t y = (shift > 0u)
+        ? (int32_t)(v + (1u << (shift - 1u))) >> shift
+        : (int32_t)v;
+    return q15_sat(y);
+}
+
+size_t cic_interpolate(cic_t *c, const q15_t *in, size_t n, q15_t *out)
+{
+    if (c == NULL || in == NULL || out == NULL || c->role != CIC_INTERP) {
+        return 0u;
+    }
+    const uint8_t ns = c->stages;
+    size_t o = 0;
+    for (size_t i = 0; i < n; i++) {
+        /* Combs at the low rate. */
+        uint32_t v = (uint32_t)(int32_t)in[i];
+        for (uint8_t k = 0; k < ns; k++) {
+            uint32_t prev = c->comb[k];
+            c->comb[k] = v;
+            v -= prev;
+        }
+        /* Zero-stuff by R and integrate at the high rate. */
+        for (uint8_t p = 0; p < c->rate; p++) {
+            uint32_t u = v;
+            for (uint8_t k = 0; k < ns; k++) {
+                c->integ[k] += u;
+                u = c->integ[k];
+            }
+            out[o++] = cic_out(u, c->shift);
+            v = 0u;
+        }
+    }
+    return o;
+}
+
+size_t cic_decimate(cic_t *c, const q15_t *in, size_t n, q15_t *out)
+{
+    if (c == NULL || in == NULL || out == NULL || c->role != CIC_DECIM) {
+        return 0u;
+    }
+    const uint8_t ns = c->stages;
+    size_t o = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t u = (uint32_t)(int32_t)in[i];
+        for (uint8_t k = 0; k < ns; k++) {
+            c->integ[k] += u;
+            u = c->integ[k];
+        }
+        if (++c->phase < c->rate) {
+            continue;
+        }
+        c->phase = 0u;
+        for (uint8_t k = 0; k < ns; k++) {
+            uint32_t prev = c->comb[k];
+            c->comb[k] = u;
+            u -= prev;
+        }
+        out[o++] = cic_out(u, c->shift);
+    }
+    return o;
+}
+
+float cic_gain(uint8_t stages, uint8_t rate, float f)
+{
+    const double x = CIC_PI * (double)f;
+    if (rate == 0u || fabs(x) < 1e-12) {
+        return 1.0f;
+    }
+    const double den = (double)rate * sin(x / (double)rate);
+    if (fabs(den) < 1e-12) {
+        return 1.0f;
+    }
+    return (float)pow(fabs(sin(x) / den), (double)stages);
+}
+
+/*
+ * Least-squares linear-phase fit. With ntaps = 2M + 1 the response is
+ * A(f) = a0 + 2 sum_{k=1}^{M} a_k cos(2 pi f k); minimise the squared error
+ * against 1 / cic_gain(f) on [0, fpass] and, at weight CIC_COMP_STOP_W,
+ * against 0 on [0.5 - fpass, 0.5], solving the (M + 1)-square normal
+ * equations by Gaussian elimination.
+ */
+uint8_t cic_comp_design(cic_comp_t *cc, uint8_t stages, uint8_t rate,
+                        uint8_t ntaps, float fpass)
+{
+    if (cc == NULL || stages == 0u || stages > CIC_MAX_STAGES || rate < 2u ||
+        ntaps < 3u || ntaps > CIC_COMP_MAX_TAPS || (ntaps & 1u) == 0u ||
+        !(fpass > 0.0f && fpass < 0.25f)) {
+        return 0u;
+    }
+    const uint8_t m = (uint8_t)(ntaps / 2u);
+    double ata[CIC_COMP_MAX_TAPS / 2u + 1u][CIC_COMP_MAX_TAPS / 2u + 2u];
+    for (uint8_t r = 0; r <= m; r++) {
+        for (uint8_t s = 0; s <= m + 1u; s++) {
+            ata[r][s] = 0.0;
+        }
+    }
+    for (uint8_t band = 0; band < 2u; band++) {
+        const double f0 = (band == 0u) ? 0.0 : 0.5 - (double)fpass;
+        for (uint16_t g = 0; g < CIC_COMP_GRID; g++) {
+            double f = f0 + (double)fpass * (double)g / (double)(CIC_COMP_GRID - 1u);
+            double d = (band == 0u) ? 1.0 / (double)cic_gain(stages, rate, (float)f) : 0.0;
+            double w = (band == 0u) ? 1.0 : CIC_COMP_STOP_W;
+            double basis[CIC_COMP_MAX_TAPS / 2u + 1u];
+            basis[0] = 1.0;
+            for (uint8_t k = 1; k <= m; k++) {
+                basis[k] = 2.0 * cos(2.0 * CIC_PI * f * (double)k);
+            }
+            for (uint8_t r = 0; r <= m; r++) {
+                for (uint8_t s = 0; s <= m; s++) {
+                    ata[r][s] += w * basis[r] * basis[s];
+                }
+                ata[r][m + 1u] += w * basis[r] * d;
+            }
+        }
+    }
+    for (uint8_t col = 0; col <= m; col++) {
+        uint8_t piv = col;
+        for (uint8_t r = (uint8_t)(col + 1u); r <= m; r++) {
+            if (fabs(ata[r][col]) > fabs(ata[piv][col])) {
+                piv = r;
+            }
+        }
+        if (fabs(ata[piv][col]) < 1e-12) {
+            return 0u;
+        }
+        for (uint8_t s = 0; s <= m + 1u; s++) {
+            double t = ata[col][s];
+            ata[col][s] = ata[piv][s];
+            ata[piv][s] = t;
+        }
+        for (uint8_t r = 0; r <= m; r++) {
+            if (r == col) {
+                continue;
+            }
+            double q = ata[r][col] / ata[col][col];
+            for (uint8_t s = col; s <= m + 1u; s++) {
+                ata[r][s] -= q * ata[col][s];
+            }
+        }
+    }
+    for (uint8_t k = 0; k <= m; k++) {
+        double a = ata[k][m + 1u] / ata[k][k] * (double)(1 << CIC_COMP_SHIFT);
+        double r = (a >= 0.0) ? floor(a + 0.5) : ceil(a - 0.5);
+        q15_t t = (r > 32767.0) ? Q15_MAX : (r < -32768.0) ? Q15_MIN : (q15_t)r;
+        cc->taps[m + k] = t;
+        cc->taps[m - k] = t;
+    }
+    cc->ntaps = ntaps;
+    cic_comp_reset(cc);
+    return ntaps;
+}
+
+void cic_comp_reset(cic_comp_t *cc)
+{
+    if (cc == NULL) {
+        return;
+    }
+    for (uint16_t i = 0; i < 2u * cc->ntaps; i++) {
+        cc->z[i] = 0;
+    }
+    cc->pos = 0u;
+}
+
+void cic_comp_run(cic_comp_t *cc, const q15_t *in, size_t n, q15_t *out)
+{
+    if (cc == NULL || in == NULL || out == NULL) {
+        return;
+    }
+    const uint16_t nt = cc->ntaps;
+    for (size_t i = 0; i < n; i++) {
+        if (cc->pos == 0u) {
+            cc->pos = nt;
+        }
+        cc->pos--;
+        cc->z[cc->pos]      = in[i];
+        cc->z[cc->pos + nt] = in[i];
+        /* q14 taps: the q29 sum doubled is dot_round_q15()'s q30 input. */
+        out[i] = dot_round_q15(2 * dot_q15(cc->taps, &cc->z[cc->pos], nt));
+    }
+}
@@ -0,0 +1,183 @@
+#include "cordic.h"
+
+/*
+ * Working precision: q15 inputs are widened by CORDIC_GUARD bits so the
+ * x >> k shifts keep their low bits until the last iteration. Worst case the
+ * vector grows to |(-1, -1)| * 1.6468 ~ 2.33 in q15 units, i.e. ~1.25e9 at
+ * 14 guard bits, comfortably inside int32.
+ */
+#define CORDIC_GUARD  14
+
+/* Half a turn in 32-bit phase units (pi). */
+#define CORDIC_PHASE_HALF  0x80000000u
+
+/* atan(2^-k) in 32-bit phase units (2^32 == 2*pi). */
+static const uint32_t cordic_atan_tab[CORDIC_MAX_ITER] = {
+    0x20000000u, 0x12E4051Eu, 0x09FB385Bu, 0x051111D4u,
+    0x028B0D43u, 0x0145D7E1u, 0x00A2F61Eu, 0x00517C55u,
+    0x0028BE53u, 0x00145F2Fu, 0x000A2F98u, 0x000517CCu,
+    0x00028BE6u, 0x000145F3u, 0x0000A2FAu, 0x0000517Du,
+    0x000028BEu, 0x0000145Fu, 0x00000A30u, 0x00000518u,
+};
+
+/*
+ * Inverse CORDIC gain after n iterations, prod_{k<n} 1/sqrt(1 + 2^-2k), in
+ * Q31. Index 0 is unused (iters is clamped to >= 1).
+ */
+static const uint32_t cordic_kinv_tab[CORDIC_MAX_ITER + 1u] = {
+    0x7FFFFFFFu,
+    0x5A82799Au, 0x50F44D89u, 0x4E8986EAu, 0x4DEE4507u,
+    0x4DC76B06u, 0x4DBDB3EBu, 0x4DBB461Au, 0x4DBAAAA6u,
+    0x4DBA83C9u, 0x4DBA7A11u, 0x4DBA77A3u, 0x4DBA7708u,
+    0x4DBA76E1u, 0x4DBA76D7u, 0x4DBA76D5u, 0x4DBA76D4u,
+    0x4DBA76D4u, 0x4DBA76D4u, 0x4DBA76D4u, 0x4DBA76D4u,
+};
+
+static unsigned clamp_iters(unsigned iters)
+{
+    if (iters == 0u) {
+        return 1u;
+    }
+    return (iters > CORDIC_MAX_ITER) ? CORDIC_MAX_ITER : iters;
+}
+
+/* Undo the CORDIC gain and drop the guard bits, rounding and saturating. */
+static q15_t cordic_scale_out(int32_t v, unsigned iters)
+{
+    int64_t p = (int64_t)v * (int64_t)cordic_kinv_tab[iters];
+    int64_t r = (p + ((int64_t)1 << (31 + CORDIC_GUARD - 1))) >> (31 + CORDIC_GUARD);
+    if (r > Q15_MAX) {
+        return Q15_MAX;
+    }
+    if (r < Q15_MIN) {
+        return Q15_MIN;
+    }
+    return (q15_t)r;
+}
+
+void cordic_vector(q15_t i, q15_t q, unsigned iters, q15_t *mag, q15_t *angle)
+{
+    iters = clamp_iters(iters);
+
+    /* The origin has no angle; without this the loop would invent one. */
+    if (i == 0 && q == 0) {
+        if (mag != NULL) {
+            *mag = 0;
+        }
+        if (angle != NULL) {
+            *angle = 0;
+        }
+        return;
+    }
+
+    int32_t x = (int32_t)i << CORDIC_GUARD;
+    int32_t y = (int32_t)q << CORDIC_GUARD;
+    uint32_t z = 0u;
+
+    /* Fold the left half-plane onto the right: angle(v) = angle(-v) + pi. */
+    if (x < 0) {
+        x = -x;
+        y = -y;
+        z = CORDIC_PHASE_HALF;
+    }
+
+    for (unsigned k = 0; k < iters; k++) {
+        int32_t xs = x >> k;
+        int32_t ys = y >> k;
+        if (y < 0) {
+            x -= ys;
+            y += xs;
+            z -= cordic_atan_tab[k];
+        } else {
+            x += ys;
+            y -= xs;
+            z += cordic_atan_tab[k];
+        }
+    }
+
+    if (mag != NULL) {
+        *mag = cordic_scale_out(x, iters);
+    }
+    if (angle != NULL) {
+        /* Top 16 bits of the phase word, rounded; wraps like the phase does. */
+        *angle = (q15_t)((z + 0x8000u) >> 16);
+    }
+}
+
+q15_t cordic_atan2(q15_t q, q15_t i, unsigned iters)
+{
+    q15_t angle;
+    cordic_vector(i, q, iters, NULL, &angle);
+    return angle;
+}
+
+q15_t cordic_mag(q15_t i, q15_t q, unsigned iters)
+{
+    q15_t mag;
+    cordic_vector(i, q, iters, &mag, NULL);
+    return mag;
+}
+
+void cordic_rotate(q15_t *i, q15_t *q, q15_t angle, unsigned iters)
+{
+    if (i == NULL || q == NULL) {
+        return;
+    }
+    iters = clamp_iters(iters);
+
+    int32_t x = (int32_t)*i << CORDIC_GUARD;
+    int32_t y = (int32_t)*q << CORDIC_GUARD;
+    int32_t z = (int32_t)CORDIC_ANGLE_TO_PHASE(angle);
+
+    /*
+     * CORDIC converges for |z| <= ~99 deg. Outside +/-90 deg rotate by pi
+     * first (negate the vector) and take the remaining angle; adding half a
+     * turn to a 32-bit phase wraps correctly in either direction.
+     */
+    if (z > (int32_t)0x40000000 || z < -(int32_t)0x40000000) {
+        x = -x;
+        y = -y;
+        z = (int32_t)((uint32_t)z + CORDIC_PHASE_HALF);
+    }
+
+    for (unsigned k = 0; k < iters; k++) {
+        int32_t xs = x >> k;
+        int32_t ys = y >> k;
+        if (z >= 0) {
+            x -= ys;
+            y += xs;
+            z -= (int32_t)cordic_atan_tab[k];
+        } else {
+            x += ys;
+            y -= xs;
+            z += (int32_t)cordic_atan_tab[k];
+        }
+    }
+
+    *i = cordic_scale_out(x, iters);
+    *q = cordic_scale_out(y, iters);
+}
+
+void cordic_sincos(q15_t angle, unsigned iters, q15_t *sin_out, q15_t *cos_out)
+{
+    q15_t c = Q15_MAX;
+    q15_t s = 0;
+    cordic_rotate(&c, &s, angle, iters);
+    if (sin_out != NULL) {
+        *sin_out = s;
+    }
+    if (cos_out != NULL) {
+        *cos_out = c;
+    }
+}
+
+void cordic_rotate_block(q15_t *i, q15_t *q, size_t n, q15_t angle,
+                         unsigned iters)
+{
+    if (i == NULL || q == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        cordic_rotate(&i[k], &q[k], angle, iters);
+    }
+}
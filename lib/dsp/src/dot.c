@@ -0,0 +1,48 @@
+#include "dot.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+/*
+ * Two packed q15 values in one LDR. The type only promises 16-bit alignment
+ * (the M4 handles the unaligned word load) and may alias the q15 array.
+ */
+typedef uint32_t __attribute__((aligned(2), may_alias)) dot_pair_t;
+
+static inline uint32_t dot_load2(const q15_t *p)
+{
+    return *(const dot_pair_t *)p;
+}
+
+/* acc += lo(a) * lo(b) + hi(a) * hi(b), 64-bit. */
+static inline int64_t dot_smlald(uint32_t a, uint32_t b, int64_t acc)
+{
+    __asm__ ("smlald %Q0, %R0, %1, %2" : "+r"(acc) : "r"(a), "r"(b));
+    return acc;
+}
+
+int64_t dot_q15(const q15_t *a, const q15_t *b, size_t n)
+{
+    int64_t acc = 0;
+    size_t k = 0;
+    for (; k + 4u <= n; k += 4u) {
+        acc = dot_smlald(dot_load2(a + k), dot_load2(b + k), acc);
+        acc = dot_smlald(dot_load2(a + k + 2u), dot_load2(b + k + 2u), acc);
+    }
+    for (; k < n; k++) {
+        acc += (int32_t)a[k] * (int32_t)b[k];
+    }
+    return acc;
+}
+
+#else
+
+int64_t dot_q15(const q15_t *a, const q15_t *b, size_t n)
+{
+    int64_t acc = 0;
+    for (size_t k = 0; k < n; k++) {
+        acc += (int32_t)a[k] * (int32_t)b[k];
+    }
+    return acc;
+}
+
+#endif
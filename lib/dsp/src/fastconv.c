@@ -0,0 +1,188 @@
+#include "fastconv.h"
+#include "dot.h"
+#include <string.h>
+
+static int32_t fastconv_peak(const q15_t *x, size_t n)
+{
+    int32_t peak = 0;
+    for (size_t k = 0; k < n; k++) {
+        int32_t a = (x[k] < 0) ? -(int32_t)x[k] : x[k];
+        if (a > peak) {
+            peak = a;
+        }
+    }
+    return peak;
+}
+
+/* Frame size with the least transform work per output sample (N >= 2M). */
+static uint16_t fastconv_pick_n(uint16_t ntaps)
+{
+    uint16_t best = 0u;
+    uint32_t best_cost = UINT32_MAX;
+    for (uint8_t m = 2u; m <= FFT_MAX_LOG2; m++) {
+        uint32_t n = 1u << m;
+        if (n < 2u * (uint32_t)ntaps) {
+            continue;
+        }
+        /* N * log2 N / L, scaled by 256 to stay in integers. */
+        uint32_t cost = (n * m * 256u) / (n - ntaps + 1u);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best      = (uint16_t)n;
+        }
+    }
+    return best;
+}
+
+uint16_t fastconv_init(fastconv_t *fc, const q15_t *taps, uint16_t ntaps,
+                       fastconv_mode_t mode)
+{
+    if (fc == NULL || taps == NULL || ntaps == 0u || ntaps > FASTCONV_MAX_TAPS ||
+        mode > FASTCONV_FFT) {
+        return 0u;
+    }
+    memcpy(fc->taps, taps, ntaps * sizeof(q15_t));
+    fc->ntaps   = ntaps;
+    fc->use_fft = (mode == FASTCONV_FFT) ||
+                  (mode == FASTCONV_AUTO && ntaps >= FASTCONV_CROSSOVER_TAPS);
+
+    if (fc->use_fft) {
+        const uint16_t n = fastconv_pick_n(ntaps);
+        memset(fc->h_spec, 0, 2u * n * sizeof(q15_t));
+        for (uint16_t k = 0; k < ntaps; k++) {
+            fc->h_spec[2u * k] = taps[k];
+        }
+        fft_q15(fc->h_spec, n, &fc->h_exp);
+        fc->h_peak = fastconv_peak(fc->h_spec, 2u * n);
+        fc->nfft   = n;
+        fc->hop    = (uint16_t)(n - ntaps + 1u);
+    } else {
+        fc->nfft = 0u;
+        fc->hop  = 0u;
+    }
+    fastconv_reset(fc);
+    return ntaps;
+}
+
+void fastconv_reset(fastconv_t *fc)
+{
+    if (fc == NULL) {
+        return;
+    }
+    memset(fc->z, 0, 2u * fc->ntaps * sizeof(q15_t));
+    memset(fc->hist, 0, fc->ntaps * sizeof(q15_t));
+    fc->pos = 0u;
+}
+
+/* Direct form: same mirrored delay line and kernel as rrc_push(). */
+static q15_t fastconv_push(fastconv_t *fc, q15_t x)
+{
+    uint16_t nt = fc->ntaps;
+    if (fc->pos == 0u) {
+        fc->pos = nt;
+    }
+    fc->pos--;
+    fc->z[fc->pos]      = x;
+    fc->z[fc->pos + nt] = x;
+    return dot_round_q15(dot_q15(fc->taps, &fc->z[fc->pos], nt));
+}
+
+/* v * 2^e back to q15: rounding right shift, or saturating left shift. */
+static inline q15_t fastconv_scale(q15_t v, int8_t e)
+{
+    if (e >= 0) {
+        if (e > Q15_SHIFT) {
+            return (v > 0) ? Q15_MAX : (v < 0) ? Q15_MIN : 0;
+        }
+        return q15_sat((q31_t)v * ((q31_t)1 << e));
+    }
+    if (e < -Q15_SHIFT) {
+        return 0;
+    }
+    return (q15_t)(((q31_t)v + ((q31_t)1 << (-e - 1))) >> -e);
+}
+
+/*
+ * One transform over up to 2L new samples. With h = M - 1 history samples
+ * and ext = hist ++ in[0..c) ++ zeros, the real rail holds ext[0..N) (outputs
+ * 0..L) and the imaginary rail ext[L..L+N) (outputs L..2L); each rail's first
+ * h results are wrap-around and skipped.
+ */
+static void fastconv_frame(fastconv_t *fc, const q15_t *in, q15_t *out, size_t c)
+{
+    const size_t n = fc->nfft, hop = fc->hop, h = fc->ntaps - 1u;
+    const size_t ca = (c < hop) ? c : hop;
+    q15_t *w = fc->work;
+
+    for (size_t k = 0; k < h; k++) {
+        w[2u * k] = fc->hist[k];
+    }
+    for (size_t k = h; k < n; k++) {
+        w[2u * k] = (k - h < ca) ? in[k - h] : 0;
+    }
+    for (size_t k = 0; k < n; k++) {
+        size_t t = hop - h + k;   /* hop > h since N >= 2M */
+        w[2u * k + 1u] = (c > hop && t < c) ? in[t] : 0;
+    }
+
+    /* Slide the history before out (which may alias in) is written. */
+    if (c < h) {
+        memmove(fc->hist, &fc->hist[c], (h - c) * sizeof(q15_t));
+        memcpy(&fc->hist[h - c], in, c * sizeof(q15_t));
+    } else {
+        memcpy(fc->hist, &in[c - h], h * sizeof(q15_t));
+    }
+
+    int8_t ex = 0;
+    fft_q15(w, n, &ex);
+
+    /*
+     * X * H: each component is a q30-scale sum of two products (64-bit: the
+     * -32768 corner overflows 32). The shift is the least that fits the
+     * bound 2 * peak(X) * peak(H) into q15, so the product keeps every bit
+     * the two spectra carry.
+     */
+    int64_t bound = 2 * (int64_t)fastconv_peak(w, 2u * n) * fc->h_peak;
+    uint8_t sh = 0u;
+    while ((bound >> sh) > (int64_t)Q15_MAX) {
+        sh++;
+    }
+    const int64_t rnd = (sh > 0u) ? ((int64_t)1 << (sh - 1u)) : 0;
+    for (size_t k = 0; k < n; k++) {
+        int32_t xr = w[2u * k], xi = w[2u * k + 1u];
+        int32_t hr = fc->h_spec[2u * k], hi = fc->h_spec[2u * k + 1u];
+        int64_t pr = (int64_t)xr * hr - (int64_t)xi * hi;
+        int64_t pi = (int64_t)xr * hi + (int64_t)xi * hr;
+        w[2u * k]      = (q15_t)((pr + rnd) >> sh);
+        w[2u * k + 1u] = (q15_t)((pi + rnd) >> sh);
+    }
+
+    int8_t ei = 0;
+    fft_q15_inverse(w, n, &ei);
+    const int8_t e = (int8_t)(ex + fc->h_exp + (int8_t)sh + ei - Q15_SHIFT);
+
+    for (size_t i = 0; i < ca; i++) {
+        out[i] = fastconv_scale(w[2u * (h + i)], e);
+    }
+    for (size_t i = hop; i < c; i++) {
+        out[i] = fastconv_scale(w[2u * (h + i - hop) + 1u], e);
+    }
+}
+
+void fastconv_run(fastconv_t *fc, const q15_t *in, q15_t *out, size_t n)
+{
+    if (fc == NULL || in == NULL || out == NULL || fc->ntaps == 0u) {
+        return;
+    }
+    if (!fc->use_fft) {
+        for (size_t k = 0; k < n; k++) {
+            out[k] = fastconv_push(fc, in[k]);
+        }
+        return;
+    }
+    const size_t step = 2u * (size_t)fc->hop;
+    for (size_t off = 0; off < n; off += step) {
+        size_t c = (n - off < step) ? n - off : step;
+        fastconv_frame(fc, &in[off], &out[off], c);
+    }
+}
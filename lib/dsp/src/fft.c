@@ -0,0 +1,215 @@
+#include "fft.h"
+
+/*
+ * Largest pre-stage peak (per component) each stage can take without
+ * overflow. Radix-4: the twiddled outputs reach 4 * sqrt(2) * peak, so
+ * peak <= 32767 / 5.657. Radix-2 (no twiddle): outputs reach 2 * peak.
+ */
+#define FFT_R4_LIMIT  5792
+#define FFT_R2_LIMIT  16383
+
+uint8_t fft_log2(size_t n)
+{
+    for (uint8_t m = 2u; m <= FFT_MAX_LOG2; m++) {
+        if (n == ((size_t)1 << m)) {
+            return m;
+        }
+    }
+    return 0u;
+}
+
+static int32_t fft_abs(int32_t v)
+{
+    return (v < 0) ? -v : v;
+}
+
+static int32_t fft_peak(const q15_t *x, size_t n)
+{
+    int32_t peak = 0;
+    for (size_t k = 0; k < 2u * n; k++) {
+        int32_t a = fft_abs(x[k]);
+        if (a > peak) {
+            peak = a;
+        }
+    }
+    return peak;
+}
+
+/* Smallest shift s with (peak >> s) < limit. */
+static uint8_t fft_headroom(int32_t peak, int32_t limit)
+{
+    uint8_t s = 0u;
+    while ((peak >> s) >= limit) {
+        s++;
+    }
+    return s;
+}
+
+/* Load one component with a rounding right shift. */
+static inline int32_t fft_ld(q15_t v, uint8_t s)
+{
+    return (s == 0u) ? (int32_t)v : ((int32_t)v + (1 << (s - 1u))) >> s;
+}
+
+/* (re + i*im) * (c - i*sn), rounded back to q15 scale. */
+static inline void fft_twiddle(int32_t re, int32_t im, int32_t c, int32_t sn,
+                               int32_t *ore, int32_t *oim)
+{
+    *ore = (re * c + im * sn + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
+    *oim = (im * c - re * sn + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
+}
+
+static inline int32_t fft_track(int32_t peak, int32_t a, int32_t b)
+{
+    a = fft_abs(a);
+    b = fft_abs(b);
+    if (a > peak) {
+        peak = a;
+    }
+    return (b > peak) ? b : peak;
+}
+
+/*
+ * One radix-2^2 stage over spans of L points (q = L/4): for each j < q and
+ * each group, with a = x0 + x2, b = x1 + x3, c = x0 - x2, d = x1 - x3:
+ *
+ *     x[j]      = a + b
+ *     x[j + q]  = (a - b)      * W^2j
+ *     x[j + 2q] = (c - i*d)    * W^j
+ *     x[j + 3q] = (c + i*d)    * W^3j        (W = e^(-2*pi*i/L))
+ *
+ * which is two radix-2 DIF stages fused, outputs in radix-2 order. Returns
+ * the peak output component.
+ */
+static int32_t fft_stage_r4(q15_t *x, size_t n, size_t L, uint8_t s)
+{
+    const size_t q      = L / 4u;
+    const size_t stride = FFT_MAX_N / L;
+    const size_t quarter = FFT_MAX_N / 4u;
+    int32_t peak = 0;
+
+    for (size_t j = 0; j < q; j++) {
+        const size_t k1 = j * stride, k2 = 2u * k1, k3 = 3u * k1;
+        const int32_t c1 = fft_sin_table[k1 + quarter], s1 = fft_sin_table[k1];
+        const int32_t c2 = fft_sin_table[k2 + quarter], s2 = fft_sin_table[k2];
+        const int32_t c3 = fft_sin_table[(k3 + quarter) & (FFT_MAX_N - 1u)];
+        const int32_t s3 = fft_sin_table[k3];
+
+        for (size_t g = j; g < n; g += L) {
+            q15_t *p0 = &x[2u * g];
+            q15_t *p1 = &x[2u * (g + q)];
+            q15_t *p2 = &x[2u * (g + 2u * q)];
+            q15_t *p3 = &x[2u * (g + 3u * q)];
+
+            int32_t x0r = fft_ld(p0[0], s), x0i = fft_ld(p0[1], s);
+            int32_t x1r = fft_ld(p1[0], s), x1i = fft_ld(p1[1], s);
+            int32_t x2r = fft_ld(p2[0], s), x2i = fft_ld(p2[1], s);
+            int32_t x3r = fft_ld(p3[0], s), x3i = fft_ld(p3[1], s);
+
+            int32_t ar = x0r + x2r, ai = x0i + x2i;
+            int32_t br = x1r + x3r, bi = x1i + x3i;
+            int32_t cr = x0r - x2r, ci = x0i - x2i;
+            int32_t dr = x1r - x3r, di = x1i - x3i;
+
+            int32_t y0r = ar + br, y0i = ai + bi;
+            int32_t y1r, y1i, y2r, y2i, y3r, y3i;
+            if (k1 == 0u) {
+                /* W^0 = 1 exactly; the table's 32767 would lose an LSB. */
+                y1r = ar - br; y1i = ai - bi;
+                y2r = cr + di; y2i = ci - dr;
+                y3r = cr - di; y3i = ci + dr;
+            } else {
+                fft_twiddle(ar - br, ai - bi, c2, s2, &y1r, &y1i);
+                fft_twiddle(cr + di, ci - dr, c1, s1, &y2r, &y2i);   /* c - i*d */
+                fft_twiddle(cr - di, ci + dr, c3, s3, &y3r, &y3i);   /* c + i*d */
+            }
+
+            p0[0] = (q15_t)y0r; p0[1] = (q15_t)y0i;
+            p1[0] = (q15_t)y1r; p1[1] = (q15_t)y1i;
+            p2[0] = (q15_t)y2r; p2[1] = (q15_t)y2i;
+            p3[0] = (q15_t)y3r; p3[1] = (q15_t)y3i;
+
+            peak = fft_track(peak, y0r, y0i);
+            peak = fft_track(peak, y1r, y1i);
+            peak = fft_track(peak, y2r, y2i);
+            peak = fft_track(peak, y3r, y3i);
+        }
+    }
+    return peak;
+}
+
+/* Final radix-2 stage (span 2, twiddle 1). */
+static void fft_stage_r2(q15_t *x, size_t n, uint8_t s)
+{
+    for (size_t g = 0; g < n; g += 2u) {
+        q15_t *p0 = &x[2u * g];
+        q15_t *p1 = &x[2u * g + 2u];
+        int32_t ar = fft_ld(p0[0], s), ai = fft_ld(p0[1], s);
+        int32_t br = fft_ld(p1[0], s), bi = fft_ld(p1[1], s);
+        p0[0] = (q15_t)(ar + br); p0[1] = (q15_t)(ai + bi);
+        p1[0] = (q15_t)(ar - br); p1[1] = (q15_t)(ai - bi);
+    }
+}
+
+static void fft_bitrev(q15_t *x, size_t n, uint8_t m)
+{
+    const uint8_t shift = (uint8_t)(FFT_MAX_LOG2 - m);
+    for (size_t i = 0; i < n; i++) {
+        size_t j = (size_t)(fft_bitrev_table[i] >> shift);
+        if (j > i) {
+            q15_t tr = x[2u * i], ti = x[2u * i + 1u];
+            x[2u * i]      = x[2u * j];
+            x[2u * i + 1u] = x[2u * j + 1u];
+            x[2u * j]      = tr;
+            x[2u * j + 1u] = ti;
+        }
+    }
+}
+
+uint8_t fft_q15(q15_t *x, size_t n, int8_t *exp)
+{
+    const uint8_t m = fft_log2(n);
+    if (x == NULL || exp == NULL || m == 0u) {
+        return 0u;
+    }
+
+    int32_t peak  = fft_peak(x, n);
+    int8_t  total = 0;
+    size_t  L     = n;
+    for (uint8_t left = m; left >= 2u; left = (uint8_t)(left - 2u)) {
+        uint8_t s = fft_headroom(peak, FFT_R4_LIMIT);
+        peak   = fft_stage_r4(x, n, L, s);
+        total  = (int8_t)(total + s);
+        L    >>= 2;
+    }
+    if (m & 1u) {
+        uint8_t s = fft_headroom(peak, FFT_R2_LIMIT);
+        fft_stage_r2(x, n, s);
+        total = (int8_t)(total + s);
+    }
+    fft_bitrev(x, n, m);
+    *exp = total;
+    return 1u;
+}
+
+/* Negate the imaginary parts (saturating: -(-32768) -> 32767). */
+static void fft_conj(q15_t *x, size_t n)
+{
+    for (size_t k = 0; k < n; k++) {
+        x[2u * k + 1u] = q15_sat(-(q31_t)x[2u * k + 1u]);
+    }
+}
+
+uint8_t fft_q15_inverse(q15_t *x, size_t n, int8_t *exp)
+{
+    const uint8_t m = fft_log2(n);
+    if (x == NULL || exp == NULL || m == 0u) {
+        return 0u;
+    }
+    int8_t e = 0;
+    fft_conj(x, n);
+    fft_q15(x, n, &e);
+    fft_conj(x, n);
+    *exp = (int8_t)(e - (int8_t)m);
+    return 1u;
+}
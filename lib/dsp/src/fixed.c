@@ -0,0 +1,6 @@
+#include "fixed.h"
+
+#ifdef Q15_SAT_STATS
+/* Every q15 clamp on the sample path since start-up; see fixed.h. */
+uint32_t q15_sat_events;
+#endif
@@ -0,0 +1,103 @@
+#include "goertzel.h"
+#include <math.h>
+
+#define GOERTZEL_COEFF_SHIFT  14
+#define GOERTZEL_PI           3.14159265358979323846f
+
+/* 2*cos(2*pi*f) in q14, rounded half away from zero: [-32768, 32768]. */
+static int32_t goertzel_coeff(float f)
+{
+    float c = 2.0f * cosf(2.0f * GOERTZEL_PI * f) * (float)(1 << GOERTZEL_COEFF_SHIFT);
+    return (int32_t)((c >= 0.0f) ? c + 0.5f : c - 0.5f);
+}
+
+uint8_t goertzel_init(goertzel_bank_t *g, const float *freqs, uint8_t ntones)
+{
+    if (g == NULL || freqs == NULL || ntones == 0u || ntones > GOERTZEL_MAX_TONES) {
+        return 0u;
+    }
+    for (uint8_t k = 0; k < ntones; k++) {
+        if (!(freqs[k] >= 0.0f && freqs[k] <= 0.5f)) {
+            return 0u;
+        }
+    }
+    for (uint8_t k = 0; k < ntones; k++) {
+        g->coeff[k] = goertzel_coeff(freqs[k]);
+    }
+    g->ntones = ntones;
+    goertzel_reset(g);
+    return ntones;
+}
+
+uint8_t goertzel_init_bins(goertzel_bank_t *g, const uint16_t *bins,
+                           uint8_t ntones, uint16_t n)
+{
+    if (bins == NULL || n == 0u || ntones == 0u || ntones > GOERTZEL_MAX_TONES) {
+        return 0u;
+    }
+    float freqs[GOERTZEL_MAX_TONES];
+    for (uint8_t k = 0; k < ntones; k++) {
+        freqs[k] = (float)bins[k] / (float)n;
+    }
+    return goertzel_init(g, freqs, ntones);
+}
+
+void goertzel_reset(goertzel_bank_t *g)
+{
+    if (g == NULL) {
+        return;
+    }
+    for (uint8_t k = 0; k < g->ntones; k++) {
+        g->s1[k] = 0;
+        g->s2[k] = 0;
+    }
+    g->count = 0u;
+}
+
+void goertzel_run(goertzel_bank_t *g, const q15_t *x, size_t n)
+{
+    if (g == NULL || x == NULL) {
+        return;
+    }
+    /* Tone-outer: each resonator's two states stay in registers. */
+    for (uint8_t k = 0; k < g->ntones; k++) {
+        const int64_t c = g->coeff[k];
+        int32_t s1 = g->s1[k], s2 = g->s2[k];
+        for (size_t i = 0; i < n; i++) {
+            int32_t s0 = x[i] + (int32_t)((c * s1) >> GOERTZEL_COEFF_SHIFT) - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        g->s1[k] = s1;
+        g->s2[k] = s2;
+    }
+    g->count = (uint16_t)(g->count + n);
+}
+
+int64_t goertzel_power(const goertzel_bank_t *g, uint8_t k)
+{
+    if (g == NULL || k >= g->ntones) {
+        return 0;
+    }
+    const int64_t s1 = g->s1[k], s2 = g->s2[k];
+    /* Scale c*s1 first: c*s1*s2 could pass 2^63 at GOERTZEL_MAX_N. */
+    int64_t p = s1 * s1 + s2 * s2 - ((g->coeff[k] * s1) >> GOERTZEL_COEFF_SHIFT) * s2;
+    return (p > 0) ? p : 0;
+}
+
+uint8_t goertzel_argmax(const goertzel_bank_t *g)
+{
+    if (g == NULL || g->ntones == 0u) {
+        return 0u;
+    }
+    uint8_t best = 0u;
+    int64_t best_p = goertzel_power(g, 0u);
+    for (uint8_t k = 1u; k < g->ntones; k++) {
+        int64_t p = goertzel_power(g, k);
+        if (p > best_p) {
+            best_p = p;
+            best   = k;
+        }
+    }
+    return best;
+}
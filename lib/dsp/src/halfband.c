@@ -0,0 +1,148 @@
+#include "halfband.h"
+#include "dot.h"
+#include <math.h>
+
+/* Zeroth-order modified Bessel function, by its power series (Kaiser window). */
+static double halfband_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/* Round half away from zero, then saturate to q15. Matches q15_from_float. */
+static q15_t halfband_q15(double x)
+{
+    double scaled = x * 32768.0;
+    double r = (scaled >= 0.0) ? floor(scaled + 0.5) : ceil(scaled - 0.5);
+    if (r > 32767.0) {
+        return Q15_MAX;
+    }
+    if (r < -32768.0) {
+        return Q15_MIN;
+    }
+    return (q15_t)r;
+}
+
+uint8_t halfband_design(halfband_t *hb, float fpass, halfband_role_t role)
+{
+    if (hb == NULL || !(fpass > 0.0f && fpass < 0.25f) ||
+        (role != HALFBAND_INTERP && role != HALFBAND_DECIM)) {
+        return 0u;
+    }
+
+    /* Kaiser's length and shape estimates for the stopband spec. */
+    const double atten = (double)HALFBAND_ATTEN_DB;
+    const double dw    = 0.5 - 2.0 * (double)fpass;
+    const double len   = (atten - 7.95) / (14.36 * dw) + 1.0;
+    uint16_t k = (uint16_t)ceil((len + 1.0) / 4.0);
+    if (k < 2u) {
+        k = 2u;
+    }
+    if (4u * k - 1u > HALFBAND_MAX_TAPS) {
+        return 0u;
+    }
+    const double beta = 0.1102 * (atten - 8.7);
+
+    /*
+     * Side tap j is prototype index 2j, an odd offset d from the centre
+     * c = 2K - 1. Ideal response 1/2 * sinc(d / 2) = sin(pi d / 2) / (pi d).
+     */
+    const double pi = 3.14159265358979323846;
+    const double c  = (double)(2u * k - 1u);
+    const uint8_t nside = (uint8_t)(2u * k);
+    double side[HALFBAND_MAX_SIDE];
+    double sum = 0.0;
+    for (uint8_t j = 0; j < nside; j++) {
+        double d = 2.0 * j - c;
+        double r = d / c;
+        double w = halfband_i0(beta * sqrt(1.0 - r * r)) / halfband_i0(beta);
+        side[j] = sin(pi * d / 2.0) / (pi * d) * w;
+        sum += side[j];
+    }
+
+    const double scale = ((role == HALFBAND_INTERP) ? 1.0 : 0.5) / sum;
+    for (uint8_t j = 0; j < nside; j++) {
+        hb->taps[j] = halfband_q15(side[j] * scale);
+    }
+    hb->nside = nside;
+    hb->ntaps = (uint8_t)(4u * k - 1u);
+    hb->role  = (uint8_t)role;
+    halfband_reset(hb);
+    return hb->ntaps;
+}
+
+void halfband_reset(halfband_t *hb)
+{
+    if (hb == NULL) {
+        return;
+    }
+    for (uint8_t i = 0; i < 2u * hb->nside; i++) {
+        hb->z[i] = 0;
+    }
+    for (uint8_t i = 0; i < hb->nside / 2u; i++) {
+        hb->zc[i] = 0;
+    }
+    hb->pos   = 0u;
+    hb->cpos  = 0u;
+    hb->phase = 0u;
+}
+
+/* Push x into the side FIR's mirrored delay line; z[pos] is then newest. */
+static inline void halfband_push(halfband_t *hb, q15_t x)
+{
+    if (hb->pos == 0u) {
+        hb->pos = hb->nside;
+    }
+    hb->pos--;
+    hb->z[hb->pos]             = x;
+    hb->z[hb->pos + hb->nside] = x;
+}
+
+size_t halfband_interpolate(halfband_t *hb, const q15_t *in, size_t n, q15_t *out)
+{
+    if (hb == NULL || in == NULL || out == NULL || hb->role != HALFBAND_INTERP) {
+        return 0u;
+    }
+    const uint8_t k = (uint8_t)(hb->nside / 2u);
+    for (size_t i = 0; i < n; i++) {
+        halfband_push(hb, in[i]);
+        out[2u * i]      = dot_round_q15(dot_q15(hb->taps, &hb->z[hb->pos], hb->nside));
+        out[2u * i + 1u] = hb->z[hb->pos + k - 1u];   /* centre tap: x[n-K+1] */
+    }
+    return 2u * n;
+}
+
+size_t halfband_decimate(halfband_t *hb, const q15_t *in, size_t n, q15_t *out)
+{
+    if (hb == NULL || in == NULL || out == NULL || hb->role != HALFBAND_DECIM) {
+        return 0u;
+    }
+    const uint8_t k = (uint8_t)(hb->nside / 2u);
+    size_t o = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (hb->phase == 0u) {
+            /*
+             * Even input x[2m]: the output is the side FIR plus half of the
+             * odd input x[2m - 2K + 1], which sits K writes back in the ring
+             * (the slot about to be reused).
+             */
+            halfband_push(hb, in[i]);
+            int64_t acc = dot_q15(hb->taps, &hb->z[hb->pos], hb->nside) +
+                          ((int64_t)hb->zc[hb->cpos] << (Q15_SHIFT - 1));
+            out[o++] = dot_round_q15(acc);
+            hb->phase = 1u;
+        } else {
+            hb->zc[hb->cpos] = in[i];
+            hb->cpos = (uint8_t)((hb->cpos + 1u == k) ? 0u : hb->cpos + 1u);
+            hb->phase = 0u;
+        }
+    }
+    return o;
+}
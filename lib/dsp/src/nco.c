@@ -0,0 +1,164 @@
+#include "nco.h"
+
+/*
+ * Bit layout of the 32-bit phase (see nco.h): quadrant in the top two bits,
+ * table index in the next NCO_QTABLE_BITS, then a 15-bit interpolation
+ * fraction. The lowest 7 bits only contribute to frequency resolution.
+ */
+#define NCO_INDEX_SHIFT  (30u - NCO_QTABLE_BITS)
+#define NCO_FRAC_SHIFT   (NCO_INDEX_SHIFT - Q15_SHIFT)
+#define NCO_INDEX_MASK   (NCO_QTABLE_SIZE - 1u)
+#define NCO_FRAC_MASK    ((1u << Q15_SHIFT) - 1u)
+
+uint32_t nco_freq_to_step(float freq_norm)
+{
+    /*
+     * step = round(f * 2^32). Done in double so the full 32-bit word is
+     * exact; this runs once per (re)tune, never in the sample loop.
+     */
+    double scaled = (double)freq_norm * 4294967296.0;
+    int64_t r = (int64_t)(scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5);
+    return (uint32_t)r;
+}
+
+void nco_init(nco_t *nco, float freq_norm, uint32_t phase0)
+{
+    if (nco == NULL) {
+        return;
+    }
+    nco->phase = phase0;
+    nco->step  = nco_freq_to_step(freq_norm);
+}
+
+void nco_set_freq(nco_t *nco, float freq_norm)
+{
+    if (nco == NULL) {
+        return;
+    }
+    nco->step = nco_freq_to_step(freq_norm);
+}
+
+q15_t nco_sin(uint32_t phase)
+{
+    uint32_t quadrant = phase >> 30;
+    uint32_t idx  = (phase >> NCO_INDEX_SHIFT) & NCO_INDEX_MASK;
+    int32_t  frac = (int32_t)((phase >> NCO_FRAC_SHIFT) & NCO_FRAC_MASK);
+
+    /*
+     * Quadrants 1 and 3 run the table backwards: sin(pi/2 + x) == sin(pi/2 - x).
+     * Reading entries [N-idx] -> [N-idx-1] with the same fraction walks the
+     * mirrored segment in the right direction, and the guard entry at
+     * [NCO_QTABLE_SIZE] means neither direction ever indexes past the table.
+     */
+    int32_t a, b;
+    if ((quadrant & 1u) == 0u) {
+        a = nco_sin_qtable[idx];
+        b = nco_sin_qtable[idx + 1u];
+    } else {
+        a = nco_sin_qtable[NCO_QTABLE_SIZE - idx];
+        b = nco_sin_qtable[NCO_QTABLE_SIZE - idx - 1u];
+    }
+
+    /* Linear interpolation, rounded; |b - a| <= 201 so no overflow. */
+    int32_t v = a + (((b - a) * frac + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT);
+
+    /* Lower half-plane (quadrants 2 and 3) is the negated upper half. */
+    return (q15_t)((quadrant & 2u) ? -v : v);
+}
+
+q15_t nco_cos(uint32_t phase)
+{
+    return nco_sin(phase + NCO_PHASE_QUARTER);
+}
+
+void nco_next(nco_t *nco, q15_t *sin_out, q15_t *cos_out)
+{
+    if (sin_out != NULL) {
+        *sin_out = nco_sin(nco->phase);
+    }
+    if (cos_out != NULL) {
+        *cos_out = nco_cos(nco->phase);
+    }
+    nco->phase += nco->step;
+}
+
+void nco_generate(nco_t *nco, q15_t *out, size_t n)
+{
+    if (nco == NULL || out == NULL) {
+        return;
+    }
+    uint32_t phase = nco->phase;
+    uint32_t step  = nco->step;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = nco_cos(phase);
+        phase += step;
+    }
+    nco->phase = phase;
+}
+
+void nco_mix_up(nco_t *nco, const q15_t *bb, q15_t *out, size_t n)
+{
+    if (nco == NULL || bb == NULL || out == NULL) {
+        return;
+    }
+    uint32_t phase = nco->phase;
+    uint32_t step  = nco->step;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = q15_mul(bb[i], nco_cos(phase));
+        phase += step;
+    }
+    nco->phase = phase;
+}
+
+void nco_mix_down(nco_t *nco, const q15_t *in, q15_t *i_out, q15_t *q_out,
+                  size_t n)
+{
+    if (nco == NULL || in == NULL || i_out == NULL) {
+        return;
+    }
+    uint32_t phase = nco->phase;
+    uint32_t step  = nco->step;
+    for (size_t k = 0; k < n; k++) {
+        q15_t x = in[k];
+        if (q_out != NULL) {
+            /*
+             * -(x * sin): negate in 32 bits and saturate, so a product of
+             * exactly -1.0 (x == Q15_MIN at sin == +1.0) clamps to Q15_MAX
+             * instead of wrapping back to -1.0.
+             */
+            q_out[k] = q15_sat(-(q31_t)q15_mul(x, nco_sin(phase)));
+        }
+        i_out[k] = q15_mul(x, nco_cos(phase));
+        phase += step;
+    }
+    nco->phase = phase;
+}
+
+void nco_rotate_iq(uint32_t phase, q15_t *i, q15_t *q)
+{
+    /*
+     * Table outputs are bounded by +/-32767, so each q30 product is below
+     * 2^30 in magnitude and the two-term sum (plus rounding) fits in q31.
+     */
+    q31_t c = nco_cos(phase);
+    q31_t s = nco_sin(phase);
+    q31_t x = *i;
+    q31_t y = *q;
+    const q31_t half = 1 << (Q15_SHIFT - 1);
+    *i = q15_sat((x * c - y * s + half) >> Q15_SHIFT);
+    *q = q15_sat((x * s + y * c + half) >> Q15_SHIFT);
+}
+
+void nco_mix_complex(nco_t *nco, q15_t *i, q15_t *q, size_t n)
+{
+    if (nco == NULL || i == NULL || q == NULL) {
+        return;
+    }
+    uint32_t phase = nco->phase;
+    uint32_t step  = nco->step;
+    for (size_t k = 0; k < n; k++) {
+        nco_rotate_iq(phase, &i[k], &q[k]);
+        phase += step;
+    }
+    nco->phase = phase;
+}
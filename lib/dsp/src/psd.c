@@ -0,0 +1,130 @@
+#include "psd.h"
+#include <string.h>
+
+/* q15 units squared to FS^2: 2^-30. */
+#define PSD_Q30_SCALE  9.313225746154785e-10f
+
+uint16_t psd_init(psd_t *psd, uint16_t nfft)
+{
+    if (psd == NULL || fft_log2(nfft) == 0u) {
+        return 0u;
+    }
+    const size_t stride  = FFT_MAX_N / nfft;
+    const size_t quarter = FFT_MAX_N / 4u;
+    float pow = 0.0f;
+
+    /* Periodic Hann: w[n] = (1 - cos(2*pi*n/N)) / 2. */
+    for (size_t n = 0; n < nfft; n++) {
+        int32_t c = fft_sin_table[(n * stride + quarter) & (FFT_MAX_N - 1u)];
+        int32_t w = (Q15_MAX - c + 1) >> 1;
+        psd->win[n] = (q15_t)w;
+        float wf = (float)w / 32768.0f;
+        pow += wf * wf;
+    }
+    psd->nfft    = nfft;
+    psd->hop     = (uint16_t)(nfft / 2u);
+    psd->win_pow = pow;
+    psd_reset(psd);
+    return nfft;
+}
+
+void psd_reset(psd_t *psd)
+{
+    if (psd == NULL) {
+        return;
+    }
+    memset(psd->acc, 0, sizeof(psd->acc));
+    psd->segments = 0u;
+    psd->fill     = 0u;
+}
+
+/* Window the full history into work, transform, accumulate, slide by hop. */
+static void psd_segment(psd_t *psd)
+{
+    const size_t n = psd->nfft;
+    for (size_t k = 0; k < n; k++) {
+        int32_t w = psd->win[k];
+        psd->work[2u * k]      = (q15_t)(((int32_t)psd->hist[2u * k] * w
+                                          + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT);
+        psd->work[2u * k + 1u] = (q15_t)(((int32_t)psd->hist[2u * k + 1u] * w
+                                          + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT);
+    }
+
+    int8_t e = 0;
+    fft_q15(psd->work, n, &e);
+    /* |X|^2 * 2^(2e): build the float scale once per segment. */
+    float scale = 1.0f;
+    for (int8_t s = 0; s < e; s++) {
+        scale *= 4.0f;
+    }
+    for (size_t k = 0; k < n; k++) {
+        int32_t re = psd->work[2u * k], im = psd->work[2u * k + 1u];
+        psd->acc[k] += (float)((uint32_t)(re * re) + (uint32_t)(im * im)) * scale;
+    }
+    psd->segments++;
+
+    memmove(psd->hist, &psd->hist[2u * psd->hop],
+            2u * (n - psd->hop) * sizeof(q15_t));
+    psd->fill = (uint16_t)(n - psd->hop);
+}
+
+void psd_push(psd_t *psd, const q15_t *i, const q15_t *q, size_t n)
+{
+    if (psd == NULL || i == NULL || psd->nfft == 0u) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        psd->hist[2u * psd->fill]      = i[k];
+        psd->hist[2u * psd->fill + 1u] = (q != NULL) ? q[k] : 0;
+        if (++psd->fill == psd->nfft) {
+            psd_segment(psd);
+        }
+    }
+}
+
+float psd_bin(const psd_t *psd, uint16_t k)
+{
+    if (psd == NULL || psd->segments == 0u || k >= psd->nfft) {
+        return 0.0f;
+    }
+    return psd->acc[k] * PSD_Q30_SCALE
+           / ((float)psd->segments * (float)psd->nfft * psd->win_pow);
+}
+
+float psd_band(const psd_t *psd, int32_t k_lo, int32_t k_hi)
+{
+    if (psd == NULL || psd->nfft == 0u) {
+        return 0.0f;
+    }
+    const int32_t mask = (int32_t)psd->nfft - 1;
+    float sum = 0.0f;
+    for (int32_t k = k_lo; k <= k_hi; k++) {
+        sum += psd_bin(psd, (uint16_t)(k & mask));
+    }
+    return sum;
+}
+
+float psd_total(const psd_t *psd)
+{
+    if (psd == NULL || psd->nfft == 0u) {
+        return 0.0f;
+    }
+    return psd_band(psd, 0, (int32_t)psd->nfft - 1);
+}
+
+uint16_t psd_occupied_bins(const psd_t *psd, float fraction)
+{
+    const float total = psd_total(psd);
+    if (total <= 0.0f) {
+        return 0u;
+    }
+    const int32_t half = (int32_t)psd->nfft / 2;
+    float sum = psd_bin(psd, 0u);
+    int32_t h = 0;
+    while (sum < fraction * total && h < half) {
+        h++;
+        sum += psd_bin(psd, (uint16_t)h)
+             + ((h < half) ? psd_bin(psd, (uint16_t)(psd->nfft - h)) : 0.0f);
+    }
+    return (uint16_t)h;
+}
@@ -1,4 +1,5 @@
 #include "rrc.h"
+#include "dot.h"
 #include <math.h>
 
 /*
@@ -92,7 +93,7 @@ void rrc_reset(rrc_t *f)
     if (f == NULL) {
         return;
     }
-    for (uint16_t i = 0; i < f->ntaps; i++) {
+    for (uint16_t i = 0; i < 2u * f->ntaps; i++) {
         f->z[i] = 0;
     }
     f->pos = 0;
@@ -101,8 +102,9 @@ void rrc_reset(rrc_t *f)
 q15_t rrc_push(rrc_t *f, q15_t x)
 {
     /*
-     * Circular delay line: store the newest sample, then accumulate
-     * taps[k] * sample[now-k] over the window. A 64-bit accumulator covers the
+     * Mirrored delay line: each sample is stored at pos and pos + ntaps, so
+     * z[pos .. pos + ntaps) is always the newest-first window in one run and
+     * the MACs go straight to dot_q15(). Its 64-bit accumulator covers the
      * worst-case sum over up to RRC_MAX_TAPS taps (~2^34) without overflow.
      */
     uint16_t nt = f->ntaps;
@@ -110,27 +112,10 @@ q15_t rrc_push(rrc_t *f, q15_t x)
         f->pos = nt;
     }
     f->pos--;
-    f->z[f->pos] = x;
+    f->z[f->pos]      = x;
+    f->z[f->pos + nt] = x;
 
-    int64_t acc = 0;
-    uint16_t idx = f->pos;
-    for (uint16_t k = 0; k < nt; k++) {
-        acc += (int64_t)f->taps[k] * (int64_t)f->z[idx];
-        idx++;
-        if (idx == nt) {
-            idx = 0;
-        }
-    }
-
-    /* Round (+1<<14) then arithmetic >>15 back to q15, with saturation. */
-    int64_t y = (acc + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
-    if (y > (int64_t)Q15_MAX) {
-        return Q15_MAX;
-    }
-    if (y < (int64_t)Q15_MIN) {
-        return Q15_MIN;
-    }
-    return (q15_t)y;
+    return dot_round_q15(dot_q15(f->taps, &f->z[f->pos], nt));
 }
 
 void rrc_tx_shape(rrc_t *f, const q15_t *syms, size_t nsyms, q15_t *out)
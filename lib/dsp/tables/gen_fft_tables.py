@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Generate the FFT twiddle and bit-reverse tables for lib/dsp/src/fft_tables.c.
+
+The q15 FFT (lib/dsp/src/fft.c) supports every power of two up to FFT_MAX_N.
+Both tables are built once for FFT_MAX_N and strided for smaller sizes:
+
+- fft_sin_table: one full period of sin(2*pi*k / FFT_MAX_N). A size-N
+  transform reads entry k * (FFT_MAX_N / N); cos is the same table a quarter
+  period (FFT_MAX_N / 4 entries) further on. The radix-4 butterflies' sines
+  of W^k, W^2k, W^3k (k < N/4, so index < 3N/4) never wrap; only the cosine
+  of W^3k does, and fft.c masks that index.
+- fft_bitrev_table: k with its FFT_MAX_LOG2 bits reversed. For a size
+  2^m transform the m-bit reverse is this entry shifted right by
+  FFT_MAX_LOG2 - m.
+
+Values are float64 sin() scaled by 32767 and rounded half away from zero,
+the same rule as gen_sin_table.py. Both tables land in .rodata (flash).
+
+Usage:
+    python3 lib/dsp/tables/gen_fft_tables.py > lib/dsp/src/fft_tables.c
+"""
+import math
+
+MAX_LOG2 = 10
+MAX_N = 1 << MAX_LOG2
+
+
+def q15_round(x: float) -> int:
+    """Round half away from zero, then saturate to q15."""
+    r = math.floor(x + 0.5) if x >= 0.0 else math.ceil(x - 0.5)
+    return max(-32768, min(32767, int(r)))
+
+
+def bitrev(k: int, bits: int) -> int:
+    r = 0
+    for _ in range(bits):
+        r = (r << 1) | (k & 1)
+        k >>= 1
+    return r
+
+
+sin_table = [q15_round(32767.0 * math.sin(2.0 * math.pi * k / MAX_N))
+             for k in range(MAX_N)]
+rev_table = [bitrev(k, MAX_LOG2) for k in range(MAX_N)]
+
+
+def emit(decl: str, values, width: int, per_row: int) -> None:
+    print(f"{decl} = {{")
+    for i in range(0, len(values), per_row):
+        row = ", ".join(f"{v:{width}d}" for v in values[i:i + per_row])
+        print(f"    {row},")
+    print("};")
+
+
+print("/*")
+print(" * Twiddle and bit-reverse tables for the q15 FFT (lib/dsp/inc/fft.h).")
+print(" *")
+print(" * Generated by lib/dsp/tables/gen_fft_tables.py — do not edit by hand.")
+print(f" * fft_sin_table[k] = round(32767 * sin(2 * pi * k / {MAX_N})), k = 0..{MAX_N - 1};")
+print(f" * fft_bitrev_table[k] = k with its {MAX_LOG2} bits reversed.")
+print(" */")
+print()
+print('#include "fft.h"')
+print()
+emit("const q15_t fft_sin_table[FFT_MAX_N]", sin_table, 6, 8)
+print()
+emit("const uint16_t fft_bitrev_table[FFT_MAX_N]", rev_table, 4, 12)
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+"""Generate the quarter-wave q15 sine table for lib/dsp/src/sin_table.c.
+
+The NCO (lib/dsp/src/nco.c) folds a 32-bit phase accumulator onto the first
+quadrant and linearly interpolates between adjacent entries of this table, so
+only sin(0..pi/2) is stored: NCO_QTABLE_SIZE + 1 entries, the last being the
+exact quadrant endpoint sin(pi/2) so interpolation never reads past the end.
+
+Values are float64 sin() scaled by 32767 (not 32768: +1.0 is not representable
+in q15) and rounded half away from zero — the same rule as q15_from_float and
+the RRC golden vectors. The table lands in .rodata (flash) on target.
+
+Usage:
+    python3 lib/dsp/tables/gen_sin_table.py > lib/dsp/src/sin_table.c
+"""
+import math
+
+QTABLE_BITS = 8
+QTABLE_SIZE = 1 << QTABLE_BITS
+
+
+def q15_round(x: float) -> int:
+    """Round half away from zero, then saturate to q15."""
+    r = math.floor(x + 0.5) if x >= 0.0 else math.ceil(x - 0.5)
+    return max(-32768, min(32767, int(r)))
+
+
+table = [q15_round(32767.0 * math.sin(0.5 * math.pi * k / QTABLE_SIZE))
+         for k in range(QTABLE_SIZE + 1)]
+
+print("/*")
+print(" * Quarter-wave q15 sine table for the NCO (lib/dsp/inc/nco.h).")
+print(" *")
+print(" * Generated by lib/dsp/tables/gen_sin_table.py — do not edit by hand.")
+print(f" * Entry k = round(32767 * sin(k * pi / {2 * QTABLE_SIZE})), k = 0..{QTABLE_SIZE}; the")
+print(" * extra last entry is the quadrant endpoint so interpolation never wraps.")
+print(" */")
+print()
+print('#include "nco.h"')
+print()
+print("const q15_t nco_sin_qtable[NCO_QTABLE_SIZE + 1u] = {")
+for i in range(0, len(table), 8):
+    row = ", ".join(f"{v:6d}" for v in table[i:i + 8])
+    print(f"    {row},")
+print("};")
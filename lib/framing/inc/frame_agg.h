@@ -0,0 +1,144 @@
+#ifndef LIB_FRAMING_FRAME_AGG_H
+#define LIB_FRAMING_FRAME_AGG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "framing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Aggregation of small messages over frame_link (framing.h). Each frame
+ * costs a FLAG pair, six header/CRC bytes and, on a stop-and-wait link, a
+ * whole ACK round trip; telemetry-sized messages are mostly that. The
+ * aggregator packs them into one FRAME_TYPE_AGG frame instead:
+ *
+ *   payload = sub-message*
+ *   sub-message = [TYPE:1][LEN:2 LE][PAYLOAD:LEN]
+ *
+ * Sender:
+ *  - send() copies the message into the open buffer; nothing goes out yet
+ *  - the buffer is flushed as one frame once it is full (no room for
+ *    another sub-message) or max_delay_ms after its first message went in,
+ *    as soon as the link is idle; meanwhile the next buffer fills
+ *  - a buffer holding a single message is sent as an ordinary frame of
+ *    that message's type, so a quiet link pays nothing extra
+ *  - a frame that runs out of retries (frame_link_tick() returns -1, or
+ *    frame_link_on_nack() 0) is sent again, unchanged and with the same
+ *    SEQ, so the peer's duplicate suppression still holds, up to
+ *    max_resends times; after that the aggregator is failed: tick(), send()
+ *    and flush() return FRAME_ERR_LINK_DOWN until frame_agg_drop() gives
+ *    up on the frame
+ *
+ * The aggregator drives frame_link's sender: call frame_agg_tick() in place
+ * of frame_link_tick(), and do not frame_link_send() on the same link. ACK,
+ * NACK and receive handling stay with the caller, as before.
+ *
+ * Receiver: frame_agg_split() unpacks an AGG frame (and passes any other
+ * frame through), so it can sit behind frame_link or frame_arq alike.
+ *
+ * Storage is the caller's: two buffers of frame_max bytes, one filling while
+ * the other is in flight.
+ */
+
+#define FRAME_AGG_SUB_OVERHEAD   3u    /* TYPE + LEN per sub-message */
+
+typedef void (*frame_agg_deliver_cb_t)(frame_type_t type,
+                                       const uint8_t *payload, size_t len,
+                                       void *user);
+
+typedef struct {
+    frame_link_t *link;      /* required; initialised by the caller */
+    uint8_t      *store;     /* required; 2 * frame_max bytes */
+    uint16_t      frame_max; /* largest AGG payload, up to FRAME_MAX_PAYLOAD */
+    uint32_t      max_delay_ms;  /* 0: flush whenever the link is idle */
+    uint8_t       max_resends;   /* resends of a frame out of retries; 0: none */
+} frame_agg_config_t;
+
+typedef struct {
+    uint32_t messages;       /* accepted by send() */
+    uint32_t frames;         /* first transmissions, AGG or single */
+    uint32_t flush_full;     /* frames sent because the buffer was full */
+    uint32_t flush_deadline; /* frames sent on max_delay_ms (or flush()) */
+    uint32_t resends;        /* frames sent again after running out of retries */
+    uint32_t dropped;        /* messages given up on by frame_agg_drop() */
+} frame_agg_counters_t;
+
+typedef struct {
+    frame_agg_config_t cfg;
+
+    /* Internal state. Treat as opaque from outside the module. */
+    uint8_t  open;           /* buffer being filled: 0 or 1 */
+    uint8_t  in_flight;      /* the other one was sent and may need resending */
+    uint8_t  in_flight_seq;  /* its SEQ; the link moves past it on the ACK */
+    uint8_t  resends_left;   /* for the in-flight frame */
+    uint8_t  failed;         /* it ran out of resends too */
+    uint16_t len[2];         /* bytes used in each buffer */
+    uint16_t count[2];       /* sub-messages in each buffer */
+    uint32_t first_ms;       /* when the open buffer got its first message */
+
+    frame_agg_counters_t stats;
+} frame_agg_t;
+
+/*
+ * Initialise from cfg (copied). Returns FRAME_OK, FRAME_ERR_NULL_ARG if g,
+ * cfg, the link or the store is NULL, or FRAME_ERR_OVERSIZE if frame_max
+ * cannot hold a one-byte sub-message or exceeds FRAME_MAX_PAYLOAD.
+ */
+frame_err_t frame_agg_init(frame_agg_t *g, const frame_agg_config_t *cfg);
+
+/*
+ * Queue one message (copied). Returns FRAME_OK, FRAME_ERR_NULL_ARG,
+ * FRAME_ERR_BAD_TYPE for ACK, NACK or AGG, FRAME_ERR_OVERSIZE if it could
+ * never fit in a frame, or FRAME_ERR_BUF_SMALL if the open buffer is full
+ * and the link is still busy with the previous one (try again after the
+ * ACK), or FRAME_ERR_LINK_DOWN while failed. Flushes at once when this
+ * fills the buffer and the link is idle.
+ */
+frame_err_t frame_agg_send(frame_agg_t *g, frame_type_t type,
+                           const uint8_t *payload, size_t len);
+
+/*
+ * Periodic timer, in place of frame_link_tick(): runs the link's retransmit
+ * timer, then sends whatever is due if the link is idle. Returns the
+ * frame_link_tick() result (-1: a frame ran out of retries and will be sent
+ * again), or FRAME_ERR_LINK_DOWN on every tick once it has run out of
+ * resends as well.
+ */
+int frame_agg_tick(frame_agg_t *g);
+
+/*
+ * Send the open buffer now, deadline or not. Returns FRAME_OK (also when
+ * there was nothing to send), FRAME_ERR_NULL_ARG, FRAME_ERR_BUF_SMALL
+ * while the link is busy, or FRAME_ERR_LINK_DOWN while failed.
+ */
+frame_err_t frame_agg_flush(frame_agg_t *g);
+
+/*
+ * Give up on the frame that failed the aggregator: its buffer is released,
+ * the link moves on to a new SEQ and sending resumes with the messages
+ * queued since. Returns how many messages were dropped (0 if not failed).
+ */
+size_t frame_agg_drop(frame_agg_t *g);
+
+/* Messages queued and not yet handed to the link. */
+size_t frame_agg_pending(const frame_agg_t *g);
+
+/*
+ * Deliver a received frame's messages: each sub-message of an AGG frame in
+ * order, or the frame itself for any other type. The frame is checked first
+ * and nothing is delivered if a sub-message overruns the payload
+ * (FRAME_ERR_TRUNC) or has type ACK, NACK, AGG or > FRAME_TYPE__MAX
+ * (FRAME_ERR_BAD_TYPE). Returns the number delivered, or the error.
+ */
+int frame_agg_split(frame_type_t type, const uint8_t *payload, size_t len,
+                    frame_agg_deliver_cb_t deliver, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_FRAMING_FRAME_AGG_H */
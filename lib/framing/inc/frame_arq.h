@@ -0,0 +1,156 @@
+#ifndef LIB_FRAMING_FRAME_ARQ_H
+#define LIB_FRAMING_FRAME_ARQ_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "framing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Selective-repeat ARQ over the frame layer: frame_link (framing.h) with a
+ * window of N frames in flight instead of one, so throughput over a link
+ * with latency is no longer capped at one frame per round trip.
+ *
+ * One frame_arq_t is both ends of a link: it sends sequenced frames and
+ * answers the peer's, over the same transport hooks as frame_link. The
+ * caller runs a frame_decoder_t on the receive side and hands every decoded
+ * frame to frame_arq_on_frame().
+ *
+ * Sender:
+ *  - send() assigns the next SEQ and transmits; up to `window` frames may
+ *    be unacknowledged at once (FRAME_ERR_BUF_SMALL beyond that)
+ *  - every frame in flight has its own retransmit timer (tick())
+ *  - ACK(c) is cumulative: every frame up to and including SEQ c arrived
+ *  - NACK(s) asks for frame s alone, which is retransmitted at once
+ *
+ * Receiver:
+ *  - frames inside the receive window are buffered (rx_store) and
+ *    delivered to deliver_cb strictly in SEQ order, each exactly once
+ *  - every sequenced frame is answered with ACK(last in-order SEQ); a
+ *    frame that opens a gap also NACKs each missing SEQ, once per gap
+ *  - duplicates of already-delivered frames are re-ACKed, not delivered
+ *
+ * SEQ is the 8-bit frame field, so the window is a power of two no larger
+ * than FRAME_ARQ_MAX_WINDOW (selective repeat needs window <= 128). As with
+ * frame_link, payloads are referenced, not copied: each must stay valid
+ * until its frame is acknowledged.
+ *
+ * ACK and NACK frames carry no payload; every other frame type is treated
+ * as sequenced data.
+ */
+
+#define FRAME_ARQ_MAX_WINDOW     16u
+
+typedef void (*frame_arq_deliver_cb_t)(frame_type_t type,
+                                       const uint8_t *payload, size_t len,
+                                       void *user);
+
+typedef struct {
+    frame_link_write_cb_t  write;      /* required */
+    frame_link_now_ms_cb_t now_ms;     /* required */
+    frame_arq_deliver_cb_t deliver;    /* required */
+    void                  *user;
+
+    uint32_t timeout_ms;     /* per-frame retransmit timer */
+    uint8_t  max_retries;    /* send attempts per frame = 1 + max_retries */
+    uint8_t  window;         /* 1, 2, 4, 8 or 16 */
+    uint8_t  mode;           /* frame_mode_t; 0 = FRAME_MODE_HDLC */
+
+    /*
+     * Receive reorder buffer: window slots of rx_slot_size bytes each. A
+     * frame longer than rx_slot_size that arrives out of order is dropped
+     * (and recovered by retransmission).
+     */
+    uint8_t *rx_store;
+    size_t   rx_slot_size;
+} frame_arq_config_t;
+
+typedef struct {
+    const uint8_t *payload;
+    uint16_t       len;
+    uint8_t        type;
+    uint8_t        attempts;     /* transmissions so far */
+    uint32_t       sent_ms;      /* last (re)transmission */
+} frame_arq_tx_slot_t;
+
+typedef struct {
+    uint16_t len;
+    uint8_t  type;
+    uint8_t  present;
+} frame_arq_rx_slot_t;
+
+typedef struct {
+    uint32_t tx_frames;          /* first transmissions */
+    uint32_t retransmits;        /* timer and NACK retransmissions */
+    uint32_t nacks_rx;
+    uint32_t nacks_tx;
+    uint32_t rx_delivered;
+    uint32_t rx_duplicates;
+    uint32_t rx_out_of_window;   /* outside both windows, or too long to buffer */
+} frame_arq_counters_t;
+
+typedef struct {
+    frame_arq_config_t cfg;
+
+    /*
+     * Internal state. Treat as opaque from outside the module — exposed only
+     * so callers can stack-allocate the struct. Slots are indexed by
+     * SEQ & (window - 1).
+     */
+    uint8_t  tx_base;            /* oldest unacknowledged SEQ */
+    uint8_t  tx_next;            /* SEQ of the next new frame */
+    uint8_t  failed;             /* a frame ran out of retries */
+    uint8_t  rx_base;            /* next SEQ to deliver */
+    uint8_t  rx_nacked_to;       /* holes below this SEQ were already NACKed */
+    frame_arq_tx_slot_t tx[FRAME_ARQ_MAX_WINDOW];
+    frame_arq_rx_slot_t rx[FRAME_ARQ_MAX_WINDOW];
+
+    frame_arq_counters_t stats;
+} frame_arq_t;
+
+/*
+ * Initialise both ends of a link from cfg (copied). Returns FRAME_OK,
+ * FRAME_ERR_NULL_ARG if a, cfg, a hook, or rx_store (window > 1) is NULL,
+ * FRAME_ERR_OVERSIZE if the window is not a power of two in
+ * 1..FRAME_ARQ_MAX_WINDOW, or FRAME_ERR_BAD_MODE for an unknown mode.
+ */
+frame_err_t frame_arq_init(frame_arq_t *a, const frame_arq_config_t *cfg);
+
+/*
+ * Send one sequenced frame. Returns FRAME_OK, an encoder error,
+ * FRAME_ERR_BUF_SMALL if the window is full or the transport write failed
+ * (nothing sent, SEQ not consumed), FRAME_ERR_BAD_TYPE for ACK/NACK (the
+ * link sends those itself), or FRAME_ERR_LINK_DOWN once the link has failed
+ * (see frame_arq_tick()).
+ */
+frame_err_t frame_arq_send(frame_arq_t *a, frame_type_t type,
+                           const uint8_t *payload, size_t len);
+
+/*
+ * Hand over a decoded frame from the peer (call from the decoder's rx_cb).
+ * ACK/NACK drive the sender; anything else is sequenced data for the
+ * receiver. Returns how many frames this acknowledged (ACK) or delivered
+ * (data), else 0.
+ */
+int frame_arq_on_frame(frame_arq_t *a, uint8_t seq, frame_type_t type,
+                       const uint8_t *payload, size_t len);
+
+/*
+ * Per-frame retransmit timers: call regularly. Returns the number of frames
+ * retransmitted, or -1 once a frame has used all its attempts. The link is
+ * then failed: send() refuses new frames until frame_arq_init() again.
+ */
+int frame_arq_tick(frame_arq_t *a);
+
+/* Frames sent and not yet acknowledged. */
+size_t frame_arq_in_flight(const frame_arq_t *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_FRAMING_FRAME_ARQ_H */
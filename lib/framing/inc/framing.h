@@ -27,6 +27,20 @@ extern "C" {
  * Both encoder and decoder are pure functions / pure state machines. They do
  * not touch any peripheral and therefore work identically on the host (for
  * unit tests and `tools/ota_send.py`) and on the target.
+ *
+ * COBS modes (frame_mode_t) keep the same body and CRC but replace the
+ * byte-stuffing with Consistent Overhead Byte Stuffing, delimited by 0x00:
+ *
+ *   [0x00] COBS([SEQ][TYPE][LEN_lo][LEN_hi][PAYLOAD][CRC_lo][CRC_hi]) [0x00]
+ *
+ * COBS splits the body at its zero bytes into blocks of at most 254
+ * non-zero bytes, each led by a code byte (block length + 1; 0xFF for a
+ * full block not ended by a zero). The overhead is at most one byte per 254
+ * whatever the payload, where stuffing costs nothing on clean data but
+ * doubles a payload of FLAG/ESC bytes. COBS-R also saves the final code
+ * byte when the body's last byte can stand in for it (and then cannot
+ * detect a frame cut short at a block boundary; the CRC still does).
+ * Both ends of a link must use the same mode; HDLC is the default.
  */
 
 #define FRAME_FLAG               0x7Eu
@@ -47,6 +61,26 @@ extern "C" {
 #define FRAME_MAX_ENCODED_SIZE                                                \
     (2u + 2u * (FRAME_FIXED_OVERHEAD + FRAME_MAX_PAYLOAD))
 
+/*
+ * Worst-case encoded size in a COBS mode: one code byte per started 254
+ * bytes of body, plus the two delimiters.
+ *
+ *   2 (delimiters) + body + ceil(body / 254),  body = FRAME_FIXED_OVERHEAD + payload_len
+ */
+#define FRAME_COBS_DELIM         0x00u
+#define FRAME_COBS_BLOCK_MAX     254u
+#define FRAME_COBS_MAX_ENCODED_SIZE                                           \
+    (2u + (FRAME_FIXED_OVERHEAD + FRAME_MAX_PAYLOAD) +                        \
+     (FRAME_FIXED_OVERHEAD + FRAME_MAX_PAYLOAD + FRAME_COBS_BLOCK_MAX - 1u) / \
+     FRAME_COBS_BLOCK_MAX)
+
+typedef enum {
+    FRAME_MODE_HDLC      = 0,   /* FLAG-delimited, byte-stuffed (default) */
+    FRAME_MODE_COBS      = 1,   /* 0x00-delimited, COBS-encoded */
+    FRAME_MODE_COBSR     = 2,   /* COBS/R: COBS, final code byte folded */
+    FRAME_MODE__MAX      = 2,   /* highest valid value, inclusive */
+} frame_mode_t;
+
 typedef enum {
     FRAME_OK             =  0,
     FRAME_ERR_NULL_ARG   = -1,
@@ -55,6 +89,8 @@ typedef enum {
     FRAME_ERR_BAD_TYPE   = -4,
     FRAME_ERR_CRC        = -5,  /* decoder: CRC mismatch (frame dropped) */
     FRAME_ERR_TRUNC      = -6,  /* decoder: frame ended before LEN bytes consumed */
+    FRAME_ERR_LINK_DOWN  = -7,  /* frame_arq/agg: a frame ran out of retries */
+    FRAME_ERR_BAD_MODE   = -8,  /* not a frame_mode_t */
 } frame_err_t;
 
 typedef enum {
@@ -67,16 +103,72 @@ typedef enum {
     FRAME_TYPE_PING       = 6,
     FRAME_TYPE_PONG       = 7,
     FRAME_TYPE_STATUS     = 8,
-    FRAME_TYPE__MAX       = 8,  /* highest valid value, inclusive */
+    FRAME_TYPE_CAPTURE    = 9,  /* modem_sim I/Q snapshot (header, then samples) */
+    FRAME_TYPE_AGG        = 10, /* packed sub-messages (frame_agg.h) */
+    FRAME_TYPE_CHAN       = 11, /* lib/link channel message: [CH][payload] */
+    FRAME_TYPE__MAX       = 11, /* highest valid value, inclusive */
 } frame_type_t;
 
 /*
  * CRC-16-CCITT, poly 0x1021, init 0xFFFF, no final XOR.
  * Software-only; the STM32F4 hardware CRC engine implements CRC-32 with a
  * fixed polynomial and cannot accelerate this.
+ *
+ * Four engines compute the same CRC (check value 0x29B1 over "123456789");
+ * they trade flash for speed:
+ *
+ *   FRAME_CRC16_BITWISE  8 shift/XOR steps per byte, no table
+ *   FRAME_CRC16_NIBBLE   two lookups per byte, 32-byte table
+ *   FRAME_CRC16_TABLE    one lookup per byte, 512-byte table
+ *   FRAME_CRC16_SLICE4   four bytes per step, 2 KB of tables
+ *
+ * FRAME_CRC16_ENGINE picks the one behind frame_crc16_update() (and so the
+ * encoder and decoder) at compile time; lib/framing/Makefile sets it from
+ * FRAME_CRC=bitwise|nibble|table|slice4. Nibble is the default: it runs
+ * several times faster than bitwise for 32 bytes, which even the 16 KB
+ * bootloader can afford. Every engine is also callable by name (tests,
+ * benchmarks); each table is its own data section, so --gc-sections drops
+ * the tables of engines nothing calls.
  */
+#define FRAME_CRC16_BITWISE      0
+#define FRAME_CRC16_NIBBLE       1
+#define FRAME_CRC16_TABLE        2
+#define FRAME_CRC16_SLICE4       3
+
+#ifndef FRAME_CRC16_ENGINE
+#define FRAME_CRC16_ENGINE       FRAME_CRC16_NIBBLE
+#endif
+
+#define FRAME_CRC16_INIT         0xFFFFu
+#define FRAME_CRC16_CHECK        0x29B1u   /* CRC of "123456789" */
+
+/* One-shot CRC of buf[0..len): frame_crc16_update(FRAME_CRC16_INIT, ...). */
 uint16_t frame_crc16(const uint8_t *buf, size_t len);
 
+/*
+ * Incremental CRC: feed the result back in to continue across buffers. Start
+ * from FRAME_CRC16_INIT; the value after the last buffer is the CRC (no
+ * final XOR). A NULL buf leaves crc unchanged.
+ */
+uint16_t frame_crc16_update(uint16_t crc, const uint8_t *buf, size_t len);
+
+/*
+ * FRAME_CRC16_ENGINE as the library was built. Code outside lib/framing sees
+ * only the header default, not the FRAME_CRC the library was compiled with.
+ */
+unsigned frame_crc16_engine(void);
+
+/* The individual engines behind frame_crc16_update(), same contract. */
+uint16_t frame_crc16_update_bitwise(uint16_t crc, const uint8_t *buf, size_t len);
+uint16_t frame_crc16_update_nibble(uint16_t crc, const uint8_t *buf, size_t len);
+uint16_t frame_crc16_update_table(uint16_t crc, const uint8_t *buf, size_t len);
+uint16_t frame_crc16_update_slice4(uint16_t crc, const uint8_t *buf, size_t len);
+
+/* Engine tables in flash (src/crc16_tables.c, tables/gen_crc16_tables.py). */
+extern const uint16_t frame_crc16_nibble_table[16];
+extern const uint16_t frame_crc16_table[256];
+extern const uint16_t frame_crc16_slice_table[3][256];
+
 /*
  * Encode (seq, type, payload[0..payload_len)) into out_buf using HDLC-style
  * framing with byte-stuffing and CRC-16-CCITT. Returns the number of bytes
@@ -92,6 +184,115 @@ int frame_encode(uint8_t seq, frame_type_t type,
                  const uint8_t *payload, size_t payload_len,
                  uint8_t *out_buf, size_t out_cap);
 
+/*
+ * frame_encode() in the given mode. An invalid mode is FRAME_ERR_BAD_MODE;
+ * out_cap must cover frame_encoded_max(mode, payload_len).
+ */
+int frame_encode_mode(frame_mode_t mode, uint8_t seq, frame_type_t type,
+                      const uint8_t *payload, size_t payload_len,
+                      uint8_t *out_buf, size_t out_cap);
+
+/* Worst-case encoded size of a payload_len-byte frame (0 for a bad mode). */
+size_t frame_encoded_max(frame_mode_t mode, size_t payload_len);
+
+/* ------------------------------------------------------------------------
+ * Streaming encoder (scatter/gather)
+ *
+ * Same wire bytes as frame_encode(), without a contiguous payload or a
+ * worst-case output buffer. The payload is a list of fragments (e.g. an
+ * application header and a data block) read in place; the encoder emits
+ * the stuffed frame a piece at a time into whatever room the caller has: a
+ * few bytes of ring, or the free half of a DMA TX buffer.
+ *
+ *     frame_encoder_t e;
+ *     frame_encoder_begin(&e, seq, FRAME_TYPE_DATA, iov, 2);
+ *     while (!frame_encoder_done(&e)) {
+ *         size_t n = frame_encoder_pull(&e, chunk, sizeof(chunk));
+ *         transport_write(chunk, n);
+ *     }
+ *
+ * The CRC is accumulated as the payload goes out, so every fragment is read
+ * exactly once. The fragments must stay valid and unchanged until the last
+ * pull.
+ * ------------------------------------------------------------------------ */
+
+typedef struct {
+    const uint8_t *base;
+    size_t         len;
+} frame_iov_t;
+
+/* A position in the frame body (head, payload fragment, tail): COBS only. */
+typedef struct {
+    size_t   iov_idx;
+    size_t   iov_off;
+    uint8_t  part;             /* head, payload, tail, end */
+    uint8_t  idx;              /* next byte within head/tail */
+} frame_enc_pos_t;
+
+typedef struct frame_encoder {
+    /*
+     * Internal state. Treat as opaque from outside the module — exposed only
+     * so callers can stack-allocate the struct.
+     */
+    const frame_iov_t *iov;
+    size_t   iov_cnt;
+    size_t   iov_idx;          /* fragment being emitted */
+    size_t   iov_off;          /* next byte within it */
+    uint8_t  head[4];          /* [SEQ][TYPE][LEN_lo][LEN_hi] */
+    uint8_t  tail[2];          /* [CRC_lo][CRC_hi], filled after the payload */
+    uint16_t crc;
+    uint8_t  phase;            /* opening FLAG, head, payload, tail, closing FLAG, done */
+    uint8_t  idx;              /* next byte within head/tail */
+    uint8_t  pending;          /* second half of an ESC pair that did not fit */
+    uint8_t  has_pending;
+    uint8_t  mode;             /* frame_mode_t */
+
+    /*
+     * COBS: `scan` looks ahead to size each block (and folds the CRC),
+     * `at` follows it emitting the block's bytes. cobs_pull is NULL for
+     * HDLC, so images that never select a mode link no COBS code.
+     */
+    size_t (*cobs_pull)(struct frame_encoder *e, uint8_t *out, size_t cap);
+    frame_enc_pos_t at;
+    frame_enc_pos_t scan;
+    uint8_t  blk_left;         /* block bytes still to emit */
+    uint8_t  blk_skip;         /* body bytes after them not sent as data */
+    uint8_t  blk_zero;         /* the block ends at a zero */
+} frame_encoder_t;
+
+/*
+ * Start encoding (seq, type, iov[0..iov_cnt)) as one frame; the payload is
+ * the concatenation of the fragments. Zero-length fragments are allowed.
+ *
+ * Failure modes:
+ *   - NULL e, NULL iov with iov_cnt > 0, or a NULL fragment
+ *     base with len > 0                                   -> FRAME_ERR_NULL_ARG
+ *   - total payload > FRAME_MAX_PAYLOAD                   -> FRAME_ERR_OVERSIZE
+ *   - type > FRAME_TYPE__MAX                              -> FRAME_ERR_BAD_TYPE
+ * On failure the encoder is left done, so pull() emits nothing.
+ */
+frame_err_t frame_encoder_begin(frame_encoder_t *e, uint8_t seq, frame_type_t type,
+                                const frame_iov_t *iov, size_t iov_cnt);
+
+/* frame_encoder_begin() in the given mode (FRAME_ERR_BAD_MODE if invalid). */
+frame_err_t frame_encoder_begin_mode(frame_encoder_t *e, frame_mode_t mode,
+                                     uint8_t seq, frame_type_t type,
+                                     const frame_iov_t *iov, size_t iov_cnt);
+
+/*
+ * Emit up to cap more bytes of the frame into out and return how many were
+ * written (0 once the frame is complete). Any cap works, 1 included: an ESC
+ * pair split by the end of out is finished on the next call.
+ *
+ * In a COBS mode each code byte needs the length of its block, so the
+ * encoder reads up to 254 body bytes ahead of what it has emitted; the
+ * payload is still read in place and folded into the CRC once.
+ */
+size_t frame_encoder_pull(frame_encoder_t *e, uint8_t *out, size_t cap);
+
+/* 1 once the closing FLAG has been emitted (or begin() failed), else 0. */
+int frame_encoder_done(const frame_encoder_t *e);
+
 /*
  * Stateful decoder. The caller hands the decoder an external payload buffer at
  * init time; the decoder reassembles each frame in place there. Whenever a
@@ -108,7 +309,7 @@ typedef void (*frame_rx_cb_t)(uint8_t seq, frame_type_t type,
 
 typedef void (*frame_err_cb_t)(frame_err_t err, void *user);
 
-typedef struct {
+typedef struct frame_decoder {
     /* Caller-owned callbacks + opaque user pointer. err_cb may be NULL. */
     frame_rx_cb_t  rx_cb;
     frame_err_cb_t err_cb;
@@ -130,6 +331,8 @@ typedef struct {
     uint8_t  type;
     uint16_t declared_len;
     uint16_t payload_idx;
+    uint16_t crc;              /* running CRC: header + payload_buf[0..crc_done) */
+    uint16_t crc_done;
     uint8_t  crc_bytes[2];
     uint8_t  crc_idx;
     uint8_t  field_idx;        /* 0..4 for header bytes */
@@ -137,6 +340,12 @@ typedef struct {
     uint8_t  in_frame;         /* 0 = idle, 1 = inside FLAG..FLAG */
     uint8_t  in_escape;        /* last byte was ESC, next is XORed */
     uint8_t  dropping;         /* current frame is poisoned, drop until FLAG */
+
+    uint8_t  mode;             /* frame_mode_t; cobs_feed NULL for HDLC */
+    void   (*cobs_feed)(struct frame_decoder *d, const uint8_t *bytes, size_t n);
+    uint8_t  cobs_code;        /* code byte of the current COBS block */
+    uint8_t  cobs_left;        /* data bytes still due in it */
+    uint8_t  cobs_zero;        /* a zero follows it (code < 0xFF) */
 } frame_decoder_t;
 
 /*
@@ -161,6 +370,12 @@ frame_err_t frame_decoder_init(frame_decoder_t *d,
 /* Reset the decoder back to idle without changing its callbacks/buffer. */
 void frame_decoder_reset(frame_decoder_t *d);
 
+/*
+ * Switch the decoder to another frame_mode_t (init() selects HDLC) and
+ * reset it. Returns FRAME_OK, FRAME_ERR_NULL_ARG or FRAME_ERR_BAD_MODE.
+ */
+frame_err_t frame_decoder_set_mode(frame_decoder_t *d, frame_mode_t mode);
+
 /* Feed n bytes into the decoder. Callbacks may fire during this call. */
 void frame_decoder_feed(frame_decoder_t *d, const uint8_t *bytes, size_t n);
 
@@ -174,11 +389,37 @@ void frame_decoder_feed(frame_decoder_t *d, const uint8_t *bytes, size_t n);
  *  - duplicate SEQ on receive -> drop payload, ACK anyway (idempotent)
  *  - bad CRC on receive       -> NACK with last good SEQ
  *
+ * The timeout adapts to the link (Jacobson/Karels, as in TCP): every ACK
+ * for a frame sent exactly once is an RTT sample feeding a smoothed RTT
+ * (gain 1/8) and a mean deviation (gain 1/4), and the retransmit timeout
+ * (RTO) is SRTT + 4 * RTTVAR, clamped to [FRAME_LINK_RTO_MIN_MS,
+ * FRAME_LINK_RTO_MAX_MS]. ACKs for retransmitted frames are ambiguous and
+ * not sampled (Karn's rule). Each timeout doubles the RTO (exponential
+ * backoff) until the next valid sample. The timeout_ms passed to
+ * frame_link_init() is the RTO until the first sample.
+ *
  * The link is transport-agnostic: the caller supplies a write callback that
  * pushes encoded bytes onto whatever transport (UART/SPI/socket) is in use,
  * plus a monotonic millisecond clock.
+ *
+ * The link keeps no copy of the payload and no encoded frame: each
+ * (re)transmission runs the streaming encoder over the caller's fragments
+ * into a FRAME_LINK_TX_CHUNK stack buffer, so one frame reaches write() as
+ * several calls of at most that many bytes. The payload must therefore
+ * stay valid and unchanged until the send resolves (ACK, or failure).
  * ------------------------------------------------------------------------ */
 
+#define FRAME_LINK_TX_CHUNK      32u   /* bytes per write() call */
+#define FRAME_LINK_MAX_IOV       4u    /* fragments per frame_link_sendv() */
+
+/* Adaptive RTO bounds in ms; override with -D for unusual transports. */
+#ifndef FRAME_LINK_RTO_MIN_MS
+#define FRAME_LINK_RTO_MIN_MS    20u
+#endif
+#ifndef FRAME_LINK_RTO_MAX_MS
+#define FRAME_LINK_RTO_MAX_MS    10000u
+#endif
+
 typedef int (*frame_link_write_cb_t)(const uint8_t *bytes, size_t n, void *user);
 typedef uint32_t (*frame_link_now_ms_cb_t)(void *user);
 
@@ -187,6 +428,25 @@ typedef enum {
     FRAME_LINK_AWAITING_ACK = 1,
 } frame_link_state_t;
 
+/* Link statistics, from frame_link_get_stats(). Times in ms. */
+typedef struct {
+    uint32_t tx_frames;      /* sends accepted */
+    uint32_t retransmits;    /* on NACK or timeout */
+    uint32_t timeouts;       /* RTO expiries */
+    uint32_t failures;       /* sends that ran out of retries */
+    uint32_t rx_duplicates;  /* dropped by frame_link_on_rx() */
+    uint32_t crc_errors;     /* reported via frame_link_on_rx_error() */
+    uint32_t rx_errors;      /* other decoder errors reported there */
+
+    uint32_t rtt_samples;    /* ACKs that passed Karn's rule */
+    uint32_t rtt_min_ms;     /* 0 until the first sample */
+    uint32_t rtt_avg_ms;
+    uint32_t rtt_max_ms;
+    uint32_t srtt_ms;        /* smoothed RTT */
+    uint32_t rttvar_ms;      /* smoothed mean deviation */
+    uint32_t rto_ms;         /* timeout the next (re)transmission gets */
+} frame_link_stats_t;
+
 typedef struct {
     /* Transport hooks. */
     frame_link_write_cb_t  write;
@@ -194,8 +454,16 @@ typedef struct {
     void                  *user;
 
     /* Tunables. */
-    uint32_t timeout_ms;     /* how long to wait for ACK before retransmit */
+    uint32_t timeout_ms;     /* initial RTO, until the first RTT sample */
     uint8_t  max_retries;    /* total send attempts = 1 + max_retries */
+    uint8_t  mode;           /* frame_mode_t of every frame sent */
+
+    /* RTT estimator (BSD fixed point: srtt x8, rttvar x4). */
+    uint32_t srtt8;
+    uint32_t rttvar4;
+    uint32_t rto_ms;         /* before backoff */
+    uint8_t  backoff;        /* RTO doublings since the last sample */
+    uint8_t  have_rtt;
 
     /* Sender state. */
     frame_link_state_t state;
@@ -204,19 +472,22 @@ typedef struct {
     uint8_t  attempts;
     uint8_t  pending_type;
     uint16_t pending_len;
-    uint8_t  pending_payload[FRAME_MAX_PAYLOAD];
-    uint8_t  encoded[FRAME_MAX_ENCODED_SIZE];
-    size_t   encoded_len;
+    uint8_t  pending_iov_cnt;
+    frame_iov_t pending_iov[FRAME_LINK_MAX_IOV];   /* caller's payload, in place */
 
     /* Receiver state (for duplicate suppression / NACK building). */
     uint8_t  rx_have_last;
     uint8_t  rx_last_seq;
+
+    /* Counters; the RTT fields are filled in by frame_link_get_stats(). */
+    frame_link_stats_t stats;
+    uint64_t rtt_sum_ms;
 } frame_link_t;
 
 /*
  * Initialise a link with the given transport hooks and tunables. Sets the
  * initial sender SEQ to 0; the decoder side has no SEQ until the first frame
- * arrives.
+ * arrives. timeout_ms is the RTO until the link has measured an RTT.
  */
 frame_err_t frame_link_init(frame_link_t *link,
                             frame_link_write_cb_t write_cb,
@@ -225,6 +496,13 @@ frame_err_t frame_link_init(frame_link_t *link,
                             uint32_t timeout_ms,
                             uint8_t max_retries);
 
+/*
+ * Frame the link's transmissions in another frame_mode_t (init() selects
+ * HDLC), from the next (re)transmission on; the peer's decoder must use the
+ * same mode. Returns FRAME_OK, FRAME_ERR_NULL_ARG or FRAME_ERR_BAD_MODE.
+ */
+frame_err_t frame_link_set_mode(frame_link_t *link, frame_mode_t mode);
+
 /*
  * Send a DATA frame and start the ARQ window. Returns FRAME_OK on success,
  * an encoder error otherwise. Caller must drive frame_link_tick() periodically
@@ -232,11 +510,21 @@ frame_err_t frame_link_init(frame_link_t *link,
  *
  * Returns FRAME_ERR_BUF_SMALL if a previous send is still awaiting ACK — the
  * sliding window of 1 means the caller must wait for that send to resolve.
+ * The payload is referenced, not copied, until then.
  */
 frame_err_t frame_link_send(frame_link_t *link,
                             frame_type_t type,
                             const uint8_t *payload, size_t payload_len);
 
+/*
+ * frame_link_send() with the payload given as up to FRAME_LINK_MAX_IOV
+ * fragments (FRAME_ERR_OVERSIZE beyond that). The iov array itself is
+ * copied; the bytes it points at are not.
+ */
+frame_err_t frame_link_sendv(frame_link_t *link,
+                             frame_type_t type,
+                             const frame_iov_t *iov, size_t iov_cnt);
+
 /*
  * Notify the link that an ACK was received for `seq`. If it matches the
  * pending SEQ, the link advances to IDLE. Mismatched ACKs are ignored.
@@ -252,13 +540,22 @@ int frame_link_on_ack(frame_link_t *link, uint8_t seq);
 int frame_link_on_nack(frame_link_t *link, uint8_t seq);
 
 /*
- * Periodic timer: call this regularly to honour the ACK timeout. Returns:
+ * Periodic timer: call this regularly to honour the RTO. A timeout doubles
+ * the RTO for the retransmission. Returns:
  *   1 if a retransmit was just issued
  *   0 if there was nothing to do (idle or still within timeout)
  *  -1 if the send has now permanently failed (max_retries exhausted)
  */
 int frame_link_tick(frame_link_t *link);
 
+/*
+ * Give up on the current SEQ, whether its frame failed or still awaits an
+ * ACK: the link goes idle and the next send uses SEQ + 1, so a peer that
+ * did receive the abandoned frame does not drop the next one as a
+ * duplicate.
+ */
+void frame_link_abandon(frame_link_t *link);
+
 /*
  * Receive helper. Call this from the decoder's rx_cb to apply duplicate
  * suppression: returns 1 if the frame is fresh and should be processed,
@@ -266,6 +563,22 @@ int frame_link_tick(frame_link_t *link);
  */
 int frame_link_on_rx(frame_link_t *link, uint8_t seq);
 
+/*
+ * Count a receive-side decoder error in the link statistics: call from the
+ * decoder's err_cb. FRAME_ERR_CRC is counted as a CRC error, anything else
+ * as another receive error.
+ */
+void frame_link_on_rx_error(frame_link_t *link, frame_err_t err);
+
+/*
+ * Snapshot the link statistics, including the current RTT estimate and
+ * RTO. Returns FRAME_OK or FRAME_ERR_NULL_ARG.
+ */
+frame_err_t frame_link_get_stats(const frame_link_t *link, frame_link_stats_t *out);
+
+/* Zero the counters and RTT min/avg/max; the RTT estimate is kept. */
+void frame_link_reset_stats(frame_link_t *link);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,112 @@
+#include "framing.h"
+
+/* ------------------------------------------------------------------------
+ * CRC-16-CCITT (a.k.a. CRC-16/IBM-3740, "CCITT-FALSE")
+ *   poly = 0x1021, init = 0xFFFF, refin = refout = false, xorout = 0x0000
+ *   reference vector: crc16("123456789") == 0x29B1
+ *
+ * The register is MSB first, so each byte enters at the top: the table
+ * engines index by the high bits of (crc ^ byte << 8) and shift the rest up.
+ * Bitwise is 8 conditional steps per byte; the tables cut that to 2, 1 and
+ * 1/4 lookups per byte. `modem bench` (target) and `make bench` in
+ * tests/lib/framing (host) time each engine.
+ * ------------------------------------------------------------------------ */
+
+#if FRAME_CRC16_ENGINE < FRAME_CRC16_BITWISE || FRAME_CRC16_ENGINE > FRAME_CRC16_SLICE4
+#error "FRAME_CRC16_ENGINE must be one of the FRAME_CRC16_* engines"
+#endif
+
+uint16_t frame_crc16_update_bitwise(uint16_t crc, const uint8_t *buf, size_t len)
+{
+    if (buf == NULL) {
+        return crc;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= ((uint16_t)buf[i]) << 8;
+        for (int b = 0; b < 8; ++b) {
+            if (crc & 0x8000u) {
+                crc = (uint16_t)((crc << 1) ^ 0x1021u);
+            } else {
+                crc = (uint16_t)(crc << 1);
+            }
+        }
+    }
+    return crc;
+}
+
+uint16_t frame_crc16_update_nibble(uint16_t crc, const uint8_t *buf, size_t len)
+{
+    if (buf == NULL) {
+        return crc;
+    }
+    const uint16_t *t = frame_crc16_nibble_table;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t b = buf[i];
+        crc = (uint16_t)((crc << 4) ^ t[(crc >> 12) ^ (b >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ t[(crc >> 12) ^ (b & 0x0Fu)]);
+    }
+    return crc;
+}
+
+uint16_t frame_crc16_update_table(uint16_t crc, const uint8_t *buf, size_t len)
+{
+    if (buf == NULL) {
+        return crc;
+    }
+    const uint16_t *t = frame_crc16_table;
+    for (size_t i = 0; i < len; ++i) {
+        crc = (uint16_t)((crc << 8) ^ t[(crc >> 8) ^ buf[i]]);
+    }
+    return crc;
+}
+
+/*
+ * Four bytes per step. The register's two bytes fold into the first two
+ * input bytes; each of the four is then looked up in the table that carries
+ * it past the bytes still to come (T3 for the oldest, T0 for the newest),
+ * and the four partial remainders XOR together. Byte loads only, so buf
+ * needs no alignment; the tail runs through the byte table.
+ */
+uint16_t frame_crc16_update_slice4(uint16_t crc, const uint8_t *buf, size_t len)
+{
+    if (buf == NULL) {
+        return crc;
+    }
+    const uint16_t *t0 = frame_crc16_table;
+    const uint16_t *t1 = frame_crc16_slice_table[0];
+    const uint16_t *t2 = frame_crc16_slice_table[1];
+    const uint16_t *t3 = frame_crc16_slice_table[2];
+    while (len >= 4u) {
+        crc = (uint16_t)(t3[(crc >> 8) ^ buf[0]] ^ t2[(crc & 0xFFu) ^ buf[1]] ^
+                         t1[buf[2]] ^ t0[buf[3]]);
+        buf += 4;
+        len -= 4u;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        crc = (uint16_t)((crc << 8) ^ t0[(crc >> 8) ^ buf[i]]);
+    }
+    return crc;
+}
+
+uint16_t frame_crc16_update(uint16_t crc, const uint8_t *buf, size_t len)
+{
+#if FRAME_CRC16_ENGINE == FRAME_CRC16_BITWISE
+    return frame_crc16_update_bitwise(crc, buf, len);
+#elif FRAME_CRC16_ENGINE == FRAME_CRC16_NIBBLE
+    return frame_crc16_update_nibble(crc, buf, len);
+#elif FRAME_CRC16_ENGINE == FRAME_CRC16_TABLE
+    return frame_crc16_update_table(crc, buf, len);
+#else
+    return frame_crc16_update_slice4(crc, buf, len);
+#endif
+}
+
+unsigned frame_crc16_engine(void)
+{
+    return FRAME_CRC16_ENGINE;
+}
+
+uint16_t frame_crc16(const uint8_t *buf, size_t len)
+{
+    return frame_crc16_update(FRAME_CRC16_INIT, buf, len);
+}
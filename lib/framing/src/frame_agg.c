@@ -0,0 +1,226 @@
+#include "frame_agg.h"
+
+#include <string.h>
+
+static inline uint8_t *agg_buf(const frame_agg_t *g, uint8_t b)
+{
+    return &g->cfg.store[(size_t)b * g->cfg.frame_max];
+}
+
+/* Sub-message types: anything sequenced, but no link control or nesting. */
+static int agg_sub_type_ok(unsigned type)
+{
+    return type <= (unsigned)FRAME_TYPE__MAX && type != FRAME_TYPE_ACK &&
+           type != FRAME_TYPE_NACK && type != FRAME_TYPE_AGG;
+}
+
+/* No room left for another non-empty sub-message. */
+static int agg_full(const frame_agg_t *g)
+{
+    return (size_t)g->len[g->open] + FRAME_AGG_SUB_OVERHEAD >= g->cfg.frame_max;
+}
+
+/* Hand buffer b to the link: one AGG frame, or a lone message as itself. */
+static frame_err_t agg_transmit(frame_agg_t *g, uint8_t b)
+{
+    const uint8_t *p = agg_buf(g, b);
+    if (g->count[b] == 1u) {
+        return frame_link_send(g->cfg.link, (frame_type_t)p[0],
+                               &p[FRAME_AGG_SUB_OVERHEAD],
+                               (size_t)g->len[b] - FRAME_AGG_SUB_OVERHEAD);
+    }
+    return frame_link_send(g->cfg.link, FRAME_TYPE_AGG, p, g->len[b]);
+}
+
+/*
+ * Whether the link can take the open buffer now. An idle link that has not
+ * moved past the SEQ of our last frame gave up on it (out of retries, on a
+ * timeout or a NACK): that frame goes out again first, from the other
+ * buffer, which is kept until then. Once max_resends are used up the
+ * aggregator is failed until frame_agg_drop().
+ */
+static int agg_link_ready(frame_agg_t *g)
+{
+    const frame_link_t *link = g->cfg.link;
+    if (g->failed || link->state != FRAME_LINK_IDLE) {
+        return 0;
+    }
+    if (g->in_flight && link->tx_seq == g->in_flight_seq) {
+        if (g->resends_left == 0u) {
+            g->failed = 1;
+        } else if (agg_transmit(g, (uint8_t)(g->open ^ 1u)) == FRAME_OK) {
+            g->resends_left--;
+            g->stats.resends++;
+        }
+        return 0;
+    }
+    g->in_flight = 0;
+    return 1;
+}
+
+/* Send the open buffer and start filling the other one. */
+static frame_err_t agg_flush_open(frame_agg_t *g, uint32_t *reason)
+{
+    if (g->count[g->open] == 0u) {
+        return FRAME_OK;
+    }
+    if (!agg_link_ready(g)) {
+        return g->failed ? FRAME_ERR_LINK_DOWN : FRAME_ERR_BUF_SMALL;
+    }
+    frame_err_t rc = agg_transmit(g, g->open);
+    if (rc != FRAME_OK) {
+        return rc;
+    }
+    g->in_flight     = 1;
+    g->in_flight_seq = g->cfg.link->tx_seq;
+    g->resends_left  = g->cfg.max_resends;
+    g->open = (uint8_t)(g->open ^ 1u);
+    g->len[g->open]   = 0;
+    g->count[g->open] = 0;
+    g->stats.frames++;
+    (*reason)++;
+    return FRAME_OK;
+}
+
+/* ------------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------------ */
+
+frame_err_t frame_agg_init(frame_agg_t *g, const frame_agg_config_t *cfg)
+{
+    if (g == NULL || cfg == NULL || cfg->link == NULL || cfg->store == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (cfg->frame_max <= FRAME_AGG_SUB_OVERHEAD || cfg->frame_max > FRAME_MAX_PAYLOAD) {
+        return FRAME_ERR_OVERSIZE;
+    }
+    memset(g, 0, sizeof(*g));
+    g->cfg = *cfg;
+    return FRAME_OK;
+}
+
+frame_err_t frame_agg_send(frame_agg_t *g, frame_type_t type,
+                           const uint8_t *payload, size_t len)
+{
+    if (g == NULL || (payload == NULL && len > 0)) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (g->failed) {
+        return FRAME_ERR_LINK_DOWN;
+    }
+    if (!agg_sub_type_ok((unsigned)type)) {
+        return FRAME_ERR_BAD_TYPE;
+    }
+    if (len > (size_t)g->cfg.frame_max - FRAME_AGG_SUB_OVERHEAD) {
+        return FRAME_ERR_OVERSIZE;
+    }
+    if ((size_t)g->len[g->open] + FRAME_AGG_SUB_OVERHEAD + len > g->cfg.frame_max &&
+        agg_flush_open(g, &g->stats.flush_full) != FRAME_OK) {
+        return g->failed ? FRAME_ERR_LINK_DOWN : FRAME_ERR_BUF_SMALL;
+    }
+
+    uint8_t *p = &agg_buf(g, g->open)[g->len[g->open]];
+    p[0] = (uint8_t)type;
+    p[1] = (uint8_t)(len & 0xFFu);
+    p[2] = (uint8_t)((len >> 8) & 0xFFu);
+    if (len > 0) {
+        memcpy(&p[FRAME_AGG_SUB_OVERHEAD], payload, len);
+    }
+    if (g->count[g->open] == 0u) {
+        g->first_ms = g->cfg.link->now_ms(g->cfg.link->user);
+    }
+    g->len[g->open]   = (uint16_t)(g->len[g->open] + FRAME_AGG_SUB_OVERHEAD + len);
+    g->count[g->open] = (uint16_t)(g->count[g->open] + 1u);
+    g->stats.messages++;
+
+    if (agg_full(g)) {
+        (void)agg_flush_open(g, &g->stats.flush_full);
+    }
+    return FRAME_OK;
+}
+
+int frame_agg_tick(frame_agg_t *g)
+{
+    if (g == NULL) {
+        return 0;
+    }
+    const int r = frame_link_tick(g->cfg.link);
+    const int ready = agg_link_ready(g);
+    if (g->failed) {
+        return FRAME_ERR_LINK_DOWN;
+    }
+    if (!ready || g->count[g->open] == 0u) {
+        return r;
+    }
+    const uint32_t now = g->cfg.link->now_ms(g->cfg.link->user);
+    if (agg_full(g)) {
+        (void)agg_flush_open(g, &g->stats.flush_full);
+    } else if ((uint32_t)(now - g->first_ms) >= g->cfg.max_delay_ms) {
+        (void)agg_flush_open(g, &g->stats.flush_deadline);
+    }
+    return r;
+}
+
+frame_err_t frame_agg_flush(frame_agg_t *g)
+{
+    if (g == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    return agg_flush_open(g, &g->stats.flush_deadline);
+}
+
+size_t frame_agg_drop(frame_agg_t *g)
+{
+    if (g == NULL || !g->failed) {
+        return 0;
+    }
+    const uint8_t b = (uint8_t)(g->open ^ 1u);
+    const size_t  n = g->count[b];
+    g->len[b]   = 0;
+    g->count[b] = 0;
+    g->in_flight = 0;
+    g->failed    = 0;
+    frame_link_abandon(g->cfg.link);
+    g->stats.dropped += (uint32_t)n;
+    return n;
+}
+
+size_t frame_agg_pending(const frame_agg_t *g)
+{
+    return (g == NULL) ? 0u : (size_t)g->count[g->open];
+}
+
+int frame_agg_split(frame_type_t type, const uint8_t *payload, size_t len,
+                    frame_agg_deliver_cb_t deliver, void *user)
+{
+    if (deliver == NULL || (payload == NULL && len > 0)) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (type != FRAME_TYPE_AGG) {
+        deliver(type, payload, len, user);
+        return 1;
+    }
+
+    /* Check the whole frame first, so a bad one delivers nothing. */
+    int n = 0;
+    for (size_t off = 0; off < len; ++n) {
+        if (len - off < FRAME_AGG_SUB_OVERHEAD) {
+            return FRAME_ERR_TRUNC;
+        }
+        const size_t sub = (size_t)payload[off + 1u] | ((size_t)payload[off + 2u] << 8);
+        if (sub > len - off - FRAME_AGG_SUB_OVERHEAD) {
+            return FRAME_ERR_TRUNC;
+        }
+        if (!agg_sub_type_ok(payload[off])) {
+            return FRAME_ERR_BAD_TYPE;
+        }
+        off += FRAME_AGG_SUB_OVERHEAD + sub;
+    }
+
+    for (size_t off = 0; off < len;) {
+        const size_t sub = (size_t)payload[off + 1u] | ((size_t)payload[off + 2u] << 8);
+        deliver((frame_type_t)payload[off], &payload[off + FRAME_AGG_SUB_OVERHEAD], sub, user);
+        off += FRAME_AGG_SUB_OVERHEAD + sub;
+    }
+    return n;
+}
@@ -0,0 +1,282 @@
+#include "frame_arq.h"
+
+#include <string.h>
+
+/*
+ * SEQ arithmetic is modulo 256 throughout: (uint8_t)(a - b) is how far a is
+ * ahead of b. Both windows are at most FRAME_ARQ_MAX_WINDOW (<= 128) wide,
+ * so "ahead by less than window" is never ambiguous.
+ */
+#define SEQ_DIFF(a, b)  ((uint8_t)((uint8_t)(a) - (uint8_t)(b)))
+
+static inline size_t slot_of(const frame_arq_t *a, uint8_t seq)
+{
+    return (size_t)(seq & (uint8_t)(a->cfg.window - 1u));
+}
+
+/* ------------------------------------------------------------------------
+ * Transmit helpers
+ * ------------------------------------------------------------------------ */
+
+/*
+ * Stream one frame through a FRAME_LINK_TX_CHUNK stack buffer into the
+ * transport, as frame_link does. Returns 0, or -1 when a write() fails.
+ */
+static int arq_write_frame(frame_arq_t *a, uint8_t seq, frame_type_t type,
+                           const uint8_t *payload, size_t len)
+{
+    uint8_t chunk[FRAME_LINK_TX_CHUNK];
+    const frame_iov_t iov = { payload, len };
+    frame_encoder_t e;
+    if (frame_encoder_begin_mode(&e, (frame_mode_t)a->cfg.mode, seq, type,
+                                 &iov, 1) != FRAME_OK) {
+        return -1;
+    }
+    while (!frame_encoder_done(&e)) {
+        size_t n = frame_encoder_pull(&e, chunk, sizeof(chunk));
+        if (a->cfg.write(chunk, n, a->cfg.user) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ACK/NACK: no payload, so the whole frame fits a few bytes of stack. */
+static void arq_write_control(frame_arq_t *a, frame_type_t type, uint8_t seq)
+{
+    uint8_t buf[2u + 2u * FRAME_FIXED_OVERHEAD];
+    int n = frame_encode_mode((frame_mode_t)a->cfg.mode, seq, type, NULL, 0,
+                              buf, sizeof(buf));
+    if (n > 0) {
+        (void)a->cfg.write(buf, (size_t)n, a->cfg.user);
+    }
+}
+
+/*
+ * (Re)transmit the frame in flight at seq. A transport error still counts
+ * as an attempt, so a stuck transport cannot loop forever.
+ */
+static void arq_transmit(frame_arq_t *a, uint8_t seq)
+{
+    frame_arq_tx_slot_t *s = &a->tx[slot_of(a, seq)];
+    if (s->attempts > 0) {
+        a->stats.retransmits++;
+    }
+    (void)arq_write_frame(a, seq, (frame_type_t)s->type, s->payload, s->len);
+    s->attempts++;
+    s->sent_ms = a->cfg.now_ms(a->cfg.user);
+}
+
+/* ------------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------------ */
+
+frame_err_t frame_arq_init(frame_arq_t *a, const frame_arq_config_t *cfg)
+{
+    if (a == NULL || cfg == NULL || cfg->write == NULL ||
+        cfg->now_ms == NULL || cfg->deliver == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (cfg->window == 0u || cfg->window > FRAME_ARQ_MAX_WINDOW ||
+        (cfg->window & (cfg->window - 1u)) != 0u) {
+        return FRAME_ERR_OVERSIZE;
+    }
+    if (cfg->window > 1u && cfg->rx_store == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if ((unsigned)cfg->mode > (unsigned)FRAME_MODE__MAX) {
+        return FRAME_ERR_BAD_MODE;
+    }
+    memset(a, 0, sizeof(*a));
+    a->cfg = *cfg;
+    return FRAME_OK;
+}
+
+size_t frame_arq_in_flight(const frame_arq_t *a)
+{
+    return (a == NULL) ? 0u : (size_t)SEQ_DIFF(a->tx_next, a->tx_base);
+}
+
+frame_err_t frame_arq_send(frame_arq_t *a, frame_type_t type,
+                           const uint8_t *payload, size_t len)
+{
+    if (a == NULL || (payload == NULL && len > 0)) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (a->failed) {
+        return FRAME_ERR_LINK_DOWN;
+    }
+    if (type == FRAME_TYPE_ACK || type == FRAME_TYPE_NACK ||
+        (unsigned)type > (unsigned)FRAME_TYPE__MAX) {
+        return FRAME_ERR_BAD_TYPE;
+    }
+    if (len > FRAME_MAX_PAYLOAD) {
+        return FRAME_ERR_OVERSIZE;
+    }
+    if (frame_arq_in_flight(a) >= a->cfg.window) {
+        return FRAME_ERR_BUF_SMALL;
+    }
+
+    const uint8_t seq = a->tx_next;
+    if (arq_write_frame(a, seq, type, payload, len) != 0) {
+        /* Nothing committed: the caller may retry with the same SEQ. */
+        return FRAME_ERR_BUF_SMALL;
+    }
+    frame_arq_tx_slot_t *s = &a->tx[slot_of(a, seq)];
+    s->payload  = payload;
+    s->len      = (uint16_t)len;
+    s->type     = (uint8_t)type;
+    s->attempts = 1;
+    s->sent_ms  = a->cfg.now_ms(a->cfg.user);
+    a->tx_next  = (uint8_t)(seq + 1u);
+    a->stats.tx_frames++;
+    return FRAME_OK;
+}
+
+/* Cumulative ACK(c): frames tx_base..c are done. Stale ACKs change nothing. */
+static int arq_on_ack(frame_arq_t *a, uint8_t c)
+{
+    const size_t n = (size_t)SEQ_DIFF(c, a->tx_base) + 1u;
+    if (n > frame_arq_in_flight(a)) {
+        return 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        a->tx[slot_of(a, (uint8_t)(a->tx_base + i))].attempts = 0;
+    }
+    a->tx_base = (uint8_t)(a->tx_base + n);
+    return (int)n;
+}
+
+/* Selective NACK(s): resend frame s now if it is still in flight. */
+static void arq_on_nack(frame_arq_t *a, uint8_t s)
+{
+    a->stats.nacks_rx++;
+    if ((size_t)SEQ_DIFF(s, a->tx_base) >= frame_arq_in_flight(a)) {
+        return;
+    }
+    if (a->tx[slot_of(a, s)].attempts > a->cfg.max_retries) {
+        return;   /* out of attempts; tick() reports the failure */
+    }
+    arq_transmit(a, s);
+}
+
+/* Deliver rx_base and everything buffered contiguously behind it. */
+static int arq_drain(frame_arq_t *a)
+{
+    int n = 0;
+    for (;;) {
+        frame_arq_rx_slot_t *r = &a->rx[slot_of(a, a->rx_base)];
+        if (!r->present) {
+            return n;
+        }
+        r->present = 0;
+        a->cfg.deliver((frame_type_t)r->type,
+                       &a->cfg.rx_store[slot_of(a, a->rx_base) * a->cfg.rx_slot_size],
+                       r->len, a->cfg.user);
+        a->rx_base = (uint8_t)(a->rx_base + 1u);
+        a->stats.rx_delivered++;
+        n++;
+    }
+}
+
+static int arq_on_data(frame_arq_t *a, uint8_t seq, frame_type_t type,
+                       const uint8_t *payload, size_t len)
+{
+    const uint8_t w   = a->cfg.window;
+    const uint8_t off = SEQ_DIFF(seq, a->rx_base);
+    int delivered = 0;
+
+    if (off >= w) {
+        /* Behind the window: already delivered, the ACK was lost. */
+        if (SEQ_DIFF(a->rx_base, seq) <= w) {
+            a->stats.rx_duplicates++;
+        } else {
+            a->stats.rx_out_of_window++;
+        }
+    } else if (off == 0u) {
+        /* The next in-order frame goes straight up, unbuffered. */
+        a->rx[slot_of(a, seq)].present = 0;
+        a->cfg.deliver(type, payload, len, a->cfg.user);
+        a->rx_base = (uint8_t)(a->rx_base + 1u);
+        a->stats.rx_delivered++;
+        delivered = 1 + arq_drain(a);
+    } else {
+        frame_arq_rx_slot_t *r = &a->rx[slot_of(a, seq)];
+        if (r->present) {
+            a->stats.rx_duplicates++;
+        } else if (len > a->cfg.rx_slot_size) {
+            a->stats.rx_out_of_window++;
+        } else {
+            if (len > 0) {
+                memcpy(&a->cfg.rx_store[slot_of(a, seq) * a->cfg.rx_slot_size],
+                       payload, len);
+            }
+            r->len     = (uint16_t)len;
+            r->type    = (uint8_t)type;
+            r->present = 1;
+
+            /* NACK each hole in front of this frame, once per gap. */
+            uint8_t from = SEQ_DIFF(a->rx_nacked_to, a->rx_base);
+            if (from >= w) {
+                from = 0;
+            }
+            for (uint8_t k = from; k < off; ++k) {
+                const uint8_t hole = (uint8_t)(a->rx_base + k);
+                if (!a->rx[slot_of(a, hole)].present) {
+                    arq_write_control(a, FRAME_TYPE_NACK, hole);
+                    a->stats.nacks_tx++;
+                }
+            }
+            if (off + 1u > from) {
+                a->rx_nacked_to = (uint8_t)(seq + 1u);
+            }
+        }
+    }
+
+    arq_write_control(a, FRAME_TYPE_ACK, (uint8_t)(a->rx_base - 1u));
+    return delivered;
+}
+
+int frame_arq_on_frame(frame_arq_t *a, uint8_t seq, frame_type_t type,
+                       const uint8_t *payload, size_t len)
+{
+    if (a == NULL || (payload == NULL && len > 0)) {
+        return 0;
+    }
+    if (type == FRAME_TYPE_ACK) {
+        return arq_on_ack(a, seq);
+    }
+    if (type == FRAME_TYPE_NACK) {
+        arq_on_nack(a, seq);
+        return 0;
+    }
+    return arq_on_data(a, seq, type, payload, len);
+}
+
+int frame_arq_tick(frame_arq_t *a)
+{
+    if (a == NULL) {
+        return 0;
+    }
+    if (a->failed) {
+        return -1;
+    }
+    const uint32_t now = a->cfg.now_ms(a->cfg.user);
+    const size_t in_flight = frame_arq_in_flight(a);
+    int resent = 0;
+    for (size_t i = 0; i < in_flight; ++i) {
+        const uint8_t seq = (uint8_t)(a->tx_base + i);
+        frame_arq_tx_slot_t *s = &a->tx[slot_of(a, seq)];
+        /* Unsigned subtraction: wraps correctly past 2^32 ms. */
+        if ((uint32_t)(now - s->sent_ms) < a->cfg.timeout_ms) {
+            continue;
+        }
+        if (s->attempts > a->cfg.max_retries) {
+            a->failed = 1;
+            return -1;
+        }
+        arq_transmit(a, seq);
+        resent++;
+    }
+    return resent;
+}
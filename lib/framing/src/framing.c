@@ -1,34 +1,35 @@
-#include "framing.h"
+#include "framing_internal.h"
 
 #include <string.h>
 
-/* ------------------------------------------------------------------------
- * CRC-16-CCITT (a.k.a. CRC-16/IBM-3740, "CCITT-FALSE")
- *   poly = 0x1021, init = 0xFFFF, refin = refout = false, xorout = 0x0000
- *   reference vector: crc16("123456789") == 0x29B1
- *
- * Bytewise (no precomputed table) — the framing layer is bandwidth-bound at
- * 115200 baud and the CRC is computed over <= ~1030 bytes per frame, so the
- * extra cycles relative to a 256-entry table are well below the per-byte
- * UART time and the table would cost us 512 B of bootloader flash.
- * ------------------------------------------------------------------------ */
-uint16_t frame_crc16(const uint8_t *buf, size_t len)
+/*
+ * CRC-16-CCITT lives in crc16.c: the encoder and decoder go through
+ * frame_crc16_update(), so FRAME_CRC16_ENGINE picks the engine for both.
+ * The COBS modes live in framing_cobs.c (see framing_internal.h).
+ */
+
+/*
+ * Length of the leading run of src[0..len) with no FLAG or ESC byte. The
+ * word loads go through memcpy, which is a plain (unaligned-capable) LDR on
+ * Cortex-M4.
+ */
+static size_t clean_run(const uint8_t *src, size_t len)
 {
-    uint16_t crc = 0xFFFFu;
-    if (buf == NULL) {
-        return crc;
-    }
-    for (size_t i = 0; i < len; ++i) {
-        crc ^= ((uint16_t)buf[i]) << 8;
-        for (int b = 0; b < 8; ++b) {
-            if (crc & 0x8000u) {
-                crc = (uint16_t)((crc << 1) ^ 0x1021u);
-            } else {
-                crc = (uint16_t)(crc << 1);
-            }
+    size_t i = 0;
+#if FRAME_SWAR
+    while (len - i >= 4u) {
+        uint32_t w;
+        memcpy(&w, &src[i], sizeof(w));
+        if (SWAR_HAS_BYTE(w, FRAME_FLAG) | SWAR_HAS_BYTE(w, FRAME_ESC)) {
+            break;
         }
+        i += 4u;
+    }
+#endif
+    while (i < len && src[i] != FRAME_FLAG && src[i] != FRAME_ESC) {
+        ++i;
     }
-    return crc;
+    return i;
 }
 
 /* ------------------------------------------------------------------------
@@ -36,24 +37,162 @@ uint16_t frame_crc16(const uint8_t *buf, size_t len)
  * ------------------------------------------------------------------------ */
 
 /*
- * Append `b` to out_buf, byte-stuffing if necessary. Returns 0 on success,
- * -1 if there is no room in out_buf.
+ * Byte-stuff src[0..len) into out[*n..cap) and return how many source bytes
+ * were consumed. When only the ESC of a pair fits, the byte still counts as
+ * consumed and its second half waits in e->pending for the next pull.
  */
-static int emit_stuffed(uint8_t b, uint8_t *out_buf, size_t out_cap, size_t *idx)
+static size_t enc_stuff(frame_encoder_t *e, const uint8_t *src, size_t len,
+                        uint8_t *out, size_t cap, size_t *n)
 {
-    if (b == FRAME_FLAG || b == FRAME_ESC) {
-        if (*idx + 2 > out_cap) {
-            return -1;
+    size_t i = 0;
+    size_t o = *n;
+    while (i < len && o < cap) {
+        /* Clean run first, bounded by both the source and the room left. */
+        const size_t room = cap - o;
+        const size_t run  = clean_run(&src[i], (len - i < room) ? len - i : room);
+        copy_run(&out[o], &src[i], run);
+        i += run;
+        o += run;
+        if (i == len || o == cap) {
+            break;
         }
-        out_buf[(*idx)++] = FRAME_ESC;
-        out_buf[(*idx)++] = (uint8_t)(b ^ FRAME_ESC_XOR);
-    } else {
-        if (*idx + 1 > out_cap) {
-            return -1;
+
+        /* src[i] is FLAG or ESC. */
+        const uint8_t b = src[i++];
+        out[o++] = FRAME_ESC;
+        if (o == cap) {
+            e->pending     = (uint8_t)(b ^ FRAME_ESC_XOR);
+            e->has_pending = 1;
+            break;
         }
-        out_buf[(*idx)++] = b;
+        out[o++] = (uint8_t)(b ^ FRAME_ESC_XOR);
     }
-    return 0;
+    *n = o;
+    return i;
+}
+
+frame_err_t frame_encoder_begin(frame_encoder_t *e, uint8_t seq, frame_type_t type,
+                                const frame_iov_t *iov, size_t iov_cnt)
+{
+    if (e == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    e->phase       = ENC_DONE;
+    e->has_pending = 0;
+    e->mode        = FRAME_MODE_HDLC;
+    e->cobs_pull   = NULL;
+    if (iov == NULL && iov_cnt > 0) {
+        return FRAME_ERR_NULL_ARG;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < iov_cnt; ++i) {
+        if (iov[i].base == NULL && iov[i].len > 0) {
+            return FRAME_ERR_NULL_ARG;
+        }
+        if (iov[i].len > FRAME_MAX_PAYLOAD - total) {
+            return FRAME_ERR_OVERSIZE;
+        }
+        total += iov[i].len;
+    }
+    if ((unsigned)type > (unsigned)FRAME_TYPE__MAX) {
+        return FRAME_ERR_BAD_TYPE;
+    }
+
+    e->iov     = iov;
+    e->iov_cnt = iov_cnt;
+    e->iov_idx = 0;
+    e->iov_off = 0;
+    e->head[0] = seq;
+    e->head[1] = (uint8_t)type;
+    e->head[2] = (uint8_t)(total & 0xFFu);
+    e->head[3] = (uint8_t)((total >> 8) & 0xFFu);
+
+    /*
+     * CRC covers [SEQ][TYPE][LEN_lo][LEN_hi][PAYLOAD] — the unstuffed body,
+     * NOT including FLAGs or the CRC bytes themselves. The payload part is
+     * added by pull() as each run of it goes out.
+     */
+    e->crc   = frame_crc16(e->head, sizeof(e->head));
+    e->idx   = 0;
+    e->phase = ENC_OPEN;
+    return FRAME_OK;
+}
+
+size_t frame_encoder_pull(frame_encoder_t *e, uint8_t *out, size_t cap)
+{
+    if (e == NULL || out == NULL) {
+        return 0;
+    }
+    if (e->cobs_pull != NULL) {
+        return e->cobs_pull(e, out, cap);
+    }
+
+    size_t n = 0;
+    if (e->has_pending && n < cap) {
+        out[n++] = e->pending;
+        e->has_pending = 0;
+    }
+
+    while (n < cap && !e->has_pending) {
+        switch (e->phase) {
+            case ENC_OPEN:
+                out[n++] = FRAME_FLAG;
+                e->phase = ENC_HEAD;
+                break;
+
+            case ENC_HEAD:
+                e->idx = (uint8_t)(e->idx + enc_stuff(e, &e->head[e->idx],
+                                                      sizeof(e->head) - e->idx,
+                                                      out, cap, &n));
+                if (e->idx == sizeof(e->head)) {
+                    e->idx   = 0;
+                    e->phase = ENC_PAYLOAD;
+                }
+                break;
+
+            case ENC_PAYLOAD:
+                if (e->iov_idx == e->iov_cnt) {
+                    /* CRC on the wire is little-endian: low byte first. */
+                    e->tail[0] = (uint8_t)(e->crc & 0xFFu);
+                    e->tail[1] = (uint8_t)((e->crc >> 8) & 0xFFu);
+                    e->phase   = ENC_TAIL;
+                } else if (e->iov_off == e->iov[e->iov_idx].len) {
+                    e->iov_idx++;
+                    e->iov_off = 0;
+                } else {
+                    const frame_iov_t *f   = &e->iov[e->iov_idx];
+                    const uint8_t     *src = f->base + e->iov_off;
+                    size_t used = enc_stuff(e, src, f->len - e->iov_off, out, cap, &n);
+                    e->crc      = frame_crc16_update(e->crc, src, used);
+                    e->iov_off += used;
+                }
+                break;
+
+            case ENC_TAIL:
+                e->idx = (uint8_t)(e->idx + enc_stuff(e, &e->tail[e->idx],
+                                                      sizeof(e->tail) - e->idx,
+                                                      out, cap, &n));
+                if (e->idx == sizeof(e->tail)) {
+                    e->phase = ENC_CLOSE;
+                }
+                break;
+
+            case ENC_CLOSE:
+                out[n++] = FRAME_FLAG;
+                e->phase = ENC_DONE;
+                break;
+
+            default:
+                return n;
+        }
+    }
+    return n;
+}
+
+int frame_encoder_done(const frame_encoder_t *e)
+{
+    return (e == NULL || (e->phase == ENC_DONE && !e->has_pending)) ? 1 : 0;
 }
 
 int frame_encode(uint8_t seq, frame_type_t type,
@@ -82,84 +221,39 @@ int frame_encode(uint8_t seq, frame_type_t type,
         return FRAME_ERR_BUF_SMALL;
     }
 
-    /* Header: SEQ, TYPE, LEN_lo, LEN_hi. */
-    const uint8_t header[4] = {
-        seq,
-        (uint8_t)type,
-        (uint8_t)(payload_len & 0xFFu),
-        (uint8_t)((payload_len >> 8) & 0xFFu),
-    };
-
-    /*
-     * CRC covers [SEQ][TYPE][LEN_lo][LEN_hi][PAYLOAD] — the unstuffed body,
-     * NOT including FLAGs or the CRC bytes themselves.
-     */
-    uint16_t crc = frame_crc16(header, sizeof(header));
-    /* Continue the CRC over the payload without recomputing the header. */
-    if (payload_len > 0) {
-        /*
-         * frame_crc16 reinitialises crc to 0xFFFF, so we re-implement the
-         * inner loop here over (header || payload) by combining a buffer.
-         * For modest payloads we just CRC over a stack copy; for full-sized
-         * payloads (1024 B) that would blow the small bootloader stack, so
-         * we instead resume the CRC manually.
-         */
-        for (size_t i = 0; i < payload_len; ++i) {
-            crc ^= ((uint16_t)payload[i]) << 8;
-            for (int b = 0; b < 8; ++b) {
-                if (crc & 0x8000u) {
-                    crc = (uint16_t)((crc << 1) ^ 0x1021u);
-                } else {
-                    crc = (uint16_t)(crc << 1);
-                }
-            }
-        }
-    }
-
-    size_t idx = 0;
-    out_buf[idx++] = FRAME_FLAG;
-
-    for (size_t i = 0; i < sizeof(header); ++i) {
-        if (emit_stuffed(header[i], out_buf, out_cap, &idx) != 0) {
-            return FRAME_ERR_BUF_SMALL;
-        }
-    }
-    for (size_t i = 0; i < payload_len; ++i) {
-        if (emit_stuffed(payload[i], out_buf, out_cap, &idx) != 0) {
-            return FRAME_ERR_BUF_SMALL;
-        }
-    }
-
-    /* CRC on the wire is little-endian: low byte first, high byte second. */
-    if (emit_stuffed((uint8_t)(crc & 0xFFu),        out_buf, out_cap, &idx) != 0) {
-        return FRAME_ERR_BUF_SMALL;
-    }
-    if (emit_stuffed((uint8_t)((crc >> 8) & 0xFFu), out_buf, out_cap, &idx) != 0) {
-        return FRAME_ERR_BUF_SMALL;
+    /* One fragment, and room for the worst case: a single pull finishes. */
+    const frame_iov_t iov = { payload, payload_len };
+    frame_encoder_t e;
+    frame_err_t rc = frame_encoder_begin(&e, seq, type, &iov, 1);
+    if (rc != FRAME_OK) {
+        return rc;
     }
-
-    if (idx + 1 > out_cap) {
+    size_t n = frame_encoder_pull(&e, out_buf, out_cap);
+    if (!frame_encoder_done(&e)) {
         return FRAME_ERR_BUF_SMALL;
     }
-    out_buf[idx++] = FRAME_FLAG;
-
-    return (int)idx;
+    return (int)n;
 }
 
 /* ------------------------------------------------------------------------
  * Decoder
  * ------------------------------------------------------------------------ */
 
-static void decoder_clear_frame_state(frame_decoder_t *d)
+void frame_decoder_clear_frame(frame_decoder_t *d)
 {
     d->seq          = 0;
     d->type         = 0;
     d->declared_len = 0;
     d->payload_idx  = 0;
+    d->crc          = FRAME_CRC16_INIT;
+    d->crc_done     = 0;
     d->crc_idx      = 0;
     d->field_idx    = 0;
     d->in_escape    = 0;
     d->dropping     = 0;
+    d->cobs_code    = 0;
+    d->cobs_left    = 0;
+    d->cobs_zero    = 0;
 }
 
 frame_err_t frame_decoder_init(frame_decoder_t *d,
@@ -181,8 +275,10 @@ frame_err_t frame_decoder_init(frame_decoder_t *d,
     d->user             = user;
     d->payload_buf      = payload_buf;
     d->payload_buf_size = payload_buf_size;
+    d->mode             = FRAME_MODE_HDLC;
+    d->cobs_feed        = NULL;
     d->in_frame         = 0;
-    decoder_clear_frame_state(d);
+    frame_decoder_clear_frame(d);
     return FRAME_OK;
 }
 
@@ -192,7 +288,7 @@ void frame_decoder_reset(frame_decoder_t *d)
         return;
     }
     d->in_frame = 0;
-    decoder_clear_frame_state(d);
+    frame_decoder_clear_frame(d);
 }
 
 /*
@@ -209,18 +305,31 @@ static void decoder_drop(frame_decoder_t *d, frame_err_t err)
     }
 }
 
+/*
+ * Fold the payload bytes that arrived since the last fold into the running
+ * CRC, in one call: once per clean run on the fast path, and at the end.
+ */
+void frame_decoder_fold_crc(frame_decoder_t *d)
+{
+    d->crc = frame_crc16_update(d->crc, &d->payload_buf[d->crc_done],
+                                (size_t)(d->payload_idx - d->crc_done));
+    d->crc_done = d->payload_idx;
+}
+
 /*
  * Consume a single unstuffed body byte, advancing the field/payload/CRC
- * sub-state machines. Anything past the expected byte count poisons the
- * frame.
+ * sub-state machines. Header bytes go into the running CRC here; payload
+ * bytes are folded in later from payload_buf (frame_decoder_fold_crc()).
+ * Anything past the expected byte count poisons the frame.
  */
-static void decoder_consume_byte(frame_decoder_t *d, uint8_t b)
+void frame_decoder_consume_byte(frame_decoder_t *d, uint8_t b)
 {
     if (d->dropping) {
         return;
     }
 
     if (d->field_idx < 4) {
+        d->crc = frame_crc16_update(d->crc, &b, 1);
         switch (d->field_idx) {
             case 0: d->seq          = b;                                break;
             case 1: d->type         = b;                                break;
@@ -267,7 +376,7 @@ static void decoder_consume_byte(frame_decoder_t *d, uint8_t b)
  * afterwards because the closing FLAG is also the opening FLAG of the next
  * frame in HDLC.
  */
-static void decoder_finalize(frame_decoder_t *d)
+void frame_decoder_finalize(frame_decoder_t *d)
 {
     /* Empty FLAG-FLAG pair (no body bytes seen) is a benign idle marker. */
     if (!d->dropping && !d->in_escape && d->field_idx == 0) {
@@ -299,25 +408,9 @@ static void decoder_finalize(frame_decoder_t *d)
         return;
     }
 
-    /* Recompute CRC over [seq, type, len_lo, len_hi, payload]. */
-    const uint8_t header[4] = {
-        d->seq,
-        d->type,
-        (uint8_t)(d->declared_len & 0xFFu),
-        (uint8_t)((d->declared_len >> 8) & 0xFFu),
-    };
-    uint16_t crc = frame_crc16(header, sizeof(header));
-    for (uint16_t i = 0; i < d->payload_idx; ++i) {
-        crc ^= ((uint16_t)d->payload_buf[i]) << 8;
-        for (int b = 0; b < 8; ++b) {
-            if (crc & 0x8000u) {
-                crc = (uint16_t)((crc << 1) ^ 0x1021u);
-            } else {
-                crc = (uint16_t)(crc << 1);
-            }
-        }
-    }
-
+    /* d->crc now covers [seq, type, len_lo, len_hi, payload]. */
+    frame_decoder_fold_crc(d);
+    const uint16_t crc = d->crc;
     uint16_t recv_crc =
         (uint16_t)d->crc_bytes[0] |
         (uint16_t)((uint16_t)d->crc_bytes[1] << 8);
@@ -345,15 +438,50 @@ void frame_decoder_feed(frame_decoder_t *d, const uint8_t *bytes, size_t n)
     if (d == NULL || bytes == NULL) {
         return;
     }
+    if (d->cobs_feed != NULL) {
+        d->cobs_feed(d, bytes, n);
+        return;
+    }
 
-    for (size_t i = 0; i < n; ++i) {
-        uint8_t b = bytes[i];
+    size_t i = 0;
+    while (i < n) {
+        /*
+         * Fast paths. Between frames, skip straight to the next FLAG/ESC.
+         * Inside a payload, copy the clean run up to the next FLAG/ESC (or
+         * the end of the payload) in one go and fold it into the CRC, and
+         * unstuff an ESC pair in place when both halves are here.
+         */
+        if (!d->in_frame) {
+            i += clean_run(&bytes[i], n - i);
+            if (i == n) {
+                break;
+            }
+        } else if (!d->in_escape && !d->dropping && d->field_idx == 4 &&
+                   d->payload_idx < d->declared_len) {
+            const size_t want = d->declared_len - d->payload_idx;
+            const size_t run  = clean_run(&bytes[i], (n - i < want) ? n - i : want);
+            if (run > 0) {
+                copy_run(&d->payload_buf[d->payload_idx], &bytes[i], run);
+                d->payload_idx = (uint16_t)(d->payload_idx + run);
+                frame_decoder_fold_crc(d);
+                i += run;
+                continue;
+            }
+            if (bytes[i] == FRAME_ESC && n - i >= 2u &&
+                bytes[i + 1] != FRAME_FLAG && bytes[i + 1] != FRAME_ESC) {
+                d->payload_buf[d->payload_idx++] = (uint8_t)(bytes[i + 1] ^ FRAME_ESC_XOR);
+                i += 2u;
+                continue;
+            }
+        }
+
+        uint8_t b = bytes[i++];
 
         if (b == FRAME_FLAG) {
             if (d->in_frame) {
-                decoder_finalize(d);
+                frame_decoder_finalize(d);
             }
-            decoder_clear_frame_state(d);
+            frame_decoder_clear_frame(d);
             d->in_frame = 1;
             continue;
         }
@@ -379,7 +507,7 @@ void frame_decoder_feed(frame_decoder_t *d, const uint8_t *bytes, size_t n)
             b ^= FRAME_ESC_XOR;
         }
 
-        decoder_consume_byte(d, b);
+        frame_decoder_consume_byte(d, b);
     }
 }
 
@@ -403,14 +531,107 @@ frame_err_t frame_link_init(frame_link_t *link,
     link->user        = user;
     link->timeout_ms  = timeout_ms;
     link->max_retries = max_retries;
+    link->rto_ms      = timeout_ms;
     link->state       = FRAME_LINK_IDLE;
     link->tx_seq      = 0;
     return FRAME_OK;
 }
 
-frame_err_t frame_link_send(frame_link_t *link,
-                            frame_type_t type,
-                            const uint8_t *payload, size_t payload_len)
+frame_err_t frame_link_set_mode(frame_link_t *link, frame_mode_t mode)
+{
+    if (link == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if ((unsigned)mode > (unsigned)FRAME_MODE__MAX) {
+        return FRAME_ERR_BAD_MODE;
+    }
+    link->mode = (uint8_t)mode;
+    return FRAME_OK;
+}
+
+/* Current RTO with backoff applied, saturating at FRAME_LINK_RTO_MAX_MS. */
+static uint32_t link_rto(const frame_link_t *link)
+{
+    const uint32_t cap = (link->rto_ms > FRAME_LINK_RTO_MAX_MS)
+                         ? link->rto_ms : FRAME_LINK_RTO_MAX_MS;
+    uint32_t t = link->rto_ms;
+    for (uint8_t i = 0; i < link->backoff && t < cap; ++i) {
+        t = (t > cap / 2u) ? cap : 2u * t;
+    }
+    return t;
+}
+
+/*
+ * Fold one RTT sample into the estimator (Jacobson/Karels, BSD fixed point:
+ * srtt8 = 8 * SRTT, rttvar4 = 4 * RTTVAR, so both updates are shifts) and
+ * recompute the RTO. A valid sample also ends any backoff.
+ */
+static void link_rtt_sample(frame_link_t *link, uint32_t r)
+{
+    frame_link_stats_t *st = &link->stats;
+    if (st->rtt_samples == 0u || r < st->rtt_min_ms) {
+        st->rtt_min_ms = r;
+    }
+    if (r > st->rtt_max_ms) {
+        st->rtt_max_ms = r;
+    }
+    st->rtt_samples++;
+    link->rtt_sum_ms += r;
+
+    /* Past the RTO cap the estimate no longer matters; keep it in range. */
+    if (r > FRAME_LINK_RTO_MAX_MS) {
+        r = FRAME_LINK_RTO_MAX_MS;
+    }
+    if (!link->have_rtt) {
+        link->srtt8    = r << 3;     /* SRTT = R      */
+        link->rttvar4  = r << 1;     /* RTTVAR = R/2  */
+        link->have_rtt = 1;
+    } else {
+        int32_t err = (int32_t)r - (int32_t)(link->srtt8 >> 3);
+        link->srtt8 = (uint32_t)((int32_t)link->srtt8 + err);           /* += err/8 */
+        if (err < 0) {
+            err = -err;
+        }
+        link->rttvar4 = link->rttvar4 + (uint32_t)err - (link->rttvar4 >> 2);  /* += (|err| - RTTVAR)/4 */
+    }
+
+    /* RTO = SRTT + max(G, 4 * RTTVAR), with a 1 ms clock granularity G. */
+    uint32_t rto = (link->srtt8 >> 3) + ((link->rttvar4 > 1u) ? link->rttvar4 : 1u);
+    if (rto < FRAME_LINK_RTO_MIN_MS) {
+        rto = FRAME_LINK_RTO_MIN_MS;
+    } else if (rto > FRAME_LINK_RTO_MAX_MS) {
+        rto = FRAME_LINK_RTO_MAX_MS;
+    }
+    link->rto_ms  = rto;
+    link->backoff = 0;
+}
+
+/*
+ * Stream the pending frame through a FRAME_LINK_TX_CHUNK stack buffer into
+ * the transport. Returns 0 on success, -1 as soon as a write() fails (the
+ * receiver sees a cut-off frame and resyncs on the next FLAG).
+ */
+static int link_transmit(frame_link_t *link)
+{
+    uint8_t chunk[FRAME_LINK_TX_CHUNK];
+    frame_encoder_t e;
+    if (frame_encoder_begin_mode(&e, (frame_mode_t)link->mode, link->tx_seq,
+                                 (frame_type_t)link->pending_type,
+                                 link->pending_iov, link->pending_iov_cnt) != FRAME_OK) {
+        return -1;
+    }
+    while (!frame_encoder_done(&e)) {
+        size_t n = frame_encoder_pull(&e, chunk, sizeof(chunk));
+        if (link->write(chunk, n, link->user) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+frame_err_t frame_link_sendv(frame_link_t *link,
+                             frame_type_t type,
+                             const frame_iov_t *iov, size_t iov_cnt)
 {
     if (link == NULL) {
         return FRAME_ERR_NULL_ARG;
@@ -419,26 +640,26 @@ frame_err_t frame_link_send(frame_link_t *link,
         /* Sliding window of 1: reject overlapping sends. */
         return FRAME_ERR_BUF_SMALL;
     }
-    if (payload_len > FRAME_MAX_PAYLOAD) {
+    if (iov_cnt > FRAME_LINK_MAX_IOV) {
         return FRAME_ERR_OVERSIZE;
     }
 
-    int n = frame_encode(link->tx_seq, type,
-                         payload, payload_len,
-                         link->encoded, sizeof(link->encoded));
-    if (n < 0) {
-        return (frame_err_t)n;
+    /* Validate up front (NULLs, total length, type) before taking the slot. */
+    frame_encoder_t probe;
+    frame_err_t rc = frame_encoder_begin(&probe, link->tx_seq, type, iov, iov_cnt);
+    if (rc != FRAME_OK) {
+        return rc;
     }
 
-    /* Stash the unencoded payload so retransmits can reuse the buffer. */
-    if (payload_len > 0 && payload != NULL) {
-        memcpy(link->pending_payload, payload, payload_len);
+    /* Keep the fragment list (not the bytes) so retransmits can re-encode. */
+    for (size_t i = 0; i < iov_cnt; ++i) {
+        link->pending_iov[i] = iov[i];
     }
-    link->pending_type = (uint8_t)type;
-    link->pending_len  = (uint16_t)payload_len;
-    link->encoded_len  = (size_t)n;
+    link->pending_iov_cnt = (uint8_t)iov_cnt;
+    link->pending_type    = (uint8_t)type;
+    link->pending_len     = (uint16_t)(probe.head[2] | (probe.head[3] << 8));
 
-    if (link->write(link->encoded, link->encoded_len, link->user) != 0) {
+    if (link_transmit(link) != 0) {
         /*
          * Transport failure on first send: leave state IDLE so the caller can
          * retry on its own terms. Do not advance tx_seq.
@@ -449,9 +670,27 @@ frame_err_t frame_link_send(frame_link_t *link,
     link->state         = FRAME_LINK_AWAITING_ACK;
     link->tx_started_ms = link->now_ms(link->user);
     link->attempts      = 1;
+    link->stats.tx_frames++;
     return FRAME_OK;
 }
 
+frame_err_t frame_link_send(frame_link_t *link,
+                            frame_type_t type,
+                            const uint8_t *payload, size_t payload_len)
+{
+    if (link == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (link->state != FRAME_LINK_IDLE) {
+        return FRAME_ERR_BUF_SMALL;
+    }
+    if (payload_len > FRAME_MAX_PAYLOAD) {
+        return FRAME_ERR_OVERSIZE;
+    }
+    const frame_iov_t iov = { payload, payload_len };
+    return frame_link_sendv(link, type, &iov, 1);
+}
+
 int frame_link_on_ack(frame_link_t *link, uint8_t seq)
 {
     if (link == NULL || link->state != FRAME_LINK_AWAITING_ACK) {
@@ -460,6 +699,10 @@ int frame_link_on_ack(frame_link_t *link, uint8_t seq)
     if (seq != link->tx_seq) {
         return 0;
     }
+    /* Karn: after a retransmit the ACK could answer either copy. */
+    if (link->attempts == 1u) {
+        link_rtt_sample(link, link->now_ms(link->user) - link->tx_started_ms);
+    }
     link->state  = FRAME_LINK_IDLE;
     link->tx_seq = (uint8_t)(link->tx_seq + 1u);
     return 1;
@@ -473,9 +716,11 @@ static int link_retransmit(frame_link_t *link)
 {
     if (link->attempts > link->max_retries) {
         link->state = FRAME_LINK_IDLE;
+        link->stats.failures++;
         return -1;
     }
-    if (link->write(link->encoded, link->encoded_len, link->user) != 0) {
+    link->stats.retransmits++;
+    if (link_transmit(link) != 0) {
         /*
          * Treat a transport-write error like an attempted retransmit: count
          * it against the budget so a stuck transport doesn't loop forever.
@@ -514,21 +759,70 @@ int frame_link_tick(frame_link_t *link)
      * Use unsigned subtraction so wraparound past 2^32 still produces a
      * monotonic delta as long as the timeout fits in 31 bits.
      */
-    if ((uint32_t)(now - link->tx_started_ms) < link->timeout_ms) {
+    if ((uint32_t)(now - link->tx_started_ms) < link_rto(link)) {
         return 0;
     }
+    link->stats.timeouts++;
+    if (link->attempts <= link->max_retries) {
+        link->backoff++;
+    }
     return link_retransmit(link);
 }
 
+void frame_link_abandon(frame_link_t *link)
+{
+    if (link == NULL) {
+        return;
+    }
+    link->state  = FRAME_LINK_IDLE;
+    link->tx_seq = (uint8_t)(link->tx_seq + 1u);
+}
+
 int frame_link_on_rx(frame_link_t *link, uint8_t seq)
 {
     if (link == NULL) {
         return 0;
     }
     if (link->rx_have_last && link->rx_last_seq == seq) {
+        link->stats.rx_duplicates++;
         return 0;
     }
     link->rx_have_last = 1;
     link->rx_last_seq  = seq;
     return 1;
 }
+
+void frame_link_on_rx_error(frame_link_t *link, frame_err_t err)
+{
+    if (link == NULL) {
+        return;
+    }
+    if (err == FRAME_ERR_CRC) {
+        link->stats.crc_errors++;
+    } else {
+        link->stats.rx_errors++;
+    }
+}
+
+frame_err_t frame_link_get_stats(const frame_link_t *link, frame_link_stats_t *out)
+{
+    if (link == NULL || out == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    *out = link->stats;
+    out->rtt_avg_ms = (out->rtt_samples > 0u)
+                      ? (uint32_t)(link->rtt_sum_ms / out->rtt_samples) : 0u;
+    out->srtt_ms    = link->srtt8 >> 3;
+    out->rttvar_ms  = link->rttvar4 >> 2;
+    out->rto_ms     = link_rto(link);
+    return FRAME_OK;
+}
+
+void frame_link_reset_stats(frame_link_t *link)
+{
+    if (link == NULL) {
+        return;
+    }
+    memset(&link->stats, 0, sizeof(link->stats));
+    link->rtt_sum_ms = 0;
+}
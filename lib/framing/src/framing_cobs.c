@@ -0,0 +1,386 @@
+#include "framing_internal.h"
+
+#include <string.h>
+
+/*
+ * COBS and COBS-R framing modes (frame_mode_t). The body and CRC are those
+ * of the HDLC format; only the byte format between the delimiters differs.
+ */
+
+static int mode_valid(frame_mode_t mode)
+{
+    return (unsigned)mode <= (unsigned)FRAME_MODE__MAX;
+}
+
+/* Length of the leading run of src[0..len) with no zero byte. */
+static size_t nonzero_run(const uint8_t *src, size_t len)
+{
+    size_t i = 0;
+#if FRAME_SWAR
+    while (len - i >= 4u) {
+        uint32_t w;
+        memcpy(&w, &src[i], sizeof(w));
+        if (SWAR_HAS_ZERO(w)) {
+            break;
+        }
+        i += 4u;
+    }
+#endif
+    while (i < len && src[i] != FRAME_COBS_DELIM) {
+        ++i;
+    }
+    return i;
+}
+
+/* ------------------------------------------------------------------------
+ * Encoder
+ * ------------------------------------------------------------------------ */
+
+/* frame_enc_pos_t parts, in body order. */
+enum {
+    POS_HEAD = 0,
+    POS_PAYLOAD,
+    POS_TAIL,
+    POS_END,
+};
+
+/*
+ * The contiguous body bytes at p (the rest of the head, a fragment or the
+ * tail) into *len, stepping over finished parts and empty fragments; NULL
+ * at the end of the body. Entering the tail writes the CRC into it: the
+ * look-ahead gets there first, having folded in the whole payload.
+ */
+static const uint8_t *pos_run(frame_encoder_t *e, frame_enc_pos_t *p, size_t *len)
+{
+    for (;;) {
+        switch (p->part) {
+            case POS_HEAD:
+                if (p->idx < sizeof(e->head)) {
+                    *len = sizeof(e->head) - p->idx;
+                    return &e->head[p->idx];
+                }
+                p->part    = POS_PAYLOAD;
+                p->iov_idx = 0;
+                p->iov_off = 0;
+                break;
+
+            case POS_PAYLOAD:
+                if (p->iov_idx == e->iov_cnt) {
+                    e->tail[0] = (uint8_t)(e->crc & 0xFFu);
+                    e->tail[1] = (uint8_t)((e->crc >> 8) & 0xFFu);
+                    p->part    = POS_TAIL;
+                    p->idx     = 0;
+                } else if (p->iov_off == e->iov[p->iov_idx].len) {
+                    p->iov_idx++;
+                    p->iov_off = 0;
+                } else {
+                    *len = e->iov[p->iov_idx].len - p->iov_off;
+                    return e->iov[p->iov_idx].base + p->iov_off;
+                }
+                break;
+
+            case POS_TAIL:
+                if (p->idx < sizeof(e->tail)) {
+                    *len = sizeof(e->tail) - p->idx;
+                    return &e->tail[p->idx];
+                }
+                p->part = POS_END;
+                break;
+
+            default:
+                *len = 0;
+                return NULL;
+        }
+    }
+}
+
+/* Advance p by n bytes within the run pos_run() just returned. */
+static void pos_skip(frame_enc_pos_t *p, size_t n)
+{
+    if (p->part == POS_PAYLOAD) {
+        p->iov_off += n;
+    } else {
+        p->idx = (uint8_t)(p->idx + n);
+    }
+}
+
+/*
+ * Size the next block: look ahead from e->scan over at most 254 non-zero
+ * bytes, up to a zero or the end of the body, folding payload into the CRC
+ * on the way. Sets blk_left/blk_skip/blk_zero and returns the code byte.
+ */
+static uint8_t cobs_next_block(frame_encoder_t *e)
+{
+    size_t  total = 0;
+    uint8_t last  = 0;
+    for (;;) {
+        size_t len;
+        const uint8_t *src = pos_run(e, &e->scan, &len);
+        if (src == NULL) {
+            /* End of body: the final block, with no zero after it. */
+            e->blk_left = (uint8_t)total;
+            e->blk_skip = 0;
+            e->blk_zero = 0;
+            if (e->mode == FRAME_MODE_COBSR && last > total + 1u) {
+                /* COBS-R: the last byte goes out as the code byte. */
+                e->blk_left--;
+                e->blk_skip = 1;
+                return last;
+            }
+            return (uint8_t)(total + 1u);
+        }
+
+        const size_t room = FRAME_COBS_BLOCK_MAX - total;
+        const size_t lim  = (len < room) ? len : room;
+        const size_t run  = nonzero_run(src, lim);
+        const size_t used = (run < lim) ? run + 1u : run;   /* and the zero */
+        if (e->scan.part == POS_PAYLOAD) {
+            e->crc = frame_crc16_update(e->crc, src, used);
+        }
+        pos_skip(&e->scan, used);
+        if (run > 0) {
+            last = src[run - 1u];
+        }
+        total += run;
+
+        if (run < lim) {
+            e->blk_left = (uint8_t)total;
+            e->blk_skip = 1;
+            e->blk_zero = 1;
+            return (uint8_t)(total + 1u);
+        }
+        if (total == FRAME_COBS_BLOCK_MAX) {
+            e->blk_left = (uint8_t)total;
+            e->blk_skip = 0;
+            e->blk_zero = 0;
+            return 0xFFu;
+        }
+    }
+}
+
+static size_t cobs_pull(frame_encoder_t *e, uint8_t *out, size_t cap)
+{
+    size_t n = 0;
+    while (n < cap) {
+        size_t len;
+        const uint8_t *src;
+        switch (e->phase) {
+            case ENC_OPEN:
+                out[n++] = FRAME_COBS_DELIM;
+                e->phase = ENC_CODE;
+                break;
+
+            case ENC_CODE:
+                out[n++] = cobs_next_block(e);
+                e->phase = ENC_BLOCK;
+                break;
+
+            case ENC_BLOCK:
+                if (e->blk_left > 0u) {
+                    src = pos_run(e, &e->at, &len);
+                    if (len > e->blk_left) {
+                        len = e->blk_left;
+                    }
+                    if (len > cap - n) {
+                        len = cap - n;
+                    }
+                    copy_run(&out[n], src, len);
+                    pos_skip(&e->at, len);
+                    e->blk_left = (uint8_t)(e->blk_left - len);
+                    n += len;
+                    break;
+                }
+                if (e->blk_skip) {
+                    (void)pos_run(e, &e->at, &len);
+                    pos_skip(&e->at, 1);
+                    e->blk_skip = 0;
+                }
+                /* A zero always opens another block, even an empty last one. */
+                e->phase = (e->blk_zero || pos_run(e, &e->at, &len) != NULL)
+                           ? ENC_CODE : ENC_CLOSE;
+                break;
+
+            case ENC_CLOSE:
+                out[n++] = FRAME_COBS_DELIM;
+                e->phase = ENC_DONE;
+                break;
+
+            default:
+                return n;
+        }
+    }
+    return n;
+}
+
+frame_err_t frame_encoder_begin_mode(frame_encoder_t *e, frame_mode_t mode,
+                                     uint8_t seq, frame_type_t type,
+                                     const frame_iov_t *iov, size_t iov_cnt)
+{
+    frame_err_t rc = frame_encoder_begin(e, seq, type, iov, iov_cnt);
+    if (rc != FRAME_OK) {
+        return rc;
+    }
+    if (!mode_valid(mode)) {
+        e->phase = ENC_DONE;
+        return FRAME_ERR_BAD_MODE;
+    }
+    if (mode != FRAME_MODE_HDLC) {
+        e->mode      = (uint8_t)mode;
+        e->cobs_pull = cobs_pull;
+        memset(&e->at, 0, sizeof(e->at));
+        memset(&e->scan, 0, sizeof(e->scan));
+        e->blk_left  = 0;
+        e->blk_skip  = 0;
+        e->blk_zero  = 0;
+    }
+    return FRAME_OK;
+}
+
+size_t frame_encoded_max(frame_mode_t mode, size_t payload_len)
+{
+    const size_t body = FRAME_FIXED_OVERHEAD + payload_len;
+    if (mode == FRAME_MODE_HDLC) {
+        return 2u + 2u * body;
+    }
+    if (mode_valid(mode)) {
+        return 2u + body + (body + FRAME_COBS_BLOCK_MAX - 1u) / FRAME_COBS_BLOCK_MAX;
+    }
+    return 0;
+}
+
+int frame_encode_mode(frame_mode_t mode, uint8_t seq, frame_type_t type,
+                      const uint8_t *payload, size_t payload_len,
+                      uint8_t *out_buf, size_t out_cap)
+{
+    if (mode == FRAME_MODE_HDLC) {
+        return frame_encode(seq, type, payload, payload_len, out_buf, out_cap);
+    }
+    if (out_buf == NULL || (payload == NULL && payload_len > 0)) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (payload_len > FRAME_MAX_PAYLOAD) {
+        return FRAME_ERR_OVERSIZE;
+    }
+    if ((unsigned)type > (unsigned)FRAME_TYPE__MAX) {
+        return FRAME_ERR_BAD_TYPE;
+    }
+    if (!mode_valid(mode)) {
+        return FRAME_ERR_BAD_MODE;
+    }
+    if (out_cap < frame_encoded_max(mode, payload_len)) {
+        return FRAME_ERR_BUF_SMALL;
+    }
+
+    const frame_iov_t iov = { payload, payload_len };
+    frame_encoder_t e;
+    frame_err_t rc = frame_encoder_begin_mode(&e, mode, seq, type, &iov, 1);
+    if (rc != FRAME_OK) {
+        return rc;
+    }
+    size_t n = frame_encoder_pull(&e, out_buf, out_cap);
+    if (!frame_encoder_done(&e)) {
+        return FRAME_ERR_BUF_SMALL;
+    }
+    return (int)n;
+}
+
+/* ------------------------------------------------------------------------
+ * Decoder
+ * ------------------------------------------------------------------------ */
+
+/*
+ * Closing delimiter. A block still short of data bytes is a cut-off frame,
+ * except in COBS-R where it means the code byte was the body's last byte.
+ */
+static void decoder_end_cobs(frame_decoder_t *d)
+{
+    if (d->cobs_left != 0u && !d->dropping) {
+        if (d->mode != FRAME_MODE_COBSR) {
+            if (d->err_cb != NULL) {
+                d->err_cb(FRAME_ERR_TRUNC, d->user);
+            }
+            return;
+        }
+        frame_decoder_consume_byte(d, d->cobs_code);
+    }
+    frame_decoder_finalize(d);
+}
+
+static void decoder_feed_cobs(frame_decoder_t *d, const uint8_t *bytes, size_t n)
+{
+    size_t i = 0;
+    while (i < n) {
+        /*
+         * Fast paths, as for HDLC: skip to the next delimiter between
+         * frames; inside a block of payload, copy up to the end of the
+         * block, the payload or the input in one go.
+         */
+        if (!d->in_frame) {
+            i += nonzero_run(&bytes[i], n - i);
+            if (i == n) {
+                break;
+            }
+        } else if (d->cobs_left > 0u && !d->dropping && d->field_idx == 4 &&
+                   d->payload_idx < d->declared_len) {
+            size_t lim = d->declared_len - d->payload_idx;
+            if (lim > d->cobs_left) {
+                lim = d->cobs_left;
+            }
+            if (lim > n - i) {
+                lim = n - i;
+            }
+            const size_t run = nonzero_run(&bytes[i], lim);
+            if (run > 0) {
+                copy_run(&d->payload_buf[d->payload_idx], &bytes[i], run);
+                d->payload_idx = (uint16_t)(d->payload_idx + run);
+                d->cobs_left   = (uint8_t)(d->cobs_left - run);
+                frame_decoder_fold_crc(d);
+                i += run;
+                continue;
+            }
+        }
+
+        const uint8_t b = bytes[i++];
+
+        if (b == FRAME_COBS_DELIM) {
+            if (d->in_frame) {
+                decoder_end_cobs(d);
+            }
+            frame_decoder_clear_frame(d);
+            d->in_frame = 1;
+            continue;
+        }
+
+        if (!d->in_frame) {
+            continue;
+        }
+
+        if (d->cobs_left == 0u) {
+            /* Code byte: the previous block's zero (if any), then a new block. */
+            if (d->cobs_zero) {
+                frame_decoder_consume_byte(d, 0);
+            }
+            d->cobs_code = b;
+            d->cobs_left = (uint8_t)(b - 1u);
+            d->cobs_zero = (b != 0xFFu);
+            continue;
+        }
+
+        d->cobs_left--;
+        frame_decoder_consume_byte(d, b);
+    }
+}
+
+frame_err_t frame_decoder_set_mode(frame_decoder_t *d, frame_mode_t mode)
+{
+    if (d == NULL) {
+        return FRAME_ERR_NULL_ARG;
+    }
+    if (!mode_valid(mode)) {
+        return FRAME_ERR_BAD_MODE;
+    }
+    d->mode      = (uint8_t)mode;
+    d->cobs_feed = (mode == FRAME_MODE_HDLC) ? NULL : decoder_feed_cobs;
+    frame_decoder_reset(d);
+    return FRAME_OK;
+}
@@ -0,0 +1,63 @@
+#ifndef LIB_FRAMING_INTERNAL_H
+#define LIB_FRAMING_INTERNAL_H
+
+/*
+ * Shared between framing.c (HDLC, the decoder core, frame_link) and
+ * framing_cobs.c (the COBS modes). Not part of the public API.
+ *
+ * COBS code is reached only through the cobs_pull / cobs_feed hooks that
+ * frame_encoder_begin_mode() and frame_decoder_set_mode() install, so an
+ * image that never selects a mode (the bootloader) links none of it.
+ */
+
+#include "framing.h"
+
+#include <string.h>
+
+/*
+ * Word-at-a-time scanning. FLAG, ESC and zero are rare in real payloads, so
+ * the encoder and decoder look for them four bytes at a time and copy the
+ * clean runs in between in bulk. -DFRAME_SWAR=0 restores the byte-at-a-time
+ * paths (tests and benchmarks build both; the output is identical).
+ */
+#ifndef FRAME_SWAR
+#define FRAME_SWAR 1
+#endif
+
+#if FRAME_SWAR
+/* Non-zero iff some byte of w is zero (exact, no false positives). */
+#define SWAR_HAS_ZERO(w)     (((w) - 0x01010101u) & ~(w) & 0x80808080u)
+#define SWAR_HAS_BYTE(w, b)  SWAR_HAS_ZERO((w) ^ (0x01010101u * (uint32_t)(b)))
+#endif
+
+/* memcpy() for the long clean runs; short ones are cheaper copied inline. */
+static inline void copy_run(uint8_t *dst, const uint8_t *src, size_t n)
+{
+    if (n >= 16u) {
+        memcpy(dst, src, n);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i];
+        }
+    }
+}
+
+/* Encoder phases, in wire order; COBS replaces HEAD..TAIL with CODE/BLOCK. */
+enum {
+    ENC_OPEN = 0,
+    ENC_HEAD,
+    ENC_PAYLOAD,
+    ENC_TAIL,
+    ENC_CLOSE,
+    ENC_DONE,
+    ENC_CODE,       /* COBS: next block's code byte */
+    ENC_BLOCK,      /* COBS: the block's data bytes */
+};
+
+/* Decoder core (framing.c), driven by either byte format. */
+void frame_decoder_clear_frame(frame_decoder_t *d);
+void frame_decoder_fold_crc(frame_decoder_t *d);
+void frame_decoder_consume_byte(frame_decoder_t *d, uint8_t b);
+void frame_decoder_finalize(frame_decoder_t *d);
+
+#endif /* LIB_FRAMING_INTERNAL_H */
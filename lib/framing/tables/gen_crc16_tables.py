@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Generate the CRC-16-CCITT lookup tables for lib/framing/src/crc16_tables.c.
+
+frame_crc16 (lib/framing/src/crc16.c) is poly 0x1021, MSB first. Three
+table-driven engines share these tables:
+
+- frame_crc16_nibble_table: the 16 register updates for one 4-bit step
+  (32 bytes). Two lookups per byte.
+- frame_crc16_table: the 256 updates for one byte, T0[x] = the register
+  after shifting x << 8 through eight bit steps (512 bytes).
+- frame_crc16_slice_table: T1..T3 for slicing-by-4, Tk[x] = Tk-1[x]
+  advanced through one more zero byte. T0 and the three slices cover four
+  bytes with four lookups (2 KB together).
+
+Each array is a separate object, so an engine links only the tables it
+reads and --gc-sections drops the rest. All of them land in .rodata
+(flash).
+
+Usage:
+    python3 lib/framing/tables/gen_crc16_tables.py > lib/framing/src/crc16_tables.c
+"""
+
+POLY = 0x1021
+
+
+def step(reg: int, bits: int) -> int:
+    """Shift reg through `bits` zero-input bit steps."""
+    for _ in range(bits):
+        reg = ((reg << 1) ^ POLY) if reg & 0x8000 else (reg << 1)
+        reg &= 0xFFFF
+    return reg
+
+
+def advance(t: int, t0: list) -> int:
+    """One more zero byte after register value t."""
+    return ((t << 8) & 0xFFFF) ^ t0[t >> 8]
+
+
+def emit(name: str, dims: str, values: list) -> None:
+    print(f"const uint16_t {name}{dims} = {{")
+    for i in range(0, len(values), 8):
+        row = ", ".join(f"0x{v:04X}" for v in values[i:i + 8])
+        print(f"    {row},")
+    print("};")
+
+
+def main() -> None:
+    nibble = [step(x << 12, 4) for x in range(16)]
+    t0 = [step(x << 8, 8) for x in range(256)]
+    slices = [t0]
+    for _ in range(3):
+        slices.append([advance(t, t0) for t in slices[-1]])
+
+    print("/*")
+    print(" * CRC-16-CCITT lookup tables for the framing CRC engines (framing.h).")
+    print(" *")
+    print(" * Generated by lib/framing/tables/gen_crc16_tables.py - do not edit by hand.")
+    print(" * Poly 0x1021, MSB first: nibble steps, the byte table T0, and the")
+    print(" * slicing-by-4 tables T1..T3 (Tk is T0 advanced through k zero bytes).")
+    print(" */")
+    print()
+    print('#include "framing.h"')
+    print()
+    emit("frame_crc16_nibble_table", "[16]", nibble)
+    print()
+    emit("frame_crc16_table", "[256]", t0)
+    print()
+    print("const uint16_t frame_crc16_slice_table[3][256] = {")
+    for k in range(1, 4):
+        print("    {")
+        for i in range(0, 256, 8):
+            row = ", ".join(f"0x{v:04X}" for v in slices[k][i:i + 8])
+            print(f"        {row},")
+        print("    },")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+#ifndef LIB_LINK_H
+#define LIB_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "framing.h"
+#include "frame_arq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Transport-agnostic link layer (Plan 002): several logical channels (OTA,
+ * telemetry, CLI, ...) multiplexed over one byte stream, on top of
+ * lib/framing's decoder and selective-repeat ARQ.
+ *
+ * Wire format: every message is one sequenced FRAME_TYPE_CHAN frame whose
+ * payload is [CH:1][message]. Both ends must configure the same channels.
+ *
+ * Transmit side:
+ *  - link_send() copies a message into one block of a shared, caller-owned
+ *    pool and queues it on its channel; the block is freed when the peer
+ *    acknowledges the frame. A channel may hold at most max_queued blocks
+ *    (queued + in flight), so one busy channel cannot drain the pool.
+ *  - Whenever the ARQ window has room, link_poll() picks the next message:
+ *    strict priority between levels (0 first), deficit round robin among
+ *    the channels of one level (each gets `quantum` bytes per round).
+ *  - A channel may have at most max_in_flight frames in the window, so a
+ *    bulk channel leaves slots free for urgent traffic. Once sent, a frame
+ *    cannot be overtaken on the wire: a bulk channel's block size bounds
+ *    how long an urgent message waits behind it.
+ *
+ * Strict priority means a saturated level starves the levels below it;
+ * keep high levels for small, latency-sensitive traffic and share a level
+ * with weights (quantum) where throughput should be split.
+ *
+ * Receive side: feed the transport's bytes to link_on_rx_bytes(); messages
+ * come out of rx_cb in order per link (so per channel), exactly once.
+ */
+
+#define LINK_MAX_CHANNELS   8u
+#define LINK_MAX_BLOCKS     64u
+#define LINK_CHAN_OVERHEAD  1u     /* the channel byte */
+
+typedef enum {
+    LINK_OK              = 0,
+    LINK_ERR_NULL_ARG    = -1,
+    LINK_ERR_BAD_CONFIG  = -2,   /* see link_init() */
+    LINK_ERR_BAD_CHANNEL = -3,
+    LINK_ERR_OVERSIZE    = -4,   /* message longer than a block holds */
+    LINK_ERR_NO_BUFFER   = -5,   /* pool empty or channel quota used up */
+    LINK_ERR_DOWN        = -6,   /* a frame ran out of retries */
+} link_err_t;
+
+typedef void (*link_rx_cb_t)(uint8_t channel, const uint8_t *payload,
+                             size_t len, void *user);
+
+typedef struct {
+    uint8_t  priority;       /* 0 = most urgent */
+    uint8_t  max_queued;     /* pool blocks held at once; 0 = no limit */
+    uint8_t  max_in_flight;  /* frames in the ARQ window; 0 = whole window */
+    uint16_t quantum;        /* DRR bytes per round; 0 = one block */
+} link_channel_config_t;
+
+typedef struct {
+    /* Transport, as for frame_arq. */
+    frame_link_write_cb_t  write;    /* required */
+    frame_link_now_ms_cb_t now_ms;   /* required */
+    link_rx_cb_t           rx;       /* required */
+    void                  *user;
+
+    uint32_t timeout_ms;             /* per-frame retransmit timer */
+    uint8_t  max_retries;
+    uint8_t  window;                 /* frame_arq window: 1..FRAME_ARQ_MAX_WINDOW */
+    uint8_t  mode;                   /* frame_mode_t */
+
+    /* Transmit pool: block_count blocks of block_size bytes. */
+    uint8_t *pool;
+    uint16_t block_size;             /* largest message + LINK_CHAN_OVERHEAD */
+    uint8_t  block_count;            /* up to LINK_MAX_BLOCKS */
+
+    /* Receive buffers: the decoder's and the ARQ reorder store. */
+    uint8_t *rx_buf;                 /* block_size bytes */
+    uint8_t *rx_store;               /* window * block_size bytes (window > 1) */
+
+    uint8_t  channel_count;          /* 1..LINK_MAX_CHANNELS */
+    link_channel_config_t channels[LINK_MAX_CHANNELS];
+} link_config_t;
+
+typedef struct {
+    uint32_t tx_messages;
+    uint32_t tx_bytes;
+    uint32_t rx_messages;
+    uint32_t rx_bytes;
+    uint32_t no_buffer;              /* link_send() refusals */
+} link_channel_stats_t;
+
+typedef struct {
+    uint32_t crc_errors;             /* decoder */
+    uint32_t rx_errors;              /* other decoder errors */
+    uint32_t rx_bad_frames;          /* not CHAN, or an unknown channel */
+} link_stats_t;
+
+typedef struct {
+    /* Queue of pool blocks, linked through blk_next, and DRR state. */
+    uint8_t  head, tail;
+    uint8_t  queued;
+    uint8_t  in_flight;
+    uint32_t deficit;
+    uint8_t  visited;                /* quantum already added this round */
+    link_channel_stats_t stats;
+} link_channel_t;
+
+typedef struct {
+    link_config_t cfg;
+
+    /* Internal state. Treat as opaque from outside the module. */
+    frame_arq_t     arq;
+    frame_decoder_t dec;
+    uint8_t  down;
+
+    uint8_t  blk_next[LINK_MAX_BLOCKS];
+    uint16_t blk_len[LINK_MAX_BLOCKS];   /* channel byte included */
+    uint8_t  free_head;
+    uint8_t  free_count;
+    uint8_t  sent_head, sent_tail;       /* in flight, in SEQ order */
+    uint8_t  sent_count;
+    uint8_t  rr;                         /* DRR position */
+
+    link_channel_t ch[LINK_MAX_CHANNELS];
+    link_stats_t   stats;
+} link_t;
+
+/*
+ * Initialise from cfg (copied). Returns LINK_OK, LINK_ERR_NULL_ARG for a
+ * NULL l, cfg, hook or buffer, or LINK_ERR_BAD_CONFIG for a bad window or
+ * mode, no channels or too many, block_size not in
+ * (LINK_CHAN_OVERHEAD, FRAME_MAX_PAYLOAD], or block_count not in
+ * 1..LINK_MAX_BLOCKS.
+ */
+link_err_t link_init(link_t *l, const link_config_t *cfg);
+
+/*
+ * Queue a message (copied) on a channel, and send it at once if the
+ * scheduler and the window allow. Returns
+ * LINK_OK, LINK_ERR_NULL_ARG, LINK_ERR_BAD_CHANNEL, LINK_ERR_OVERSIZE,
+ * LINK_ERR_NO_BUFFER (retry after link_poll() frees blocks) or
+ * LINK_ERR_DOWN.
+ */
+link_err_t link_send(link_t *l, uint8_t channel, const uint8_t *payload, size_t len);
+
+/*
+ * Retransmit timers, then fill the ARQ window from the channel queues. Call
+ * regularly. Returns the number of frames sent, or LINK_ERR_DOWN once a
+ * frame has run out of retries (link_init() again to recover).
+ */
+int link_poll(link_t *l);
+
+/* Bytes from the transport: decode, deliver, and send what the ACKs allow. */
+void link_on_rx_bytes(link_t *l, const uint8_t *bytes, size_t n);
+
+/* Messages queued on a channel and not yet sent (0 for a bad channel). */
+size_t link_queued(const link_t *l, uint8_t channel);
+
+/* Pool blocks free. */
+size_t link_free_blocks(const link_t *l);
+
+/* Per-channel counters, or NULL for a bad channel. */
+const link_channel_stats_t *link_channel_stats(const link_t *l, uint8_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_LINK_H */
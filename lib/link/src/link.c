@@ -0,0 +1,295 @@
+#include "link.h"
+
+#include <string.h>
+
+#define LINK_NO_BLOCK  0xFFu
+
+static inline uint8_t *blk_data(const link_t *l, uint8_t b)
+{
+    return &l->cfg.pool[(size_t)b * l->cfg.block_size];
+}
+
+/* ------------------------------------------------------------------------
+ * frame_arq / decoder hooks (user is the link_t)
+ * ------------------------------------------------------------------------ */
+
+static int link_write(const uint8_t *bytes, size_t n, void *user)
+{
+    const link_t *l = (const link_t *)user;
+    return l->cfg.write(bytes, n, l->cfg.user);
+}
+
+static uint32_t link_now(void *user)
+{
+    const link_t *l = (const link_t *)user;
+    return l->cfg.now_ms(l->cfg.user);
+}
+
+static void link_deliver(frame_type_t type, const uint8_t *payload, size_t len,
+                         void *user)
+{
+    link_t *l = (link_t *)user;
+    if (type != FRAME_TYPE_CHAN || len < LINK_CHAN_OVERHEAD ||
+        payload[0] >= l->cfg.channel_count) {
+        l->stats.rx_bad_frames++;
+        return;
+    }
+    link_channel_t *c = &l->ch[payload[0]];
+    c->stats.rx_messages++;
+    c->stats.rx_bytes += (uint32_t)(len - LINK_CHAN_OVERHEAD);
+    l->cfg.rx(payload[0], &payload[LINK_CHAN_OVERHEAD], len - LINK_CHAN_OVERHEAD,
+              l->cfg.user);
+}
+
+static void link_dec_rx(uint8_t seq, frame_type_t type, const uint8_t *payload,
+                        size_t len, void *user)
+{
+    link_t *l = (link_t *)user;
+    (void)frame_arq_on_frame(&l->arq, seq, type, payload, len);
+}
+
+static void link_dec_err(frame_err_t err, void *user)
+{
+    link_t *l = (link_t *)user;
+    if (err == FRAME_ERR_CRC) {
+        l->stats.crc_errors++;
+    } else {
+        l->stats.rx_errors++;
+    }
+}
+
+/* ------------------------------------------------------------------------
+ * Pool and scheduler
+ * ------------------------------------------------------------------------ */
+
+/* Free the blocks of every frame the peer has acknowledged. */
+static void link_reclaim(link_t *l)
+{
+    const size_t in_flight = frame_arq_in_flight(&l->arq);
+    while (l->sent_count > in_flight) {
+        const uint8_t b = l->sent_head;
+        l->sent_head = l->blk_next[b];
+        l->sent_count--;
+        l->ch[blk_data(l, b)[0]].in_flight--;
+        l->blk_next[b] = l->free_head;
+        l->free_head   = b;
+        l->free_count++;
+    }
+}
+
+static int link_eligible(const link_t *l, uint8_t i)
+{
+    const uint8_t cap = l->cfg.channels[i].max_in_flight;
+    return l->ch[i].queued > 0u && (cap == 0u || l->ch[i].in_flight < cap);
+}
+
+/*
+ * The channel to send from next, or -1: the most urgent level with an
+ * eligible channel, deficit round robin within it. Each visit in a round
+ * adds the channel's quantum; a channel sends while its deficit covers the
+ * message at its head.
+ */
+static int link_pick(link_t *l)
+{
+    const uint8_t n = l->cfg.channel_count;
+    int best = -1;
+    for (uint8_t i = 0; i < n; ++i) {
+        if (link_eligible(l, i) && (best < 0 || l->cfg.channels[i].priority < best)) {
+            best = l->cfg.channels[i].priority;
+        }
+    }
+    if (best < 0) {
+        return -1;
+    }
+    for (;;) {
+        const uint8_t i = l->rr;
+        link_channel_t *c = &l->ch[i];
+        if (link_eligible(l, i) && l->cfg.channels[i].priority == best) {
+            if (!c->visited) {
+                const uint16_t q = l->cfg.channels[i].quantum;
+                c->deficit += (q != 0u) ? q : l->cfg.block_size;
+                c->visited  = 1;
+            }
+            const uint16_t len = l->blk_len[c->head];
+            if (c->deficit >= len) {
+                c->deficit -= len;
+                return i;
+            }
+        }
+        c->visited = 0;
+        l->rr = (uint8_t)((i + 1u) % n);
+    }
+}
+
+/* Send from the channel queues while the ARQ window has room. */
+static int link_fill(link_t *l)
+{
+    int sent = 0;
+    while (frame_arq_in_flight(&l->arq) < l->cfg.window) {
+        const int i = link_pick(l);
+        if (i < 0) {
+            break;
+        }
+        link_channel_t *c = &l->ch[i];
+        const uint8_t b = c->head;
+        if (frame_arq_send(&l->arq, FRAME_TYPE_CHAN, blk_data(l, b), l->blk_len[b]) != FRAME_OK) {
+            c->deficit += l->blk_len[b];   /* transport busy; not sent after all */
+            break;
+        }
+
+        c->head = l->blk_next[b];
+        if (--c->queued == 0u) {
+            c->deficit = 0;
+        }
+        c->in_flight++;
+        c->stats.tx_messages++;
+        c->stats.tx_bytes += (uint32_t)(l->blk_len[b] - LINK_CHAN_OVERHEAD);
+
+        l->blk_next[b] = LINK_NO_BLOCK;
+        if (l->sent_count == 0u) {
+            l->sent_head = b;
+        } else {
+            l->blk_next[l->sent_tail] = b;
+        }
+        l->sent_tail = b;
+        l->sent_count++;
+        sent++;
+    }
+    return sent;
+}
+
+/* ------------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------------ */
+
+link_err_t link_init(link_t *l, const link_config_t *cfg)
+{
+    if (l == NULL || cfg == NULL || cfg->write == NULL || cfg->now_ms == NULL ||
+        cfg->rx == NULL || cfg->pool == NULL || cfg->rx_buf == NULL) {
+        return LINK_ERR_NULL_ARG;
+    }
+    if (cfg->channel_count == 0u || cfg->channel_count > LINK_MAX_CHANNELS ||
+        cfg->block_size <= LINK_CHAN_OVERHEAD || cfg->block_size > FRAME_MAX_PAYLOAD ||
+        cfg->block_count == 0u || cfg->block_count > LINK_MAX_BLOCKS) {
+        return LINK_ERR_BAD_CONFIG;
+    }
+
+    memset(l, 0, sizeof(*l));
+    l->cfg = *cfg;
+
+    const frame_arq_config_t acfg = {
+        .write = link_write, .now_ms = link_now, .deliver = link_deliver, .user = l,
+        .timeout_ms = cfg->timeout_ms, .max_retries = cfg->max_retries,
+        .window = cfg->window, .mode = cfg->mode,
+        .rx_store = cfg->rx_store, .rx_slot_size = cfg->block_size,
+    };
+    frame_err_t rc = frame_arq_init(&l->arq, &acfg);
+    if (rc != FRAME_OK) {
+        return (rc == FRAME_ERR_NULL_ARG) ? LINK_ERR_NULL_ARG : LINK_ERR_BAD_CONFIG;
+    }
+    frame_decoder_init(&l->dec, link_dec_rx, link_dec_err, l, cfg->rx_buf, cfg->block_size);
+    (void)frame_decoder_set_mode(&l->dec, (frame_mode_t)cfg->mode);
+
+    for (uint8_t b = 0; b < cfg->block_count; ++b) {
+        l->blk_next[b] = (uint8_t)((b + 1u < cfg->block_count) ? b + 1u : LINK_NO_BLOCK);
+    }
+    l->free_head  = 0;
+    l->free_count = cfg->block_count;
+    l->sent_head  = LINK_NO_BLOCK;
+    for (uint8_t i = 0; i < LINK_MAX_CHANNELS; ++i) {
+        l->ch[i].head = LINK_NO_BLOCK;
+    }
+    return LINK_OK;
+}
+
+link_err_t link_send(link_t *l, uint8_t channel, const uint8_t *payload, size_t len)
+{
+    if (l == NULL || (payload == NULL && len > 0)) {
+        return LINK_ERR_NULL_ARG;
+    }
+    if (channel >= l->cfg.channel_count) {
+        return LINK_ERR_BAD_CHANNEL;
+    }
+    if (len > (size_t)l->cfg.block_size - LINK_CHAN_OVERHEAD) {
+        return LINK_ERR_OVERSIZE;
+    }
+    if (l->down) {
+        return LINK_ERR_DOWN;
+    }
+
+    link_reclaim(l);
+    link_channel_t *c = &l->ch[channel];
+    const uint8_t quota = l->cfg.channels[channel].max_queued;
+    if (l->free_count == 0u ||
+        (quota != 0u && (uint32_t)c->queued + c->in_flight >= quota)) {
+        c->stats.no_buffer++;
+        return LINK_ERR_NO_BUFFER;
+    }
+
+    const uint8_t b = l->free_head;
+    l->free_head = l->blk_next[b];
+    l->free_count--;
+    uint8_t *p = blk_data(l, b);
+    p[0] = channel;
+    if (len > 0) {
+        memcpy(&p[LINK_CHAN_OVERHEAD], payload, len);
+    }
+    l->blk_len[b]  = (uint16_t)(len + LINK_CHAN_OVERHEAD);
+    l->blk_next[b] = LINK_NO_BLOCK;
+    if (c->queued == 0u) {
+        c->head = b;
+    } else {
+        l->blk_next[c->tail] = b;
+    }
+    c->tail = b;
+    c->queued++;
+
+    (void)link_fill(l);
+    return LINK_OK;
+}
+
+int link_poll(link_t *l)
+{
+    if (l == NULL) {
+        return LINK_ERR_NULL_ARG;
+    }
+    if (l->down || frame_arq_tick(&l->arq) < 0) {
+        l->down = 1;
+        return LINK_ERR_DOWN;
+    }
+    link_reclaim(l);
+    return link_fill(l);
+}
+
+void link_on_rx_bytes(link_t *l, const uint8_t *bytes, size_t n)
+{
+    if (l == NULL || bytes == NULL) {
+        return;
+    }
+    frame_decoder_feed(&l->dec, bytes, n);
+    if (!l->down) {
+        link_reclaim(l);
+        (void)link_fill(l);
+    }
+}
+
+size_t link_queued(const link_t *l, uint8_t channel)
+{
+    if (l == NULL || channel >= l->cfg.channel_count) {
+        return 0;
+    }
+    return l->ch[channel].queued;
+}
+
+size_t link_free_blocks(const link_t *l)
+{
+    return (l == NULL) ? 0u : l->free_count;
+}
+
+const link_channel_stats_t *link_channel_stats(const link_t *l, uint8_t channel)
+{
+    if (l == NULL || channel >= l->cfg.channel_count) {
+        return NULL;
+    }
+    return &l->ch[channel].stats;
+}
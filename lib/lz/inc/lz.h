@@ -0,0 +1,100 @@
+#ifndef LIB_LZ_H
+#define LIB_LZ_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Streaming LZSS decompressor with a bounded history window, for payloads
+ * compressed on the host by tools/_lz.py (OTA images, bulk transfers).
+ *
+ * Stream format:
+ *
+ *   stream  = header group*
+ *   header  = 'L' 'Z' [WBITS] [0]      history window = 1 << WBITS bytes
+ *   group   = [FLAGS] item{1..8}       bit i of FLAGS (LSB first) types item i
+ *   literal = [BYTE]                   FLAGS bit 1
+ *   match   = [D_lo] [L:4 | D_hi:4] [EXT]*
+ *                                      FLAGS bit 0; copy length L + 3 from
+ *                                      distance D + 1. L = 15 adds EXT bytes
+ *                                      to the length, each 255 continuing.
+ *
+ * The stream has no end marker: it ends where its input does, on an item
+ * boundary (lz_decoder_finish() checks that), and the consumer knows the
+ * decompressed size (OTA_BEGIN carries it).
+ *
+ * RAM is the caller's window of 256..4096 bytes (a power of two), which
+ * must be at least the stream's 1 << WBITS. Input may be fed in pieces of
+ * any size; decompressed bytes go to the sink in runs, at the latest when
+ * each feed returns.
+ */
+
+#define LZ_HEADER_SIZE       4u
+#define LZ_MIN_MATCH         3u
+#define LZ_WINDOW_BITS_MIN   8u
+#define LZ_WINDOW_BITS_MAX   12u
+#define LZ_WINDOW_MAX        (1u << LZ_WINDOW_BITS_MAX)
+
+typedef enum {
+    LZ_OK             = 0,
+    LZ_ERR_NULL_ARG   = -1,
+    LZ_ERR_BAD_CONFIG = -2,   /* window size not a power of two in range */
+    LZ_ERR_BAD_HEADER = -3,   /* wrong magic, WBITS or reserved byte */
+    LZ_ERR_WINDOW     = -4,   /* stream needs a bigger window than ours */
+    LZ_ERR_CORRUPT    = -5,   /* match reaches before the start of output */
+    LZ_ERR_TRUNC      = -6,   /* input ended inside the header or an item */
+    LZ_ERR_SINK       = -7,   /* the sink refused a run */
+} lz_err_t;
+
+/* Decompressed bytes, in order. Return 0 to go on, nonzero to stop. */
+typedef int (*lz_sink_cb_t)(const uint8_t *bytes, size_t n, void *user);
+
+typedef struct {
+    uint8_t     *window;
+    uint16_t     mask;         /* window size - 1 */
+    lz_sink_cb_t sink;
+    void        *user;
+
+    /* Internal state. Treat as opaque from outside the module. */
+    uint16_t pos;              /* next write position in the window */
+    uint16_t flushed;          /* first byte not yet passed to the sink */
+    uint32_t total;            /* bytes produced */
+    uint16_t dist_max;         /* the stream's window */
+    uint8_t  state;
+    uint8_t  flags;            /* FLAGS of the current group, shifted */
+    uint8_t  items;            /* items left in the current group */
+    uint8_t  d_lo;
+    uint16_t dist;
+    uint32_t len;
+    int8_t   err;              /* sticky: the first error seen */
+} lz_decoder_t;
+
+/*
+ * Initialise on the caller's window (window_size bytes, a power of two in
+ * 1 << LZ_WINDOW_BITS_MIN .. LZ_WINDOW_MAX). Returns LZ_OK,
+ * LZ_ERR_NULL_ARG or LZ_ERR_BAD_CONFIG.
+ */
+lz_err_t lz_decoder_init(lz_decoder_t *d, uint8_t *window, size_t window_size,
+                         lz_sink_cb_t sink, void *user);
+
+/*
+ * Decompress n more input bytes. Returns LZ_OK, or the first error; after an
+ * error the decoder stays failed until lz_decoder_init().
+ */
+lz_err_t lz_decoder_feed(lz_decoder_t *d, const uint8_t *in, size_t n);
+
+/* End of input: LZ_OK if the stream ended on an item boundary. */
+lz_err_t lz_decoder_finish(const lz_decoder_t *d);
+
+/* Bytes decompressed so far. */
+uint32_t lz_decoder_total(const lz_decoder_t *d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_LZ_H */
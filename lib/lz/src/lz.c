@@ -0,0 +1,197 @@
+#include "lz.h"
+
+enum {
+    LZ_ST_MAGIC0 = 0,
+    LZ_ST_MAGIC1,
+    LZ_ST_WBITS,
+    LZ_ST_RESERVED,
+    LZ_ST_FLAGS,               /* between groups */
+    LZ_ST_ITEM,                /* between items of a group */
+    LZ_ST_MATCH_HI,
+    LZ_ST_MATCH_EXT,
+};
+
+static lz_err_t lz_fail(lz_decoder_t *d, lz_err_t err)
+{
+    d->err = (int8_t)err;
+    return err;
+}
+
+/* Pass the bytes decompressed since the last flush to the sink. */
+static lz_err_t lz_flush(lz_decoder_t *d)
+{
+    if (d->pos != d->flushed &&
+        d->sink(&d->window[d->flushed], (size_t)(d->pos - d->flushed), d->user) != 0) {
+        return lz_fail(d, LZ_ERR_SINK);
+    }
+    d->flushed = d->pos;
+    return LZ_OK;
+}
+
+/* Append one byte; the window is flushed as the write position wraps. */
+static lz_err_t lz_put(lz_decoder_t *d, uint8_t b)
+{
+    d->window[d->pos++] = b;
+    d->total++;
+    if (d->pos > d->mask) {
+        if (lz_flush(d) != LZ_OK) {
+            return LZ_ERR_SINK;
+        }
+        d->pos     = 0;
+        d->flushed = 0;
+    }
+    return LZ_OK;
+}
+
+static lz_err_t lz_copy(lz_decoder_t *d)
+{
+    if (d->dist > d->dist_max || d->dist > d->total) {
+        return lz_fail(d, LZ_ERR_CORRUPT);
+    }
+    uint16_t src = (uint16_t)((d->pos - d->dist) & d->mask);
+    for (uint32_t k = 0; k < d->len; ++k) {
+        if (lz_put(d, d->window[src]) != LZ_OK) {
+            return LZ_ERR_SINK;
+        }
+        src = (uint16_t)((src + 1u) & d->mask);
+    }
+    return LZ_OK;
+}
+
+/* One item done: move to the next, or to the next group's FLAGS. */
+static void lz_next_item(lz_decoder_t *d)
+{
+    d->flags >>= 1;
+    d->state = (--d->items == 0u) ? LZ_ST_FLAGS : LZ_ST_ITEM;
+}
+
+lz_err_t lz_decoder_init(lz_decoder_t *d, uint8_t *window, size_t window_size,
+                         lz_sink_cb_t sink, void *user)
+{
+    if (d == NULL || window == NULL || sink == NULL) {
+        return LZ_ERR_NULL_ARG;
+    }
+    if (window_size < (1u << LZ_WINDOW_BITS_MIN) || window_size > LZ_WINDOW_MAX ||
+        (window_size & (window_size - 1u)) != 0u) {
+        return LZ_ERR_BAD_CONFIG;
+    }
+    d->window   = window;
+    d->mask     = (uint16_t)(window_size - 1u);
+    d->sink     = sink;
+    d->user     = user;
+    d->pos      = 0;
+    d->flushed  = 0;
+    d->total    = 0;
+    d->dist_max = 0;
+    d->state    = LZ_ST_MAGIC0;
+    d->flags    = 0;
+    d->items    = 0;
+    d->d_lo     = 0;
+    d->dist     = 0;
+    d->len      = 0;
+    d->err      = LZ_OK;
+    return LZ_OK;
+}
+
+lz_err_t lz_decoder_feed(lz_decoder_t *d, const uint8_t *in, size_t n)
+{
+    if (d == NULL || (in == NULL && n > 0)) {
+        return LZ_ERR_NULL_ARG;
+    }
+    if (d->err != LZ_OK) {
+        return (lz_err_t)d->err;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t b = in[i];
+        switch (d->state) {
+        case LZ_ST_MAGIC0:
+        case LZ_ST_MAGIC1:
+            if (b != ((d->state == LZ_ST_MAGIC0) ? 'L' : 'Z')) {
+                return lz_fail(d, LZ_ERR_BAD_HEADER);
+            }
+            d->state++;
+            break;
+
+        case LZ_ST_WBITS:
+            if (b < LZ_WINDOW_BITS_MIN || b > LZ_WINDOW_BITS_MAX) {
+                return lz_fail(d, LZ_ERR_BAD_HEADER);
+            }
+            if ((1u << b) > (uint32_t)d->mask + 1u) {
+                return lz_fail(d, LZ_ERR_WINDOW);
+            }
+            d->dist_max = (uint16_t)(1u << b);
+            d->state    = LZ_ST_RESERVED;
+            break;
+
+        case LZ_ST_RESERVED:
+            if (b != 0u) {
+                return lz_fail(d, LZ_ERR_BAD_HEADER);
+            }
+            d->state = LZ_ST_FLAGS;
+            break;
+
+        case LZ_ST_FLAGS:
+            d->flags = b;
+            d->items = 8;
+            d->state = LZ_ST_ITEM;
+            break;
+
+        case LZ_ST_ITEM:
+            if (d->flags & 1u) {
+                if (lz_put(d, b) != LZ_OK) {
+                    return LZ_ERR_SINK;
+                }
+                lz_next_item(d);
+            } else {
+                d->d_lo  = b;
+                d->state = LZ_ST_MATCH_HI;
+            }
+            break;
+
+        case LZ_ST_MATCH_HI:
+            d->dist = (uint16_t)((d->d_lo | ((uint16_t)(b & 0x0Fu) << 8)) + 1u);
+            d->len  = (uint32_t)(b >> 4) + LZ_MIN_MATCH;
+            if ((b >> 4) == 0x0Fu) {
+                d->state = LZ_ST_MATCH_EXT;
+                break;
+            }
+            if (lz_copy(d) != LZ_OK) {
+                return (lz_err_t)d->err;
+            }
+            lz_next_item(d);
+            break;
+
+        case LZ_ST_MATCH_EXT:
+            d->len += b;
+            if (b == 0xFFu) {
+                break;
+            }
+            if (lz_copy(d) != LZ_OK) {
+                return (lz_err_t)d->err;
+            }
+            lz_next_item(d);
+            break;
+
+        default:
+            return lz_fail(d, LZ_ERR_CORRUPT);
+        }
+    }
+    return lz_flush(d);
+}
+
+lz_err_t lz_decoder_finish(const lz_decoder_t *d)
+{
+    if (d == NULL) {
+        return LZ_ERR_NULL_ARG;
+    }
+    if (d->err != LZ_OK) {
+        return (lz_err_t)d->err;
+    }
+    return (d->state == LZ_ST_FLAGS || d->state == LZ_ST_ITEM) ? LZ_OK : LZ_ERR_TRUNC;
+}
+
+uint32_t lz_decoder_total(const lz_decoder_t *d)
+{
+    return (d == NULL) ? 0u : d->total;
+}
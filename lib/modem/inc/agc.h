@@ -0,0 +1,84 @@
+#ifndef LIB_MODEM_AGC_H
+#define LIB_MODEM_AGC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Automatic gain control for the software modem receiver (Plan 002 sub-track
+ * B0). See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * The AWGN channel preserves unit symbol energy, so the slicer and the Costas
+ * loop have so far been fed samples at a known level. A real ADC front end
+ * delivers whatever the link budget leaves — tens of dB below full scale, or
+ * clipping. The AGC sits after the matched filter and ahead of timing/carrier
+ * recovery and normalises the output power to a fixed target:
+ *
+ *   x ──▶ (x) ──▶ y ──▶ downstream
+ *          ▲      │
+ *          g   one-pole |y|^2 estimate p
+ *          └── g += g * (target - p) * 2^-mu_shift
+ *
+ * Feedback form: the power is measured at the output, so the loop settles
+ * where p == target regardless of the input level, and the multiplicative
+ * update makes the settling time (in dB per sample) independent of the
+ * starting gain. The power filter is p += (|y|^2 - p) * 2^-alpha_shift.
+ *
+ * Gain format: a q15-scaled int32 (AGC_GAIN_ONE == 1.0) so the gain can exceed
+ * unity — up to AGC_GAIN_MAX (60 dB), enough to lift a signal 40 dB below full
+ * scale with margin. Outputs saturate like every other q15 stage; when a
+ * sample would clip, the gain takes an immediate fast-attack cut instead of
+ * waiting for the filtered power to catch up, so a sudden strong signal does
+ * not sit in saturation for the loop's time constant.
+ *
+ * Integer sample path; floats appear only in agc_init() and agc_gain_db().
+ */
+
+#define AGC_GAIN_ONE   32768       /* 1.0 in the q15-scaled gain        */
+#define AGC_GAIN_MIN   2048        /* 1/16 (-24 dB)                     */
+#define AGC_GAIN_MAX   (1 << 25)   /* 1024 (+60 dB)                     */
+
+/* Reasonable defaults: ~-12 dBFS output, ~100-sample settling. */
+#define AGC_DEFAULT_TARGET_RMS   0.25f
+#define AGC_DEFAULT_ALPHA_SHIFT  5u
+#define AGC_DEFAULT_MU_SHIFT     2u
+
+typedef struct {
+    int32_t  gain;         /* current gain, q15-scaled (AGC_GAIN_ONE == 1) */
+    uint32_t power;        /* output power estimate, 2^30 == full scale^2  */
+    uint32_t target;       /* target output power, same units              */
+    uint8_t  alpha_shift;  /* power-filter coefficient 2^-alpha_shift      */
+    uint8_t  mu_shift;     /* gain-update step 2^-mu_shift                 */
+    uint32_t clips;        /* samples that hit the fast-attack path        */
+} agc_t;
+
+/*
+ * Initialise with a target output RMS (fraction of full scale, per rail for
+ * I/Q use: the complex target power is 2 * target_rms^2), filter and loop
+ * shifts. Gain starts at unity.
+ */
+void agc_init(agc_t *agc, float target_rms, uint8_t alpha_shift,
+              uint8_t mu_shift);
+
+/* Apply the gain to a real block in place and update the loop per sample. */
+void agc_run(agc_t *agc, q15_t *x, size_t n);
+
+/*
+ * Complex variant: one gain for both rails, driven by |i|^2 + |q|^2, so the
+ * AGC is blind to carrier phase and can run before the Costas loop.
+ */
+void agc_run_iq(agc_t *agc, q15_t *i, q15_t *q, size_t n);
+
+/* Current gain in dB (reporting only). */
+float agc_gain_db(const agc_t *agc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_AGC_H */
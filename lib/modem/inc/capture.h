@@ -0,0 +1,96 @@
+#ifndef LIB_MODEM_CAPTURE_H
+#define LIB_MODEM_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Triggered I/Q snapshot ring for the software modem (Plan 002 sub-track B0).
+ * See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * A receiver loop that misbehaves on target can only be seen through its
+ * samples. capture_t keeps the last CAPTURE_RING samples of one or two rails
+ * (I, and Q when the chain has one) and freezes a window of `len` of them
+ * around a trigger: `pre` before the trigger sample and len - pre from it
+ * on. Samples are numbered from the arm, counting every sample pushed.
+ *
+ * The chain pushes whole blocks. Every test is made once per block — has the
+ * window started, where does it stop — and the per-sample work is one store
+ * per rail into the ring. Blocks wholly before a known window are skipped;
+ * the block that reaches the stop point is cut there and the ring freezes.
+ *
+ * The trigger can be set before the samples arrive (a known symbol instant)
+ * or afterwards, from a decision the chain made on a block it has not pushed
+ * yet (the first bit error): anything still in the ring can be captured, so a
+ * block may be pushed after its own trigger as long as len <= CAPTURE_RING.
+ * Once DONE, capture_read() unrolls the window in time order.
+ */
+
+#define CAPTURE_RING  1024u   /* samples per rail, power of two */
+
+typedef enum {
+    CAPTURE_IDLE      = 0,   /* not armed: pushes are ignored          */
+    CAPTURE_ARMED     = 1,   /* filling the ring, no trigger yet       */
+    CAPTURE_TRIGGERED = 2,   /* trigger set, filling up to the stop    */
+    CAPTURE_DONE      = 3    /* window frozen, ready for capture_read  */
+} capture_state_t;
+
+typedef struct {
+    q15_t    i[CAPTURE_RING];
+    q15_t    q[CAPTURE_RING];
+    uint32_t head;       /* samples pushed since the arm             */
+    uint32_t trigger;    /* trigger sample index                     */
+    uint32_t stop;       /* one past the window's last sample        */
+    uint16_t len;        /* window length                            */
+    uint16_t pre;        /* window samples before the trigger        */
+    uint8_t  state;      /* capture_state_t                          */
+    uint8_t  has_q;      /* 1 if the pushes carried a Q rail         */
+} capture_t;
+
+/*
+ * Arm for a window of len samples (1..CAPTURE_RING), pre of them before the
+ * trigger (pre < len). Sample numbering restarts at 0. Returns len, or 0 if
+ * invalid (c untouched).
+ */
+uint16_t capture_arm(capture_t *c, uint16_t len, uint16_t pre);
+
+/* Disarm: back to IDLE, ring contents kept. */
+void capture_disarm(capture_t *c);
+
+/*
+ * Trigger at sample index `at`. Accepted while ARMED, if the window's first
+ * sample has not already left the ring; the window is then
+ * [at - pre, at + len - pre), cut at sample 0 when at < pre. Returns 1 if
+ * accepted, 0 otherwise (already triggered, not armed, or too late).
+ */
+uint8_t capture_trigger(capture_t *c, uint32_t at);
+
+/*
+ * Push n samples: i, and q unless NULL (Q is then read back as zero). Stores
+ * at most one sample per rail per input; a no-op when IDLE or DONE.
+ */
+void capture_push(capture_t *c, const q15_t *i, const q15_t *q, size_t n);
+
+static inline capture_state_t capture_state(const capture_t *c)
+{
+    return (capture_state_t)c->state;
+}
+
+/*
+ * Copy the frozen window in time order into i_out (and q_out unless NULL).
+ * *trig_out (unless NULL) gets the trigger's offset within it. Returns the
+ * number of samples written, or 0 unless DONE.
+ */
+size_t capture_read(const capture_t *c, q15_t *i_out, q15_t *q_out,
+                    uint16_t *trig_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_CAPTURE_H */
@@ -0,0 +1,100 @@
+#ifndef LIB_MODEM_COSTAS_H
+#define LIB_MODEM_COSTAS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Costas-loop carrier phase/frequency recovery for the software modem (Plan 002
+ * sub-track B0). See docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Runs at the symbol rate on complex baseband (one I/Q pair per symbol, after
+ * the matched filter and decimator):
+ *
+ *   (i, q) ──▶ rotate by -phase ──▶ (i', q') ──▶ slicer
+ *                   ▲                  │
+ *                   │            phase detector e
+ *                  NCO ◀── PI loop filter ◀┘
+ *
+ * Phase detector (decision-directed):
+ *
+ *   BPSK   e = sgn(i') * q'                      ~  A * sin(phi)
+ *   QPSK   e = sgn(i') * q' - sgn(q') * i'       ~ 2a * sin(phi)
+ *
+ * where A is the BPSK amplitude and a the QPSK per-axis amplitude. The loop is
+ * second order (proportional + integral), so it tracks a constant frequency
+ * offset with zero steady-state phase error; the integrator holds the
+ * frequency estimate. BPSK locks modulo pi and QPSK modulo pi/2 — the usual
+ * Costas ambiguity, resolved by differential coding or a known preamble.
+ *
+ * Loop design
+ * -----------
+ * costas_init() takes the normalised noise bandwidth BnT (loop bandwidth over
+ * symbol rate) and damping zeta and derives the PI gains with the standard
+ * discrete-time mapping
+ *
+ *   theta = BnT / (zeta + 1/(4 zeta))
+ *   Kp    = 4 zeta theta   / (1 + 2 zeta theta + theta^2) / Kd
+ *   Ki    = 4 theta^2      / (1 + 2 zeta theta + theta^2) / Kd
+ *
+ * Wider BnT pulls in faster (lock time ~ 1/BnT) but passes more noise: the
+ * residual phase jitter is sigma_phi^2 ~ BnT / (Es/N0). BnT ~ 0.01 with
+ * zeta = 0.707 is a sensible default for a few-hundred-ppm crystal offset.
+ *
+ * The sample path is integer: the phase is a 32-bit NCO word (2^32 == 2*pi),
+ * the gains are Q16 multipliers from q15 detector output to phase-word units,
+ * and the de-rotation uses the lib/dsp NCO table. Floats appear only in
+ * costas_init() and the reporting helpers.
+ */
+
+typedef enum {
+    COSTAS_BPSK = 0,
+    COSTAS_QPSK = 1,
+} costas_mode_t;
+
+typedef struct {
+    costas_mode_t mode;
+    uint32_t phase;   /* current carrier phase estimate (2^32 == 2*pi)       */
+    int32_t  freq;    /* integrator: frequency estimate, phase units/symbol  */
+    int32_t  kp;      /* proportional gain, Q16, q15 error -> phase units    */
+    int32_t  ki;      /* integral gain, Q16                                  */
+    int32_t  err;     /* last phase-detector output (q15 scale, unsaturated) */
+} costas_t;
+
+/*
+ * Initialise a loop. bn_t: normalised noise bandwidth (0 < BnT < ~0.1);
+ * zeta: damping; amplitude: expected per-axis constellation amplitude as a
+ * fraction of full scale (1.0 for full-scale BPSK, ~0.707 for QPSK at unit
+ * symbol energy). Phase and frequency start at zero.
+ */
+void costas_init(costas_t *c, costas_mode_t mode, float bn_t, float zeta,
+                 float amplitude);
+
+/* Clear the phase/frequency state, keeping the loop gains. */
+void costas_reset(costas_t *c);
+
+/*
+ * De-rotate one symbol in place by the current phase estimate, run the phase
+ * detector on the result, and advance the loop.
+ */
+void costas_step(costas_t *c, q15_t *i, q15_t *q);
+
+/* costas_step() over n symbols. */
+void costas_run(costas_t *c, q15_t *i, q15_t *q, size_t n);
+
+/* Current frequency estimate in cycles per symbol (f / Rs). */
+float costas_freq(const costas_t *c);
+
+/* Current phase estimate in radians, wrapped to [-pi, pi). */
+float costas_phase(const costas_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_COSTAS_H */
@@ -0,0 +1,98 @@
+#ifndef LIB_MODEM_DBPSK_H
+#define LIB_MODEM_DBPSK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "bpsk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Differential BPSK with a non-coherent delay-and-multiply detector for the
+ * software modem (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * The bit rides on the phase change, not the phase. Bit 1 repeats the last
+ * symbol and bit 0 inverts it, so the transmitted phase is the running XNOR
+ * of the bits, mapped through bpsk_map(). The chain starts from a reference
+ * symbol of +1.
+ *
+ * The detector multiplies each received sample by the conjugate of the one
+ * before:
+ *
+ *     d_k = Re{ r_k * conj(r_{k-1}) } = I_k I_{k-1} + Q_k Q_{k-1}
+ *
+ * and decides bit 1 when d_k >= 0 (the bpsk_slice() tie rule). A carrier
+ * phase common to both samples cancels, and so does the gain. There is no
+ * carrier recovery and no AGC in front of it. A frequency offset only costs
+ * its phase step per symbol, cos(2 pi f). The price is that each decision
+ * uses two noisy samples. In complex AWGN the theory is
+ *
+ *     Pb = 0.5 * exp(-Eb/N0)
+ *
+ * against Q(sqrt(2 Eb/N0)) for coherent BPSK: ~0.9 dB at 1e-5, more at low
+ * Eb/N0. Errors tend to come in pairs, because one bad sample spoils the
+ * decisions on both sides of it.
+ *
+ * With q == NULL the detector uses I alone (real samples, I_k I_{k-1}). That
+ * is only right with no carrier offset, and the BER is then 2p(1 - p) with
+ * p the coherent BPSK error rate.
+ *
+ * The products are formed in int64, so full-scale inputs of either sign are
+ * exact.
+ */
+
+typedef struct {
+    uint8_t tx_phase;   /* last transmitted symbol: 1 = +1, 0 = -1     */
+    q15_t   rx_i;       /* last received sample (detector reference)  */
+    q15_t   rx_q;
+} dbpsk_t;
+
+/*
+ * Reset both ends to the reference symbol: the transmitter last sent +1 and
+ * the detector expects it (full scale on I).
+ */
+void dbpsk_init(dbpsk_t *d);
+
+/* Differential phase for one bit: 1 keeps the last phase, 0 inverts it. */
+static inline uint8_t dbpsk_encode_bit(dbpsk_t *d, uint8_t bit)
+{
+    d->tx_phase = (uint8_t)(d->tx_phase ^ (~bit & 1u));
+    return d->tx_phase;
+}
+
+/* Delay-and-multiply decision for sample (i1, q1) following (i0, q0). */
+static inline uint8_t dbpsk_detect(q15_t i0, q15_t q0, q15_t i1, q15_t q1)
+{
+    int64_t d = (int64_t)((int32_t)i1 * i0) + (int64_t)((int32_t)q1 * q0);
+    return (d >= 0) ? 1u : 0u;
+}
+
+/* Differentially encode n bits and map them to n BPSK symbols. */
+void dbpsk_mod_block(dbpsk_t *d, const uint8_t *bits, q15_t *syms, size_t n);
+
+/*
+ * Detect n samples (q NULL: I only) to n bits. The last sample carries over
+ * as the reference for the next call.
+ */
+void dbpsk_demod_block(dbpsk_t *d, const q15_t *i, const q15_t *q,
+                       uint8_t *bits, size_t n);
+
+/* Closed-form BER of DBPSK with delay-and-multiply detection in AWGN. */
+double dbpsk_theory_ber(float ebn0_db);
+
+/*
+ * The same averaged over flat Rician fading of factor K (0: Rayleigh) at mean
+ * Eb/N0, with the channel constant over two symbols:
+ * Pb = (1 + K) / (2 (1 + K + g)) * exp(-K g / (1 + K + g)).
+ */
+double dbpsk_fading_theory_ber(float ebn0_db, float k_factor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_DBPSK_H */
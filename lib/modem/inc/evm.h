@@ -0,0 +1,112 @@
+#ifndef LIB_MODEM_EVM_H
+#define LIB_MODEM_EVM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "bpsk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * EVM / MER estimator and constellation statistics for the software modem
+ * (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * BER only moves when a symbol crosses the decision boundary, so telling two
+ * receiver settings apart at a useful SNR takes millions of bits. The error
+ * vector — how far each received point sits from its constellation point —
+ * moves with every symbol, and its power averages down in a few thousand.
+ *
+ * The estimate is decision-directed and blind to the signal level: the slicer
+ * picks the constellation point (the sign of I), and the point's amplitude is
+ * the centroid a = mean(|I|) of the same symbols. With d = |I| (I projected
+ * onto its decision) and Q ideally zero:
+ *
+ *     error power  = var(d) + mean(Q^2)
+ *     MER (dB)     = 10*log10(a^2 / error power)
+ *     EVM rms (%)  = 100 * sqrt(error power) / a
+ *
+ * so one pass keeps only sums (count, sum d, sum d^2, sum Q^2, min/max d) and
+ * the ratio is formed at report time; no level has to be known up front, which
+ * suits every chain (full-scale symbols, RRC peaks, post-AGC). For BPSK after
+ * a matched filter MER = 2*Eb/N0, so the report also gives the Eb/N0 the
+ * receiver effectively sees (MER - 3.01 dB); the gap to the channel's Eb/N0 is
+ * the implementation loss.
+ *
+ * Caveats: below ~4 dB Eb/N0 the decision errors fold noise back onto the
+ * wrong point and MER reads optimistic. Samples clipped at q15 full scale (the
+ * default chains transmit full-scale symbols) have their outer noise cut off,
+ * which also flatters it, so the clipped share is counted and reported;
+ * compare settings at equal drive.
+ */
+
+typedef struct {
+    uint32_t n;          /* symbols accumulated                          */
+    uint64_t sum_d;      /* sum |I|                                      */
+    uint64_t sum_d2;     /* sum I^2 (q30)                                */
+    uint64_t sum_q2;     /* sum Q^2 (q30), quadrature leakage            */
+    uint16_t min_d;      /* smallest / largest |I| seen                  */
+    uint16_t max_d;
+    uint32_t clipped;    /* symbols with |I| at full scale               */
+} evm_t;
+
+/* Report derived from an evm_t. */
+typedef struct {
+    uint32_t symbols;
+    float    centroid;     /* a: mean |I|, fraction of full scale          */
+    float    i_std;        /* spread of |I| about a, fraction of FS        */
+    float    q_rms;        /* rms Q, fraction of FS                        */
+    float    mer_db;       /* a^2 / error power                            */
+    float    evm_rms_pct;
+    float    evm_peak_pct; /* worst I-rail deviation from a, % of a        */
+    float    ebn0_db;      /* MER - 3.01 dB (BPSK, matched-filtered)       */
+    float    clip_pct;     /* symbols at full scale, % of all              */
+} evm_stats_t;
+
+/* MER reported for an error-free constellation (exact points, no Q). */
+#define EVM_MER_CAP_DB  99.0f
+
+/* Empty the accumulators. */
+void evm_reset(evm_t *evm);
+
+/*
+ * Slice one I/Q symbol (BPSK: the sign of I, same tie rule as bpsk_slice) and
+ * accumulate its error vector. Returns the bit.
+ */
+static inline uint8_t evm_slice(evm_t *evm, q15_t i, q15_t q)
+{
+    uint16_t d = (uint16_t)((i < 0) ? -(int32_t)i : i);
+    evm->n++;
+    evm->sum_d  += d;
+    evm->sum_d2 += (uint32_t)d * d;
+    evm->sum_q2 += (uint32_t)((int32_t)q * q);
+    if (d < evm->min_d) {
+        evm->min_d = d;
+    }
+    if (d > evm->max_d) {
+        evm->max_d = d;
+    }
+    if (d >= (uint16_t)Q15_MAX) {
+        evm->clipped++;
+    }
+    return bpsk_slice(i);
+}
+
+/*
+ * bpsk_slice_block() plus accumulation: n symbols from i (and q, or NULL for
+ * a real chain) to bits.
+ */
+void evm_slice_block(evm_t *evm, const q15_t *i, const q15_t *q, uint8_t *bits,
+                     size_t n);
+
+/* Fill *out from the accumulators. Returns 0 (out untouched) if none yet. */
+uint8_t evm_report(const evm_t *evm, evm_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_EVM_H */
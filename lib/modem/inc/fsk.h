@@ -0,0 +1,85 @@
+#ifndef LIB_MODEM_FSK_H
+#define LIB_MODEM_FSK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+#include "goertzel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Orthogonal M-FSK mapper and non-coherent detector for the software modem
+ * (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * Each symbol carries log2(M) bits (MSB first) as one of M real tones held
+ * for N samples. Tone m sits on DFT bin bin0 + m of the N-sample symbol, so
+ * the tones are 1/T apart — the minimum spacing at which they stay orthogonal
+ * with unknown phase — and, being whole cycles per symbol, every symbol
+ * starts at phase zero: continuous phase with no state.
+ *
+ * The detector is a Goertzel bank (lib/dsp goertzel.h) over each symbol:
+ * the tone with the most energy wins. Energy ignores the carrier phase, so
+ * there is no carrier recovery and a phase offset costs nothing; the price is
+ * ~3-4 dB against coherent BPSK at M = 2, narrowing as M grows (more bits per
+ * symbol, same energy decision). Theory for orthogonal non-coherent M-FSK:
+ *
+ *     Ps = sum_{k=1}^{M-1} (-1)^(k+1) C(M-1, k) / (k+1)
+ *                          * exp(-k/(k+1) * log2(M) * Eb/N0)
+ *     Pb = Ps * (M/2) / (M-1)
+ *
+ * Energy: a tone of amplitude A over N samples carries Es = N * A^2 / 2
+ * (full-scale units), Eb = Es / log2(M). fsk_init() takes A; fsk_unit_eb_amp()
+ * gives Eb = 1 — the energy one full-scale BPSK sample carries — so
+ * channel_awgn_apply() at a given Eb/N0 means the same thing for both.
+ *
+ * Tones are generated from the NCO quarter-wave table (lib/dsp nco.h).
+ */
+
+#define FSK_MAX_M    8u
+#define FSK_MAX_N    64u    /* samples per symbol */
+
+/* Amplitude for Eb = 1 at m tones, n samples/symbol: sqrt(2 log2 m / n). */
+float fsk_unit_eb_amp(uint8_t m, uint8_t n);
+
+typedef struct {
+    goertzel_bank_t bank;
+    q15_t    amp;            /* tone amplitude                             */
+    uint8_t  m;              /* tones (2, 4 or 8)                          */
+    uint8_t  bits;           /* log2(m): bits per symbol                   */
+    uint8_t  n;              /* samples per symbol                         */
+    uint8_t  bin0;           /* DFT bin of tone 0                          */
+} fsk_t;
+
+/*
+ * Configure M-FSK: m in {2, 4, 8}; n a power of two in [8, FSK_MAX_N]; tones
+ * on bins bin0..bin0+m-1, which must lie strictly between DC and n/2; amp in
+ * (0, 1]. Returns bits per symbol, or 0 if invalid (f untouched).
+ */
+uint8_t fsk_init(fsk_t *f, uint8_t m, uint8_t n, uint8_t bin0, float amp);
+
+/*
+ * Map nbits bits (a multiple of f->bits) to tones: writes
+ * (nbits / f->bits) * f->n samples to out and returns that count, or 0 if
+ * nbits is not a whole number of symbols.
+ */
+size_t fsk_modulate(const fsk_t *f, const uint8_t *bits, size_t nbits, q15_t *out);
+
+/*
+ * Detect nsamps samples (a multiple of f->n), one Goertzel block per symbol,
+ * writing f->bits bits per symbol. Returns the bit count, or 0 if nsamps is
+ * not a whole number of symbols.
+ */
+size_t fsk_demodulate(fsk_t *f, const q15_t *in, size_t nsamps, uint8_t *bits);
+
+/* Closed-form BER of orthogonal non-coherent M-FSK in AWGN. */
+double fsk_theory_ber(uint8_t m, float ebn0_db);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_FSK_H */
@@ -0,0 +1,107 @@
+#ifndef LIB_MODEM_LMS_EQ_H
+#define LIB_MODEM_LMS_EQ_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Adaptive LMS equaliser for the software modem (Plan 002 sub-track B0). See
+ * docs/wiki/plans/002-dsp-baseband/software-modem.md.
+ *
+ * The RRC matched filter is only optimal for a channel that adds noise. A
+ * multipath channel smears each symbol over its neighbours, and the ISI the
+ * matched filter passes through can dominate the noise. This FIR, placed
+ * after the matched filter, adapts its taps to undo the channel:
+ *
+ *     y[m] = sum_k w[k] * x[m*sps + sps - 1 - k]       (one output per symbol)
+ *     e[m] = d[m] - y[m]
+ *     w[k] = (1 - 2^-leak_shift) * w[k] + 2^-mu_shift * e[m] * x[...]
+ *
+ * with d[m] the known training symbol while the caller supplies one, and the
+ * sliced decision (+/-level) afterwards (decision-directed). With sps = 2 the
+ * taps are T/2-spaced (fractionally spaced): the equaliser then also absorbs
+ * a sampling-phase error, and is insensitive to where within the symbol the
+ * decimator landed.
+ *
+ * Fixed point: the filter runs on q15 taps through the shared dot_q15()
+ * kernel (dot.h), but each tap keeps a q30 shadow that the update writes;
+ * mu * e * x is usually far below one q15 LSB, so updating q15 taps directly
+ * would stall. The leak (0 disables) bleeds the shadow taps toward zero, which
+ * keeps them bounded when the input leaves some direction unexcited (e.g. the
+ * spectral nulls of a band-limited signal) instead of random-walking into
+ * q15 overflow.
+ *
+ * The taps start as a spike at the centre, i.e. a pure delay of eq_delay()
+ * symbols: output m is the estimate of symbol m - eq_delay(), and training
+ * references must be aligned to match.
+ */
+
+#define LMS_EQ_MAX_TAPS  32u
+#define LMS_EQ_MAX_SPS   2u
+
+/* Defaults for the modem: 16 T/2 taps (8 symbols), mu = 2^-7, leak 2^-14. */
+#define LMS_EQ_DEFAULT_TAPS        16u
+#define LMS_EQ_DEFAULT_MU_SHIFT    7u
+#define LMS_EQ_DEFAULT_LEAK_SHIFT  14u
+
+typedef struct {
+    q15_t    w[LMS_EQ_MAX_TAPS];       /* taps used by the filter (q15)        */
+    int32_t  wq30[LMS_EQ_MAX_TAPS];    /* full-precision taps (q30)           */
+    q15_t    z[2u * LMS_EQ_MAX_TAPS];  /* mirrored delay line, z[pos] newest  */
+    uint8_t  pos;
+    uint8_t  ntaps;
+    uint8_t  sps;                      /* input samples per symbol (1 or 2)   */
+    uint8_t  delay;                    /* decision delay, symbols             */
+    uint8_t  mu_shift;
+    uint8_t  leak_shift;
+    q15_t    level;                    /* decision amplitude                  */
+    int32_t  err;                      /* last error d - y (q15 scale)        */
+    uint32_t mse;                      /* smoothed e^2, q30 (1.0 == 2^30)     */
+} lms_eq_t;
+
+/*
+ * Configure an equaliser: ntaps in [2*sps, LMS_EQ_MAX_TAPS], sps 1 (symbol-
+ * spaced) or 2 (T/2), step size 2^-mu_shift, leak 2^-leak_shift per symbol
+ * (leak_shift 0 disables it), and the symbol amplitude decisions slice to
+ * (fraction of full scale). Returns ntaps, or 0 if a parameter is out of range
+ * (eq is then untouched).
+ */
+uint8_t lms_eq_init(lms_eq_t *eq, uint8_t ntaps, uint8_t sps, uint8_t mu_shift,
+                    uint8_t leak_shift, float level);
+
+/* Back to the centre-spike taps with an empty delay line. */
+void lms_eq_reset(lms_eq_t *eq);
+
+/*
+ * Consume eq->sps input samples (one symbol period) from in, return the
+ * equalised symbol and adapt. train points at the reference symbol (q15) or is
+ * NULL for decision-directed adaptation.
+ */
+q15_t lms_eq_step(lms_eq_t *eq, const q15_t *in, const q15_t *train);
+
+/*
+ * nsym symbols: in holds nsym * eq->sps samples, out receives nsym outputs.
+ * train is NULL (decision-directed) or nsym reference symbols.
+ */
+void lms_eq_run(lms_eq_t *eq, const q15_t *in, q15_t *out, size_t nsym,
+                const q15_t *train);
+
+/* Decision delay in symbols: output m estimates input symbol m - delay. */
+static inline size_t lms_eq_delay(const lms_eq_t *eq)
+{
+    return eq->delay;
+}
+
+/* Smoothed mean-square error relative to the decision level, in dB. */
+float lms_eq_mse_db(const lms_eq_t *eq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_MODEM_LMS_EQ_H */
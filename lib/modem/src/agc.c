@@ -0,0 +1,103 @@
+#include "agc.h"
+#include <math.h>
+
+void agc_init(agc_t *agc, float target_rms, uint8_t alpha_shift,
+              uint8_t mu_shift)
+{
+    if (agc == NULL) {
+        return;
+    }
+    if (target_rms <= 0.0f || target_rms > 1.0f) {
+        target_rms = AGC_DEFAULT_TARGET_RMS;
+    }
+    /* Power in units of (q15 full scale)^2 == 2^30. */
+    agc->target      = (uint32_t)(target_rms * target_rms * 1073741824.0f);
+    agc->power       = agc->target;
+    agc->gain        = AGC_GAIN_ONE;
+    agc->alpha_shift = (alpha_shift > 15u) ? 15u : alpha_shift;
+    agc->mu_shift    = (mu_shift > 15u) ? 15u : mu_shift;
+    agc->clips       = 0u;
+}
+
+/*
+ * Scale one sample by the gain. Sets *clipped if the product fell outside
+ * q15 (the output is then saturated).
+ */
+static inline q15_t agc_scale(q15_t x, int32_t gain, int *clipped)
+{
+    int64_t y = ((int64_t)x * gain + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
+    if (y > Q15_MAX) {
+        *clipped = 1;
+        return Q15_MAX;
+    }
+    if (y < Q15_MIN) {
+        *clipped = 1;
+        return Q15_MIN;
+    }
+    return (q15_t)y;
+}
+
+/*
+ * One loop update from the instantaneous output power pwr (2^30 units) against
+ * the effective target: filter the power, then nudge the gain
+ * multiplicatively. A clipped sample instead cuts the gain by 1/8 (~1.2 dB)
+ * straight away.
+ */
+static inline void agc_update(agc_t *agc, uint32_t pwr, uint32_t target,
+                              int clipped)
+{
+    int32_t g = agc->gain;
+    if (clipped) {
+        agc->clips++;
+        g -= g >> 3;
+    } else {
+        int64_t p = (int64_t)agc->power;
+        p += ((int64_t)pwr - p) >> agc->alpha_shift;
+        agc->power = (uint32_t)p;
+
+        int64_t err = (int64_t)target - p;
+        g += (int32_t)(((int64_t)g * err) >> (30 + agc->mu_shift));
+    }
+    if (g < AGC_GAIN_MIN) {
+        g = AGC_GAIN_MIN;
+    } else if (g > AGC_GAIN_MAX) {
+        g = AGC_GAIN_MAX;
+    }
+    agc->gain = g;
+}
+
+void agc_run(agc_t *agc, q15_t *x, size_t n)
+{
+    if (agc == NULL || x == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        int clipped = 0;
+        q15_t y = agc_scale(x[k], agc->gain, &clipped);
+        x[k] = y;
+        agc_update(agc, (uint32_t)((int32_t)y * y), agc->target, clipped);
+    }
+}
+
+void agc_run_iq(agc_t *agc, q15_t *i, q15_t *q, size_t n)
+{
+    if (agc == NULL || i == NULL || q == NULL) {
+        return;
+    }
+    /* Per-rail target RMS -> complex power is twice the real target. */
+    uint32_t target = agc->target << 1;
+    for (size_t k = 0; k < n; k++) {
+        int clipped = 0;
+        q15_t yi = agc_scale(i[k], agc->gain, &clipped);
+        q15_t yq = agc_scale(q[k], agc->gain, &clipped);
+        i[k] = yi;
+        q[k] = yq;
+        uint32_t pwr = (uint32_t)((int32_t)yi * yi) + (uint32_t)((int32_t)yq * yq);
+        agc_update(agc, pwr, target, clipped);
+    }
+}
+
+float agc_gain_db(const agc_t *agc)
+{
+    return 20.0f * log10f((float)agc->gain / (float)AGC_GAIN_ONE);
+}
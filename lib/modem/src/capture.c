@@ -0,0 +1,111 @@
+#include "capture.h"
+
+#define CAPTURE_MASK (CAPTURE_RING - 1u)
+
+/* First sample of the window: pre before the trigger, cut at sample 0. */
+static inline uint32_t capture_start(const capture_t *c)
+{
+    return (c->trigger >= c->pre) ? c->trigger - c->pre : 0u;
+}
+
+uint16_t capture_arm(capture_t *c, uint16_t len, uint16_t pre)
+{
+    if (c == NULL || len == 0u || len > CAPTURE_RING || pre >= len) {
+        return 0u;
+    }
+    c->len     = len;
+    c->pre     = pre;
+    c->head    = 0u;
+    c->trigger = 0u;
+    c->stop    = 0u;
+    c->has_q   = 0u;
+    c->state   = CAPTURE_ARMED;
+    return len;
+}
+
+void capture_disarm(capture_t *c)
+{
+    if (c == NULL) {
+        return;
+    }
+    c->state = CAPTURE_IDLE;
+}
+
+uint8_t capture_trigger(capture_t *c, uint32_t at)
+{
+    if (c == NULL || c->state != CAPTURE_ARMED) {
+        return 0u;
+    }
+    const uint32_t start = (at >= c->pre) ? at - c->pre : 0u;
+    if (c->head > start && c->head - start > CAPTURE_RING) {
+        return 0u;   /* the window's head has already been overwritten */
+    }
+    c->trigger = at;
+    c->stop    = at + (uint32_t)(c->len - c->pre);
+    c->state   = (c->stop <= c->head) ? CAPTURE_DONE : CAPTURE_TRIGGERED;
+    return 1u;
+}
+
+void capture_push(capture_t *c, const q15_t *i, const q15_t *q, size_t n)
+{
+    if (c == NULL || i == NULL ||
+        (c->state != CAPTURE_ARMED && c->state != CAPTURE_TRIGGERED)) {
+        return;
+    }
+
+    /*
+     * Block-level bounds: [from, to) of this block is stored. Armed, only the
+     * last CAPTURE_RING samples can survive; triggered, nothing before the
+     * window's start and nothing past its stop.
+     */
+    size_t from = (n > CAPTURE_RING) ? n - CAPTURE_RING : 0u;
+    size_t to   = n;
+    if (c->state == CAPTURE_TRIGGERED) {
+        const uint32_t start = capture_start(c);
+        if (c->stop - c->head < to) {
+            to = c->stop - c->head;
+        }
+        from = (start > c->head) ? start - c->head : 0u;
+        if (from > to) {
+            from = to;
+        }
+    }
+
+    uint32_t w = c->head + (uint32_t)from;
+    for (size_t k = from; k < to; k++) {
+        c->i[w++ & CAPTURE_MASK] = i[k];
+    }
+    if (q != NULL) {
+        w = c->head + (uint32_t)from;
+        for (size_t k = from; k < to; k++) {
+            c->q[w++ & CAPTURE_MASK] = q[k];
+        }
+    }
+    c->has_q = (q != NULL);
+
+    c->head += (uint32_t)to;
+    if (c->state == CAPTURE_TRIGGERED && c->head == c->stop) {
+        c->state = CAPTURE_DONE;
+    }
+}
+
+size_t capture_read(const capture_t *c, q15_t *i_out, q15_t *q_out,
+                    uint16_t *trig_out)
+{
+    if (c == NULL || i_out == NULL || c->state != CAPTURE_DONE) {
+        return 0u;
+    }
+    const uint32_t start = capture_start(c);
+    const size_t   count = c->stop - start;
+    for (size_t k = 0; k < count; k++) {
+        const uint32_t r = (start + (uint32_t)k) & CAPTURE_MASK;
+        i_out[k] = c->i[r];
+        if (q_out != NULL) {
+            q_out[k] = c->has_q ? c->q[r] : 0;
+        }
+    }
+    if (trig_out != NULL) {
+        *trig_out = (uint16_t)(c->trigger - start);
+    }
+    return count;
+}
@@ -0,0 +1,99 @@
+#include "costas.h"
+#include "nco.h"
+
+#define COSTAS_TWO_PI  6.283185307179586f
+
+/*
+ * Convert a loop gain K (radians of correction per radian of phase error) into
+ * the Q16 multiplier the sample path uses. The detector output is
+ * e = Kd * phi * 32768 (q15), and one radian is 2^32 / (2*pi) phase units, so
+ *
+ *   correction = K * phi * 2^32 / (2*pi) = e * K * 2^17 / (2*pi * Kd)
+ *
+ * and the Q16 gain is that factor times 2^16. Clamped to int32.
+ */
+static int32_t gain_to_q16(float k, float kd)
+{
+    float g = k * 8589934592.0f / (COSTAS_TWO_PI * kd);   /* 2^33 */
+    if (g > 2147483520.0f) {
+        return INT32_MAX;
+    }
+    return (int32_t)(g + 0.5f);
+}
+
+void costas_init(costas_t *c, costas_mode_t mode, float bn_t, float zeta,
+                 float amplitude)
+{
+    if (c == NULL) {
+        return;
+    }
+    c->mode = mode;
+
+    /* Detector slope: A for BPSK, 2a for QPSK (see costas.h). */
+    float kd = (mode == COSTAS_QPSK) ? 2.0f * amplitude : amplitude;
+    if (kd <= 0.0f) {
+        kd = 1.0f;
+    }
+
+    float theta = bn_t / (zeta + 0.25f / zeta);
+    float denom = 1.0f + 2.0f * zeta * theta + theta * theta;
+    c->kp = gain_to_q16(4.0f * zeta * theta / denom, kd);
+    c->ki = gain_to_q16(4.0f * theta * theta / denom, kd);
+
+    costas_reset(c);
+}
+
+void costas_reset(costas_t *c)
+{
+    if (c == NULL) {
+        return;
+    }
+    c->phase = 0u;
+    c->freq  = 0;
+    c->err   = 0;
+}
+
+/* Q16 gain times detector output, rounded, in phase-word units. */
+static inline int32_t apply_gain(int32_t e, int32_t g)
+{
+    return (int32_t)(((int64_t)e * g + (1 << 15)) >> 16);
+}
+
+void costas_step(costas_t *c, q15_t *i, q15_t *q)
+{
+    nco_rotate_iq(0u - c->phase, i, q);
+
+    int32_t e;
+    if (c->mode == COSTAS_QPSK) {
+        int32_t ei = (*i >= 0) ? *q : -(int32_t)*q;
+        int32_t eq = (*q >= 0) ? *i : -(int32_t)*i;
+        e = ei - eq;
+    } else {
+        e = (*i >= 0) ? *q : -(int32_t)*q;
+    }
+    c->err = e;
+
+    /* PI loop filter: the integrator is the frequency, the sum the phase step. */
+    c->freq  += apply_gain(e, c->ki);
+    c->phase += (uint32_t)(c->freq + apply_gain(e, c->kp));
+}
+
+void costas_run(costas_t *c, q15_t *i, q15_t *q, size_t n)
+{
+    if (c == NULL || i == NULL || q == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        costas_step(c, &i[k], &q[k]);
+    }
+}
+
+float costas_freq(const costas_t *c)
+{
+    return (float)c->freq / 4294967296.0f;
+}
+
+float costas_phase(const costas_t *c)
+{
+    return (float)(int32_t)c->phase * (COSTAS_TWO_PI / 4294967296.0f);
+}
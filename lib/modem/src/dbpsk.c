@@ -0,0 +1,59 @@
+#include "dbpsk.h"
+#include <math.h>
+
+void dbpsk_init(dbpsk_t *d)
+{
+    if (d == NULL) {
+        return;
+    }
+    d->tx_phase = 1u;
+    d->rx_i     = BPSK_SYM_HI;
+    d->rx_q     = 0;
+}
+
+void dbpsk_mod_block(dbpsk_t *d, const uint8_t *bits, q15_t *syms, size_t n)
+{
+    if (d == NULL || bits == NULL || syms == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        syms[k] = bpsk_map(dbpsk_encode_bit(d, bits[k]));
+    }
+}
+
+void dbpsk_demod_block(dbpsk_t *d, const q15_t *i, const q15_t *q,
+                       uint8_t *bits, size_t n)
+{
+    if (d == NULL || i == NULL || bits == NULL || n == 0u) {
+        return;
+    }
+    q15_t pi = d->rx_i;
+    q15_t pq = d->rx_q;
+    if (q != NULL) {
+        for (size_t k = 0; k < n; k++) {
+            bits[k] = dbpsk_detect(pi, pq, i[k], q[k]);
+            pi = i[k];
+            pq = q[k];
+        }
+    } else {
+        for (size_t k = 0; k < n; k++) {
+            bits[k] = dbpsk_detect(pi, 0, i[k], 0);
+            pi = i[k];
+        }
+        pq = 0;
+    }
+    d->rx_i = pi;
+    d->rx_q = pq;
+}
+
+double dbpsk_theory_ber(float ebn0_db)
+{
+    return 0.5 * exp(-pow(10.0, (double)ebn0_db / 10.0));
+}
+
+double dbpsk_fading_theory_ber(float ebn0_db, float k_factor)
+{
+    const double g = pow(10.0, (double)ebn0_db / 10.0);
+    const double k = (k_factor > 0.0f) ? (double)k_factor : 0.0;
+    return (1.0 + k) / (2.0 * (1.0 + k + g)) * exp(-k * g / (1.0 + k + g));
+}
@@ -0,0 +1,71 @@
+#include "evm.h"
+#include <math.h>
+
+/* 10*log10(2): MER of BPSK after a matched filter is 2*Eb/N0. */
+#define EVM_BPSK_MER_OFFSET_DB  3.0103f
+
+void evm_reset(evm_t *evm)
+{
+    if (evm == NULL) {
+        return;
+    }
+    evm->n       = 0u;
+    evm->sum_d   = 0u;
+    evm->sum_d2  = 0u;
+    evm->sum_q2  = 0u;
+    evm->min_d   = UINT16_MAX;
+    evm->max_d   = 0u;
+    evm->clipped = 0u;
+}
+
+void evm_slice_block(evm_t *evm, const q15_t *i, const q15_t *q, uint8_t *bits,
+                     size_t n)
+{
+    if (evm == NULL || i == NULL || bits == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < n; k++) {
+        bits[k] = evm_slice(evm, i[k], (q != NULL) ? q[k] : 0);
+    }
+}
+
+uint8_t evm_report(const evm_t *evm, evm_stats_t *out)
+{
+    if (evm == NULL || out == NULL || evm->n == 0u) {
+        return 0u;
+    }
+    const double fs   = 32768.0;
+    const double n    = (double)evm->n;
+    const double a    = (double)evm->sum_d / n;
+    double       var  = (double)evm->sum_d2 / n - a * a;
+    const double q_ms = (double)evm->sum_q2 / n;
+    if (var < 0.0) {
+        var = 0.0;          /* rounding when every |I| is identical */
+    }
+    const double err = var + q_ms;
+
+    out->symbols  = evm->n;
+    out->centroid = (float)(a / fs);
+    out->i_std    = (float)(sqrt(var) / fs);
+    out->q_rms    = (float)(sqrt(q_ms) / fs);
+    out->clip_pct = (float)(100.0 * (double)evm->clipped / n);
+
+    if (a <= 0.0) {
+        out->mer_db       = 0.0f;
+        out->evm_rms_pct  = 0.0f;
+        out->evm_peak_pct = 0.0f;
+        out->ebn0_db      = -EVM_BPSK_MER_OFFSET_DB;
+        return 1u;
+    }
+    double lo = a - (double)evm->min_d;
+    double hi = (double)evm->max_d - a;
+    out->evm_rms_pct  = (float)(100.0 * sqrt(err) / a);
+    out->evm_peak_pct = (float)(100.0 * ((lo > hi) ? lo : hi) / a);
+    out->mer_db       = (err > 0.0) ? (float)(10.0 * log10(a * a / err))
+                                    : EVM_MER_CAP_DB;
+    if (out->mer_db > EVM_MER_CAP_DB) {
+        out->mer_db = EVM_MER_CAP_DB;
+    }
+    out->ebn0_db = out->mer_db - EVM_BPSK_MER_OFFSET_DB;
+    return 1u;
+}
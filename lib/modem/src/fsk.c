@@ -0,0 +1,104 @@
+#include "fsk.h"
+#include "nco.h"
+#include <math.h>
+
+static uint8_t fsk_log2(uint8_t m)
+{
+    switch (m) {
+    case 2u: return 1u;
+    case 4u: return 2u;
+    case 8u: return 3u;
+    default: return 0u;
+    }
+}
+
+float fsk_unit_eb_amp(uint8_t m, uint8_t n)
+{
+    uint8_t b = fsk_log2(m);
+    if (b == 0u || n == 0u) {
+        return 0.0f;
+    }
+    return sqrtf(2.0f * (float)b / (float)n);
+}
+
+uint8_t fsk_init(fsk_t *f, uint8_t m, uint8_t n, uint8_t bin0, float amp)
+{
+    const uint8_t b = fsk_log2(m);
+    if (f == NULL || b == 0u || n < 8u || n > FSK_MAX_N || (n & (n - 1u)) != 0u ||
+        bin0 == 0u || (uint16_t)bin0 + m - 1u >= n / 2u ||
+        !(amp > 0.0f && amp <= 1.0f)) {
+        return 0u;
+    }
+    uint16_t bins[FSK_MAX_M];
+    for (uint8_t k = 0; k < m; k++) {
+        bins[k] = (uint16_t)(bin0 + k);
+    }
+    goertzel_init_bins(&f->bank, bins, m, n);
+    f->amp  = q15_from_float(amp);
+    f->m    = m;
+    f->bits = b;
+    f->n    = n;
+    f->bin0 = bin0;
+    return b;
+}
+
+size_t fsk_modulate(const fsk_t *f, const uint8_t *bits, size_t nbits, q15_t *out)
+{
+    if (f == NULL || bits == NULL || out == NULL || f->bits == 0u ||
+        nbits % f->bits != 0u) {
+        return 0u;
+    }
+    size_t o = 0;
+    for (size_t k = 0; k < nbits; k += f->bits) {
+        uint8_t sym = 0u;
+        for (uint8_t b = 0; b < f->bits; b++) {
+            sym = (uint8_t)((sym << 1) | (bits[k + b] & 1u));
+        }
+        /*
+         * Bin b of an n-sample symbol is b * 2^32 / n of phase per sample (n a
+         * power of two, so exact). Whole cycles per symbol: every tone
+         * restarts at phase 0.
+         */
+        const uint32_t step = (uint32_t)(f->bin0 + sym) * (0xFFFFFFFFu / f->n + 1u);
+        uint32_t phase = 0u;
+        for (uint8_t i = 0; i < f->n; i++) {
+            out[o++] = q15_mul(f->amp, nco_cos(phase));
+            phase += step;
+        }
+    }
+    return o;
+}
+
+size_t fsk_demodulate(fsk_t *f, const q15_t *in, size_t nsamps, uint8_t *bits)
+{
+    if (f == NULL || in == NULL || bits == NULL || f->n == 0u || nsamps % f->n != 0u) {
+        return 0u;
+    }
+    size_t o = 0;
+    for (size_t k = 0; k < nsamps; k += f->n) {
+        goertzel_reset(&f->bank);
+        goertzel_run(&f->bank, &in[k], f->n);
+        uint8_t sym = goertzel_argmax(&f->bank);
+        for (uint8_t b = f->bits; b > 0u; b--) {
+            bits[o++] = (uint8_t)((sym >> (b - 1u)) & 1u);
+        }
+    }
+    return o;
+}
+
+double fsk_theory_ber(uint8_t m, float ebn0_db)
+{
+    const uint8_t b = fsk_log2(m);
+    if (b == 0u) {
+        return 0.0;
+    }
+    const double ebn0 = pow(10.0, (double)ebn0_db / 10.0);
+    double ps = 0.0, binom = 1.0;   /* C(M-1, k), built up term by term */
+    for (uint8_t k = 1u; k < m; k++) {
+        binom = binom * (double)(m - k) / (double)k;
+        double term = binom / (double)(k + 1u) *
+                      exp(-(double)k / (double)(k + 1u) * (double)b * ebn0);
+        ps += (k & 1u) ? term : -term;
+    }
+    return ps * ((double)m / 2.0) / (double)(m - 1u);
+}
@@ -0,0 +1,116 @@
+#include "lms_eq.h"
+#include "dot.h"
+#include <math.h>
+
+/* Error-power smoothing: one-pole, time constant 2^6 symbols. */
+#define LMS_EQ_MSE_SHIFT  6u
+
+/* q30 shadow-tap limits matching the q15 range. */
+#define LMS_EQ_W_MAX  ((int32_t)Q15_MAX << Q15_SHIFT)
+#define LMS_EQ_W_MIN  ((int32_t)Q15_MIN * (1 << Q15_SHIFT))
+
+static uint8_t lms_eq_centre(const lms_eq_t *eq)
+{
+    return (uint8_t)(eq->sps * eq->delay + eq->sps - 1u);
+}
+
+uint8_t lms_eq_init(lms_eq_t *eq, uint8_t ntaps, uint8_t sps, uint8_t mu_shift,
+                    uint8_t leak_shift, float level)
+{
+    if (eq == NULL || sps < 1u || sps > LMS_EQ_MAX_SPS ||
+        ntaps < 2u * sps || ntaps > LMS_EQ_MAX_TAPS ||
+        mu_shift < 1u || mu_shift > 30u || leak_shift > 30u ||
+        level <= 0.0f || level > 1.0f) {
+        return 0u;
+    }
+    eq->ntaps      = ntaps;
+    eq->sps        = sps;
+    eq->delay      = (uint8_t)((ntaps / sps - 1u) / 2u);
+    eq->mu_shift   = mu_shift;
+    eq->leak_shift = leak_shift;
+    eq->level      = q15_from_float(level);
+    lms_eq_reset(eq);
+    return ntaps;
+}
+
+void lms_eq_reset(lms_eq_t *eq)
+{
+    if (eq == NULL) {
+        return;
+    }
+    for (size_t k = 0; k < LMS_EQ_MAX_TAPS; k++) {
+        eq->w[k]    = 0;
+        eq->wq30[k] = 0;
+    }
+    for (size_t k = 0; k < 2u * LMS_EQ_MAX_TAPS; k++) {
+        eq->z[k] = 0;
+    }
+    uint8_t c = lms_eq_centre(eq);
+    eq->w[c]    = Q15_MAX;
+    eq->wq30[c] = LMS_EQ_W_MAX;
+    eq->pos     = 0u;
+    eq->err     = 0;
+    eq->mse     = (uint32_t)((int32_t)eq->level * eq->level);
+}
+
+q15_t lms_eq_step(lms_eq_t *eq, const q15_t *in, const q15_t *train)
+{
+    const uint8_t nt = eq->ntaps;
+
+    for (uint8_t s = 0; s < eq->sps; s++) {
+        if (eq->pos == 0u) {
+            eq->pos = nt;
+        }
+        eq->pos--;
+        eq->z[eq->pos]      = in[s];
+        eq->z[eq->pos + nt] = in[s];
+    }
+    const q15_t *x = &eq->z[eq->pos];
+
+    q15_t y = dot_round_q15(dot_q15(eq->w, x, nt));
+
+    int32_t d = (train != NULL) ? *train : ((y >= 0) ? eq->level : -eq->level);
+    int32_t e = d - y;
+    eq->err = e;
+
+    /* Leaky LMS on the q30 shadow taps, then refresh the q15 copies. */
+    const uint8_t mu = eq->mu_shift, leak = eq->leak_shift;
+    for (uint8_t k = 0; k < nt; k++) {
+        int32_t w = eq->wq30[k];
+        if (leak != 0u) {
+            w -= w >> leak;
+        }
+        int64_t v = (int64_t)w + (((int64_t)e * x[k]) >> mu);
+        if (v > LMS_EQ_W_MAX) {
+            v = LMS_EQ_W_MAX;
+        } else if (v < LMS_EQ_W_MIN) {
+            v = LMS_EQ_W_MIN;
+        }
+        eq->wq30[k] = (int32_t)v;
+        eq->w[k]    = q15_sat((q31_t)((v + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT));
+    }
+
+    int64_t p = eq->mse;
+    p += ((int64_t)((uint32_t)e * (uint32_t)e) - p) >> LMS_EQ_MSE_SHIFT;
+    eq->mse = (uint32_t)p;
+    return y;
+}
+
+void lms_eq_run(lms_eq_t *eq, const q15_t *in, q15_t *out, size_t nsym,
+                const q15_t *train)
+{
+    if (eq == NULL || in == NULL || out == NULL) {
+        return;
+    }
+    for (size_t m = 0; m < nsym; m++) {
+        out[m] = lms_eq_step(eq, &in[m * eq->sps],
+                             (train != NULL) ? &train[m] : NULL);
+    }
+}
+
+float lms_eq_mse_db(const lms_eq_t *eq)
+{
+    float ref = (float)eq->level * (float)eq->level;
+    float mse = (eq->mse > 0u) ? (float)eq->mse : 1.0f;
+    return 10.0f * log10f(mse / ref);
+}
@@ -0,0 +1,250 @@
+#include "unity.h"
+#include "fading.h"
+#include "awgn.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define N_GAIN 20000
+
+static int32_t g_re[N_GAIN], g_im[N_GAIN];
+
+static double gain_pow(size_t k)
+{
+    double r = g_re[k] / 32768.0, i = g_im[k] / 32768.0;
+    return r * r + i * i;
+}
+
+/* --- envelope statistics ------------------------------------------------- */
+
+/*
+ * Rayleigh: |g|^2 is exponential with unit mean, so P(|g|^2 < x) = 1 - e^-x.
+ * Pooled over many seeds (the model is ergodic only as M grows), the mean
+ * power and the CDF at a deep-fade, median and peak level must match.
+ */
+static void test_rayleigh_envelope_distribution(void)
+{
+    static const double xs[] = {0.01, 0.1, 0.693, 2.0};
+    double below[4] = {0}, mean = 0.0, total = 0.0;
+    for (uint32_t seed = 1; seed <= 40; seed++) {
+        channel_fading_t f;
+        channel_fading_init(&f, 0.01f, 0.0f, 0u, seed);
+        channel_fading_gain(&f, g_re, g_im, N_GAIN);
+        for (size_t k = 0; k < N_GAIN; k++) {
+            double p = gain_pow(k);
+            mean += p;
+            for (int j = 0; j < 4; j++) {
+                below[j] += (p < xs[j]);
+            }
+        }
+        total += N_GAIN;
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(0.03, 1.0, mean / total);
+    for (int j = 0; j < 4; j++) {
+        double want = 1.0 - exp(-xs[j]);
+        TEST_ASSERT_DOUBLE_WITHIN(0.1 * want + 0.002, want, below[j] / total);
+    }
+}
+
+/*
+ * Rician: unit mean power for any K, and the normalised fourth moment
+ * E|g|^4 = (2 + 4K + K^2) / (1 + K)^2 (2 for Rayleigh, -> 1 as K grows).
+ */
+static void test_rician_moments(void)
+{
+    static const float ks[] = {1.0f, 4.0f, 10.0f};
+    for (int j = 0; j < 3; j++) {
+        double m2 = 0.0, m4 = 0.0, total = 0.0;
+        for (uint32_t seed = 1; seed <= 20; seed++) {
+            channel_fading_t f;
+            channel_fading_init(&f, 0.01f, ks[j], 0u, seed);
+            channel_fading_gain(&f, g_re, g_im, N_GAIN);
+            for (size_t k = 0; k < N_GAIN; k++) {
+                double p = gain_pow(k);
+                m2 += p;
+                m4 += p * p;
+            }
+            total += N_GAIN;
+        }
+        double k = ks[j];
+        TEST_ASSERT_DOUBLE_WITHIN(0.03, 1.0, m2 / total);
+        TEST_ASSERT_DOUBLE_WITHIN(0.05, (2.0 + 4.0 * k + k * k) / ((1.0 + k) * (1.0 + k)),
+                                  m4 / total);
+    }
+}
+
+/* --- time correlation ---------------------------------------------------- */
+
+/*
+ * Clarke/Jakes: E[g[k] g*[k + tau]] = J0(2 * pi * fd * tau). Averaged over
+ * seeds the real part must follow the Bessel curve through its first zero
+ * (fd * tau = 0.383) and its negative lobe.
+ */
+static void test_autocorrelation_is_j0(void)
+{
+    const double fd = 0.005;
+    static const int taus[] = {0, 20, 50, 77, 100, 150};
+    double acc[6] = {0};
+    double count = 0.0;
+    for (uint32_t seed = 1; seed <= 60; seed++) {
+        channel_fading_t f;
+        channel_fading_init(&f, (float)fd, 0.0f, 0u, seed);
+        channel_fading_gain(&f, g_re, g_im, N_GAIN);
+        for (size_t k = 0; k + 150 < N_GAIN; k += 7) {
+            for (int j = 0; j < 6; j++) {
+                size_t t = k + (size_t)taus[j];
+                acc[j] += ((double)g_re[k] * g_re[t] + (double)g_im[k] * g_im[t]) /
+                          (32768.0 * 32768.0);
+            }
+            count += 1.0;
+        }
+    }
+    for (int j = 0; j < 6; j++) {
+        double want = j0(2.0 * 3.14159265358979 * fd * taus[j]);
+        TEST_ASSERT_DOUBLE_WITHIN(0.05, want, acc[j] / count);
+    }
+}
+
+/*
+ * Knot interpolation plus table lookup against the model evaluated exactly in
+ * double, per sample, from the fader's own phases. init has already stepped
+ * one knot ahead, so the start phases are ph - st and each sample advances by
+ * st / span. Error must stay well under 1% of unit gain at any Doppler.
+ */
+static void test_matches_exact_model(void)
+{
+    static const float fds[] = {0.0005f, 0.01f, 0.05f};
+    const double two_pi = 6.28318530717958647692;
+    for (int j = 0; j < 3; j++) {
+        channel_fading_t f;
+        channel_fading_init(&f, fds[j], 2.0f, 0u, 5u);
+        const channel_fading_t ref = f;
+        const double span = (double)(1u << ref.span_shift);
+        channel_fading_gain(&f, g_re, g_im, 4000);
+
+        for (size_t k = 0; k < 4000; k++) {
+            double c = 0.0, s = 0.0;
+            for (size_t n = 0; n < ref.paths; n++) {
+                double pc = (uint32_t)(ref.ph_c[n] - ref.st_c[n]) +
+                            (double)(int32_t)ref.st_c[n] * k / span;
+                double ps = (uint32_t)(ref.ph_s[n] - ref.st_s[n]) +
+                            (double)(int32_t)ref.st_s[n] * k / span;
+                c += cos(two_pi * pc / 4294967296.0);
+                s += cos(two_pi * ps / 4294967296.0);
+            }
+            double pl = (uint32_t)(ref.ph_los - ref.st_los) +
+                        (double)(int32_t)ref.st_los * k / span;
+            double want_re = c * ref.diff_amp + cos(two_pi * pl / 4294967296.0) * ref.los_amp;
+            double want_im = s * ref.diff_amp + sin(two_pi * pl / 4294967296.0) * ref.los_amp;
+            TEST_ASSERT_DOUBLE_WITHIN(200.0, want_re, (double)g_re[k]);
+            TEST_ASSERT_DOUBLE_WITHIN(200.0, want_im, (double)g_im[k]);
+        }
+    }
+}
+
+/* --- apply and BER ------------------------------------------------------- */
+
+static void test_apply_matches_gain_and_is_deterministic(void)
+{
+    channel_fading_t a, b;
+    channel_fading_init(&a, 0.002f, 3.0f, 0u, 99u);
+    channel_fading_init(&b, 0.002f, 3.0f, 0u, 99u);
+    channel_fading_gain(&a, g_re, g_im, 1000);
+
+    q15_t i[1000], q[1000];
+    for (size_t k = 0; k < 1000; k++) {
+        i[k] = 6000;
+        q[k] = -2000;
+    }
+    channel_fading_apply(&b, i, q, 1000);
+    for (size_t k = 0; k < 1000; k++) {
+        double wr = (6000.0 * g_re[k] + 2000.0 * g_im[k]) / 32768.0;
+        double wi = (6000.0 * g_im[k] - 2000.0 * g_re[k]) / 32768.0;
+        TEST_ASSERT_INT_WITHIN(1, (int)lrint(wr), i[k]);
+        TEST_ASSERT_INT_WITHIN(1, (int)lrint(wi), q[k]);
+    }
+}
+
+/*
+ * Coherent BPSK through the fader with ideal channel knowledge: symbols at a
+ * quarter of full scale (room for fading peaks), complex AWGN at the same
+ * scale, decision on Re(r * conj(g)). Measured BER must track the fading
+ * theory, which at high SNR falls only as 1/(4 Eb/N0) for Rayleigh.
+ */
+static double fading_ber(float ebn0_db, float k_factor, uint32_t seed)
+{
+    enum { N_SYM = 400000, BLK = 1000 };
+    const double amp = 0.25;
+    const float  sig = channel_awgn_sigma(ebn0_db) * (float)(amp * 32768.0);
+    channel_fading_t f;
+    awgn_prng_t rng;
+    channel_fading_init(&f, 0.01f, k_factor, 0u, seed);
+    awgn_prng_seed(&rng, seed);
+
+    uint32_t errors = 0;
+    for (int blk = 0; blk < N_SYM / BLK; blk++) {
+        channel_fading_gain(&f, g_re, g_im, BLK);
+        for (int k = 0; k < BLK; k++) {
+            int bit = (int)(awgn_prng_u32(&rng) >> 31);
+            double s = (bit ? amp : -amp) * 32768.0;
+            double rr = s * g_re[k] / 32768.0 + sig * awgn_prng_gauss(&rng);
+            double ri = s * g_im[k] / 32768.0 + sig * awgn_prng_gauss(&rng);
+            double z  = rr * g_re[k] + ri * g_im[k];
+            errors += ((z > 0.0) != bit);
+        }
+    }
+    return (double)errors / N_SYM;
+}
+
+static void test_ber_tracks_fading_theory(void)
+{
+    static const float snrs[] = {5.0f, 10.0f, 20.0f};
+    static const float ks[]   = {0.0f, 5.0f};
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 2; b++) {
+            double theory = channel_fading_theory_ber(snrs[a], ks[b]);
+            double ber = fading_ber(snrs[a], ks[b], 11u + (uint32_t)(a * 2 + b));
+            TEST_ASSERT_DOUBLE_WITHIN(theory * 0.2, theory, ber);
+        }
+    }
+    /* Rayleigh at 20 dB is still worse than AWGN at 6 dB. */
+    TEST_ASSERT_TRUE(channel_fading_theory_ber(20.0f, 0.0f) >
+                     channel_awgn_theory_ber(6.0f));
+}
+
+static void test_theory_rician_limits(void)
+{
+    /* The Craig integral at tiny K meets the Rayleigh closed form ... */
+    TEST_ASSERT_DOUBLE_WITHIN(1e-4, channel_fading_theory_ber(10.0f, 0.0f),
+                              channel_fading_theory_ber(10.0f, 1e-4f));
+    /* ... and at huge K the AWGN curve. */
+    double awgn = channel_awgn_theory_ber(8.0f);
+    TEST_ASSERT_DOUBLE_WITHIN(awgn * 0.05, awgn, channel_fading_theory_ber(8.0f, 1e4f));
+}
+
+static void test_null_args_safe(void)
+{
+    channel_fading_t f;
+    q15_t x = 0;
+    channel_fading_init(NULL, 0.01f, 0.0f, 0u, 1u);
+    channel_fading_init(&f, 0.01f, 0.0f, 200u, 1u);
+    TEST_ASSERT_EQUAL_UINT8(CHANNEL_FADING_MAX_PATHS, f.paths);
+    channel_fading_gain(&f, NULL, g_im, 1);
+    channel_fading_apply(NULL, &x, &x, 1);
+    channel_fading_apply(&f, &x, NULL, 1);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rayleigh_envelope_distribution);
+    RUN_TEST(test_rician_moments);
+    RUN_TEST(test_autocorrelation_is_j0);
+    RUN_TEST(test_matches_exact_model);
+    RUN_TEST(test_apply_matches_gain_and_is_deterministic);
+    RUN_TEST(test_ber_tracks_fading_theory);
+    RUN_TEST(test_theory_rician_limits);
+    RUN_TEST(test_null_args_safe);
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+#include "unity.h"
+#include "impair.h"
+#include <math.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const double TWO_PI = 6.28318530717958647692;
+
+#define N 6000
+
+static q15_t g_i[N], g_q[N];
+static q15_t g_i2[N], g_q2[N];
+
+/* A two-tone complex test signal with both rails busy. */
+static void fill_signal(q15_t *i, q15_t *q, size_t n)
+{
+    for (size_t k = 0; k < n; k++) {
+        i[k] = (q15_t)lrint(9000.0 * cos(TWO_PI * 0.013 * k) + 4000.0 * sin(TWO_PI * 0.071 * k));
+        q[k] = (q15_t)lrint(9000.0 * sin(TWO_PI * 0.013 * k) - 3000.0 * cos(TWO_PI * 0.047 * k));
+    }
+}
+
+static channel_impair_cfg_t base_cfg(uint32_t stages)
+{
+    channel_impair_cfg_t c;
+    memset(&c, 0, sizeof(c));
+    c.stages = stages;
+    c.seed   = 42u;
+    return c;
+}
+
+/* Every stage on, moderately: used by the determinism tests. */
+static channel_impair_cfg_t full_cfg(void)
+{
+    channel_impair_cfg_t c = base_cfg(0x1FFu);
+    c.mp_ntaps   = 3;
+    c.mp_taps[0] = (channel_cplx_t){0.8f, 0.0f};
+    c.mp_taps[1] = (channel_cplx_t){0.2f, -0.1f};
+    c.mp_taps[2] = (channel_cplx_t){-0.05f, 0.05f};
+    c.fd_norm    = 2e-3f;
+    c.k_factor   = 2.0f;
+    c.ebn0_db    = 12.0f;
+    c.cfo        = 1e-3f;
+    c.phase0_rad = 0.4f;
+    c.pn_rms_rad = 0.01f;
+    c.clock_ppm  = 200.0f;
+    c.dc_i       = 0.01f;
+    c.dc_q       = -0.02f;
+    c.clip_level = 0.9f;
+    c.adc_bits   = 12;
+    return c;
+}
+
+/* --- plumbing ------------------------------------------------------------ */
+
+static void test_empty_mask_is_bit_exact_passthrough(void)
+{
+    fill_signal(g_i, g_q, N);
+    fill_signal(g_i2, g_q2, N);
+    channel_impair_cfg_t c = full_cfg();
+    c.stages = 0u;
+    channel_impair_t ch;
+    channel_impair_init(&ch, &c);
+    channel_impair_apply(&ch, g_i, g_q, N);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(g_i2, g_i, N);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(g_q2, g_q, N);
+    TEST_ASSERT_EQUAL_size_t(0u, channel_impair_delay(&ch));
+}
+
+static void test_deterministic_and_block_size_invariant(void)
+{
+    channel_impair_cfg_t c = full_cfg();
+    channel_impair_t a, b;
+
+    fill_signal(g_i, g_q, N);
+    channel_impair_init(&a, &c);
+    channel_impair_apply(&a, g_i, g_q, N);
+
+    /* Same seed, fed in ragged blocks: identical waveform. */
+    fill_signal(g_i2, g_q2, N);
+    channel_impair_init(&b, &c);
+    size_t done = 0, blk = 1;
+    while (done < N) {
+        size_t n = (N - done < blk) ? N - done : blk;
+        channel_impair_apply(&b, g_i2 + done, g_q2 + done, n);
+        done += n;
+        blk = blk * 3u + 1u;
+    }
+    TEST_ASSERT_EQUAL_INT16_ARRAY(g_i, g_i2, N);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(g_q, g_q2, N);
+    TEST_ASSERT_EQUAL_UINT32(a.slips, b.slips);
+
+    /* A different seed changes the noise. */
+    c.seed = 43u;
+    fill_signal(g_i2, g_q2, N);
+    channel_impair_init(&b, &c);
+    channel_impair_apply(&b, g_i2, g_q2, N);
+    TEST_ASSERT_TRUE(memcmp(g_i, g_i2, sizeof(g_i)) != 0);
+}
+
+/* --- stages -------------------------------------------------------------- */
+
+static void test_multipath_impulse_response(void)
+{
+    channel_impair_cfg_t c = base_cfg(CHANNEL_IMP_MULTIPATH);
+    c.mp_ntaps   = 3;
+    c.mp_taps[0] = (channel_cplx_t){0.5f, 0.25f};
+    c.mp_taps[1] = (channel_cplx_t){0.0f, -0.5f};
+    c.mp_taps[2] = (channel_cplx_t){-0.125f, 0.0f};
+    channel_impair_t ch;
+    channel_impair_init(&ch, &c);
+
+    q15_t i[5] = {32767, 0, 0, 0, 0};
+    q15_t q[5] = {0};
+    channel_impair_apply(&ch, i, q, 5);
+    const int16_t want_i[5] = {16384, 0, -4096, 0, 0};
+    const int16_t want_q[5] = {8192, -16384, 0, 0, 0};
+    for (int k = 0; k < 5; k++) {
+        TEST_ASSERT_INT_WITHIN(1, want_i[k], i[k]);
+        TEST_ASSERT_INT_WITHIN(1, want_q[k], q[k]);
+    }
+}
+
+static void test_awgn_stage_variance_per_rail(void)
+{
+    for (size_t k = 0; k < N; k++) {
+        g_i[k] = 0;
+        g_q[k] = 0;
+    }
+    channel_impair_cfg_t c = base_cfg(CHANNEL_IMP_AWGN);
+    c.ebn0_db = 10.0f;
+    channel_impair_t ch;
+    channel_impair_init(&ch, &c);
+    channel_impair_apply(&ch, g_i, g_q, N);
+
+    double vi = 0.0, vq = 0.0;
+    for (size_t k = 0; k < N; k++) {
+        vi += (double)g_i[k] * g_i[k];
+        vq += (double)g_q[k] * g_q[k];
+    }
+    double sigma = channel_awgn_sigma(10.0f) * 32768.0;
+    TEST_ASSERT_DOUBLE_WITHIN(0.06, 1.0, sqrt(vi / N) / sigma);
+    TEST_ASSERT_DOUBLE_WITHIN(0.06, 1.0, sqrt(vq / N) / sigma);
+}
+
+/*
+ * Phase noise on a constant carrier: the sample-to-sample phase increments
+ * are the Wiener steps, so their RMS must equal pn_rms_rad, and with CFO on
+ * too their mean must be the offset (to within the walk's own spread,
+ * pn_rms / sqrt(N) ~ 2.6e-4).
+ */
+static void test_phase_noise_increment_rms(void)
+{
+    for (size_t k = 0; k < N; k++) {
+        g_i[k] = 30000;
+        g_q[k] = 0;
+    }
+    channel_impair_cfg_t c = base_cfg(CHANNEL_IMP_CFO | CHANNEL_IMP_PHASE_NOISE);
+    c.cfo        = 2e-3f;
+    c.pn_rms_rad = 0.02f;
+    channel_impair_t ch;
+    channel_impair_init(&ch, &c);
+    channel_impair_apply(&ch, g_i, g_q, N);
+
+    double mean = 0.0, var = 0.0;
+    double prev = atan2(g_q[0], g_i[0]);
+    for (size_t k = 1; k < N; k++) {
+        double ph = atan2(g_q[k], g_i[k]);
+        double d = remainder(ph - prev, TWO_PI);
+        mean += d;
+        var  += d * d;
+        prev = ph;
+    }
+    mean /= (N - 1);
+    var = var / (N - 1) - mean * mean;
+    TEST_ASSERT_DOUBLE_WITHIN(8e-4, TWO_PI * 2e-3, mean);
+    TEST_ASSERT_DOUBLE_WITHIN(0.002, 0.02, sqrt(var));
+}
+
+/*
+ * Clock drift on a slow tone: until the first slip the output is the input
+ * resampled at t_k = k * (1 + ppm) - delay; slips then occur once per 1/ppm
+ * samples after the history's slack (2 samples) is used up.
+ */
+static void test_clock_drift_resamples_and_slips(void)
+{
+    const double f = 0.02, eps = 1e-3;
+    for (size_t k = 0; k < N; k++) {
+        g_i[k] = (q15_t)lrint(20000.0 * sin(TWO_PI * f * k));
+        g_q[k] = (q15_t)lrint(20000.0 * cos(TWO_PI * f * k));
+    }
+    channel_impair_cfg_t c = base_cfg(CHANNEL_IMP_CLOCK);
+    c.clock_ppm = (float)(eps * 1e6);
+    channel_impair_t ch;
+    channel_impair_init(&ch, &c);
+    TEST_ASSERT_EQUAL_size_t(CHANNEL_IMPAIR_CLK_DELAY, channel_impair_delay(&ch));
+    channel_impair_apply(&ch, g_i, g_q, N);
+
+    for (size_t k = 10; k < 1900; k++) {
+        double t = k * (1.0 + eps) - CHANNEL_IMPAIR_CLK_DELAY;
+        TEST_ASSERT_INT_WITHIN(6, (int)lrint(20000.0 * sin(TWO_PI * f * t)), g_i[k]);
+        TEST_ASSERT_INT_WITHIN(6, (int)lrint(20000.0 * cos(TWO_PI * f * t)), g_q[k]);
+    }
+    /* First slip at ~2/eps, then one per 1/eps: 2000, 3000, 4000, 5000. */
+    TEST_ASSERT_EQUAL_UINT32(4u, ch.slips);
+}
+
+static void test_dc_clip_and_quantise(void)
+{
+    fill_signal(g_i, g_q, N);
+    fill_signal(g_i2, g_q2, N);
+    channel_impair_cfg_t c = base_cfg(CHANNEL_IMP_DC | CHANNEL_IMP_CLIP | CHANNEL_IMP_ADC);
+    c.dc_i       = 0.125f;       /* +4096 */
+    c.dc_q       = -0.0625f;     /* -2048 */
+    c.clip_level = 0.375f;       /* 12288 */
+    c.adc_bits   = 8;            /* step 256 */
+    channel_impair_t ch;
+    channel_impair_init(&ch, &c);
+    channel_impair_apply(&ch, g_i, g_q, N);
+
+    for (size_t k = 0; k < N; k++) {
+        int wi = g_i2[k] + 4096, wq = g_q2[k] - 2048;
+        wi = wi > 12288 ? 12288 : (wi < -12288 ? -12288 : wi);
+        wq = wq > 12288 ? 12288 : (wq < -12288 ? -12288 : wq);
+        TEST_ASSERT_EQUAL_INT(0, g_i[k] % 256);
+        TEST_ASSERT_EQUAL_INT(0, g_q[k] % 256);
+        TEST_ASSERT_INT_WITHIN(128, wi, g_i[k]);
+        TEST_ASSERT_INT_WITHIN(128, wq, g_q[k]);
+    }
+}
+
+static void test_null_args_safe(void)
+{
+    channel_impair_t ch;
+    channel_impair_cfg_t c = full_cfg();
+    q15_t x = 0;
+    channel_impair_init(NULL, &c);
+    channel_impair_init(&ch, NULL);
+    channel_impair_init(&ch, &c);
+    channel_impair_apply(NULL, &x, &x, 1);
+    channel_impair_apply(&ch, &x, NULL, 1);
+    TEST_ASSERT_EQUAL_size_t(0u, channel_impair_delay(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_mask_is_bit_exact_passthrough);
+    RUN_TEST(test_deterministic_and_block_size_invariant);
+    RUN_TEST(test_multipath_impulse_response);
+    RUN_TEST(test_awgn_stage_variance_per_rail);
+    RUN_TEST(test_phase_noise_increment_rms);
+    RUN_TEST(test_clock_drift_resamples_and_slips);
+    RUN_TEST(test_dc_clip_and_quantise);
+    RUN_TEST(test_null_args_safe);
+    return UNITY_END();
+}
@@ -0,0 +1,223 @@
+#include "unity.h"
+#include "cordic.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const double PI = 3.14159265358979323846;
+
+/* One q15 angle LSB in radians. */
+static const double ANGLE_LSB = 3.14159265358979323846 / 32768.0;
+
+/* Wrapped difference between two q15 angles, in LSBs. */
+static int angle_err_lsb(q15_t got, double ref_rad)
+{
+    double ref = ref_rad / ANGLE_LSB;
+    double d = fmod((double)got - ref, 65536.0);
+    if (d > 32768.0) {
+        d -= 65536.0;
+    } else if (d < -32768.0) {
+        d += 65536.0;
+    }
+    return (int)lrint(fabs(d));
+}
+
+/* Deterministic q15 test points covering every octant and magnitude scale. */
+static uint32_t g_lcg = 1u;
+static q15_t rand_q15(void)
+{
+    g_lcg = g_lcg * 1664525u + 1013904223u;
+    return (q15_t)(g_lcg >> 16);
+}
+
+/* --- vectoring ----------------------------------------------------------- */
+
+static void test_atan2_axes_and_diagonals(void)
+{
+    const int n = CORDIC_ITER_Q15;
+    TEST_ASSERT_INT_WITHIN(1, 0,      cordic_atan2(0, 20000, n));
+    TEST_ASSERT_INT_WITHIN(1, 16384,  cordic_atan2(20000, 0, n));      /* +pi/2 */
+    TEST_ASSERT_INT_WITHIN(1, -16384, cordic_atan2(-20000, 0, n));     /* -pi/2 */
+    TEST_ASSERT_INT_WITHIN(1, 8192,   cordic_atan2(10000, 10000, n));  /* +pi/4 */
+    TEST_ASSERT_INT_WITHIN(1, -24576, cordic_atan2(-10000, -10000, n));/* -3pi/4 */
+    /* Negative real axis is +/-pi: both wrap to Q15_MIN. */
+    TEST_ASSERT_LESS_OR_EQUAL(1, angle_err_lsb(cordic_atan2(0, -20000, n), PI));
+    /* atan2(0, 0) is defined as 0. */
+    TEST_ASSERT_EQUAL_INT16(0, cordic_atan2(0, 0, n));
+}
+
+/*
+ * Angle error vs libm atan2 over random vectors. Vectors shorter than ~1000
+ * LSB are skipped: their true angle is only known to ~1/|v| rad after q15
+ * quantisation of the inputs, which is the input's limit, not CORDIC's.
+ */
+static void test_atan2_matches_libm(void)
+{
+    int worst = 0;
+    g_lcg = 7u;
+    for (int t = 0; t < 20000; t++) {
+        q15_t i = rand_q15(), q = rand_q15();
+        if (hypot(i, q) < 1000.0) {
+            continue;
+        }
+        int e = angle_err_lsb(cordic_atan2(q, i, CORDIC_ITER_Q15), atan2(q, i));
+        if (e > worst) {
+            worst = e;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(2, worst);
+}
+
+static void test_magnitude_matches_libm(void)
+{
+    int worst = 0;
+    g_lcg = 11u;
+    for (int t = 0; t < 20000; t++) {
+        /* Halve the inputs so |v| < 1.0 and the reference never saturates. */
+        q15_t i = (q15_t)(rand_q15() / 2), q = (q15_t)(rand_q15() / 2);
+        int e = (int)lrint(fabs(cordic_mag(i, q, CORDIC_ITER_Q15) - hypot(i, q)));
+        if (e > worst) {
+            worst = e;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(2, worst);
+}
+
+static void test_magnitude_saturates(void)
+{
+    /* |(-1, -1)| = sqrt(2) is out of q15 range. */
+    TEST_ASSERT_EQUAL_INT16(Q15_MAX, cordic_mag(Q15_MIN, Q15_MIN, CORDIC_ITER_Q15));
+    TEST_ASSERT_EQUAL_INT16(Q15_MAX, cordic_mag(Q15_MAX, Q15_MAX, CORDIC_ITER_Q15));
+    TEST_ASSERT_EQUAL_INT16(0, cordic_mag(0, 0, CORDIC_ITER_Q15));
+}
+
+/*
+ * Fewer iterations are coarser but bounded: the residual angle after n steps
+ * is below atan(2^-(n-1)), so the error must stay inside that bound and
+ * shrink as iterations are added.
+ */
+static void test_error_shrinks_with_iterations(void)
+{
+    int prev = 1 << 30;
+    for (unsigned n = 4; n <= CORDIC_ITER_Q15; n += 4) {
+        int worst = 0;
+        g_lcg = 3u;
+        for (int t = 0; t < 4000; t++) {
+            q15_t i = rand_q15(), q = rand_q15();
+            if (hypot(i, q) < 1000.0) {
+                continue;
+            }
+            int e = angle_err_lsb(cordic_atan2(q, i, n), atan2(q, i));
+            if (e > worst) {
+                worst = e;
+            }
+        }
+        double bound = atan(ldexp(1.0, -(int)(n - 1))) / ANGLE_LSB + 2.0;
+        TEST_ASSERT_LESS_OR_EQUAL((int)bound, worst);
+        TEST_ASSERT_LESS_OR_EQUAL(prev, worst);
+        prev = worst;
+    }
+}
+
+/* --- rotation ------------------------------------------------------------ */
+
+static void test_rotate_matches_libm(void)
+{
+    int worst = 0;
+    g_lcg = 19u;
+    for (int t = 0; t < 20000; t++) {
+        q15_t i0 = (q15_t)(rand_q15() / 2), q0 = (q15_t)(rand_q15() / 2);
+        q15_t a = rand_q15();
+        double phi = a * ANGLE_LSB;
+        double ri = i0 * cos(phi) - q0 * sin(phi);
+        double rq = i0 * sin(phi) + q0 * cos(phi);
+
+        q15_t i = i0, q = q0;
+        cordic_rotate(&i, &q, a, CORDIC_ITER_Q15);
+        int ei = (int)lrint(fabs(i - ri));
+        int eq = (int)lrint(fabs(q - rq));
+        if (ei > worst) {
+            worst = ei;
+        }
+        if (eq > worst) {
+            worst = eq;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(2, worst);
+}
+
+static void test_sincos_matches_libm(void)
+{
+    int worst = 0;
+    for (int a = -32768; a < 32768; a += 37) {
+        q15_t s, c;
+        cordic_sincos((q15_t)a, CORDIC_ITER_Q15, &s, &c);
+        double phi = a * ANGLE_LSB;
+        int es = (int)lrint(fabs(s - 32767.0 * sin(phi)));
+        int ec = (int)lrint(fabs(c - 32767.0 * cos(phi)));
+        if (es > worst) {
+            worst = es;
+        }
+        if (ec > worst) {
+            worst = ec;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(2, worst);
+}
+
+static void test_rotate_then_vector_roundtrip(void)
+{
+    /* Rotating by phi and measuring the angle must give back phi (mod 2pi). */
+    for (int a = -32768; a < 32768; a += 811) {
+        q15_t i = 20000, q = 0;
+        cordic_rotate(&i, &q, (q15_t)a, CORDIC_ITER_Q15);
+        q15_t mag, ang;
+        cordic_vector(i, q, CORDIC_ITER_Q15, &mag, &ang);
+        TEST_ASSERT_INT_WITHIN(3, 20000, mag);
+        TEST_ASSERT_LESS_OR_EQUAL(3, angle_err_lsb(ang, a * ANGLE_LSB));
+    }
+}
+
+static void test_rotate_block_and_null_safety(void)
+{
+    q15_t i[4] = {10000, 0, -10000, 0};
+    q15_t q[4] = {0, 10000, 0, -10000};
+    cordic_rotate_block(i, q, 4, 16384, CORDIC_ITER_Q15);   /* +90 deg */
+    TEST_ASSERT_INT_WITHIN(1, 0,      i[0]);
+    TEST_ASSERT_INT_WITHIN(1, 10000,  q[0]);
+    TEST_ASSERT_INT_WITHIN(1, -10000, i[1]);
+    TEST_ASSERT_INT_WITHIN(1, 0,      q[1]);
+    TEST_ASSERT_INT_WITHIN(1, -10000, q[2]);
+    TEST_ASSERT_INT_WITHIN(1, 10000,  i[3]);
+
+    cordic_rotate(NULL, q, 100, CORDIC_ITER_Q15);
+    cordic_rotate_block(i, NULL, 4, 100, CORDIC_ITER_Q15);
+    cordic_vector(1000, 1000, CORDIC_ITER_Q15, NULL, NULL);
+    /* Out-of-range iteration counts clamp instead of reading past the tables. */
+    TEST_ASSERT_INT_WITHIN(2, 8192, cordic_atan2(10000, 10000, 1000u));
+    TEST_ASSERT_INT_WITHIN(4096, 8192, cordic_atan2(10000, 10000, 0u));
+}
+
+static void test_angle_phase_bridge(void)
+{
+    TEST_ASSERT_EQUAL_INT16(16384, CORDIC_ANGLE_FROM_PHASE(0x40000000u));
+    TEST_ASSERT_EQUAL_INT16(Q15_MIN, CORDIC_ANGLE_FROM_PHASE(0x80000000u));
+    TEST_ASSERT_EQUAL_HEX32(0xC0000000u, CORDIC_ANGLE_TO_PHASE((q15_t)-16384));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_atan2_axes_and_diagonals);
+    RUN_TEST(test_atan2_matches_libm);
+    RUN_TEST(test_magnitude_matches_libm);
+    RUN_TEST(test_magnitude_saturates);
+    RUN_TEST(test_error_shrinks_with_iterations);
+    RUN_TEST(test_rotate_matches_libm);
+    RUN_TEST(test_sincos_matches_libm);
+    RUN_TEST(test_rotate_then_vector_roundtrip);
+    RUN_TEST(test_rotate_block_and_null_safety);
+    RUN_TEST(test_angle_phase_bridge);
+    return UNITY_END();
+}
@@ -0,0 +1,72 @@
+#include "unity.h"
+#include "dot.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define N 67
+
+static q15_t g_a[N + 1], g_b[N + 1];
+
+static void fill(uint32_t seed)
+{
+    uint32_t s = seed;
+    for (size_t k = 0; k < N + 1; k++) {
+        s = s * 1664525u + 1013904223u;
+        g_a[k] = (q15_t)(s >> 16);
+        s = s * 1664525u + 1013904223u;
+        g_b[k] = (q15_t)(s >> 16);
+    }
+}
+
+static int64_t ref_dot(const q15_t *a, const q15_t *b, size_t n)
+{
+    int64_t acc = 0;
+    for (size_t k = 0; k < n; k++) {
+        acc += (int64_t)a[k] * b[k];
+    }
+    return acc;
+}
+
+/* Every length (tail handling) and an odd start (unaligned pairs on target). */
+static void test_matches_reference_all_lengths_and_offsets(void)
+{
+    fill(1u);
+    for (size_t off = 0; off < 2; off++) {
+        for (size_t n = 0; n <= N - off; n++) {
+            int64_t want = ref_dot(g_a + off, g_b + off, n);
+            TEST_ASSERT_TRUE(dot_q15(g_a + off, g_b + off, n) == want);
+        }
+    }
+}
+
+/* Full-scale worst case: no 32-bit overflow anywhere in the sum. */
+static void test_extremes_do_not_overflow(void)
+{
+    for (size_t k = 0; k < N; k++) {
+        g_a[k] = Q15_MIN;
+        g_b[k] = Q15_MIN;
+    }
+    TEST_ASSERT_TRUE(dot_q15(g_a, g_b, N) == (int64_t)N << 30);
+    for (size_t k = 0; k < N; k++) {
+        g_b[k] = Q15_MAX;
+    }
+    TEST_ASSERT_TRUE(dot_q15(g_a, g_b, N) == -(int64_t)N * 32768 * 32767);
+}
+
+static void test_round_q15(void)
+{
+    TEST_ASSERT_EQUAL_INT16(1, dot_round_q15(1 << 14));
+    TEST_ASSERT_EQUAL_INT16(0, dot_round_q15((1 << 14) - 1));
+    TEST_ASSERT_EQUAL_INT16(Q15_MAX, dot_round_q15((int64_t)1 << 40));
+    TEST_ASSERT_EQUAL_INT16(Q15_MIN, dot_round_q15(-((int64_t)1 << 40)));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_reference_all_lengths_and_offsets);
+    RUN_TEST(test_extremes_do_not_overflow);
+    RUN_TEST(test_round_q15);
+    return UNITY_END();
+}
@@ -1,5 +1,10 @@
 #include "unity.h"
 #include "fixed.h"
+#include "dot.h"
+#ifdef Q15_SAT_STATS
+#include "rrc.h"
+#include "awgn.h"
+#endif
 
 void setUp(void) {}
 void tearDown(void) {}
@@ -98,6 +103,92 @@ static void test_to_float_roundtrip(void)
     }
 }
 
+/* --- saturation telemetry ------------------------------------------------ */
+
+#ifdef Q15_SAT_STATS
+
+/* Only clamps count: in-range values, and the endpoints themselves, do not. */
+static void test_sat_count_counts_clamps_only(void)
+{
+    uint32_t c0 = q15_sat_count();
+    (void)q15_sat(1234);
+    (void)q15_sat((q31_t)Q15_MAX);
+    (void)q15_sat((q31_t)Q15_MIN);
+    (void)q15_add(16000, 16000);
+    (void)q15_mul(Q15_ONE, Q15_MIN);
+    TEST_ASSERT_EQUAL_UINT32(0u, q15_sat_count() - c0);
+
+    (void)q15_sat(40000);
+    (void)q15_sat(-40000);
+    (void)q15_add(30000, 30000);
+    (void)q15_mul(Q15_MIN, Q15_MIN);
+    (void)dot_round_q15((int64_t)1 << 40);
+    (void)dot_round_q15(-((int64_t)1 << 40));
+    TEST_ASSERT_EQUAL_UINT32(6u, q15_sat_count() - c0);
+}
+
+/*
+ * The matched filter's DC gain is about sqrt(sps): a full-scale constant
+ * clamps every output once the delay line fills, a quarter-scale one never.
+ */
+static void test_sat_count_rrc_push(void)
+{
+    rrc_t f;
+    TEST_ASSERT_NOT_EQUAL(0u, rrc_design(&f, 0.35f, 4u, 8u));
+
+    uint32_t c0 = q15_sat_count();
+    for (uint16_t k = 0; k < 200u; k++) {
+        (void)rrc_push(&f, Q15_MAX / 4);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0u, q15_sat_count() - c0);
+
+    rrc_reset(&f);
+    for (uint16_t k = 0; k < 200u; k++) {
+        (void)rrc_push(&f, Q15_MAX);
+    }
+    uint32_t hits = q15_sat_count() - c0;
+    TEST_ASSERT_TRUE(hits > 100u && hits < 200u);
+}
+
+/*
+ * Noise on a full-scale symbol clamps whenever it points outward: about half
+ * the samples, at any Eb/N0 low enough that the noise is not rounded away.
+ * Half-scale symbols at 20 dB stay clear.
+ */
+static void test_sat_count_awgn(void)
+{
+    static q15_t x[4096];
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, 1u);
+
+    for (size_t k = 0; k < 4096u; k++) {
+        x[k] = Q15_MAX / 2;
+    }
+    uint32_t c0 = q15_sat_count();
+    channel_awgn_apply(x, 4096u, 20.0f, &rng);
+    TEST_ASSERT_EQUAL_UINT32(0u, q15_sat_count() - c0);
+
+    for (size_t k = 0; k < 4096u; k++) {
+        x[k] = (k & 1u) ? Q15_MAX : Q15_MIN;
+    }
+    channel_awgn_apply(x, 4096u, 6.0f, &rng);
+    uint32_t hits = q15_sat_count() - c0;
+    TEST_ASSERT_UINT32_WITHIN(200u, 2048u, hits);
+}
+
+#else
+
+/* Compiled out, the counter is the constant 0 however much clamps. */
+static void test_sat_count_compiled_out(void)
+{
+    (void)q15_sat(40000);
+    (void)q15_add(30000, 30000);
+    (void)dot_round_q15((int64_t)1 << 40);
+    TEST_ASSERT_EQUAL_UINT32(0u, q15_sat_count());
+}
+
+#endif
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -112,5 +203,12 @@ int main(void)
     RUN_TEST(test_from_float_round_half_away_from_zero);
     RUN_TEST(test_from_float_saturates);
     RUN_TEST(test_to_float_roundtrip);
+#ifdef Q15_SAT_STATS
+    RUN_TEST(test_sat_count_counts_clamps_only);
+    RUN_TEST(test_sat_count_rrc_push);
+    RUN_TEST(test_sat_count_awgn);
+#else
+    RUN_TEST(test_sat_count_compiled_out);
+#endif
     return UNITY_END();
 }
@@ -0,0 +1,125 @@
+#include "unity.h"
+#include "goertzel.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static goertzel_bank_t g_bank;
+static q15_t g_x[GOERTZEL_MAX_N];
+
+static void fill_tone(q15_t *x, size_t n, double f, double amp, double phase)
+{
+    for (size_t t = 0; t < n; t++) {
+        x[t] = (q15_t)lrint(amp * 32767.0 * cos(2.0 * M_PI * f * (double)t + phase));
+    }
+}
+
+/* |sum x[t] e^(-j 2 pi f t)|^2 in double, the quantity Goertzel returns. */
+static double dft_power(const q15_t *x, size_t n, double f)
+{
+    double re = 0.0, im = 0.0;
+    for (size_t t = 0; t < n; t++) {
+        re += x[t] * cos(2.0 * M_PI * f * (double)t);
+        im -= x[t] * sin(2.0 * M_PI * f * (double)t);
+    }
+    return re * re + im * im;
+}
+
+static void test_init_validates(void)
+{
+    const float ok[2] = {0.1f, 0.25f};
+    const float bad[2] = {0.1f, 0.6f};
+    const uint16_t bins[2] = {1u, 3u};
+    TEST_ASSERT_EQUAL_UINT8(0u, goertzel_init(NULL, ok, 2u));
+    TEST_ASSERT_EQUAL_UINT8(0u, goertzel_init(&g_bank, NULL, 2u));
+    TEST_ASSERT_EQUAL_UINT8(0u, goertzel_init(&g_bank, ok, 0u));
+    TEST_ASSERT_EQUAL_UINT8(0u, goertzel_init(&g_bank, ok, GOERTZEL_MAX_TONES + 1u));
+    TEST_ASSERT_EQUAL_UINT8(0u, goertzel_init(&g_bank, bad, 2u));
+    TEST_ASSERT_EQUAL_UINT8(0u, goertzel_init_bins(&g_bank, bins, 2u, 0u));
+    TEST_ASSERT_EQUAL_UINT8(2u, goertzel_init(&g_bank, ok, 2u));
+    TEST_ASSERT_EQUAL_UINT8(2u, goertzel_init_bins(&g_bank, bins, 2u, 16u));
+    TEST_ASSERT_EQUAL_UINT16(0u, g_bank.count);
+}
+
+/*
+ * Random input at arbitrary (off-bin) frequencies: the fixed-point recursion
+ * matches the double-precision DFT sum to within 0.1% of the block energy.
+ */
+static void test_matches_dft(void)
+{
+    const float freqs[4] = {0.0f, 0.0731f, 0.25f, 0.4999f};
+    uint32_t lcg = 99u;
+    for (size_t t = 0; t < 200u; t++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        g_x[t] = (q15_t)((int32_t)(lcg >> 16) - 32768);
+    }
+    double energy = 0.0;
+    for (size_t t = 0; t < 200u; t++) {
+        energy += (double)g_x[t] * g_x[t];
+    }
+    goertzel_init(&g_bank, freqs, 4u);
+    goertzel_run(&g_bank, g_x, 120u);     /* in two pieces */
+    goertzel_run(&g_bank, &g_x[120], 80u);
+    TEST_ASSERT_EQUAL_UINT16(200u, g_bank.count);
+    for (uint8_t k = 0; k < 4u; k++) {
+        double want = dft_power(g_x, 200u, freqs[k]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3 * energy * 200.0, want,
+                                 (double)goertzel_power(&g_bank, k));
+    }
+}
+
+/*
+ * On-bin tones: energy (N*A/2)^2 whatever the phase, and the orthogonal
+ * neighbours see (almost) nothing — the FSK decision in miniature.
+ */
+static void test_on_bin_energy_is_phase_blind(void)
+{
+    const uint16_t bins[4] = {2u, 3u, 4u, 5u};
+    const size_t n = 16u;
+    const double amp = 0.5;
+    const double want = pow(n * amp * 32767.0 / 2.0, 2.0);
+    goertzel_init_bins(&g_bank, bins, 4u, (uint16_t)n);
+    for (int p = 0; p < 8; p++) {
+        fill_tone(g_x, n, 4.0 / n, amp, p * M_PI / 4.0);
+        goertzel_reset(&g_bank);
+        goertzel_run(&g_bank, g_x, n);
+        TEST_ASSERT_EQUAL_UINT8(2u, goertzel_argmax(&g_bank));
+        TEST_ASSERT_FLOAT_WITHIN(0.01 * want, want, (double)goertzel_power(&g_bank, 2u));
+        for (uint8_t k = 0; k < 4u; k++) {
+            if (k != 2u) {
+                TEST_ASSERT_TRUE((double)goertzel_power(&g_bank, k) < 1e-4 * want);
+            }
+        }
+    }
+}
+
+/* The worst case for state growth: full-scale DC over the longest block. */
+static void test_no_overflow_at_max_block(void)
+{
+    const float f[2] = {0.0f, 0.5f};
+    for (size_t t = 0; t < GOERTZEL_MAX_N; t++) {
+        g_x[t] = Q15_MAX;
+    }
+    goertzel_init(&g_bank, f, 1u);
+    goertzel_run(&g_bank, g_x, GOERTZEL_MAX_N);
+    double want = pow((double)GOERTZEL_MAX_N * 32767.0, 2.0);
+    TEST_ASSERT_FLOAT_WITHIN(0.01 * want, want, (double)goertzel_power(&g_bank, 0u));
+
+    for (size_t t = 0; t < GOERTZEL_MAX_N; t++) {
+        g_x[t] = (t & 1u) ? Q15_MIN : Q15_MAX;
+    }
+    goertzel_init(&g_bank, &f[1], 1u);
+    goertzel_run(&g_bank, g_x, GOERTZEL_MAX_N);
+    TEST_ASSERT_FLOAT_WITHIN(0.01 * want, want, (double)goertzel_power(&g_bank, 0u));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_validates);
+    RUN_TEST(test_matches_dft);
+    RUN_TEST(test_on_bin_energy_is_phase_blind);
+    RUN_TEST(test_no_overflow_at_max_block);
+    return UNITY_END();
+}
@@ -0,0 +1,186 @@
+#include "unity.h"
+#include "halfband.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define N_IN 512u
+
+static halfband_t g_hb;
+static halfband_t g_hb2;
+static q15_t g_in[N_IN];
+static q15_t g_out[2u * N_IN];
+static q15_t g_ref[2u * N_IN];
+
+static void fill_random(q15_t *x, size_t n, uint32_t seed, int32_t amp)
+{
+    uint32_t lcg = seed;
+    for (size_t i = 0; i < n; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        x[i] = (q15_t)(((int32_t)(lcg >> 16) - 32768) * amp / 32768);
+    }
+}
+
+static void fill_tone(q15_t *x, size_t n, double f, double amp)
+{
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (q15_t)lrint(amp * 32767.0 * cos(2.0 * M_PI * f * (double)i));
+    }
+}
+
+/* |sum h[i] e^(-j 2 pi f i)| for a real sequence. */
+static double response(const q15_t *h, size_t n, double scale, double f)
+{
+    double re = 0.0, im = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        re += h[i] * scale * cos(2.0 * M_PI * f * (double)i);
+        im -= h[i] * scale * sin(2.0 * M_PI * f * (double)i);
+    }
+    return sqrt(re * re + im * im);
+}
+
+static double rms_from(const q15_t *x, size_t from, size_t n)
+{
+    double acc = 0.0;
+    for (size_t i = from; i < n; i++) {
+        acc += (double)x[i] * x[i];
+    }
+    return sqrt(acc / (double)(n - from)) / 32768.0;
+}
+
+static void test_design_validates_and_sizes(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(0u, halfband_design(NULL, 0.1f, HALFBAND_INTERP));
+    TEST_ASSERT_EQUAL_UINT8(0u, halfband_design(&g_hb, 0.0f, HALFBAND_INTERP));
+    TEST_ASSERT_EQUAL_UINT8(0u, halfband_design(&g_hb, 0.25f, HALFBAND_DECIM));
+    TEST_ASSERT_EQUAL_UINT8(0u, halfband_design(&g_hb, 0.1f, (halfband_role_t)7));
+    TEST_ASSERT_EQUAL_UINT8(0u, halfband_design(&g_hb, 0.24f, HALFBAND_INTERP)); /* > 63 taps */
+
+    /* Always 4K - 1 taps, shorter as the transition widens. */
+    uint8_t wide   = halfband_design(&g_hb, 0.04f, HALFBAND_INTERP);
+    uint8_t modem  = halfband_design(&g_hb, 0.0844f, HALFBAND_INTERP);
+    uint8_t narrow = halfband_design(&g_hb, 0.2f, HALFBAND_INTERP);
+    TEST_ASSERT_EQUAL_UINT8(3u, wide % 4u);
+    TEST_ASSERT_EQUAL_UINT8(3u, narrow % 4u);
+    TEST_ASSERT_TRUE(wide <= modem && modem < narrow);
+    TEST_ASSERT_EQUAL_UINT8(15u, modem);
+    TEST_ASSERT_EQUAL_size_t((narrow - 1u) / 2u, halfband_delay(&g_hb));
+
+    /* Role checks. */
+    TEST_ASSERT_EQUAL_size_t(0u, halfband_decimate(&g_hb, g_in, 4u, g_out));
+    halfband_design(&g_hb, 0.1f, HALFBAND_DECIM);
+    TEST_ASSERT_EQUAL_size_t(0u, halfband_interpolate(&g_hb, g_in, 4u, g_out));
+}
+
+/*
+ * The centre-tap branch is a pure delay: every odd interpolator output is
+ * an input sample, bit for bit, 2K - 1 high-rate samples late.
+ */
+static void test_centre_branch_is_exact_delay(void)
+{
+    halfband_design(&g_hb, 0.1f, HALFBAND_INTERP);
+    const size_t d = halfband_delay(&g_hb);
+    fill_random(g_in, N_IN, 3u, 32767);
+    TEST_ASSERT_EQUAL_size_t(2u * N_IN, halfband_interpolate(&g_hb, g_in, N_IN, g_out));
+    for (size_t m = d; m < 2u * N_IN; m += 2u) {
+        TEST_ASSERT_EQUAL_INT16(g_in[(m - d) / 2u], g_out[m]);
+    }
+}
+
+/*
+ * The interpolator's impulse response is the prototype at gain 2: unity in
+ * the passband to 1e-3, HALFBAND_ATTEN_DB (less 5 dB for q15 taps) beyond
+ * 0.5 - fpass.
+ */
+static void test_interpolator_response_meets_spec(void)
+{
+    static const float fps[4] = {0.04f, 0.0844f, 0.15f, 0.2f};
+    for (size_t t = 0; t < 4u; t++) {
+        halfband_design(&g_hb, fps[t], HALFBAND_INTERP);
+        for (size_t i = 0; i < 64u; i++) {
+            g_in[i] = 0;
+        }
+        g_in[0] = 16384;
+        halfband_interpolate(&g_hb, g_in, 64u, g_out);
+        for (int g = 0; g <= 50; g++) {
+            double fp = fps[t] * g / 50.0;
+            double fs = 0.5 - fps[t] + fps[t] * g / 50.0;
+            TEST_ASSERT_FLOAT_WITHIN(1e-3, 1.0, response(g_out, 128u, 1.0 / 32768.0, fp));
+            TEST_ASSERT_TRUE(response(g_out, 128u, 1.0 / 32768.0, fs) <
+                             pow(10.0, -(HALFBAND_ATTEN_DB - 5.0) / 20.0));
+        }
+    }
+}
+
+/* Decimating: a passband tone keeps its level, a stopband tone is gone. */
+static void test_decimator_keeps_passband_rejects_stopband(void)
+{
+    halfband_design(&g_hb, 0.1f, HALFBAND_DECIM);
+    fill_tone(g_in, N_IN, 0.07, 0.5);
+    TEST_ASSERT_EQUAL_size_t(N_IN / 2u, halfband_decimate(&g_hb, g_in, N_IN, g_out));
+    TEST_ASSERT_FLOAT_WITHIN(0.002, 0.5 / sqrt(2.0), rms_from(g_out, 32u, N_IN / 2u));
+
+    halfband_reset(&g_hb);
+    fill_tone(g_in, N_IN, 0.43, 0.9);
+    halfband_decimate(&g_hb, g_in, N_IN, g_out);
+    TEST_ASSERT_TRUE(rms_from(g_out, 32u, N_IN / 2u) < 0.9 * pow(10.0, -60.0 / 20.0));
+}
+
+/* The even/odd phase carries across calls: ragged pieces, in place. */
+static void test_decimator_streams_in_place(void)
+{
+    fill_random(g_in, N_IN, 11u, 20000);
+    halfband_design(&g_hb, 0.12f, HALFBAND_DECIM);
+    size_t nref = halfband_decimate(&g_hb, g_in, N_IN, g_ref);
+
+    halfband_design(&g_hb2, 0.12f, HALFBAND_DECIM);
+    size_t i = 0, o = 0, step = 1u;
+    while (i < N_IN) {
+        size_t n = (N_IN - i < step) ? N_IN - i : step;
+        for (size_t k = 0; k < n; k++) {
+            g_out[k] = g_in[i + k];
+        }
+        size_t got = halfband_decimate(&g_hb2, g_out, n, g_out);
+        for (size_t k = 0; k < got; k++) {
+            TEST_ASSERT_EQUAL_INT16(g_ref[o + k], g_out[k]);
+        }
+        o += got;
+        i += n;
+        step = (step * 5u + 2u) % 13u + 1u;
+    }
+    TEST_ASSERT_EQUAL_size_t(nref, o);
+}
+
+/* Up then down by two gives back the input, delayed, for a passband signal. */
+static void test_interpolate_then_decimate_round_trips(void)
+{
+    halfband_design(&g_hb, 0.1f, HALFBAND_INTERP);
+    halfband_design(&g_hb2, 0.1f, HALFBAND_DECIM);
+    fill_tone(g_in, N_IN, 0.13, 0.4);                   /* 0.065 at 2x */
+    halfband_interpolate(&g_hb, g_in, N_IN, g_out);
+    size_t n = halfband_decimate(&g_hb2, g_out, 2u * N_IN, g_out);
+    TEST_ASSERT_EQUAL_size_t(N_IN, n);
+
+    /* Total delay 2 * (2K - 1) high-rate samples = 2K - 1 low-rate ones. */
+    const size_t d = halfband_delay(&g_hb);
+    double err = 0.0, sig = 0.0;
+    for (size_t k = 64u; k < N_IN; k++) {
+        double e = (double)g_out[k] - g_in[k - d];
+        err += e * e;
+        sig += (double)g_in[k - d] * g_in[k - d];
+    }
+    TEST_ASSERT_TRUE(10.0 * log10(sig / err) > 60.0);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_design_validates_and_sizes);
+    RUN_TEST(test_centre_branch_is_exact_delay);
+    RUN_TEST(test_interpolator_response_meets_spec);
+    RUN_TEST(test_decimator_keeps_passband_rejects_stopband);
+    RUN_TEST(test_decimator_streams_in_place);
+    RUN_TEST(test_interpolate_then_decimate_round_trips);
+    return UNITY_END();
+}
@@ -0,0 +1,292 @@
+#include "unity.h"
+#include "nco.h"
+#include "rrc.h"
+#include "bpsk.h"
+#include "prbs.h"
+#include "awgn.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const double PI = 3.14159265358979323846;
+
+/* --- frequency word ------------------------------------------------------ */
+
+static void test_freq_to_step_known_points(void)
+{
+    TEST_ASSERT_EQUAL_HEX32(0x00000000u, nco_freq_to_step(0.0f));
+    TEST_ASSERT_EQUAL_HEX32(0x40000000u, nco_freq_to_step(0.25f));
+    TEST_ASSERT_EQUAL_HEX32(0x20000000u, nco_freq_to_step(0.125f));
+    /* Negative frequency == two's-complement step (clockwise rotation). */
+    TEST_ASSERT_EQUAL_HEX32(0xC0000000u, nco_freq_to_step(-0.25f));
+}
+
+static void test_phase_is_continuous_across_retune(void)
+{
+    nco_t nco;
+    nco_init(&nco, 0.125f, 0u);
+    for (int i = 0; i < 3; i++) {
+        nco_next(&nco, NULL, NULL);
+    }
+    TEST_ASSERT_EQUAL_HEX32(0x60000000u, nco.phase);
+
+    nco_set_freq(&nco, 0.25f);
+    TEST_ASSERT_EQUAL_HEX32(0x60000000u, nco.phase);   /* untouched */
+    nco_next(&nco, NULL, NULL);
+    TEST_ASSERT_EQUAL_HEX32(0xA0000000u, nco.phase);
+}
+
+/* --- lookup ------------------------------------------------------------- */
+
+static void test_quadrant_landmarks(void)
+{
+    TEST_ASSERT_EQUAL_INT16(0,      nco_sin(0x00000000u));
+    TEST_ASSERT_EQUAL_INT16(32767,  nco_sin(0x40000000u));
+    TEST_ASSERT_EQUAL_INT16(0,      nco_sin(0x80000000u));
+    TEST_ASSERT_EQUAL_INT16(-32767, nco_sin(0xC0000000u));
+    TEST_ASSERT_EQUAL_INT16(32767,  nco_cos(0x00000000u));
+    TEST_ASSERT_EQUAL_INT16(-32767, nco_cos(0x80000000u));
+}
+
+/*
+ * Interpolated lookup vs float64 sin() over a dense sweep of phases. The
+ * interpolation error of a 1024-point/turn table is ~1.2e-6 of full scale, so
+ * the only visible error is q15 rounding of table entries and the interpolant:
+ * within 1 LSB everywhere.
+ */
+static void test_lookup_matches_libm_within_1lsb(void)
+{
+    int worst = 0;
+    for (uint32_t k = 0; k < 65536u; k++) {
+        uint32_t phase = k * 65537u + 12345u;   /* covers all quadrants */
+        double ref = 32767.0 * sin(2.0 * PI * (double)phase / 4294967296.0);
+        int err = (int)lrint(fabs((double)nco_sin(phase) - ref));
+        if (err > worst) {
+            worst = err;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(1, worst);
+}
+
+static void test_sin_cos_are_quadrature(void)
+{
+    /* sin^2 + cos^2 == 1 to within q15 rounding at every phase. */
+    for (uint32_t k = 0; k < 4096u; k++) {
+        uint32_t phase = k << 20;
+        double s = nco_sin(phase) / 32767.0;
+        double c = nco_cos(phase) / 32767.0;
+        TEST_ASSERT_DOUBLE_WITHIN(1e-4, 1.0, s * s + c * c);
+    }
+}
+
+/* --- spectral purity ---------------------------------------------------- */
+
+#define SFDR_N 4096
+
+static q15_t  g_tone[SFDR_N];
+static double g_cos_tw[SFDR_N];
+static double g_sin_tw[SFDR_N];
+
+/*
+ * Spur-free dynamic range of an NCO tone, in dBc: carrier power over the
+ * strongest other bin of a length-SFDR_N DFT. The tone sits exactly on bin
+ * `bin` (step = bin * 2^32 / N is an integer), so there is no window leakage
+ * and every non-carrier bin is genuine distortion or quantisation noise.
+ */
+static double measure_sfdr_dbc(const q15_t *x, int bin)
+{
+    for (int n = 0; n < SFDR_N; n++) {
+        g_cos_tw[n] = cos(2.0 * PI * n / SFDR_N);
+        g_sin_tw[n] = sin(2.0 * PI * n / SFDR_N);
+    }
+    double carrier = 0.0, worst_spur = 0.0;
+    for (int k = 0; k <= SFDR_N / 2; k++) {
+        double re = 0.0, im = 0.0;
+        int idx = 0;
+        for (int n = 0; n < SFDR_N; n++) {
+            re += x[n] * g_cos_tw[idx];
+            im -= x[n] * g_sin_tw[idx];
+            idx += k;
+            if (idx >= SFDR_N) {
+                idx -= SFDR_N;
+            }
+        }
+        double p = re * re + im * im;
+        if (k == bin) {
+            carrier = p;
+        } else if (p > worst_spur) {
+            worst_spur = p;
+        }
+    }
+    return 10.0 * log10(carrier / worst_spur);
+}
+
+static void test_tone_sfdr_exceeds_80dbc(void)
+{
+    /* Bin 227 of 4096: an awkward frequency that walks every table entry. */
+    const int bin = 227;
+    nco_t nco;
+    nco.phase = 0x1234u;
+    nco.step  = (uint32_t)bin << 20;   /* bin * 2^32 / 4096 */
+    nco_generate(&nco, g_tone, SFDR_N);
+
+    double sfdr = measure_sfdr_dbc(g_tone, bin);
+    TEST_ASSERT_GREATER_THAN(80.0, sfdr);
+}
+
+static void test_upconverted_tone_sfdr(void)
+{
+    /*
+     * Mix a constant baseband (DC at 0.5) up to bin 301: the output must be a
+     * clean carrier at the IF with the mixer's product rounding adding no spur
+     * above -80 dBc.
+     */
+    const int bin = 301;
+    static q15_t bb[SFDR_N];
+    for (int n = 0; n < SFDR_N; n++) {
+        bb[n] = 16384;
+    }
+    nco_t nco;
+    nco.phase = 0u;
+    nco.step  = (uint32_t)bin << 20;
+    nco_mix_up(&nco, bb, g_tone, SFDR_N);
+
+    double sfdr = measure_sfdr_dbc(g_tone, bin);
+    TEST_ASSERT_GREATER_THAN(80.0, sfdr);
+}
+
+/* --- mixer -------------------------------------------------------------- */
+
+static void test_mix_down_recovers_baseband_at_half_scale(void)
+{
+    /*
+     * Constant baseband up- then down-converted with phase-locked NCOs gives
+     * I = bb/2 + (bb/2)cos(2wn), Q = -(bb/2)sin(2wn). Averaging over whole
+     * periods removes the 2*IF image, leaving I = bb/2 and Q = 0.
+     */
+    enum { N = 1000 };            /* IF = 0.1 -> 2*IF has period 5: exact */
+    static q15_t bb[N], pb[N], i_bb[N], q_bb[N];
+    for (int n = 0; n < N; n++) {
+        bb[n] = 20000;
+    }
+    nco_t tx, rx;
+    nco_init(&tx, 0.1f, 0u);
+    nco_init(&rx, 0.1f, 0u);
+    nco_mix_up(&tx, bb, pb, N);
+    nco_mix_down(&rx, pb, i_bb, q_bb, N);
+
+    double i_mean = 0.0, q_mean = 0.0;
+    for (int n = 0; n < N; n++) {
+        i_mean += i_bb[n];
+        q_mean += q_bb[n];
+    }
+    i_mean /= N;
+    q_mean /= N;
+    TEST_ASSERT_DOUBLE_WITHIN(20.0, 10000.0, i_mean);
+    TEST_ASSERT_DOUBLE_WITHIN(20.0, 0.0, q_mean);
+}
+
+static void test_mix_null_args_safe(void)
+{
+    nco_t nco;
+    nco_init(&nco, 0.1f, 0u);
+    q15_t x = 0;
+    nco_mix_up(NULL, &x, &x, 1);
+    nco_mix_up(&nco, NULL, &x, 1);
+    nco_mix_down(&nco, &x, NULL, &x, 1);
+    nco_generate(&nco, NULL, 1);
+    nco_init(NULL, 0.1f, 0u);
+    TEST_PASS();
+}
+
+/* --- passband BER ------------------------------------------------------- */
+
+/*
+ * Full passband chain: PRBS -> BPSK -> RRC shape (sps=8) -> mix up to IF=0.2
+ * -> AWGN -> mix down -> RRC matched filter -> decimate -> slice. The RRC
+ * occupies |f| < (1+beta)/(2*sps) = 0.084, so the IF band and its 2*IF image
+ * are both well clear of baseband and the matched filter rejects the image.
+ *
+ * Mixing up halves the energy per bit (cos^2 averages 1/2), so the noise is
+ * applied at a nominal Eb/N0 10*log10(2) dB above the target to land at the
+ * target true Eb/N0; the down-mixer's 6 dB scale loss applies equally to
+ * signal and noise. The BER must then track the baseband BPSK theory curve.
+ */
+#define PB_SPS   8u
+#define PB_SPAN  8u
+#define PB_IF    0.2f
+
+static rrc_t g_tx_rrc;
+static rrc_t g_rx_rrc;
+
+static double passband_ber(float ebn0_db, int payload, uint32_t seed)
+{
+    rrc_design(&g_tx_rrc, 0.35f, PB_SPS, PB_SPAN);
+    rrc_design(&g_rx_rrc, 0.35f, PB_SPS, PB_SPAN);
+
+    prbs_t tx_bits;
+    prbs_check_t chk;
+    awgn_prng_t rng;
+    nco_t up, down;
+    prbs_init(&tx_bits, PRBS15, 0xBEEFu);
+    prbs_check_init(&chk, PRBS15, 0xBEEFu);
+    awgn_prng_seed(&rng, seed);
+    nco_init(&up, PB_IF, 0u);
+    nco_init(&down, PB_IF, 0u);
+
+    const float nominal_db = ebn0_db + 3.0103f;
+    size_t delay = rrc_chain_delay(&g_tx_rrc);
+    size_t total_syms = (size_t)payload + delay / PB_SPS + 1u;
+    size_t sample_idx = 0, next_peak = delay, produced = 0;
+    q15_t win[PB_SPS];
+
+    for (size_t k = 0; k < total_syms; k++) {
+        q15_t sym = (k < (size_t)payload) ? bpsk_map(prbs_next_bit(&tx_bits)) : 0;
+        win[0] = rrc_push(&g_tx_rrc, sym);
+        for (uint8_t p = 1; p < PB_SPS; p++) {
+            win[p] = rrc_push(&g_tx_rrc, 0);
+        }
+        nco_mix_up(&up, win, win, PB_SPS);
+        channel_awgn_apply(win, PB_SPS, nominal_db, &rng);
+        nco_mix_down(&down, win, win, NULL, PB_SPS);
+
+        for (uint8_t p = 0; p < PB_SPS; p++) {
+            q15_t y = rrc_push(&g_rx_rrc, win[p]);
+            if (sample_idx == next_peak && produced < (size_t)payload) {
+                prbs_check_bit(&chk, bpsk_slice(y));
+                next_peak += PB_SPS;
+                produced++;
+            }
+            sample_idx++;
+        }
+    }
+    return (double)chk.errors / (double)chk.total;
+}
+
+static void test_passband_ber_tracks_theory(void)
+{
+    const float points[] = {0.0f, 2.0f, 4.0f, 6.0f};
+    for (unsigned i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        double measured = passband_ber(points[i], 40000, 0xFACEu + i);
+        double theory = channel_awgn_theory_ber(points[i]);
+        double tol = theory * 0.20 + 1.5e-3;
+        TEST_ASSERT_DOUBLE_WITHIN(tol, theory, measured);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_freq_to_step_known_points);
+    RUN_TEST(test_phase_is_continuous_across_retune);
+    RUN_TEST(test_quadrant_landmarks);
+    RUN_TEST(test_lookup_matches_libm_within_1lsb);
+    RUN_TEST(test_sin_cos_are_quadrature);
+    RUN_TEST(test_tone_sfdr_exceeds_80dbc);
+    RUN_TEST(test_upconverted_tone_sfdr);
+    RUN_TEST(test_mix_down_recovers_baseband_at_half_scale);
+    RUN_TEST(test_mix_null_args_safe);
+    RUN_TEST(test_passband_ber_tracks_theory);
+    return UNITY_END();
+}
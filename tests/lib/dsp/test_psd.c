@@ -0,0 +1,168 @@
+#include "unity.h"
+#include "psd.h"
+#include "rrc.h"
+#include "bpsk.h"
+#include "prbs.h"
+#include "awgn.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static psd_t  g_psd;
+static psd_t  g_psd2;
+static rrc_t  g_tx;
+static q15_t  g_i[8192];
+static q15_t  g_q[8192];
+
+static void test_init_validates_size(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0u, psd_init(&g_psd, 0u));
+    TEST_ASSERT_EQUAL_UINT16(0u, psd_init(&g_psd, 100u));
+    TEST_ASSERT_EQUAL_UINT16(0u, psd_init(&g_psd, 2u * PSD_MAX_N));
+    TEST_ASSERT_EQUAL_UINT16(0u, psd_init(NULL, 256u));
+    TEST_ASSERT_EQUAL_UINT16(256u, psd_init(&g_psd, 256u));
+    TEST_ASSERT_EQUAL_UINT16(128u, g_psd.hop);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, psd_total(&g_psd));
+    TEST_ASSERT_EQUAL_UINT16(0u, psd_occupied_bins(&g_psd, 0.99f));
+
+    /* Hann: zero at n = 0, unity at the centre, sum w^2 = 3N/8. */
+    TEST_ASSERT_EQUAL_INT16(0, g_psd.win[0]);
+    TEST_ASSERT_EQUAL_INT16(32767, g_psd.win[128]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 96.0f, g_psd.win_pow);
+}
+
+/* Segments complete every hop samples once the first nfft have arrived. */
+static void test_overlap_segment_count(void)
+{
+    psd_init(&g_psd, 256u);
+    for (size_t k = 0; k < 1024u; k++) {
+        g_i[k] = 1000;
+    }
+    psd_push(&g_psd, g_i, NULL, 255u);
+    TEST_ASSERT_EQUAL_UINT32(0u, g_psd.segments);
+    psd_push(&g_psd, g_i, NULL, 1u);
+    TEST_ASSERT_EQUAL_UINT32(1u, g_psd.segments);
+    psd_push(&g_psd, g_i, NULL, 1024u - 256u);
+    TEST_ASSERT_EQUAL_UINT32(7u, g_psd.segments);   /* (1024 - 256)/128 + 1 */
+}
+
+/* A complex tone on a bin: its power, nearly all of it in the main lobe. */
+static void test_complex_tone_power(void)
+{
+    const uint16_t n = 512u, bin = 40u;
+    const double amp = 0.5;
+    psd_init(&g_psd, n);
+    for (size_t t = 0; t < 4096u; t++) {
+        double a = 2.0 * M_PI * (double)(bin * t % n) / (double)n;
+        g_i[t] = (q15_t)lrint(amp * 32767.0 * cos(a));
+        g_q[t] = (q15_t)lrint(amp * 32767.0 * sin(a));
+    }
+    psd_push(&g_psd, g_i, g_q, 4096u);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.25f, psd_total(&g_psd));
+    /* Hann main lobe is +/-2 bins; the rest is quantisation noise. */
+    float lobe = psd_band(&g_psd, bin - 2, bin + 2);
+    TEST_ASSERT_TRUE(lobe > 0.9999f * psd_total(&g_psd));
+    /* The image bin is empty: a complex tone is one-sided. */
+    TEST_ASSERT_TRUE(psd_bin(&g_psd, (uint16_t)(n - bin)) < 1e-8f);
+}
+
+/* White noise: flat to within the Welch variance, total = sigma^2. */
+static void test_white_noise_flat(void)
+{
+    const uint16_t n = 64u;
+    const float sigma = 0.1f;
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, 12345u);
+    psd_init(&g_psd, n);
+    for (int blk = 0; blk < 16; blk++) {
+        for (size_t t = 0; t < 8192u; t++) {
+            g_i[t] = q15_from_float(sigma * awgn_prng_gauss(&rng));
+            g_q[t] = q15_from_float(sigma * awgn_prng_gauss(&rng));
+        }
+        psd_push(&g_psd, g_i, g_q, 8192u);
+    }
+    const float total = 2.0f * sigma * sigma;
+    TEST_ASSERT_FLOAT_WITHIN(0.02f * total, total, psd_total(&g_psd));
+    /* ~4000 segments: each bin within 10% of total/n. */
+    for (uint16_t k = 0; k < n; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.1f * total / n, total / n, psd_bin(&g_psd, k));
+    }
+}
+
+/* Chunking must not matter: same data in ragged pieces, same spectrum. */
+static void test_ragged_chunks_match(void)
+{
+    psd_init(&g_psd, 128u);
+    psd_init(&g_psd2, 128u);
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, 7u);
+    for (size_t t = 0; t < 2000u; t++) {
+        g_i[t] = q15_from_float(0.2f * awgn_prng_gauss(&rng));
+    }
+    psd_push(&g_psd, g_i, NULL, 2000u);
+    static const size_t chunks[] = {1u, 63u, 128u, 7u, 500u, 301u, 1000u};
+    size_t off = 0;
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        psd_push(&g_psd2, &g_i[off], NULL, chunks[c]);
+        off += chunks[c];
+    }
+    TEST_ASSERT_EQUAL_UINT32(g_psd.segments, g_psd2.segments);
+    TEST_ASSERT_EQUAL_UINT16(g_psd.fill, g_psd2.fill);
+    for (uint16_t k = 0; k < 128u; k++) {
+        TEST_ASSERT_EQUAL_FLOAT(psd_bin(&g_psd, k), psd_bin(&g_psd2, k));
+    }
+    /* Real input: the spectrum is Hermitian-symmetric. */
+    for (uint16_t k = 1; k < 64u; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f * psd_bin(&g_psd, k) + 1e-9f,
+                                 psd_bin(&g_psd, k), psd_bin(&g_psd, 128u - k));
+    }
+}
+
+/*
+ * The shaped BPSK waveform (beta 0.35, SPS 4). The spectrum is a raised
+ * cosine, nonzero out to (1 + beta) * Rs / 2, but its roll-off carries little
+ * power: 99% sits inside 1.167 * Rs = 0.2917 cycles/sample. Beyond the band
+ * edge only tap truncation and q15 rounding leak — the spectral checks the
+ * modem psd command reports on target.
+ */
+static void test_rrc_bpsk_occupied_bandwidth(void)
+{
+    const uint16_t n = 1024u;
+    const uint8_t  sps = 4u;
+    prbs_t p;
+    uint8_t bits[1024];
+    q15_t   syms[1024];
+    prbs_init(&p, PRBS15, 0x1u);
+    rrc_design(&g_tx, 0.35f, sps, 8u);
+    psd_init(&g_psd, n);
+    for (int blk = 0; blk < 16; blk++) {
+        prbs_next_bits(&p, bits, 1024u / sps * 2u);
+        bpsk_map_block(bits, syms, 1024u / sps * 2u);
+        rrc_tx_shape(&g_tx, syms, 1024u / sps * 2u, g_i);
+        psd_push(&g_psd, g_i, NULL, 2048u);
+    }
+
+    uint16_t h = psd_occupied_bins(&g_psd, 0.99f);
+    float obw = (float)(2u * h + 1u) / (float)n;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.167f / sps, obw);
+
+    /* Power beyond 1.2x the RRC band edge, relative to the channel. */
+    int32_t edge = (int32_t)lrintf(1.35f / (2.0f * sps) * n);  /* 173 */
+    float main = psd_band(&g_psd, -edge, edge);
+    float adj  = psd_band(&g_psd, edge + edge / 5, n / 2 - 1);
+    TEST_ASSERT_TRUE(10.0f * log10f(adj / main) < -40.0f);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_validates_size);
+    RUN_TEST(test_overlap_segment_count);
+    RUN_TEST(test_complex_tone_power);
+    RUN_TEST(test_white_noise_flat);
+    RUN_TEST(test_ragged_chunks_match);
+    RUN_TEST(test_rrc_bpsk_occupied_bandwidth);
+    return UNITY_END();
+}
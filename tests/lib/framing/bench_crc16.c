@@ -0,0 +1,78 @@
+/*
+ * Host throughput of the four CRC-16 engines (framing.h). Not a unit test:
+ * `make bench` builds it with -O2 and prints, per engine, ns/byte, MB/s and
+ * (x86) TSC cycles/byte and bytes/cycle over full-size frame payloads. The
+ * target numbers come from `modem bench` on the board.
+ */
+#include "framing.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define BENCH_LEN   FRAME_MAX_PAYLOAD
+#define BENCH_REPS  20000u
+
+typedef uint16_t (*crc16_engine_t)(uint16_t crc, const uint8_t *buf, size_t len);
+
+static const struct {
+    const char     *name;
+    crc16_engine_t  fn;
+    unsigned        table_bytes;
+} engines[] = {
+    {"bitwise", frame_crc16_update_bitwise, 0u},
+    {"nibble",  frame_crc16_update_nibble,  sizeof(frame_crc16_nibble_table)},
+    {"table",   frame_crc16_update_table,   sizeof(frame_crc16_table)},
+    {"slice4",  frame_crc16_update_slice4,
+                sizeof(frame_crc16_table) + sizeof(frame_crc16_slice_table)},
+};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(void)
+{
+    static uint8_t buf[BENCH_LEN];
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (uint8_t)(i * 131u + 7u);
+    }
+
+    printf("CRC-16 engines, %u-byte buffers x %u\n", (unsigned)BENCH_LEN,
+           (unsigned)BENCH_REPS);
+    printf("engine   | table B |  ns/byte |     MB/s | cyc/byte | bytes/cyc\n");
+    printf("---------+---------+----------+----------+----------+----------\n");
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e) {
+        volatile uint16_t sink = 0;
+        uint16_t crc = FRAME_CRC16_INIT;
+        double t0 = now_ns();
+#ifdef HAVE_TSC
+        uint64_t c0 = __rdtsc();
+#endif
+        for (uint32_t r = 0; r < BENCH_REPS; ++r) {
+            crc = engines[e].fn(crc, buf, sizeof(buf));
+        }
+#ifdef HAVE_TSC
+        double cyc = (double)(__rdtsc() - c0);
+#else
+        double cyc = 0.0;
+#endif
+        double ns = now_ns() - t0;
+        sink = crc;
+        (void)sink;
+
+        double bytes = (double)BENCH_LEN * BENCH_REPS;
+        printf("%-8s | %7u | %8.3f | %8.1f | %8.2f | %8.3f\n", engines[e].name,
+               engines[e].table_bytes, ns / bytes, bytes / ns * 1e3,
+               cyc / bytes, (cyc > 0.0) ? bytes / cyc : 0.0);
+    }
+    return 0;
+}
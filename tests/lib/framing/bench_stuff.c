@@ -0,0 +1,200 @@
+/*
+ * Host throughput of the frame encoder and decoder (framing.h). Not a unit
+ * test: `make bench` builds it twice with -O2, once per FRAME_SWAR setting,
+ * and prints ns/byte of payload for full-size frames whose payload is clean
+ * (no FLAG/ESC/0x00), uniformly random (~0.8% FLAG/ESC, ~0.4% zero), dense
+ * (1 in 8 FLAG) or zero-filled, in each framing mode, with the wire bytes
+ * per payload byte.
+ *
+ * Given firmware images (`make bench_images IMAGES=...`), it sends each as
+ * OTA_CHUNK frames of IMAGE_CHUNK bytes (tools/ota_send.py's default) and
+ * compares the modes on the bytes that would cross the wire.
+ */
+#include "framing.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef FRAME_SWAR
+#define FRAME_SWAR 1
+#endif
+
+#define BENCH_LEN    FRAME_MAX_PAYLOAD
+#define BENCH_REPS   20000u
+#define IMAGE_CHUNK  256u
+#define IMAGE_REPS   20u
+#define IMAGE_MAX    (1024u * 1024u)
+
+static const char *const mode_names[] = {"hdlc", "cobs", "cobsr"};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static size_t g_rx_bytes;
+
+static void sink_rx_cb(uint8_t seq, frame_type_t type,
+                       const uint8_t *payload, size_t len, void *user)
+{
+    (void)seq;
+    (void)type;
+    (void)payload;
+    (void)user;
+    g_rx_bytes += len;
+}
+
+static void fill(uint8_t *buf, size_t n, int kind)
+{
+    uint32_t x = 0x1234567u;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        uint8_t b = (uint8_t)(x >> 24);
+        if (kind == 0 && (b == FRAME_FLAG || b == FRAME_ESC || b == 0)) {
+            b = 0x41u;
+        } else if (kind == 2 && (i % 8u) == 0) {
+            b = FRAME_FLAG;
+        } else if (kind == 3) {
+            b = 0;
+        }
+        buf[i] = b;
+    }
+}
+
+static void bench_synthetic(void)
+{
+    static const char *const kinds[] = {"clean", "random", "dense", "zeros"};
+    static uint8_t payload[BENCH_LEN];
+    static uint8_t wire[FRAME_MAX_ENCODED_SIZE];
+    static uint8_t pbuf[FRAME_MAX_PAYLOAD];
+
+    printf("Frame codec, FRAME_SWAR=%d, %u-byte payloads x %u\n", FRAME_SWAR,
+           (unsigned)BENCH_LEN, (unsigned)BENCH_REPS);
+    printf("payload  | mode  | encode ns/B | decode ns/B | wire B/B\n");
+    printf("---------+-------+-------------+-------------+---------\n");
+    for (int k = 0; k < 4; ++k) {
+        fill(payload, sizeof(payload), k);
+        for (int m = 0; m <= (int)FRAME_MODE__MAX; ++m) {
+            int n = 0;
+            double t0 = now_ns();
+            for (uint32_t r = 0; r < BENCH_REPS; ++r) {
+                /* Vary the SEQ to keep the work from being hoisted. */
+                n = frame_encode_mode((frame_mode_t)m, (uint8_t)r, FRAME_TYPE_DATA,
+                                      payload, sizeof(payload), wire, sizeof(wire));
+            }
+            double enc = (now_ns() - t0) / ((double)BENCH_LEN * BENCH_REPS);
+
+            frame_decoder_t d;
+            frame_decoder_init(&d, sink_rx_cb, NULL, NULL, pbuf, sizeof(pbuf));
+            frame_decoder_set_mode(&d, (frame_mode_t)m);
+            g_rx_bytes = 0;
+            t0 = now_ns();
+            for (uint32_t r = 0; r < BENCH_REPS; ++r) {
+                frame_decoder_feed(&d, wire, (size_t)n);
+            }
+            double dec = (now_ns() - t0) / ((double)BENCH_LEN * BENCH_REPS);
+            if (g_rx_bytes != (size_t)BENCH_LEN * BENCH_REPS) {
+                printf("decode lost frames\n");
+                exit(1);
+            }
+
+            printf("%-8s | %-5s | %11.3f | %11.3f | %8.4f\n", kinds[k], mode_names[m],
+                   enc, dec, (double)n / BENCH_LEN);
+        }
+    }
+}
+
+/*
+ * Frame the whole image in one mode into wire[], as OTA_CHUNK frames;
+ * returns the wire length.
+ */
+static size_t frame_image(frame_mode_t mode, const uint8_t *img, size_t len,
+                          uint8_t *wire)
+{
+    size_t o = 0;
+    uint8_t seq = 0;
+    for (size_t off = 0; off < len; off += IMAGE_CHUNK) {
+        const size_t n = (len - off < IMAGE_CHUNK) ? len - off : IMAGE_CHUNK;
+        const int w = frame_encode_mode(mode, seq++, FRAME_TYPE_OTA_CHUNK, &img[off], n,
+                                        &wire[o], frame_encoded_max(mode, n));
+        o += (size_t)w;
+    }
+    return o;
+}
+
+static int bench_image(const char *path)
+{
+    static uint8_t img[IMAGE_MAX];
+    static uint8_t wire[(IMAGE_MAX / IMAGE_CHUNK) * (2u + 2u * (FRAME_FIXED_OVERHEAD + IMAGE_CHUNK))];
+    static uint8_t pbuf[FRAME_MAX_PAYLOAD];
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        printf("%s: cannot open\n", path);
+        return 1;
+    }
+    const size_t len = fread(img, 1, sizeof(img), f);
+    fclose(f);
+    if (len == 0 || len == sizeof(img)) {
+        printf("%s: empty or larger than %u bytes\n", path, (unsigned)IMAGE_MAX);
+        return 1;
+    }
+
+    size_t zeros = 0, specials = 0;
+    for (size_t i = 0; i < len; ++i) {
+        zeros    += (img[i] == 0);
+        specials += (img[i] == FRAME_FLAG || img[i] == FRAME_ESC);
+    }
+    printf("%s: %zu bytes, %.1f%% 0x00, %.2f%% FLAG/ESC, %u-byte chunks\n", path, len,
+           100.0 * (double)zeros / (double)len, 100.0 * (double)specials / (double)len,
+           (unsigned)IMAGE_CHUNK);
+
+    for (int m = 0; m <= (int)FRAME_MODE__MAX; ++m) {
+        size_t n = 0;
+        double t0 = now_ns();
+        for (uint32_t r = 0; r < IMAGE_REPS; ++r) {
+            n = frame_image((frame_mode_t)m, img, len, wire);
+        }
+        double enc = (now_ns() - t0) / ((double)len * IMAGE_REPS);
+
+        frame_decoder_t d;
+        frame_decoder_init(&d, sink_rx_cb, NULL, NULL, pbuf, sizeof(pbuf));
+        frame_decoder_set_mode(&d, (frame_mode_t)m);
+        g_rx_bytes = 0;
+        t0 = now_ns();
+        for (uint32_t r = 0; r < IMAGE_REPS; ++r) {
+            frame_decoder_feed(&d, wire, n);
+        }
+        double dec = (now_ns() - t0) / ((double)len * IMAGE_REPS);
+        if (g_rx_bytes != len * IMAGE_REPS) {
+            printf("decode lost frames\n");
+            return 1;
+        }
+
+        /* Framing overhead beyond the payload, and the line time at 115200 8N1. */
+        printf("  %-5s  wire %8zu B  overhead %6.2f%%  %7.2f s  enc %6.3f ns/B  dec %6.3f ns/B\n",
+               mode_names[m], n, 100.0 * (double)(n - len) / (double)len,
+               (double)n * 10.0 / 115200.0, enc, dec);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        bench_synthetic();
+        return 0;
+    }
+    int rc = 0;
+    for (int i = 1; i < argc; ++i) {
+        rc |= bench_image(argv[i]);
+    }
+    return rc;
+}
@@ -0,0 +1,612 @@
+/*
+ * Host lossy-link simulator for lib/framing. Not a unit test: `make sim`
+ * runs a scenario matrix and writes sim_link.json, so ARQ and codec
+ * changes can be compared without hardware.
+ *
+ * Two link ends, A and B, share a simulated full-duplex serial line on a
+ * virtual microsecond clock:
+ *  - each direction serialises frames at --baud (10 bits per byte), so a
+ *    frame occupies the line for its encoded length
+ *  - a frame arrives --latency ms after its last byte left, plus a uniform
+ *    0..--jitter ms, never ahead of the frame before it
+ *  - each frame is lost with probability --drop, and each byte that gets
+ *    through has one bit flipped with probability --corrupt
+ *
+ * A sends --messages payloads of --payload bytes, with frame_link
+ * (stop-and-wait, adaptive RTO) by default or frame_arq with --window N,
+ * framed as HDLC (default) or --mode cobs|cobsr. With --agg ms, frame_link
+ * sends through frame_agg, packing messages into frames of up to
+ * FRAME_MAX_PAYLOAD flushed after at most that many ms.
+ * B de-duplicates, delivers and answers ACK, or NACK on a CRC error (the
+ * frame_link convention). A new message goes out as soon as the link
+ * accepts it and the line is idle; a frame_link send that runs out of
+ * retries is offered again.
+ *
+ * Output is one JSON object per scenario: goodput, delivery latency
+ * percentiles (send() call to in-order delivery at B), and the link
+ * counters. Usage:
+ *
+ *   sim_link.out [--baud N] [--latency ms] [--jitter ms] [--drop p]
+ *                [--corrupt p] [--payload N] [--messages N] [--window N]
+ *                [--rto ms] [--retries N] [--seed N] [--mode hdlc|cobs|cobsr]
+ *                [--agg ms]
+ *   sim_link.out --matrix          # the `make sim` scenarios, as an array
+ */
+#include "framing.h"
+#include "frame_arq.h"
+#include "frame_agg.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_MAX_PAYLOAD   FRAME_MAX_PAYLOAD
+#define SIM_WIRE_MAX      (2u + 2u * (FRAME_FIXED_OVERHEAD + SIM_MAX_PAYLOAD))
+#define SIM_QUEUE         64u
+#define SIM_MAX_MESSAGES  100000u
+#define SIM_LIMIT_US      (24ull * 3600u * 1000000u)   /* give up after a virtual day */
+
+typedef struct {
+    uint32_t baud;
+    double   latency_ms;
+    double   jitter_ms;
+    double   drop;
+    double   corrupt;
+    uint32_t payload;
+    uint32_t messages;
+    uint32_t window;       /* 0: frame_link, else frame_arq window */
+    uint32_t rto_ms;       /* frame_link initial RTO / frame_arq timeout */
+    uint32_t retries;
+    uint32_t seed;
+    frame_mode_t mode;
+    int32_t  agg_ms;       /* frame_link only: -1 off, else frame_agg max_delay_ms */
+} sim_config_t;
+
+static const char *const g_mode_names[] = {"hdlc", "cobs", "cobsr"};
+
+typedef struct {
+    uint64_t arrive_us;
+    size_t   len;
+    uint8_t  bytes[SIM_WIRE_MAX];
+} sim_frame_t;
+
+typedef struct {
+    sim_frame_t *q;                /* SIM_QUEUE frames, in arrival order */
+    size_t       head, count;
+    uint8_t      cur[SIM_WIRE_MAX];
+    size_t       cur_len;
+    uint64_t     busy_until_us;
+    uint64_t     last_arrive_us;
+    uint64_t     bytes_on_wire;
+    uint32_t     frames_lost;
+    uint32_t     frames_overflow;  /* queue full; counted as lost */
+} sim_line_t;
+
+typedef struct sim_end {
+    struct sim *s;
+    sim_line_t *tx;
+    frame_decoder_t dec;
+    uint8_t dec_buf[SIM_MAX_PAYLOAD];
+    frame_link_t link;
+    frame_arq_t  arq;
+    frame_agg_t  agg;
+    uint8_t agg_store[2u * SIM_MAX_PAYLOAD];
+    uint8_t rx_store[FRAME_ARQ_MAX_WINDOW * SIM_MAX_PAYLOAD];
+    uint32_t crc_errors;
+    uint32_t rx_errors;
+} sim_end_t;
+
+typedef struct sim {
+    sim_config_t cfg;
+    uint64_t now_us;
+    uint64_t rng;
+    sim_line_t ab, ba;
+    sim_end_t a, b;
+
+    uint32_t next_expected;        /* at B */
+    uint32_t sent;                 /* messages handed to A */
+    uint32_t failed;               /* frame_link sends that ran out of retries */
+    int      resend;               /* the next offer repeats a failed message */
+    int      link_down;            /* frame_arq gave up */
+    uint64_t *submit_us;           /* per message */
+    uint64_t *latency_us;          /* per delivered message */
+    uint32_t  n_latency;
+    uint64_t done_us;
+} sim_t;
+
+static uint8_t g_messages_buf[SIM_MAX_PAYLOAD * 2u];
+
+/* ------------------------------------------------------------------------
+ * Randomness and the line
+ * ------------------------------------------------------------------------ */
+
+static uint64_t sim_rand(sim_t *s)
+{
+    /* xorshift64* */
+    s->rng ^= s->rng >> 12;
+    s->rng ^= s->rng << 25;
+    s->rng ^= s->rng >> 27;
+    return s->rng * 0x2545F4914F6CDD1Dull;
+}
+
+static double sim_uniform(sim_t *s)
+{
+    return (double)(sim_rand(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* One whole frame has been written: serialise it, then lose, damage or queue it. */
+static void line_frame_done(sim_t *s, sim_line_t *l)
+{
+    const uint64_t start = (l->busy_until_us > s->now_us) ? l->busy_until_us : s->now_us;
+    l->busy_until_us = start + (uint64_t)l->cur_len * 10u * 1000000u / s->cfg.baud;
+    l->bytes_on_wire += l->cur_len;
+
+    if (sim_uniform(s) < s->cfg.drop) {
+        l->frames_lost++;
+        return;
+    }
+    if (l->count == SIM_QUEUE) {
+        l->frames_overflow++;
+        return;
+    }
+    sim_frame_t *f = &l->q[(l->head + l->count) % SIM_QUEUE];
+    memcpy(f->bytes, l->cur, l->cur_len);
+    f->len = l->cur_len;
+    if (s->cfg.corrupt > 0.0) {
+        for (size_t k = 0; k < f->len; ++k) {
+            if (sim_uniform(s) < s->cfg.corrupt) {
+                f->bytes[k] ^= (uint8_t)(1u << (sim_rand(s) & 7u));
+            }
+        }
+    }
+    uint64_t at = l->busy_until_us + (uint64_t)(s->cfg.latency_ms * 1000.0);
+    if (s->cfg.jitter_ms > 0.0) {
+        at += (uint64_t)(sim_uniform(s) * s->cfg.jitter_ms * 1000.0);
+    }
+    if (l->count > 0 && at < l->last_arrive_us) {
+        at = l->last_arrive_us;    /* a serial line does not reorder */
+    }
+    f->arrive_us = at;
+    l->last_arrive_us = at;
+    l->count++;
+}
+
+/* Transport hook for both link types: bytes come in chunks, frames go out whole. */
+static int sim_write(const uint8_t *bytes, size_t n, void *user)
+{
+    sim_end_t  *e = (sim_end_t *)user;
+    sim_line_t *l = e->tx;
+    for (size_t i = 0; i < n; ++i) {
+        if (l->cur_len < SIM_WIRE_MAX) {
+            l->cur[l->cur_len++] = bytes[i];
+        }
+        const uint8_t delim = (e->s->cfg.mode == FRAME_MODE_HDLC) ? FRAME_FLAG
+                                                                  : FRAME_COBS_DELIM;
+        if (bytes[i] == delim && l->cur_len > 1u) {
+            line_frame_done(e->s, l);
+            l->cur_len = 0;
+        }
+    }
+    return 0;
+}
+
+static uint32_t sim_now_ms(void *user)
+{
+    return (uint32_t)(((sim_end_t *)user)->s->now_us / 1000u);
+}
+
+static void line_deliver(sim_t *s, sim_line_t *l, sim_end_t *to)
+{
+    while (l->count > 0 && l->q[l->head].arrive_us <= s->now_us) {
+        sim_frame_t *f = &l->q[l->head];
+        l->head = (l->head + 1u) % SIM_QUEUE;
+        l->count--;
+        frame_decoder_feed(&to->dec, f->bytes, f->len);
+    }
+}
+
+/* ------------------------------------------------------------------------
+ * Link ends
+ * ------------------------------------------------------------------------ */
+
+static void sim_delivered(sim_t *s, const uint8_t *payload, size_t len)
+{
+    const uint32_t m = s->next_expected;
+    if (m >= s->cfg.messages || len != s->cfg.payload ||
+        memcmp(payload, &g_messages_buf[m % SIM_MAX_PAYLOAD], len) != 0) {
+        fprintf(stderr, "sim_link: message %u delivered out of order or damaged\n",
+                (unsigned)m);
+        exit(1);
+    }
+    s->latency_us[s->n_latency++] = s->now_us - s->submit_us[m];
+    if (++s->next_expected == s->cfg.messages) {
+        s->done_us = s->now_us;
+    }
+}
+
+static void control_reply(sim_end_t *e, frame_type_t type, uint8_t seq)
+{
+    uint8_t buf[2u + 2u * FRAME_FIXED_OVERHEAD];
+    int n = frame_encode_mode(e->s->cfg.mode, seq, type, NULL, 0, buf, sizeof(buf));
+    if (n > 0) {
+        sim_write(buf, (size_t)n, e);
+    }
+}
+
+/* frame_arq and frame_agg_split() delivery. */
+static void end_deliver(frame_type_t type, const uint8_t *payload, size_t len,
+                        void *user)
+{
+    (void)type;
+    sim_delivered(((sim_end_t *)user)->s, payload, len);
+}
+
+static void end_rx(uint8_t seq, frame_type_t type, const uint8_t *payload,
+                   size_t len, void *user)
+{
+    sim_end_t *e = (sim_end_t *)user;
+    sim_t *s = e->s;
+    if (s->cfg.window > 0u) {
+        frame_arq_on_frame(&e->arq, seq, type, payload, len);
+        return;
+    }
+    if (type == FRAME_TYPE_ACK) {
+        frame_link_on_ack(&e->link, seq);
+    } else if (type == FRAME_TYPE_NACK) {
+        frame_link_on_nack(&e->link, seq);
+    } else {
+        if (frame_link_on_rx(&e->link, seq) &&
+            frame_agg_split(type, payload, len, end_deliver, e) < 0) {
+            e->rx_errors++;
+        }
+        control_reply(e, FRAME_TYPE_ACK, seq);
+    }
+}
+
+static void end_err(frame_err_t err, void *user)
+{
+    sim_end_t *e = (sim_end_t *)user;
+    if (err == FRAME_ERR_CRC) {
+        e->crc_errors++;
+    } else {
+        e->rx_errors++;
+    }
+    if (e->s->cfg.window == 0u) {
+        frame_link_on_rx_error(&e->link, err);
+        if (err == FRAME_ERR_CRC && e->link.rx_have_last) {
+            control_reply(e, FRAME_TYPE_NACK, e->link.rx_last_seq);
+        }
+    }
+}
+
+static void end_init(sim_t *s, sim_end_t *e, sim_line_t *tx)
+{
+    e->s  = s;
+    e->tx = tx;
+    frame_decoder_init(&e->dec, end_rx, end_err, e, e->dec_buf, sizeof(e->dec_buf));
+    frame_decoder_set_mode(&e->dec, s->cfg.mode);
+    if (s->cfg.window == 0u) {
+        frame_link_init(&e->link, sim_write, sim_now_ms, e, s->cfg.rto_ms,
+                        (uint8_t)s->cfg.retries);
+        frame_link_set_mode(&e->link, s->cfg.mode);
+        if (s->cfg.agg_ms >= 0) {
+            const frame_agg_config_t gcfg = {
+                .link = &e->link, .store = e->agg_store,
+                .frame_max = FRAME_MAX_PAYLOAD, .max_delay_ms = (uint32_t)s->cfg.agg_ms,
+                .max_resends = (uint8_t)s->cfg.retries,
+            };
+            frame_agg_init(&e->agg, &gcfg);
+        }
+    } else {
+        const frame_arq_config_t acfg = {
+            .write = sim_write, .now_ms = sim_now_ms, .deliver = end_deliver,
+            .user = e, .timeout_ms = s->cfg.rto_ms,
+            .max_retries = (uint8_t)s->cfg.retries, .window = (uint8_t)s->cfg.window,
+            .mode = (uint8_t)s->cfg.mode,
+            .rx_store = e->rx_store, .rx_slot_size = SIM_MAX_PAYLOAD,
+        };
+        if (frame_arq_init(&e->arq, &acfg) != FRAME_OK) {
+            fprintf(stderr, "sim_link: --window must be 1, 2, 4, 8 or 16\n");
+            exit(2);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------
+ * One scenario
+ * ------------------------------------------------------------------------ */
+
+/* Try to hand A the next message; returns 1 if it was accepted. */
+static int sim_offer(sim_t *s)
+{
+    if (s->sent == s->cfg.messages) {
+        return 0;
+    }
+    const uint8_t *p = &g_messages_buf[s->sent % SIM_MAX_PAYLOAD];
+    frame_err_t rc;
+    if (s->cfg.agg_ms >= 0) {
+        /* The aggregator takes messages until both its buffers are full. */
+        rc = frame_agg_send(&s->a.agg, FRAME_TYPE_DATA, p, s->cfg.payload);
+    } else if (s->ab.busy_until_us > s->now_us) {
+        return 0;
+    } else if (s->cfg.window == 0u) {
+        if (s->a.link.state != FRAME_LINK_IDLE) {
+            return 0;
+        }
+        rc = frame_link_send(&s->a.link, FRAME_TYPE_DATA, p, s->cfg.payload);
+    } else {
+        rc = frame_arq_send(&s->a.arq, FRAME_TYPE_DATA, p, s->cfg.payload);
+    }
+    if (rc != FRAME_OK) {
+        return 0;
+    }
+    if (!s->resend) {
+        s->submit_us[s->sent] = s->now_us;
+    }
+    s->resend = 0;
+    s->sent++;
+    return 1;
+}
+
+static int cmp_u64(const void *x, const void *y)
+{
+    const uint64_t a = *(const uint64_t *)x, b = *(const uint64_t *)y;
+    return (a > b) - (a < b);
+}
+
+static double pct_ms(const uint64_t *v, uint32_t n, double p)
+{
+    if (n == 0) {
+        return 0.0;
+    }
+    uint32_t i = (uint32_t)(p * (double)(n - 1u) + 0.5);
+    return (double)v[i] / 1000.0;
+}
+
+static void sim_run(const sim_config_t *cfg, int first)
+{
+    static sim_t s;
+    static sim_frame_t qa[SIM_QUEUE], qb[SIM_QUEUE];
+    memset(&s, 0, sizeof(s));
+    s.cfg = *cfg;
+    s.rng = 0x9E3779B97F4A7C15ull ^ cfg->seed;
+    s.ab.q = qa;
+    s.ba.q = qb;
+    s.submit_us  = calloc(cfg->messages, sizeof(uint64_t));
+    s.latency_us = calloc(cfg->messages, sizeof(uint64_t));
+    if (s.submit_us == NULL || s.latency_us == NULL) {
+        fprintf(stderr, "sim_link: out of memory\n");
+        exit(2);
+    }
+    end_init(&s, &s.a, &s.ab);
+    end_init(&s, &s.b, &s.ba);
+
+    while (s.next_expected < cfg->messages && !s.link_down &&
+           s.now_us < SIM_LIMIT_US) {
+        line_deliver(&s, &s.ab, &s.b);
+        line_deliver(&s, &s.ba, &s.a);
+
+        if (cfg->agg_ms >= 0) {
+            /* frame_agg sends a failed frame again by itself, up to a point. */
+            const int r = frame_agg_tick(&s.a.agg);
+            if (r == FRAME_ERR_LINK_DOWN) {
+                s.link_down = 1;
+            } else if (r < 0) {
+                s.failed++;
+            }
+        } else if (cfg->window == 0u) {
+            if (frame_link_tick(&s.a.link) < 0) {
+                /*
+                 * Out of retries: offer the message again. The failed send
+                 * did not consume its SEQ, so if B had it after all (only
+                 * the ACKs were lost) it drops the repeat as a duplicate.
+                 */
+                s.failed++;
+                s.sent--;
+                s.resend = 1;
+            }
+        } else if (frame_arq_tick(&s.a.arq) < 0) {
+            s.link_down = 1;
+        }
+        while (sim_offer(&s)) {
+        }
+
+        /* Next event: an arrival, the line going idle, or the next ms tick. */
+        uint64_t next = (s.now_us / 1000u + 1u) * 1000u;
+        if (s.ab.count > 0 && s.ab.q[s.ab.head].arrive_us < next) {
+            next = s.ab.q[s.ab.head].arrive_us;
+        }
+        if (s.ba.count > 0 && s.ba.q[s.ba.head].arrive_us < next) {
+            next = s.ba.q[s.ba.head].arrive_us;
+        }
+        if (s.ab.busy_until_us > s.now_us && s.ab.busy_until_us < next) {
+            next = s.ab.busy_until_us;
+        }
+        s.now_us = (next > s.now_us) ? next : s.now_us + 1u;
+    }
+    if (s.done_us == 0) {
+        s.done_us = s.now_us;
+    }
+
+    qsort(s.latency_us, s.n_latency, sizeof(uint64_t), cmp_u64);
+    const double secs = (double)s.done_us / 1e6;
+    const double goodput = (secs > 0.0) ? (double)s.n_latency * cfg->payload / secs : 0.0;
+
+    uint32_t tx_frames, retransmits, timeouts = 0, duplicates;
+    if (cfg->window == 0u) {
+        frame_link_stats_t a, b;
+        frame_link_get_stats(&s.a.link, &a);
+        frame_link_get_stats(&s.b.link, &b);
+        tx_frames = a.tx_frames;
+        retransmits = a.retransmits;
+        timeouts = a.timeouts;
+        duplicates = b.rx_duplicates;
+    } else {
+        tx_frames = s.a.arq.stats.tx_frames;
+        retransmits = s.a.arq.stats.retransmits;
+        duplicates = s.b.arq.stats.rx_duplicates;
+    }
+
+    printf("%s{\n", first ? "" : ",\n");
+    printf("  \"config\": {\"link\": \"%s\", \"window\": %u, \"mode\": \"%s\", \"baud\": %u, "
+           "\"latency_ms\": %g, \"jitter_ms\": %g, \"drop\": %g, \"corrupt\": %g, "
+           "\"payload\": %u, \"messages\": %u, \"rto_ms\": %u, \"retries\": %u, "
+           "\"seed\": %u, \"agg_ms\": %d},\n",
+           cfg->window ? "arq" : "stop_and_wait", cfg->window ? cfg->window : 1u,
+           g_mode_names[cfg->mode], cfg->baud, cfg->latency_ms, cfg->jitter_ms, cfg->drop, cfg->corrupt,
+           cfg->payload, cfg->messages, cfg->rto_ms, cfg->retries, cfg->seed, (int)cfg->agg_ms);
+    printf("  \"delivered\": %u, \"failed\": %u, \"link_down\": %s,\n",
+           s.n_latency, s.failed, s.link_down ? "true" : "false");
+    printf("  \"elapsed_ms\": %.1f, \"goodput_Bps\": %.1f, \"line_efficiency\": %.4f,\n",
+           secs * 1000.0, goodput, goodput / (cfg->baud / 10.0));
+    printf("  \"latency_ms\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f},\n",
+           pct_ms(s.latency_us, s.n_latency, 0.50), pct_ms(s.latency_us, s.n_latency, 0.90),
+           pct_ms(s.latency_us, s.n_latency, 0.99), pct_ms(s.latency_us, s.n_latency, 1.0));
+    printf("  \"tx_frames\": %u, \"retransmits\": %u, \"timeouts\": %u, "
+           "\"duplicates\": %u, \"crc_errors\": %u, \"rx_errors\": %u,\n",
+           tx_frames, retransmits, timeouts, duplicates,
+           s.a.crc_errors + s.b.crc_errors, s.a.rx_errors + s.b.rx_errors);
+    printf("  \"frames_lost\": %u, \"wire_bytes\": %llu",
+           s.ab.frames_lost + s.ba.frames_lost + s.ab.frames_overflow + s.ba.frames_overflow,
+           (unsigned long long)(s.ab.bytes_on_wire + s.ba.bytes_on_wire));
+    if (cfg->window == 0u) {
+        frame_link_stats_t a;
+        frame_link_get_stats(&s.a.link, &a);
+        printf(",\n  \"rtt_ms\": {\"min\": %u, \"avg\": %u, \"max\": %u, \"srtt\": %u, \"rto\": %u}",
+               a.rtt_min_ms, a.rtt_avg_ms, a.rtt_max_ms, a.srtt_ms, a.rto_ms);
+    }
+    printf("\n}");
+
+    free(s.submit_us);
+    free(s.latency_us);
+}
+
+/* ------------------------------------------------------------------------
+ * Command line
+ * ------------------------------------------------------------------------ */
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: sim_link.out [--baud N] [--latency ms] [--jitter ms] [--drop p]\n"
+            "                    [--corrupt p] [--payload N] [--messages N] [--window N]\n"
+            "                    [--rto ms] [--retries N] [--seed N]\n"
+            "                    [--mode hdlc|cobs|cobsr] [--agg ms] | --matrix\n");
+    exit(2);
+}
+
+/*
+ * The `make sim` matrix: stop-and-wait vs ARQ windows across line
+ * conditions, then small messages with and without frame_agg.
+ */
+static void run_matrix(const sim_config_t *base)
+{
+    static const struct { double latency, jitter, drop, corrupt; } lines[] = {
+        {  1.0,  0.0, 0.00, 0.0    },   /* bench cable */
+        { 50.0,  0.0, 0.00, 0.0    },   /* radio hop */
+        { 50.0, 20.0, 0.02, 1e-4   },
+        { 50.0, 20.0, 0.10, 1e-3   },   /* bad day */
+    };
+    static const uint32_t windows[] = {0, 1, 4, 16};
+    int first = 1;
+    printf("[\n");
+    for (size_t l = 0; l < sizeof(lines) / sizeof(lines[0]); ++l) {
+        for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); ++w) {
+            sim_config_t c = *base;
+            c.latency_ms = lines[l].latency;
+            c.jitter_ms  = lines[l].jitter;
+            c.drop       = lines[l].drop;
+            c.corrupt    = lines[l].corrupt;
+            c.window     = windows[w];
+            /* A fixed timer for ARQ: one round trip, a frame time and margin. */
+            if (c.window > 0u) {
+                c.rto_ms = (uint32_t)(2.0 * (c.latency_ms + c.jitter_ms)) +
+                           (2u + 2u * (FRAME_FIXED_OVERHEAD + c.payload)) * 10u * 1000u / c.baud +
+                           20u;
+            }
+            sim_run(&c, first);
+            first = 0;
+        }
+    }
+    /* Telemetry: 16-byte messages on stop-and-wait, one per frame or aggregated. */
+    for (size_t l = 0; l < sizeof(lines) / sizeof(lines[0]); ++l) {
+        for (int agg = 0; agg < 2; ++agg) {
+            sim_config_t c = *base;
+            c.latency_ms = lines[l].latency;
+            c.jitter_ms  = lines[l].jitter;
+            c.drop       = lines[l].drop;
+            c.corrupt    = lines[l].corrupt;
+            c.window     = 0;
+            c.payload    = 16;
+            c.messages   = 2000;
+            c.agg_ms     = agg ? 5 : -1;
+            sim_run(&c, 0);
+        }
+    }
+    printf("\n]\n");
+}
+
+int main(int argc, char **argv)
+{
+    sim_config_t cfg = {
+        .baud = 115200, .latency_ms = 5.0, .jitter_ms = 0.0, .drop = 0.0,
+        .corrupt = 0.0, .payload = 128, .messages = 500, .window = 0,
+        .rto_ms = 1000, .retries = 10, .seed = 1, .agg_ms = -1,
+    };
+    int matrix = 0;
+    for (int i = 1; i < argc; ++i) {
+        const char *k = argv[i];
+        if (strcmp(k, "--matrix") == 0) {
+            matrix = 1;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+        }
+        const char *v = argv[++i];
+        if      (strcmp(k, "--baud") == 0)     cfg.baud       = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--latency") == 0)  cfg.latency_ms = strtod(v, NULL);
+        else if (strcmp(k, "--jitter") == 0)   cfg.jitter_ms  = strtod(v, NULL);
+        else if (strcmp(k, "--drop") == 0)     cfg.drop       = strtod(v, NULL);
+        else if (strcmp(k, "--corrupt") == 0)  cfg.corrupt    = strtod(v, NULL);
+        else if (strcmp(k, "--payload") == 0)  cfg.payload    = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--messages") == 0) cfg.messages   = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--window") == 0)   cfg.window     = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--rto") == 0)      cfg.rto_ms     = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--retries") == 0)  cfg.retries    = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--seed") == 0)     cfg.seed       = (uint32_t)strtoul(v, NULL, 10);
+        else if (strcmp(k, "--agg") == 0)      cfg.agg_ms     = (int32_t)strtol(v, NULL, 10);
+        else if (strcmp(k, "--mode") == 0) {
+            int m = 0;
+            while (m <= (int)FRAME_MODE__MAX && strcmp(v, g_mode_names[m]) != 0) {
+                ++m;
+            }
+            if (m > (int)FRAME_MODE__MAX) {
+                usage();
+            }
+            cfg.mode = (frame_mode_t)m;
+        }
+        else usage();
+    }
+    if (cfg.baud == 0 || cfg.payload == 0 || cfg.payload > SIM_MAX_PAYLOAD ||
+        cfg.messages == 0 || cfg.messages > SIM_MAX_MESSAGES || cfg.retries > 255 ||
+        cfg.drop < 0.0 || cfg.drop > 1.0 || cfg.corrupt < 0.0 || cfg.corrupt > 1.0 ||
+        (cfg.agg_ms >= 0 && (cfg.window > 0u ||
+                             cfg.payload > SIM_MAX_PAYLOAD - FRAME_AGG_SUB_OVERHEAD))) {
+        usage();
+    }
+
+    /* Message m is payload bytes from offset m % SIM_MAX_PAYLOAD of a fixed pattern. */
+    for (size_t k = 0; k < sizeof(g_messages_buf); ++k) {
+        g_messages_buf[k] = (uint8_t)(k * 131u + (k >> 8));
+    }
+
+    if (matrix) {
+        run_matrix(&cfg);
+    } else {
+        sim_run(&cfg, 1);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,362 @@
+#include "frame_agg.h"
+#include "unity.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* ------------------------------------------------------------------------
+ * Fixture: A aggregates over a frame_link; everything it writes is decoded
+ * at B, which splits the frames and records the messages. The tests ACK by
+ * hand.
+ * ------------------------------------------------------------------------ */
+
+#define FMAX      64u
+#define MAX_GOT   64u
+
+typedef struct {
+    uint8_t type;
+    uint8_t len;
+    uint8_t first;
+} got_t;
+
+static uint32_t        g_now;
+static frame_link_t    g_link;
+static frame_agg_t     g_agg;
+static uint8_t         g_store[2u * FMAX];
+static frame_decoder_t g_dec;
+static uint8_t         g_dec_buf[FMAX];
+
+/* What B saw: frames (seq, type) and the messages split out of them. */
+static size_t  g_frames;
+static uint8_t g_last_seq;
+static uint8_t g_last_type;
+static got_t   g_got[MAX_GOT];
+static size_t  g_n_got;
+static size_t  g_wire;
+static int     g_write_fails;
+
+static int a_write(const uint8_t *bytes, size_t n, void *user)
+{
+    (void)user;
+    if (g_write_fails) {
+        return -1;
+    }
+    g_wire += n;
+    frame_decoder_feed(&g_dec, bytes, n);
+    return 0;
+}
+
+static uint32_t a_now(void *user)
+{
+    (void)user;
+    return g_now;
+}
+
+static void b_deliver(frame_type_t type, const uint8_t *payload, size_t len,
+                      void *user)
+{
+    (void)user;
+    TEST_ASSERT_TRUE(g_n_got < MAX_GOT);
+    g_got[g_n_got].type  = (uint8_t)type;
+    g_got[g_n_got].len   = (uint8_t)len;
+    g_got[g_n_got].first = (len > 0) ? payload[0] : 0;
+    g_n_got++;
+}
+
+static void b_rx(uint8_t seq, frame_type_t type, const uint8_t *payload,
+                 size_t len, void *user)
+{
+    (void)user;
+    g_frames++;
+    g_last_seq  = seq;
+    g_last_type = (uint8_t)type;
+    TEST_ASSERT_TRUE(frame_agg_split(type, payload, len, b_deliver, NULL) > 0);
+}
+
+static void fixture_init(uint32_t max_delay_ms, uint8_t retries)
+{
+    g_now = 0;
+    g_frames = 0;
+    g_n_got = 0;
+    g_wire = 0;
+    g_write_fails = 0;
+    TEST_ASSERT_EQUAL_INT(FRAME_OK,
+        frame_link_init(&g_link, a_write, a_now, NULL, 100, retries));
+    const frame_agg_config_t cfg = {
+        .link = &g_link, .store = g_store, .frame_max = FMAX,
+        .max_delay_ms = max_delay_ms, .max_resends = 2,
+    };
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_agg_init(&g_agg, &cfg));
+    frame_decoder_init(&g_dec, b_rx, NULL, NULL, g_dec_buf, sizeof(g_dec_buf));
+}
+
+/* A message of len bytes of value k (so its first byte identifies it). */
+static frame_err_t send_msg(frame_type_t type, uint8_t k, size_t len)
+{
+    uint8_t buf[FMAX];
+    memset(buf, k, sizeof(buf));
+    return frame_agg_send(&g_agg, type, buf, len);
+}
+
+static void ack_last(void)
+{
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_ack(&g_link, g_last_seq));
+}
+
+/* ------------------------------------------------------------------------
+ * Tests
+ * ------------------------------------------------------------------------ */
+
+void test_agg_init_and_send_validate_arguments(void)
+{
+    frame_agg_t g;
+    frame_agg_config_t cfg = {
+        .link = &g_link, .store = g_store, .frame_max = FMAX, .max_delay_ms = 10,
+    };
+    fixture_init(10, 3);
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_agg_init(&g, &cfg));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_init(NULL, &cfg));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_init(&g, NULL));
+    cfg.store = NULL;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_init(&g, &cfg));
+    cfg.store = g_store;
+    cfg.link = NULL;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_init(&g, &cfg));
+    cfg.link = &g_link;
+    cfg.frame_max = FRAME_AGG_SUB_OVERHEAD;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE, frame_agg_init(&g, &cfg));
+    cfg.frame_max = FRAME_MAX_PAYLOAD + 1u;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE, frame_agg_init(&g, &cfg));
+
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_send(NULL, FRAME_TYPE_DATA, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_send(&g_agg, FRAME_TYPE_DATA, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE, send_msg(FRAME_TYPE_ACK, 0, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE, send_msg(FRAME_TYPE_AGG, 0, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE, send_msg((frame_type_t)(FRAME_TYPE__MAX + 1), 0, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE, send_msg(FRAME_TYPE_DATA, 0, FMAX - 2u));
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, 0, FMAX - 3u));
+
+    TEST_ASSERT_EQUAL_INT(0, frame_agg_tick(NULL));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_agg_flush(NULL));
+    TEST_ASSERT_EQUAL_size_t(0, frame_agg_pending(NULL));
+}
+
+/* Small messages wait for the deadline, then go out as one AGG frame. */
+void test_agg_deadline_packs_messages_into_one_frame(void)
+{
+    fixture_init(10, 3);
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, 1, 4));
+    g_now = 3;
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_STATUS, 2, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, 3, 0));
+    TEST_ASSERT_EQUAL_size_t(3, frame_agg_pending(&g_agg));
+
+    g_now = 9;
+    frame_agg_tick(&g_agg);
+    TEST_ASSERT_EQUAL_size_t(0, g_wire);
+    g_now = 10;                          /* 10 ms after the first message */
+    frame_agg_tick(&g_agg);
+    TEST_ASSERT_EQUAL_size_t(1, g_frames);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_AGG, g_last_type);
+    TEST_ASSERT_EQUAL_size_t(0, frame_agg_pending(&g_agg));
+
+    TEST_ASSERT_EQUAL_size_t(3, g_n_got);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_DATA, g_got[0].type);
+    TEST_ASSERT_EQUAL_UINT8(4, g_got[0].len);
+    TEST_ASSERT_EQUAL_UINT8(1, g_got[0].first);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_STATUS, g_got[1].type);
+    TEST_ASSERT_EQUAL_UINT8(1, g_got[1].len);
+    TEST_ASSERT_EQUAL_UINT8(2, g_got[1].first);
+    TEST_ASSERT_EQUAL_UINT8(0, g_got[2].len);
+
+    /* 2 FLAGs, header and CRC, and 3 bytes of framing per message. */
+    TEST_ASSERT_EQUAL_size_t(2u + FRAME_FIXED_OVERHEAD + 3u * FRAME_AGG_SUB_OVERHEAD + 5u, g_wire);
+    TEST_ASSERT_EQUAL_UINT32(1, g_agg.stats.flush_deadline);
+}
+
+/* A message alone in its buffer goes out as an ordinary frame. */
+void test_agg_lone_message_is_sent_as_itself(void)
+{
+    fixture_init(0, 3);
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_STATUS, 7, 2));
+    frame_agg_tick(&g_agg);
+    TEST_ASSERT_EQUAL_size_t(1, g_frames);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_STATUS, g_last_type);
+    TEST_ASSERT_EQUAL_size_t(2u + FRAME_FIXED_OVERHEAD + 2u, g_wire);
+    TEST_ASSERT_EQUAL_size_t(1, g_n_got);
+    TEST_ASSERT_EQUAL_UINT8(7, g_got[0].first);
+}
+
+/*
+ * A full buffer flushes at once; the next one fills while the first is in
+ * flight, and send() pushes back only when both are taken.
+ */
+void test_agg_full_buffer_flushes_and_backpressures(void)
+{
+    fixture_init(1000, 3);
+    /* 11 bytes each: five fit in 64, the sixth does not. */
+    for (uint8_t k = 0; k < 5; ++k) {
+        TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, k, 8));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, g_frames);
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, 5, 8));
+    TEST_ASSERT_EQUAL_size_t(1, g_frames);
+    TEST_ASSERT_EQUAL_size_t(5, g_n_got);
+    TEST_ASSERT_EQUAL_UINT32(1, g_agg.stats.flush_full);
+
+    for (uint8_t k = 6; k < 10; ++k) {
+        TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, k, 8));
+    }
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BUF_SMALL, send_msg(FRAME_TYPE_DATA, 10, 8));
+    TEST_ASSERT_EQUAL_size_t(5, frame_agg_pending(&g_agg));
+
+    /* The ACK frees the link; the retried send flushes the waiting five. */
+    ack_last();
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, 10, 8));
+    TEST_ASSERT_EQUAL_size_t(2, g_frames);
+    TEST_ASSERT_EQUAL_size_t(10, g_n_got);
+    for (uint8_t k = 0; k < 10; ++k) {
+        TEST_ASSERT_EQUAL_UINT8(k, g_got[k].first);
+    }
+    TEST_ASSERT_EQUAL_size_t(1, frame_agg_pending(&g_agg));
+    TEST_ASSERT_EQUAL_UINT32(11, g_agg.stats.messages);
+    TEST_ASSERT_EQUAL_UINT32(2, g_agg.stats.frames);
+}
+
+/* A frame that runs out of retries goes out again, byte for byte. */
+void test_agg_failed_frame_is_resent_with_the_same_seq(void)
+{
+    fixture_init(0, 1);
+    send_msg(FRAME_TYPE_DATA, 1, 2);
+    send_msg(FRAME_TYPE_DATA, 2, 2);
+    frame_agg_tick(&g_agg);
+    TEST_ASSERT_EQUAL_size_t(1, g_frames);
+    const uint8_t seq = g_last_seq;
+
+    /* Meanwhile another message waits behind it. */
+    send_msg(FRAME_TYPE_DATA, 3, 2);
+    g_now = 100;
+    TEST_ASSERT_EQUAL_INT(1, frame_agg_tick(&g_agg));     /* attempt 2 of 2 */
+    g_now = 300;
+    TEST_ASSERT_EQUAL_INT(-1, frame_agg_tick(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(3, g_frames);
+    TEST_ASSERT_EQUAL_UINT8(seq, g_last_seq);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_AGG, g_last_type);
+    TEST_ASSERT_EQUAL_UINT32(1, g_agg.stats.resends);
+    TEST_ASSERT_EQUAL_size_t(1, frame_agg_pending(&g_agg));
+
+    /* Running out on NACKs instead: the next tick sends it again too. */
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_nack(&g_link, seq));
+    TEST_ASSERT_EQUAL_INT(0, frame_link_on_nack(&g_link, seq));
+    TEST_ASSERT_EQUAL_INT(0, frame_agg_tick(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(5, g_frames);
+    TEST_ASSERT_EQUAL_UINT8(seq, g_last_seq);
+    TEST_ASSERT_EQUAL_UINT32(2, g_agg.stats.resends);
+
+    /* Only after its ACK does the waiting message go out. */
+    ack_last();
+    frame_agg_tick(&g_agg);
+    TEST_ASSERT_EQUAL_size_t(6, g_frames);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(seq + 1u), g_last_seq);
+    TEST_ASSERT_EQUAL_UINT8(3, g_got[g_n_got - 1u].first);
+}
+
+/* A peer that never answers: resends run out, the link is reported down. */
+void test_agg_dead_peer_fails_and_drop_recovers(void)
+{
+    fixture_init(0, 1);
+    send_msg(FRAME_TYPE_DATA, 1, 2);
+    send_msg(FRAME_TYPE_DATA, 2, 2);
+    frame_agg_tick(&g_agg);
+    const uint8_t seq = g_last_seq;
+    send_msg(FRAME_TYPE_DATA, 3, 2);
+
+    int r = 0;
+    for (int i = 0; i < 1000 && r != FRAME_ERR_LINK_DOWN; ++i) {
+        g_now += 100;
+        r = frame_agg_tick(&g_agg);
+    }
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_LINK_DOWN, r);
+    TEST_ASSERT_EQUAL_size_t(6, g_frames);         /* 3 sends x 2 attempts */
+    TEST_ASSERT_EQUAL_UINT32(2, g_agg.stats.resends);
+
+    /* It stays down, and says so, rather than backpressuring forever. */
+    g_now += 1000;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_LINK_DOWN, frame_agg_tick(&g_agg));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_LINK_DOWN, send_msg(FRAME_TYPE_DATA, 4, 2));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_LINK_DOWN, frame_agg_flush(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(6, g_frames);
+
+    /* Dropping the stuck frame resumes with what was queued behind it. */
+    TEST_ASSERT_EQUAL_size_t(2, frame_agg_drop(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(0, frame_agg_drop(&g_agg));
+    TEST_ASSERT_EQUAL_UINT32(2, g_agg.stats.dropped);
+    TEST_ASSERT_EQUAL_INT(0, frame_agg_tick(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(7, g_frames);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(seq + 1u), g_last_seq);
+    TEST_ASSERT_EQUAL_UINT8(3, g_got[g_n_got - 1u].first);
+    ack_last();
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, send_msg(FRAME_TYPE_DATA, 5, 2));
+}
+
+void test_agg_transport_failure_keeps_the_buffer(void)
+{
+    fixture_init(0, 3);
+    send_msg(FRAME_TYPE_DATA, 1, 2);
+    g_write_fails = 1;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BUF_SMALL, frame_agg_flush(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(1, frame_agg_pending(&g_agg));
+    g_write_fails = 0;
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_agg_flush(&g_agg));
+    TEST_ASSERT_EQUAL_size_t(1, g_n_got);
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_agg_flush(&g_agg));    /* nothing left */
+}
+
+/* Malformed AGG payloads are rejected whole; other frames pass through. */
+void test_agg_split_rejects_malformed_frames(void)
+{
+    g_n_got = 0;
+    const uint8_t ok[]    = {FRAME_TYPE_DATA, 1, 0, 0xAA, FRAME_TYPE_STATUS, 0, 0};
+    const uint8_t short_hdr[] = {FRAME_TYPE_DATA, 1, 0, 0xAA, FRAME_TYPE_DATA, 0};
+    const uint8_t overrun[]   = {FRAME_TYPE_DATA, 1, 0, 0xAA, FRAME_TYPE_DATA, 2, 0, 0xBB};
+    const uint8_t nested[]    = {FRAME_TYPE_DATA, 0, 0, FRAME_TYPE_AGG, 0, 0};
+    const uint8_t control[]   = {FRAME_TYPE_ACK, 0, 0};
+
+    TEST_ASSERT_EQUAL_INT(2, frame_agg_split(FRAME_TYPE_AGG, ok, sizeof(ok), b_deliver, NULL));
+    TEST_ASSERT_EQUAL_INT(0, frame_agg_split(FRAME_TYPE_AGG, NULL, 0, b_deliver, NULL));
+    TEST_ASSERT_EQUAL_size_t(2, g_n_got);
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_TRUNC,
+        frame_agg_split(FRAME_TYPE_AGG, short_hdr, sizeof(short_hdr), b_deliver, NULL));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_TRUNC,
+        frame_agg_split(FRAME_TYPE_AGG, overrun, sizeof(overrun), b_deliver, NULL));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE,
+        frame_agg_split(FRAME_TYPE_AGG, nested, sizeof(nested), b_deliver, NULL));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE,
+        frame_agg_split(FRAME_TYPE_AGG, control, sizeof(control), b_deliver, NULL));
+    TEST_ASSERT_EQUAL_size_t(2, g_n_got);
+
+    TEST_ASSERT_EQUAL_INT(1, frame_agg_split(FRAME_TYPE_STATUS, ok, 1, b_deliver, NULL));
+    TEST_ASSERT_EQUAL_UINT8(FRAME_TYPE_STATUS, g_got[2].type);
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG,
+        frame_agg_split(FRAME_TYPE_AGG, ok, sizeof(ok), NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_agg_init_and_send_validate_arguments);
+    RUN_TEST(test_agg_deadline_packs_messages_into_one_frame);
+    RUN_TEST(test_agg_lone_message_is_sent_as_itself);
+    RUN_TEST(test_agg_full_buffer_flushes_and_backpressures);
+    RUN_TEST(test_agg_failed_frame_is_resent_with_the_same_seq);
+    RUN_TEST(test_agg_dead_peer_fails_and_drop_recovers);
+    RUN_TEST(test_agg_transport_failure_keeps_the_buffer);
+    RUN_TEST(test_agg_split_rejects_malformed_frames);
+
+    return UNITY_END();
+}
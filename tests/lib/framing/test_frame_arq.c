@@ -0,0 +1,551 @@
+#include "frame_arq.h"
+#include "unity.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* ------------------------------------------------------------------------
+ * Loopback fixture: two endpoints, A and B, whose written bytes are held per
+ * direction until the test lets them through (or drops them).
+ * ------------------------------------------------------------------------ */
+
+#define WIN       8u
+#define SLOT      64u
+#define MAX_HELD  32u
+
+typedef struct {
+    uint8_t bytes[2u + 2u * (FRAME_FIXED_OVERHEAD + SLOT)];
+    size_t  len;
+} held_frame_t;
+
+typedef struct endpoint {
+    frame_arq_t     arq;
+    frame_decoder_t dec;
+    uint8_t         rx_store[WIN * SLOT];
+    uint8_t         dec_buf[SLOT];
+
+    /* Frames this endpoint wrote, one per entry, not yet delivered. */
+    held_frame_t    out[MAX_HELD];
+    size_t          n_out;
+    uint8_t         assembling;
+    uint8_t         delim;         /* closing FLAG, or 0x00 in a COBS mode */
+
+    /* What it delivered, in order. */
+    uint8_t         got[64];
+    size_t          n_got;
+    int             write_fails;
+} endpoint_t;
+
+static uint32_t g_now;
+
+static int ep_write(const uint8_t *bytes, size_t n, void *user)
+{
+    endpoint_t *ep = (endpoint_t *)user;
+    if (ep->write_fails) {
+        return -1;
+    }
+    /* Split the byte stream back into frames at the closing delimiter. */
+    for (size_t i = 0; i < n; ++i) {
+        if (!ep->assembling) {
+            TEST_ASSERT_TRUE(ep->n_out < MAX_HELD);
+            ep->out[ep->n_out].len = 0;
+            ep->assembling = 1;
+        }
+        held_frame_t *f = &ep->out[ep->n_out];
+        f->bytes[f->len++] = bytes[i];
+        if (bytes[i] == ep->delim && f->len > 1) {
+            ep->assembling = 0;
+            ep->n_out++;
+        }
+    }
+    return 0;
+}
+
+static uint32_t ep_now(void *user)
+{
+    (void)user;
+    return g_now;
+}
+
+static void ep_deliver(frame_type_t type, const uint8_t *payload, size_t len,
+                       void *user)
+{
+    endpoint_t *ep = (endpoint_t *)user;
+    TEST_ASSERT_EQUAL_INT(FRAME_TYPE_DATA, type);
+    TEST_ASSERT_EQUAL_size_t(1, len);
+    ep->got[ep->n_got++] = payload[0];
+}
+
+static void ep_rx(uint8_t seq, frame_type_t type, const uint8_t *payload,
+                  size_t len, void *user)
+{
+    endpoint_t *ep = (endpoint_t *)user;
+    frame_arq_on_frame(&ep->arq, seq, type, payload, len);
+}
+
+static void ep_init_mode(endpoint_t *ep, uint8_t window, uint8_t retries,
+                         frame_mode_t mode)
+{
+    memset(ep, 0, sizeof(*ep));
+    const frame_arq_config_t cfg = {
+        .write = ep_write, .now_ms = ep_now, .deliver = ep_deliver, .user = ep,
+        .timeout_ms = 100, .max_retries = retries, .window = window,
+        .mode = (uint8_t)mode,
+        .rx_store = ep->rx_store, .rx_slot_size = SLOT,
+    };
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_init(&ep->arq, &cfg));
+    frame_decoder_init(&ep->dec, ep_rx, NULL, ep, ep->dec_buf, sizeof(ep->dec_buf));
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_decoder_set_mode(&ep->dec, mode));
+    ep->delim = (mode == FRAME_MODE_HDLC) ? FRAME_FLAG : FRAME_COBS_DELIM;
+}
+
+static void ep_init(endpoint_t *ep, uint8_t window, uint8_t retries)
+{
+    ep_init_mode(ep, window, retries, FRAME_MODE_HDLC);
+}
+
+/*
+ * Move the frames `from` wrote to `to`, dropping those whose bit is set in
+ * drop_mask (bit k = k-th frame held). Frames written while this runs are
+ * held for the next call.
+ */
+static void pass(endpoint_t *from, endpoint_t *to, uint32_t drop_mask)
+{
+    static held_frame_t batch[MAX_HELD];
+    size_t n = from->n_out;
+    memcpy(batch, from->out, n * sizeof(batch[0]));
+    from->n_out = 0;
+    for (size_t k = 0; k < n; ++k) {
+        if (!(drop_mask & (1u << k))) {
+            frame_decoder_feed(&to->dec, batch[k].bytes, batch[k].len);
+        }
+    }
+}
+
+static const uint8_t g_msgs[64] = {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+};
+
+static endpoint_t g_a;
+static endpoint_t g_b;
+
+/* ------------------------------------------------------------------------
+ * Protocol behaviour
+ * ------------------------------------------------------------------------ */
+
+void test_arq_init_validates_config(void)
+{
+    frame_arq_t a;
+    uint8_t store[4 * SLOT];
+    frame_arq_config_t cfg = {
+        .write = ep_write, .now_ms = ep_now, .deliver = ep_deliver, .user = NULL,
+        .timeout_ms = 100, .max_retries = 3, .window = 4,
+        .rx_store = store, .rx_slot_size = SLOT,
+    };
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_init(&a, &cfg));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_arq_init(NULL, &cfg));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_arq_init(&a, NULL));
+
+    cfg.window = 3;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE, frame_arq_init(&a, &cfg));
+    cfg.window = 32;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE, frame_arq_init(&a, &cfg));
+    cfg.window = 0;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE, frame_arq_init(&a, &cfg));
+
+    cfg.window = 4;
+    cfg.rx_store = NULL;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_arq_init(&a, &cfg));
+    cfg.window = 1;   /* stop-and-wait never buffers */
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_init(&a, &cfg));
+
+    cfg.mode = FRAME_MODE__MAX + 1u;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_MODE, frame_arq_init(&a, &cfg));
+    cfg.mode = FRAME_MODE_COBS;
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_init(&a, &cfg));
+
+    cfg.deliver = NULL;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_arq_init(&a, &cfg));
+
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG,
+        frame_arq_send(NULL, FRAME_TYPE_DATA, g_msgs, 1));
+    TEST_ASSERT_EQUAL_INT(0, frame_arq_on_frame(NULL, 0, FRAME_TYPE_ACK, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, frame_arq_tick(NULL));
+    TEST_ASSERT_EQUAL_size_t(0, frame_arq_in_flight(NULL));
+}
+
+void test_arq_window_fills_then_cumulative_ack_slides_it(void)
+{
+    ep_init(&g_a, WIN, 3);
+    ep_init(&g_b, WIN, 3);
+
+    for (size_t i = 0; i < WIN; ++i) {
+        TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[i], 1));
+    }
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BUF_SMALL,
+        frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[WIN], 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE,
+        frame_arq_send(&g_a.arq, FRAME_TYPE_ACK, NULL, 0));
+    TEST_ASSERT_EQUAL_size_t(WIN, frame_arq_in_flight(&g_a.arq));
+
+    /* B gets all eight, delivers them and ACKs each; drop all ACKs but the last. */
+    pass(&g_a, &g_b, 0);
+    TEST_ASSERT_EQUAL_size_t(WIN, g_b.n_got);
+    TEST_ASSERT_EQUAL_MEMORY(g_msgs, g_b.got, WIN);
+    TEST_ASSERT_EQUAL_size_t(WIN, g_b.n_out);
+    pass(&g_b, &g_a, (1u << (WIN - 1u)) - 1u);
+    TEST_ASSERT_EQUAL_size_t(0, frame_arq_in_flight(&g_a.arq));
+
+    /* Window open again; SEQs continue. */
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[WIN], 1));
+    TEST_ASSERT_EQUAL_UINT8(WIN, g_a.out[0].bytes[1]);
+}
+
+/* A lost frame is NACKed by the gap after it, resent alone, and the
+ * frames buffered behind it are then delivered in order. */
+void test_arq_gap_is_nacked_and_delivery_stays_in_order(void)
+{
+    ep_init(&g_a, WIN, 3);
+    ep_init(&g_b, WIN, 3);
+    for (size_t i = 0; i < 5; ++i) {
+        frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[i], 1);
+    }
+    pass(&g_a, &g_b, 1u << 1);   /* lose SEQ 1 */
+
+    TEST_ASSERT_EQUAL_size_t(1, g_b.n_got);            /* only 0 so far */
+    TEST_ASSERT_EQUAL_UINT32(1, g_b.arq.stats.nacks_tx); /* one NACK for the gap */
+
+    pass(&g_b, &g_a, 0);                                /* ACK 0, NACK 1, ACK 0 x3 */
+    TEST_ASSERT_EQUAL_size_t(4, frame_arq_in_flight(&g_a.arq));
+    TEST_ASSERT_EQUAL_UINT32(1, g_a.arq.stats.retransmits);
+    TEST_ASSERT_EQUAL_size_t(1, g_a.n_out);             /* SEQ 1 only */
+
+    pass(&g_a, &g_b, 0);
+    TEST_ASSERT_EQUAL_size_t(5, g_b.n_got);
+    TEST_ASSERT_EQUAL_MEMORY(g_msgs, g_b.got, 5);
+    pass(&g_b, &g_a, 0);
+    TEST_ASSERT_EQUAL_size_t(0, frame_arq_in_flight(&g_a.arq));
+    TEST_ASSERT_EQUAL_UINT32(0, g_b.arq.stats.rx_duplicates);
+}
+
+/* The same recovery with every frame, ACK and NACK COBS-framed. */
+void test_arq_cobs_mode_recovers_a_gap(void)
+{
+    for (int mode = FRAME_MODE_COBS; mode <= FRAME_MODE_COBSR; ++mode) {
+        ep_init_mode(&g_a, WIN, 3, (frame_mode_t)mode);
+        ep_init_mode(&g_b, WIN, 3, (frame_mode_t)mode);
+        for (size_t i = 0; i < 5; ++i) {
+            frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[i], 1);
+        }
+        TEST_ASSERT_EQUAL_size_t(5, g_a.n_out);
+        TEST_ASSERT_EQUAL_HEX8(FRAME_COBS_DELIM, g_a.out[0].bytes[0]);
+
+        pass(&g_a, &g_b, 1u << 1);
+        TEST_ASSERT_EQUAL_UINT32(1, g_b.arq.stats.nacks_tx);
+        pass(&g_b, &g_a, 0);
+        TEST_ASSERT_EQUAL_UINT32(1, g_a.arq.stats.retransmits);
+        pass(&g_a, &g_b, 0);
+        TEST_ASSERT_EQUAL_size_t(5, g_b.n_got);
+        TEST_ASSERT_EQUAL_MEMORY(g_msgs, g_b.got, 5);
+        pass(&g_b, &g_a, 0);
+        TEST_ASSERT_EQUAL_size_t(0, frame_arq_in_flight(&g_a.arq));
+    }
+}
+
+/* Lost ACKs: the per-frame timers resend, and B re-ACKs without delivering twice. */
+void test_arq_timer_resends_and_duplicates_are_not_redelivered(void)
+{
+    ep_init(&g_a, WIN, 3);
+    ep_init(&g_b, WIN, 3);
+    g_now = 1000;
+    frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[0], 1);
+    g_now = 1050;
+    frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[1], 1);
+    pass(&g_a, &g_b, 0);
+    pass(&g_b, &g_a, ~0u);                    /* both ACKs lost */
+
+    g_now = 1099;
+    TEST_ASSERT_EQUAL_INT(0, frame_arq_tick(&g_a.arq));
+    g_now = 1100;                             /* only SEQ 0's timer has expired */
+    TEST_ASSERT_EQUAL_INT(1, frame_arq_tick(&g_a.arq));
+    g_now = 1150;
+    TEST_ASSERT_EQUAL_INT(1, frame_arq_tick(&g_a.arq));
+
+    pass(&g_a, &g_b, 0);
+    TEST_ASSERT_EQUAL_size_t(2, g_b.n_got);
+    TEST_ASSERT_EQUAL_UINT32(2, g_b.arq.stats.rx_duplicates);
+    pass(&g_b, &g_a, 0);
+    TEST_ASSERT_EQUAL_size_t(0, frame_arq_in_flight(&g_a.arq));
+}
+
+void test_arq_retry_exhaustion_takes_the_link_down(void)
+{
+    ep_init(&g_a, 2, 1);
+    g_now = 0;
+    frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[0], 1);
+    g_now = 100;
+    TEST_ASSERT_EQUAL_INT(1, frame_arq_tick(&g_a.arq));   /* attempt 2 of 2 */
+    g_now = 200;
+    TEST_ASSERT_EQUAL_INT(-1, frame_arq_tick(&g_a.arq));
+    TEST_ASSERT_EQUAL_INT(-1, frame_arq_tick(&g_a.arq));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_LINK_DOWN,
+        frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[1], 1));
+}
+
+void test_arq_write_failure_consumes_nothing(void)
+{
+    ep_init(&g_a, WIN, 3);
+    g_a.write_fails = 1;
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BUF_SMALL,
+        frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[0], 1));
+    TEST_ASSERT_EQUAL_size_t(0, frame_arq_in_flight(&g_a.arq));
+    g_a.write_fails = 0;
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_send(&g_a.arq, FRAME_TYPE_DATA, &g_msgs[0], 1));
+    TEST_ASSERT_EQUAL_UINT8(0, g_a.out[0].bytes[1]);   /* still SEQ 0 */
+}
+
+/* ------------------------------------------------------------------------
+ * Goodput simulation
+ *
+ * A full-duplex serial link at SIM_BAUD (10 bits per byte): each frame
+ * occupies its direction for its wire length, then arrives one_way_ms
+ * later, or is lost with probability `loss` (either direction, ACKs and
+ * NACKs included). A sends SIM_MSGS payloads of SIM_PAYLOAD bytes as fast
+ * as its window allows; goodput is payload bytes delivered in order at B
+ * per second until the last one lands.
+ * ------------------------------------------------------------------------ */
+
+#define SIM_BAUD      115200u
+#define SIM_PAYLOAD   128u
+#define SIM_MSGS      200u
+#define SIM_QUEUE     64u
+#define SIM_WIRE_MAX  (2u + 2u * (FRAME_FIXED_OVERHEAD + SIM_PAYLOAD))
+
+typedef struct {
+    uint64_t arrive_us;
+    size_t   len;
+    uint8_t  bytes[SIM_WIRE_MAX];
+} sim_pkt_t;
+
+typedef struct sim_dir {
+    sim_pkt_t q[SIM_QUEUE];   /* in flight, in arrival order */
+    size_t    head, count;
+    uint8_t   cur[SIM_WIRE_MAX];
+    size_t    cur_len;
+    uint64_t  busy_until_us;
+} sim_dir_t;
+
+typedef struct sim_end {
+    frame_arq_t       arq;
+    frame_decoder_t   dec;
+    uint8_t           dec_buf[SIM_PAYLOAD];
+    uint8_t           rx_store[FRAME_ARQ_MAX_WINDOW * SIM_PAYLOAD];
+    sim_dir_t        *tx;
+    struct sim_world *w;
+} sim_end_t;
+
+typedef struct sim_world {
+    uint64_t  now_us;
+    uint32_t  one_way_ms;
+    uint32_t  loss_q16;       /* loss probability * 65536 */
+    uint32_t  rng;
+    sim_dir_t ab, ba;
+    sim_end_t a, b;
+    uint32_t  next_expected;  /* at B */
+    uint64_t  done_us;
+} sim_world_t;
+
+static uint8_t g_sim_msgs[SIM_MSGS][SIM_PAYLOAD];
+
+static uint32_t sim_rand(sim_world_t *w)
+{
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 17;
+    w->rng ^= w->rng << 5;
+    return w->rng;
+}
+
+static int sim_write(const uint8_t *bytes, size_t n, void *user)
+{
+    sim_end_t   *e = (sim_end_t *)user;
+    sim_world_t *w = e->w;
+    sim_dir_t   *d = e->tx;
+    for (size_t i = 0; i < n; ++i) {
+        d->cur[d->cur_len++] = bytes[i];
+        if (bytes[i] != FRAME_FLAG || d->cur_len == 1) {
+            continue;
+        }
+        /* A whole frame: serialise it, then keep or lose it. */
+        uint64_t start = (d->busy_until_us > w->now_us) ? d->busy_until_us : w->now_us;
+        d->busy_until_us = start + (uint64_t)d->cur_len * 10u * 1000000u / SIM_BAUD;
+        if ((sim_rand(w) & 0xFFFFu) >= w->loss_q16) {
+            TEST_ASSERT_TRUE(d->count < SIM_QUEUE);
+            sim_pkt_t *p = &d->q[(d->head + d->count++) % SIM_QUEUE];
+            p->arrive_us = d->busy_until_us + (uint64_t)w->one_way_ms * 1000u;
+            p->len       = d->cur_len;
+            memcpy(p->bytes, d->cur, d->cur_len);
+        }
+        d->cur_len = 0;
+    }
+    return 0;
+}
+
+static uint32_t sim_now(void *user)
+{
+    return (uint32_t)(((sim_end_t *)user)->w->now_us / 1000u);
+}
+
+static void sim_deliver(frame_type_t type, const uint8_t *payload, size_t len,
+                        void *user)
+{
+    sim_world_t *w = ((sim_end_t *)user)->w;
+    (void)type;
+    TEST_ASSERT_TRUE(w->next_expected < SIM_MSGS);
+    TEST_ASSERT_EQUAL_size_t(SIM_PAYLOAD, len);
+    TEST_ASSERT_EQUAL_MEMORY(g_sim_msgs[w->next_expected], payload, len);
+    if (++w->next_expected == SIM_MSGS) {
+        w->done_us = w->now_us;
+    }
+}
+
+static void sim_rx(uint8_t seq, frame_type_t type, const uint8_t *payload,
+                   size_t len, void *user)
+{
+    frame_arq_on_frame(&((sim_end_t *)user)->arq, seq, type, payload, len);
+}
+
+static void sim_end_init(sim_world_t *w, sim_end_t *e, sim_dir_t *tx,
+                         uint8_t window, uint32_t timeout_ms)
+{
+    e->w  = w;
+    e->tx = tx;
+    const frame_arq_config_t cfg = {
+        .write = sim_write, .now_ms = sim_now, .deliver = sim_deliver, .user = e,
+        .timeout_ms = timeout_ms, .max_retries = 20, .window = window,
+        .rx_store = e->rx_store, .rx_slot_size = SIM_PAYLOAD,
+    };
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_arq_init(&e->arq, &cfg));
+    frame_decoder_init(&e->dec, sim_rx, NULL, e, e->dec_buf, sizeof(e->dec_buf));
+}
+
+static void sim_arrivals(sim_world_t *w, sim_dir_t *d, sim_end_t *to)
+{
+    while (d->count > 0 && d->q[d->head].arrive_us <= w->now_us) {
+        sim_pkt_t *p = &d->q[d->head];
+        d->head = (d->head + 1u) % SIM_QUEUE;
+        d->count--;
+        frame_decoder_feed(&to->dec, p->bytes, p->len);
+    }
+}
+
+/* Goodput in payload bytes/s for one configuration; 0 if it never finished. */
+static double sim_goodput(uint8_t window, uint32_t one_way_ms, double loss)
+{
+    static sim_world_t w;
+    memset(&w, 0, sizeof(w));
+    w.one_way_ms = one_way_ms;
+    w.loss_q16   = (uint32_t)(loss * 65536.0);
+    w.rng        = 0x9E3779B9u ^ (window * 131u) ^ (one_way_ms * 7919u);
+
+    /*
+     * Timer: frames are only handed over when the UART is idle, so an ACK is
+     * due one frame time plus a round trip after send(); add a margin for
+     * the control frames queued ahead of it.
+     */
+    const uint32_t frame_ms = (SIM_WIRE_MAX * 10u * 1000u) / SIM_BAUD + 1u;
+    const uint32_t rto = 2u * one_way_ms + frame_ms + 20u;
+    sim_end_init(&w, &w.a, &w.ab, window, rto);
+    sim_end_init(&w, &w.b, &w.ba, window, rto);
+
+    uint32_t sent = 0;
+    while (w.next_expected < SIM_MSGS && w.now_us < 600u * 1000000u) {
+        sim_arrivals(&w, &w.ab, &w.b);
+        sim_arrivals(&w, &w.ba, &w.a);
+        /* Keep the window full, but only hand the UART what it can start now. */
+        while (sent < SIM_MSGS && w.ab.busy_until_us <= w.now_us &&
+               frame_arq_send(&w.a.arq, FRAME_TYPE_DATA, g_sim_msgs[sent],
+                              SIM_PAYLOAD) == FRAME_OK) {
+            sent++;
+        }
+        TEST_ASSERT_TRUE(frame_arq_tick(&w.a.arq) >= 0);
+        w.now_us += 250u;
+    }
+    TEST_ASSERT_EQUAL_UINT32(SIM_MSGS, w.next_expected);
+    return (double)SIM_MSGS * SIM_PAYLOAD * 1e6 / (double)w.done_us;
+}
+
+void test_arq_goodput_vs_window_loss_and_rtt(void)
+{
+    static const uint8_t  windows[] = {1, 2, 4, 8, 16};
+    static const uint32_t delays[]  = {5, 50};          /* one way, ms */
+    static const double   losses[]  = {0.0, 0.02, 0.10};
+    enum { NW = 5, ND = 2, NL = 3 };
+    double g[ND][NL][NW];
+
+    for (size_t m = 0; m < SIM_MSGS; ++m) {
+        for (size_t k = 0; k < SIM_PAYLOAD; ++k) {
+            g_sim_msgs[m][k] = (uint8_t)(m * 31u + k * 7u);
+        }
+    }
+
+    char line[128];
+    TEST_MESSAGE("goodput B/s: one-way ms, loss, window 1 2 4 8 16");
+    for (size_t d = 0; d < ND; ++d) {
+        for (size_t l = 0; l < NL; ++l) {
+            int p = snprintf(line, sizeof(line), "%3u ms %4.0f%%:",
+                             (unsigned)delays[d], losses[l] * 100.0);
+            for (size_t i = 0; i < NW; ++i) {
+                g[d][l][i] = sim_goodput(windows[i], delays[d], losses[l]);
+                p += snprintf(&line[p], sizeof(line) - (size_t)p, " %6.0f", g[d][l][i]);
+            }
+            TEST_MESSAGE(line);
+        }
+    }
+
+    /* Upper bound: every byte on the wire is a frame byte. */
+    const double wire_rate = SIM_BAUD / 10.0 * SIM_PAYLOAD /
+                             (SIM_PAYLOAD + FRAME_FIXED_OVERHEAD + 2u);
+    for (size_t d = 0; d < ND; ++d) {
+        for (size_t l = 0; l < NL; ++l) {
+            for (size_t i = 0; i < NW; ++i) {
+                TEST_ASSERT_TRUE(g[d][l][i] < wire_rate * 1.02);
+                if (i > 0) {   /* a wider window never costs much */
+                    TEST_ASSERT_TRUE(g[d][l][i] > 0.9 * g[d][l][i - 1]);
+                }
+            }
+        }
+    }
+
+    /* Short RTT, no loss: stop-and-wait already does well, 8 fills the pipe. */
+    TEST_ASSERT_TRUE(g[0][0][3] > 0.85 * wire_rate);
+    /* 100 ms RTT: window 1 is latency-bound, 8 and up are not. */
+    TEST_ASSERT_TRUE(g[1][0][0] < 0.25 * wire_rate);
+    TEST_ASSERT_TRUE(g[1][0][3] > 3.0 * g[1][0][0]);
+    TEST_ASSERT_TRUE(g[1][0][4] > 0.80 * wire_rate);
+    /* 10% loss each way at 100 ms RTT: selective repeat keeps the wider window ahead. */
+    TEST_ASSERT_TRUE(g[1][2][4] > 3.0 * g[1][2][0]);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_arq_init_validates_config);
+    RUN_TEST(test_arq_window_fills_then_cumulative_ack_slides_it);
+    RUN_TEST(test_arq_gap_is_nacked_and_delivery_stays_in_order);
+    RUN_TEST(test_arq_cobs_mode_recovers_a_gap);
+    RUN_TEST(test_arq_timer_resends_and_duplicates_are_not_redelivered);
+    RUN_TEST(test_arq_retry_exhaustion_takes_the_link_down);
+    RUN_TEST(test_arq_write_failure_consumes_nothing);
+    RUN_TEST(test_arq_goodput_vs_window_loss_and_rtt);
+
+    return UNITY_END();
+}
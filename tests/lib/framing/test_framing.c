@@ -70,6 +70,82 @@ void test_crc16_empty_input_is_init(void)
     TEST_ASSERT_EQUAL_HEX16(0xFFFFu, frame_crc16(NULL, 0));
 }
 
+/* ------------------------------------------------------------------------
+ * CRC engines — bitwise, nibble, byte table and slicing-by-4 must agree
+ * ------------------------------------------------------------------------ */
+
+typedef uint16_t (*crc16_engine_t)(uint16_t crc, const uint8_t *buf, size_t len);
+
+static const crc16_engine_t crc16_engines[] = {
+    frame_crc16_update_bitwise,
+    frame_crc16_update_nibble,
+    frame_crc16_update_table,
+    frame_crc16_update_slice4,
+};
+#define NUM_CRC16_ENGINES (sizeof(crc16_engines) / sizeof(crc16_engines[0]))
+
+/* Deterministic filler (xorshift32) so failures reproduce. */
+static void fill_pseudo_random(uint8_t *buf, size_t n, uint32_t seed)
+{
+    uint32_t x = seed;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+}
+
+void test_crc16_engines_check_value(void)
+{
+    const uint8_t v[] = "123456789";
+    for (size_t e = 0; e < NUM_CRC16_ENGINES; ++e) {
+        TEST_ASSERT_EQUAL_HEX16(FRAME_CRC16_CHECK,
+                                crc16_engines[e](FRAME_CRC16_INIT, v, sizeof(v) - 1));
+        TEST_ASSERT_EQUAL_HEX16(0x1234u, crc16_engines[e](0x1234u, NULL, 5));
+        TEST_ASSERT_EQUAL_HEX16(0x1234u, crc16_engines[e](0x1234u, v, 0));
+    }
+    TEST_ASSERT_EQUAL_HEX16(FRAME_CRC16_CHECK,
+                            frame_crc16_update(FRAME_CRC16_INIT, v, sizeof(v) - 1));
+    TEST_ASSERT_EQUAL_UINT(FRAME_CRC16_ENGINE, frame_crc16_engine());
+}
+
+/*
+ * Every length across the slicing-by-4 block boundary and every start
+ * alignment, from a non-trivial register value: all engines match bitwise.
+ */
+void test_crc16_engines_agree_on_every_length_and_offset(void)
+{
+    uint8_t buf[72];
+    fill_pseudo_random(buf, sizeof(buf), 0xC0FFEEu);
+    for (size_t off = 0; off < 4u; ++off) {
+        for (size_t len = 0; len + off <= 67u; ++len) {
+            uint16_t seed = (uint16_t)(0xFFFFu - 977u * len - off);
+            uint16_t ref  = frame_crc16_update_bitwise(seed, &buf[off], len);
+            for (size_t e = 1; e < NUM_CRC16_ENGINES; ++e) {
+                TEST_ASSERT_EQUAL_HEX16(ref, crc16_engines[e](seed, &buf[off], len));
+            }
+        }
+    }
+}
+
+/* Splitting a buffer anywhere and chaining the updates gives the one-shot CRC. */
+void test_crc16_update_is_incremental(void)
+{
+    uint8_t buf[FRAME_MAX_PAYLOAD];
+    fill_pseudo_random(buf, sizeof(buf), 12345u);
+    const uint16_t whole = frame_crc16(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_HEX16(whole, frame_crc16_update_bitwise(FRAME_CRC16_INIT, buf,
+                                                              sizeof(buf)));
+    for (size_t e = 0; e < NUM_CRC16_ENGINES; ++e) {
+        for (size_t cut = 0; cut <= sizeof(buf); cut += 93u) {
+            uint16_t crc = crc16_engines[e](FRAME_CRC16_INIT, buf, cut);
+            crc = crc16_engines[e](crc, &buf[cut], sizeof(buf) - cut);
+            TEST_ASSERT_EQUAL_HEX16(whole, crc);
+        }
+    }
+}
+
 /* ------------------------------------------------------------------------
  * Encoder happy path
  * ------------------------------------------------------------------------ */
@@ -215,6 +291,91 @@ void test_encode_buf_too_small_rejected(void)
     TEST_ASSERT_EQUAL_INT(FRAME_ERR_BUF_SMALL, n);
 }
 
+/* ------------------------------------------------------------------------
+ * Streaming encoder — same bytes as frame_encode for any split and any room
+ * ------------------------------------------------------------------------ */
+
+/* Pull e to completion in pieces of cap bytes; returns the total length. */
+static size_t encoder_drain(frame_encoder_t *e, uint8_t *out, size_t out_cap,
+                            size_t cap)
+{
+    size_t total = 0;
+    while (!frame_encoder_done(e)) {
+        size_t room = (out_cap - total < cap) ? out_cap - total : cap;
+        size_t n = frame_encoder_pull(e, &out[total], room);
+        TEST_ASSERT_TRUE(n <= room);
+        TEST_ASSERT_TRUE(n > 0);
+        total += n;
+    }
+    TEST_ASSERT_EQUAL_size_t(0, frame_encoder_pull(e, out, out_cap));
+    return total;
+}
+
+void test_encoder_matches_frame_encode_for_any_split_and_cap(void)
+{
+    static uint8_t payload[300];
+    static uint8_t want[FRAME_MAX_ENCODED_SIZE];
+    static uint8_t got[FRAME_MAX_ENCODED_SIZE];
+    fill_pseudo_random(payload, sizeof(payload), 0x5EEDu);
+    /* Stuffed bytes at fragment edges, back to back, and at the very end. */
+    payload[0] = FRAME_FLAG;  payload[99] = FRAME_ESC;  payload[100] = FRAME_FLAG;
+    payload[101] = FRAME_ESC; payload[299] = FRAME_FLAG;
+
+    int wn = frame_encode(FRAME_FLAG, FRAME_TYPE_DATA, payload, sizeof(payload),
+                          want, sizeof(want));
+    TEST_ASSERT_TRUE(wn > 0);
+
+    static const size_t splits[][2] = { {0, 0}, {1, 100}, {100, 101}, {299, 300} };
+    static const size_t caps[] = {1, 2, 3, 5, 7, 32, 64, sizeof(got)};
+    for (size_t s = 0; s < sizeof(splits) / sizeof(splits[0]); ++s) {
+        const frame_iov_t iov[4] = {
+            { payload,                splits[s][0] },
+            { NULL,                   0 },
+            { payload + splits[s][0], splits[s][1] - splits[s][0] },
+            { payload + splits[s][1], sizeof(payload) - splits[s][1] },
+        };
+        for (size_t c = 0; c < sizeof(caps) / sizeof(caps[0]); ++c) {
+            frame_encoder_t e;
+            TEST_ASSERT_EQUAL_INT(FRAME_OK,
+                frame_encoder_begin(&e, FRAME_FLAG, FRAME_TYPE_DATA, iov, 4));
+            size_t n = encoder_drain(&e, got, sizeof(got), caps[c]);
+            TEST_ASSERT_EQUAL_size_t((size_t)wn, n);
+            TEST_ASSERT_EQUAL_HEX8_ARRAY(want, got, n);
+        }
+    }
+
+    /* No fragments at all is an empty payload. */
+    frame_encoder_t e;
+    wn = frame_encode(3, FRAME_TYPE_PING, NULL, 0, want, sizeof(want));
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_encoder_begin(&e, 3, FRAME_TYPE_PING, NULL, 0));
+    TEST_ASSERT_EQUAL_size_t((size_t)wn, encoder_drain(&e, got, sizeof(got), 4));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(want, got, (size_t)wn);
+}
+
+void test_encoder_begin_errors_leave_it_done(void)
+{
+    static uint8_t big[FRAME_MAX_PAYLOAD];
+    uint8_t out[8];
+    frame_encoder_t e;
+    const frame_iov_t null_frag[1] = { { NULL, 1 } };
+    const frame_iov_t too_long[2]  = { { big, sizeof(big) }, { big, 1 } };
+    const frame_iov_t one[1]       = { { big, 1 } };
+
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG,
+        frame_encoder_begin(NULL, 0, FRAME_TYPE_DATA, one, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG,
+        frame_encoder_begin(&e, 0, FRAME_TYPE_DATA, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG,
+        frame_encoder_begin(&e, 0, FRAME_TYPE_DATA, null_frag, 1));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE,
+        frame_encoder_begin(&e, 0, FRAME_TYPE_DATA, too_long, 2));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_TYPE,
+        frame_encoder_begin(&e, 0, (frame_type_t)(FRAME_TYPE__MAX + 1), one, 1));
+    TEST_ASSERT_EQUAL_INT(1, frame_encoder_done(&e));
+    TEST_ASSERT_EQUAL_size_t(0, frame_encoder_pull(&e, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_size_t(0, frame_encoder_pull(NULL, out, sizeof(out)));
+}
+
 /* ------------------------------------------------------------------------
  * Decoder error / edge cases
  * ------------------------------------------------------------------------ */
@@ -494,6 +655,439 @@ void test_decoder_reset_clears_in_progress_frame(void)
     TEST_ASSERT_EQUAL_INT(0, cap.err_count);
 }
 
+/* ------------------------------------------------------------------------
+ * Word-at-a-time fast paths — same bytes as the byte-at-a-time reference
+ *
+ * Built twice: test_framing.out (FRAME_SWAR on, the default) and
+ * test_framing_bytewise.out (-DFRAME_SWAR=0).
+ * ------------------------------------------------------------------------ */
+
+/* The original per-byte encoder: stuff every body byte, bitwise CRC. */
+static size_t ref_encode(uint8_t seq, uint8_t type, const uint8_t *payload,
+                         size_t len, uint8_t *out)
+{
+    static uint8_t body[4 + FRAME_MAX_PAYLOAD + 2];
+    body[0] = seq;
+    body[1] = type;
+    body[2] = (uint8_t)(len & 0xFFu);
+    body[3] = (uint8_t)(len >> 8);
+    memcpy(&body[4], payload, len);
+    uint16_t crc = frame_crc16_update_bitwise(FRAME_CRC16_INIT, body, 4 + len);
+    body[4 + len] = (uint8_t)(crc & 0xFFu);
+    body[5 + len] = (uint8_t)(crc >> 8);
+
+    size_t o = 0;
+    out[o++] = FRAME_FLAG;
+    for (size_t i = 0; i < 6 + len; ++i) {
+        if (body[i] == FRAME_FLAG || body[i] == FRAME_ESC) {
+            out[o++] = FRAME_ESC;
+            out[o++] = (uint8_t)(body[i] ^ FRAME_ESC_XOR);
+        } else {
+            out[o++] = body[i];
+        }
+    }
+    out[o++] = FRAME_FLAG;
+    return o;
+}
+
+/* Random bytes with a FLAG or ESC planted about every `gap` bytes (0: none). */
+static void fill_with_specials(uint8_t *buf, size_t n, uint32_t seed, size_t gap)
+{
+    fill_pseudo_random(buf, n, seed);
+    for (size_t i = 0; i < n; ++i) {
+        if (buf[i] == FRAME_FLAG || buf[i] == FRAME_ESC) {
+            buf[i] = 0x41u;
+        }
+        if (gap > 0 && (buf[i] % gap) == 0) {
+            buf[i] = (i & 1u) ? FRAME_FLAG : FRAME_ESC;
+        }
+    }
+}
+
+void test_swar_encode_matches_reference(void)
+{
+    static uint8_t src[FRAME_MAX_PAYLOAD + 3];
+    static uint8_t want[FRAME_MAX_ENCODED_SIZE];
+    static uint8_t got[FRAME_MAX_ENCODED_SIZE];
+    static const size_t gaps[] = {0, 1, 3, 17, 200};
+    static const size_t lens[] = {0, 1, 3, 4, 5, 7, 8, 63, 64, 65, FRAME_MAX_PAYLOAD};
+
+    for (size_t g = 0; g < sizeof(gaps) / sizeof(gaps[0]); ++g) {
+        fill_with_specials(src, sizeof(src), (uint32_t)(g + 1u), gaps[g]);
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); ++l) {
+            for (size_t off = 0; off < 4; ++off) {   /* every word alignment */
+                size_t wn = ref_encode(0x5Au, FRAME_TYPE_DATA, &src[off], lens[l], want);
+                int n = frame_encode(0x5Au, FRAME_TYPE_DATA, &src[off], lens[l],
+                                     got, sizeof(got));
+                TEST_ASSERT_EQUAL_INT((int)wn, n);
+                TEST_ASSERT_EQUAL_HEX8_ARRAY(want, got, wn);
+            }
+        }
+    }
+
+    /* One special byte at each position of two words. */
+    for (size_t pos = 0; pos < 8; ++pos) {
+        uint8_t p[8];
+        memset(p, 0x41, sizeof(p));
+        p[pos] = (pos & 1u) ? FRAME_ESC : FRAME_FLAG;
+        size_t wn = ref_encode(1, FRAME_TYPE_DATA, p, sizeof(p), want);
+        int n = frame_encode(1, FRAME_TYPE_DATA, p, sizeof(p), got, sizeof(got));
+        TEST_ASSERT_EQUAL_INT((int)wn, n);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(want, got, wn);
+    }
+}
+
+/*
+ * A stream of frames with every stuffing density, leading garbage and one
+ * corrupted frame, fed in ragged chunks: the same frames come out and
+ * the corrupted one is reported as a CRC error, whatever the chunking.
+ */
+void test_swar_decode_stream_in_random_chunks(void)
+{
+    static const size_t gaps[] = {0, 1, 3, 17, 200, 0};
+    static const size_t lens[] = {1024, 300, 5, 64, 1, 0};
+    enum { NF = 6, BAD = 3 };
+    static uint8_t payloads[NF][FRAME_MAX_PAYLOAD];
+    static uint8_t stream[NF * FRAME_MAX_ENCODED_SIZE + 64];
+    size_t slen = 0;
+
+    /* Leading garbage with ESCs but no FLAG (a closing FLAG opens the next frame). */
+    fill_pseudo_random(stream, 61, 7u);
+    for (size_t i = 0; i < 61; ++i) {
+        stream[i] = (stream[i] == FRAME_FLAG || (i % 5u) == 0) ? FRAME_ESC : stream[i];
+    }
+    slen = 61;
+
+    for (size_t f = 0; f < NF; ++f) {
+        fill_with_specials(payloads[f], lens[f], (uint32_t)(100u + f), gaps[f]);
+        size_t at = slen;
+        slen += ref_encode((uint8_t)f, FRAME_TYPE_DATA, payloads[f], lens[f], &stream[slen]);
+        if (f == BAD) {
+            /* Flip a payload byte that neither is nor becomes FLAG/ESC. */
+            size_t k = at + 7;
+            while ((stream[k] | 0x03u) == 0x7Fu || stream[k - 1] == FRAME_ESC) {
+                ++k;
+            }
+            stream[k] ^= 0x01u;
+        }
+    }
+
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        static capture_t cap;
+        static uint8_t pbuf[FRAME_MAX_PAYLOAD];
+        frame_decoder_t d;
+        memset(&cap, 0, sizeof(cap));
+        frame_decoder_init(&d, capture_rx_cb, capture_err_cb, &cap, pbuf, sizeof(pbuf));
+
+        uint32_t x = seed;
+        for (size_t i = 0; i < slen;) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            size_t m = 1u + (x % 97u);
+            if (m > slen - i) {
+                m = slen - i;
+            }
+            frame_decoder_feed(&d, &stream[i], m);
+            i += m;
+        }
+
+        TEST_ASSERT_EQUAL_size_t(NF - 1, cap.count);
+        TEST_ASSERT_EQUAL_INT(1, cap.err_count);
+        TEST_ASSERT_EQUAL_INT(FRAME_ERR_CRC, cap.last_err);
+        for (size_t f = 0, c = 0; f < NF; ++f) {
+            if (f == BAD) {
+                continue;
+            }
+            TEST_ASSERT_EQUAL_UINT8(f, cap.frames[c].seq);
+            TEST_ASSERT_EQUAL_size_t(lens[f], cap.frames[c].len);
+            TEST_ASSERT_EQUAL_MEMORY(payloads[f], cap.frames[c].payload, lens[f]);
+            ++c;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------
+ * COBS / COBS-R modes — checked against a plain per-block reference and
+ * golden vectors shared with tools/_framing.py.
+ * ------------------------------------------------------------------------ */
+
+/* Textbook COBS of the frame body between 0x00 delimiters (COBS-R if reduced). */
+static size_t ref_encode_cobs(uint8_t seq, uint8_t type, const uint8_t *payload,
+                              size_t len, int reduced, uint8_t *out)
+{
+    static uint8_t body[4 + FRAME_MAX_PAYLOAD + 2];
+    const size_t blen = 6 + len;
+    body[0] = seq;
+    body[1] = type;
+    body[2] = (uint8_t)(len & 0xFFu);
+    body[3] = (uint8_t)(len >> 8);
+    memcpy(&body[4], payload, len);
+    uint16_t crc = frame_crc16_update_bitwise(FRAME_CRC16_INIT, body, 4 + len);
+    body[4 + len] = (uint8_t)(crc & 0xFFu);
+    body[5 + len] = (uint8_t)(crc >> 8);
+
+    size_t o = 0;
+    out[o++] = 0x00;
+    size_t i = 0;
+    for (;;) {
+        size_t j = i;
+        while (j < blen && body[j] != 0 && j - i < 254u) {
+            ++j;
+        }
+        const size_t k = j - i;
+        if (k == 254u) {
+            out[o++] = 0xFF;
+            memcpy(&out[o], &body[i], k);
+            o += k;
+            i = j;
+            if (i == blen) {
+                break;
+            }
+        } else if (j == blen) {
+            if (reduced && k > 0 && body[j - 1] > k + 1u) {
+                out[o++] = body[j - 1];
+                memcpy(&out[o], &body[i], k - 1u);
+                o += k - 1u;
+            } else {
+                out[o++] = (uint8_t)(k + 1u);
+                memcpy(&out[o], &body[i], k);
+                o += k;
+            }
+            break;
+        } else {
+            out[o++] = (uint8_t)(k + 1u);
+            memcpy(&out[o], &body[i], k);
+            o += k;
+            i = j + 1;
+        }
+    }
+    out[o++] = 0x00;
+    return o;
+}
+
+/* Random bytes with a zero about every `gap` bytes (0: none, 1: all zero). */
+static void fill_with_zeros(uint8_t *buf, size_t n, uint32_t seed, size_t gap)
+{
+    fill_pseudo_random(buf, n, seed);
+    for (size_t i = 0; i < n; ++i) {
+        if (buf[i] == 0) {
+            buf[i] = 0x41u;
+        }
+        if (gap > 0 && (buf[i] % gap) == 0) {
+            buf[i] = 0;
+        }
+    }
+}
+
+void test_cobs_golden_vectors(void)
+{
+    /* Also produced by tools/_framing.py encode_frame(..., mode=...). */
+    static const uint8_t empty_cobs[]  = {0x00, 0x01, 0x01, 0x01, 0x01, 0x03, 0xC0, 0x84, 0x00};
+    static const uint8_t empty_cobsr[] = {0x00, 0x01, 0x01, 0x01, 0x01, 0x84, 0xC0, 0x00};
+    static const uint8_t p[] = {0x00, 0x01, 0x02, 0x00, 0x7E};
+    static const uint8_t p_cobs[]  = {0x00, 0x04, 0x7E, 0x04, 0x05, 0x01, 0x03, 0x01,
+                                      0x02, 0x04, 0x7E, 0x99, 0x31, 0x00};
+    static const uint8_t p_cobsr[] = {0x00, 0x04, 0x7E, 0x04, 0x05, 0x01, 0x03, 0x01,
+                                      0x02, 0x31, 0x7E, 0x99, 0x00};
+    uint8_t out[32];
+
+    int n = frame_encode_mode(FRAME_MODE_COBS, 0, FRAME_TYPE_DATA, NULL, 0, out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(sizeof(empty_cobs), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(empty_cobs, out, sizeof(empty_cobs));
+    n = frame_encode_mode(FRAME_MODE_COBSR, 0, FRAME_TYPE_DATA, NULL, 0, out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(sizeof(empty_cobsr), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(empty_cobsr, out, sizeof(empty_cobsr));
+
+    n = frame_encode_mode(FRAME_MODE_COBS, 0x7E, FRAME_TYPE_OTA_CHUNK, p, sizeof(p),
+                          out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(sizeof(p_cobs), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(p_cobs, out, sizeof(p_cobs));
+    n = frame_encode_mode(FRAME_MODE_COBSR, 0x7E, FRAME_TYPE_OTA_CHUNK, p, sizeof(p),
+                          out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(sizeof(p_cobsr), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(p_cobsr, out, sizeof(p_cobsr));
+}
+
+/*
+ * Block boundaries around 254 bytes (a full block at the end, a zero right
+ * after one), every zero density, and fragment splits and pull sizes that
+ * cut blocks anywhere: the streaming encoder matches the reference.
+ */
+void test_cobs_encode_matches_reference(void)
+{
+    static uint8_t src[FRAME_MAX_PAYLOAD];
+    static uint8_t want[FRAME_COBS_MAX_ENCODED_SIZE];
+    static uint8_t got[FRAME_COBS_MAX_ENCODED_SIZE];
+    static const size_t gaps[] = {0, 1, 2, 17, 251};
+    static const size_t lens[] = {0, 1, 3, 244, 247, 248, 249, 250, 253, 254,
+                                  255, 502, 503, 508, FRAME_MAX_PAYLOAD};
+    static const size_t caps[] = {1, 3, 32, sizeof(got)};
+
+    for (int mode = FRAME_MODE_COBS; mode <= FRAME_MODE_COBSR; ++mode) {
+        for (size_t g = 0; g < sizeof(gaps) / sizeof(gaps[0]); ++g) {
+            fill_with_zeros(src, sizeof(src), (uint32_t)(g + 1u), gaps[g]);
+            for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); ++l) {
+                const size_t len = lens[l];
+                size_t wn = ref_encode_cobs(0x11u, FRAME_TYPE_DATA, src, len,
+                                            mode == FRAME_MODE_COBSR, want);
+                TEST_ASSERT_TRUE(wn <= frame_encoded_max((frame_mode_t)mode, len));
+
+                int n = frame_encode_mode((frame_mode_t)mode, 0x11u, FRAME_TYPE_DATA,
+                                          src, len, got, sizeof(got));
+                TEST_ASSERT_EQUAL_INT((int)wn, n);
+                TEST_ASSERT_EQUAL_HEX8_ARRAY(want, got, wn);
+
+                const size_t cut = len / 3u;
+                const frame_iov_t iov[3] = {
+                    { src,       cut },
+                    { NULL,      0 },
+                    { src + cut, len - cut },
+                };
+                for (size_t c = 0; c < sizeof(caps) / sizeof(caps[0]); ++c) {
+                    frame_encoder_t e;
+                    TEST_ASSERT_EQUAL_INT(FRAME_OK,
+                        frame_encoder_begin_mode(&e, (frame_mode_t)mode, 0x11u,
+                                                 FRAME_TYPE_DATA, iov, 3));
+                    TEST_ASSERT_EQUAL_size_t(wn, encoder_drain(&e, got, sizeof(got), caps[c]));
+                    TEST_ASSERT_EQUAL_HEX8_ARRAY(want, got, wn);
+                }
+            }
+        }
+    }
+}
+
+void test_cobs_overhead_is_bounded(void)
+{
+    static uint8_t src[FRAME_MAX_PAYLOAD];
+    static uint8_t out[FRAME_MAX_ENCODED_SIZE];
+    static const uint8_t fills[] = {0x00, 0x01, FRAME_FLAG, FRAME_ESC, 0xFF};
+
+    TEST_ASSERT_EQUAL_size_t(FRAME_COBS_MAX_ENCODED_SIZE,
+                             frame_encoded_max(FRAME_MODE_COBS, FRAME_MAX_PAYLOAD));
+    TEST_ASSERT_EQUAL_size_t(FRAME_MAX_ENCODED_SIZE,
+                             frame_encoded_max(FRAME_MODE_HDLC, FRAME_MAX_PAYLOAD));
+    TEST_ASSERT_EQUAL_size_t(0, frame_encoded_max((frame_mode_t)3, 0));
+
+    for (size_t f = 0; f < sizeof(fills); ++f) {
+        memset(src, fills[f], sizeof(src));
+        int n = frame_encode_mode(FRAME_MODE_COBS, 1, FRAME_TYPE_DATA, src, sizeof(src),
+                                  out, sizeof(out));
+        /* 1030-byte body: at most 5 code bytes and 2 delimiters. */
+        TEST_ASSERT_TRUE(n > 0 && (size_t)n <= 2u + 1030u + 5u);
+        for (int i = 1; i < n - 1; ++i) {
+            TEST_ASSERT_NOT_EQUAL(0, out[i]);
+        }
+    }
+
+    /* Worst case for stuffing: HDLC doubles it, COBS adds 1 per 254. */
+    memset(src, FRAME_FLAG, sizeof(src));
+    int hdlc = frame_encode(1, FRAME_TYPE_DATA, src, sizeof(src), out, sizeof(out));
+    int cobs = frame_encode_mode(FRAME_MODE_COBS, 1, FRAME_TYPE_DATA, src, sizeof(src),
+                                 out, sizeof(out));
+    TEST_ASSERT_TRUE(hdlc >= 2 + 2 * 1024);
+    TEST_ASSERT_TRUE(cobs <= 2 + 1030 + 5);
+}
+
+void test_cobs_mode_errors(void)
+{
+    uint8_t out[32];
+    frame_encoder_t e;
+    frame_decoder_t d;
+    frame_link_t link;
+    uint8_t pbuf[8];
+    capture_t cap;
+
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_MODE,
+        frame_encode_mode((frame_mode_t)3, 0, FRAME_TYPE_DATA, NULL, 0, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_MODE,
+        frame_encoder_begin_mode(&e, (frame_mode_t)3, 0, FRAME_TYPE_DATA, NULL, 0));
+    TEST_ASSERT_TRUE(frame_encoder_done(&e));
+    /* The COBS worst case is smaller, so a buffer HDLC rejects can fit. */
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BUF_SMALL,
+        frame_encode(0, FRAME_TYPE_DATA, NULL, 0, out, 9));
+    TEST_ASSERT_EQUAL_INT(9,
+        frame_encode_mode(FRAME_MODE_COBS, 0, FRAME_TYPE_DATA, NULL, 0, out, 9));
+
+    frame_decoder_init(&d, capture_rx_cb, capture_err_cb, &cap, pbuf, sizeof(pbuf));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_decoder_set_mode(NULL, FRAME_MODE_COBS));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_MODE, frame_decoder_set_mode(&d, (frame_mode_t)3));
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_decoder_set_mode(&d, FRAME_MODE_COBSR));
+
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_link_set_mode(NULL, FRAME_MODE_COBS));
+    memset(&link, 0, sizeof(link));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_BAD_MODE, frame_link_set_mode(&link, (frame_mode_t)3));
+}
+
+/*
+ * The COBS counterpart of the ragged-chunk stream test: garbage, frames of
+ * every zero density, one corrupted and one cut off mid-block. COBS-R takes
+ * a short block for a folded code byte, but LEN still exposes the cut.
+ */
+void test_cobs_decode_stream_in_random_chunks(void)
+{
+    static const size_t gaps[] = {0, 1, 2, 17, 251, 0, 3};
+    static const size_t lens[] = {1024, 300, 5, 254, 1, 0, 600};
+    enum { NF = 7, BAD = 3, CUT = 6 };
+    static uint8_t payloads[NF][FRAME_MAX_PAYLOAD];
+    static uint8_t stream[NF * FRAME_COBS_MAX_ENCODED_SIZE + 64];
+
+    for (int mode = FRAME_MODE_COBS; mode <= FRAME_MODE_COBSR; ++mode) {
+        size_t slen = 0;
+        fill_with_zeros(stream, 61, 7u, 0);   /* leading garbage, no delimiter */
+        slen = 61;
+
+        for (size_t f = 0; f < NF; ++f) {
+            fill_with_zeros(payloads[f], lens[f], (uint32_t)(200u + f), gaps[f]);
+            size_t at = slen;
+            slen += ref_encode_cobs((uint8_t)f, FRAME_TYPE_DATA, payloads[f], lens[f],
+                                    mode == FRAME_MODE_COBSR, &stream[slen]);
+            if (f == BAD) {
+                stream[at + 9] ^= 0x10u;   /* a data byte of the first block */
+            }
+            if (f == CUT) {
+                stream[at + 200] = 0x00;   /* delimiter in the middle of a block */
+                slen = at + 201;
+            }
+        }
+
+        for (uint32_t seed = 1; seed <= 8; ++seed) {
+            static capture_t cap;
+            static uint8_t pbuf[FRAME_MAX_PAYLOAD];
+            frame_decoder_t d;
+            memset(&cap, 0, sizeof(cap));
+            frame_decoder_init(&d, capture_rx_cb, capture_err_cb, &cap, pbuf, sizeof(pbuf));
+            TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_decoder_set_mode(&d, (frame_mode_t)mode));
+
+            uint32_t x = seed;
+            for (size_t i = 0; i < slen;) {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                size_t m = 1u + (x % 97u);
+                if (m > slen - i) {
+                    m = slen - i;
+                }
+                frame_decoder_feed(&d, &stream[i], m);
+                i += m;
+            }
+
+            TEST_ASSERT_EQUAL_size_t(NF - 2, cap.count);
+            TEST_ASSERT_EQUAL_INT(2, cap.err_count);
+            TEST_ASSERT_EQUAL_INT(FRAME_ERR_TRUNC, cap.last_err);
+            for (size_t f = 0, c = 0; f < NF; ++f) {
+                if (f == BAD || f == CUT) {
+                    continue;
+                }
+                TEST_ASSERT_EQUAL_UINT8(f, cap.frames[c].seq);
+                TEST_ASSERT_EQUAL_size_t(lens[f], cap.frames[c].len);
+                TEST_ASSERT_EQUAL_MEMORY(payloads[f], cap.frames[c].payload, lens[f]);
+                ++c;
+            }
+        }
+    }
+}
+
 /* ------------------------------------------------------------------------
  * Reliable layer (frame_link)
  * ------------------------------------------------------------------------ */
@@ -652,11 +1246,196 @@ void test_link_tick_retransmits_after_timeout(void)
     TEST_ASSERT_EQUAL_INT(1, frame_link_tick(&link));
     TEST_ASSERT_EQUAL_INT(2, io.writes);
 
-    /* Two more ticks past their respective timeouts -> third attempt then exhausted. */
+    /* Each timeout doubles the RTO: 200 ms to the third attempt, then 400. */
     io.now = 250;
+    TEST_ASSERT_EQUAL_INT(0, frame_link_tick(&link));
+    io.now = 300;
     TEST_ASSERT_EQUAL_INT(1, frame_link_tick(&link));
-    io.now = 400;
+    io.now = 699;
+    TEST_ASSERT_EQUAL_INT(0, frame_link_tick(&link));
+    io.now = 700;
+    TEST_ASSERT_EQUAL_INT(-1, frame_link_tick(&link));
+}
+
+/* Send one frame at io->now and ACK it rtt ms later. */
+static void link_round_trip(frame_link_t *link, link_io_t *io, uint32_t rtt)
+{
+    const uint8_t payload[] = {0xAB};
+    TEST_ASSERT_EQUAL_INT(FRAME_OK,
+        frame_link_send(link, FRAME_TYPE_DATA, payload, sizeof(payload)));
+    io->now += rtt;
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_ack(link, link->tx_seq));
+}
+
+/*
+ * Jacobson/Karels: the first sample sets SRTT = R, RTTVAR = R/2, so
+ * RTO = 3R; steady samples then pull RTTVAR (and the RTO) down towards SRTT.
+ */
+void test_link_rto_tracks_measured_rtt(void)
+{
+    frame_link_t link;
+    link_io_t io = {0};
+    frame_link_init(&link, link_write_cb, link_now_ms_cb, &io, 1000, 2);
+    frame_link_stats_t st;
+
+    link_round_trip(&link, &io, 80);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(80, st.srtt_ms);
+    TEST_ASSERT_EQUAL_UINT32(40, st.rttvar_ms);
+    TEST_ASSERT_EQUAL_UINT32(240, st.rto_ms);
+
+    /* Second sample 160: err = 80, SRTT 80 + 10, RTTVAR 40 + (80 - 40)/4. */
+    link_round_trip(&link, &io, 160);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(90, st.srtt_ms);
+    TEST_ASSERT_EQUAL_UINT32(50, st.rttvar_ms);
+    TEST_ASSERT_EQUAL_UINT32(290, st.rto_ms);
+
+    for (int i = 0; i < 60; ++i) {
+        link_round_trip(&link, &io, 100);
+    }
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_UINT32_WITHIN(1, 100, st.srtt_ms);
+    TEST_ASSERT_TRUE(st.rto_ms < 110);
+    TEST_ASSERT_EQUAL_UINT32(62, st.rtt_samples);
+    TEST_ASSERT_EQUAL_UINT32(80, st.rtt_min_ms);
+    TEST_ASSERT_EQUAL_UINT32(160, st.rtt_max_ms);
+    TEST_ASSERT_EQUAL_UINT32((80 + 160 + 60 * 100) / 62, st.rtt_avg_ms);
+
+    /* The timer now follows the estimate, not the initial 1000 ms. */
+    const uint8_t payload[] = {0xAB};
+    frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload));
+    uint32_t sent = io.now;
+    io.now = sent + st.rto_ms - 1u;
+    TEST_ASSERT_EQUAL_INT(0, frame_link_tick(&link));
+    io.now = sent + st.rto_ms;
+    TEST_ASSERT_EQUAL_INT(1, frame_link_tick(&link));
+}
+
+/* Very fast and very slow links stay inside the RTO bounds. */
+void test_link_rto_is_clamped(void)
+{
+    frame_link_t link;
+    link_io_t io = {0};
+    frame_link_stats_t st;
+    frame_link_init(&link, link_write_cb, link_now_ms_cb, &io, 100, 2);
+    link_round_trip(&link, &io, 0);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(FRAME_LINK_RTO_MIN_MS, st.rto_ms);
+
+    link_round_trip(&link, &io, FRAME_LINK_RTO_MAX_MS * 2u);
+    link_round_trip(&link, &io, FRAME_LINK_RTO_MAX_MS * 2u);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(FRAME_LINK_RTO_MAX_MS, st.rto_ms);
+    TEST_ASSERT_EQUAL_UINT32(FRAME_LINK_RTO_MAX_MS * 2u, st.rtt_max_ms);
+}
+
+/*
+ * Karn's rule: an ACK after a retransmit is not sampled, and the backed-off
+ * RTO carries over to the next frame until one is ACKed first time.
+ */
+void test_link_karn_skips_retransmitted_samples(void)
+{
+    frame_link_t link;
+    link_io_t io = {0};
+    frame_link_stats_t st;
+    frame_link_init(&link, link_write_cb, link_now_ms_cb, &io, 1000, 3);
+    link_round_trip(&link, &io, 100);          /* RTO 300 */
+
+    const uint8_t payload[] = {0xAB};
+    frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload));
+    uint32_t t0 = io.now;
+    io.now = t0 + 300;
+    TEST_ASSERT_EQUAL_INT(1, frame_link_tick(&link));   /* RTO now 600 */
+    io.now = t0 + 310;
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_ack(&link, link.tx_seq));
+
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.rtt_samples);
+    TEST_ASSERT_EQUAL_UINT32(100, st.srtt_ms);
+    TEST_ASSERT_EQUAL_UINT32(600, st.rto_ms);
+    TEST_ASSERT_EQUAL_UINT32(1, st.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, st.retransmits);
+
+    /* A NACK retransmit is not a timeout: no backoff, but still no sample. */
+    frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_nack(&link, 0));
+    io.now += 50;
+    frame_link_on_ack(&link, link.tx_seq);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.rtt_samples);
+    TEST_ASSERT_EQUAL_UINT32(600, st.rto_ms);
+
+    /* First-time ACK: sampled, backoff cleared. */
+    link_round_trip(&link, &io, 100);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(2, st.rtt_samples);
+    TEST_ASSERT_EQUAL_UINT32(250, st.rto_ms);   /* SRTT 100, RTTVAR 37.5 -> x4 = 150 */
+}
+
+/* Backoff doubles per timeout and saturates at FRAME_LINK_RTO_MAX_MS. */
+void test_link_backoff_saturates(void)
+{
+    frame_link_t link;
+    link_io_t io = {0};
+    frame_link_stats_t st;
+    frame_link_init(&link, link_write_cb, link_now_ms_cb, &io, 1000, 20);
+    const uint8_t payload[] = {0xAB};
+    frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload));
+
+    static const uint32_t want[] = {2000, 4000, 8000, FRAME_LINK_RTO_MAX_MS,
+                                    FRAME_LINK_RTO_MAX_MS};
+    uint32_t rto = 1000;
+    for (size_t i = 0; i < sizeof(want) / sizeof(want[0]); ++i) {
+        io.now += rto;
+        TEST_ASSERT_EQUAL_INT(1, frame_link_tick(&link));
+        frame_link_get_stats(&link, &st);
+        TEST_ASSERT_EQUAL_UINT32(want[i], st.rto_ms);
+        rto = st.rto_ms;
+    }
+}
+
+/* Duplicate drops and decoder errors land in the stats; reset keeps the estimate. */
+void test_link_stats_count_rx_events(void)
+{
+    frame_link_t link;
+    link_io_t io = {0};
+    frame_link_stats_t st;
+    frame_link_init(&link, link_write_cb, link_now_ms_cb, &io, 100, 0);
+
+    frame_link_on_rx(&link, 5);
+    frame_link_on_rx(&link, 5);
+    frame_link_on_rx(&link, 5);
+    frame_link_on_rx_error(&link, FRAME_ERR_CRC);
+    frame_link_on_rx_error(&link, FRAME_ERR_CRC);
+    frame_link_on_rx_error(&link, FRAME_ERR_TRUNC);
+    frame_link_on_rx_error(NULL, FRAME_ERR_CRC);
+    link_round_trip(&link, &io, 70);
+
+    /* Zero retries: the first timeout fails the send. */
+    const uint8_t payload[] = {0xAB};
+    frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload));
+    io.now += 1000;
     TEST_ASSERT_EQUAL_INT(-1, frame_link_tick(&link));
+
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_link_get_stats(NULL, &st));
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_NULL_ARG, frame_link_get_stats(&link, NULL));
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_link_get_stats(&link, &st));
+    TEST_ASSERT_EQUAL_UINT32(2, st.rx_duplicates);
+    TEST_ASSERT_EQUAL_UINT32(2, st.crc_errors);
+    TEST_ASSERT_EQUAL_UINT32(1, st.rx_errors);
+    TEST_ASSERT_EQUAL_UINT32(2, st.tx_frames);
+    TEST_ASSERT_EQUAL_UINT32(1, st.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, st.failures);
+    TEST_ASSERT_EQUAL_UINT32(0, st.retransmits);
+    TEST_ASSERT_EQUAL_UINT32(70, st.rtt_avg_ms);
+
+    frame_link_reset_stats(&link);
+    frame_link_get_stats(&link, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.crc_errors);
+    TEST_ASSERT_EQUAL_UINT32(0, st.rtt_samples);
+    TEST_ASSERT_EQUAL_UINT32(0, st.rtt_avg_ms);
+    TEST_ASSERT_EQUAL_UINT32(70, st.srtt_ms);
 }
 
 void test_link_tick_idle_link_is_noop(void)
@@ -668,6 +1447,26 @@ void test_link_tick_idle_link_is_noop(void)
     TEST_ASSERT_EQUAL_INT(0, frame_link_tick(&link));
 }
 
+void test_link_abandon_moves_to_the_next_seq(void)
+{
+    frame_link_t link;
+    link_io_t io = {0};
+    frame_link_init(&link, link_write_cb, link_now_ms_cb, &io, 100, 0);
+
+    const uint8_t payload[] = {0xAB};
+    frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload));
+    io.now = 100;
+    TEST_ASSERT_EQUAL_INT(-1, frame_link_tick(&link));     /* out of retries */
+
+    /* A failed send keeps its SEQ; abandoning it moves on. */
+    frame_link_abandon(&link);
+    frame_link_abandon(NULL);
+    TEST_ASSERT_EQUAL_INT(FRAME_OK,
+        frame_link_send(&link, FRAME_TYPE_DATA, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_INT(0, frame_link_on_ack(&link, 0));
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_ack(&link, 1));
+}
+
 void test_link_on_rx_dedups_repeated_seq(void)
 {
     frame_link_t link;
@@ -682,6 +1481,79 @@ void test_link_on_rx_dedups_repeated_seq(void)
     TEST_ASSERT_EQUAL_INT(1, frame_link_on_rx(&link, 43));
 }
 
+/*
+ * A maximum-size frame goes out in FRAME_LINK_TX_CHUNK writes straight from
+ * the caller's fragments; the retransmit re-encodes the same bytes.
+ */
+typedef struct {
+    uint8_t bytes[2 * FRAME_MAX_ENCODED_SIZE];
+    size_t  len;
+    int     writes;
+    size_t  max_write;
+    uint32_t now;
+} link_stream_io_t;
+
+static int link_stream_write_cb(const uint8_t *bytes, size_t n, void *user)
+{
+    link_stream_io_t *io = (link_stream_io_t *)user;
+    TEST_ASSERT_TRUE(io->len + n <= sizeof(io->bytes));
+    memcpy(&io->bytes[io->len], bytes, n);
+    io->len += n;
+    io->writes++;
+    if (n > io->max_write) {
+        io->max_write = n;
+    }
+    return 0;
+}
+
+static uint32_t link_stream_now_ms_cb(void *user)
+{
+    return ((link_stream_io_t *)user)->now;
+}
+
+void test_link_sendv_streams_in_small_chunks(void)
+{
+    static link_stream_io_t io;
+    static uint8_t hdr[16];
+    static uint8_t body[FRAME_MAX_PAYLOAD - sizeof(hdr)];
+    frame_link_t link;
+    memset(&io, 0, sizeof(io));
+    fill_pseudo_random(hdr, sizeof(hdr), 11u);
+    fill_pseudo_random(body, sizeof(body), 12u);
+    body[0] = FRAME_FLAG;
+
+    /* No payload copy and no encoded frame inside the link any more. */
+    TEST_ASSERT_TRUE(sizeof(frame_link_t) < 256u);
+
+    frame_link_init(&link, link_stream_write_cb, link_stream_now_ms_cb, &io, 100, 1);
+    const frame_iov_t iov[2] = { { hdr, sizeof(hdr) }, { body, sizeof(body) } };
+    TEST_ASSERT_EQUAL_INT(FRAME_OK, frame_link_sendv(&link, FRAME_TYPE_DATA, iov, 2));
+    TEST_ASSERT_TRUE(io.writes > 1);
+    TEST_ASSERT_EQUAL_size_t(FRAME_LINK_TX_CHUNK, io.max_write);
+    const size_t first = io.len;
+
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_nack(&link, 0));
+    TEST_ASSERT_EQUAL_size_t(2 * first, io.len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(io.bytes, &io.bytes[first], first);
+
+    static capture_t cap;
+    static uint8_t pbuf[FRAME_MAX_PAYLOAD];
+    frame_decoder_t d;
+    memset(&cap, 0, sizeof(cap));
+    frame_decoder_init(&d, capture_rx_cb, capture_err_cb, &cap, pbuf, sizeof(pbuf));
+    frame_decoder_feed(&d, io.bytes, io.len);
+    TEST_ASSERT_EQUAL_size_t(2, cap.count);
+    TEST_ASSERT_EQUAL_size_t(FRAME_MAX_PAYLOAD, cap.frames[0].len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(hdr, cap.frames[0].payload, sizeof(hdr));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(body, &cap.frames[0].payload[sizeof(hdr)], sizeof(body));
+
+    /* Too many fragments for the link's iov slots. */
+    TEST_ASSERT_EQUAL_INT(1, frame_link_on_ack(&link, 0));
+    const frame_iov_t many[FRAME_LINK_MAX_IOV + 1] = { { NULL, 0 } };
+    TEST_ASSERT_EQUAL_INT(FRAME_ERR_OVERSIZE,
+        frame_link_sendv(&link, FRAME_TYPE_DATA, many, FRAME_LINK_MAX_IOV + 1));
+}
+
 /* ------------------------------------------------------------------------
  * Test runner
  * ------------------------------------------------------------------------ */
@@ -692,6 +1564,9 @@ int main(void)
 
     RUN_TEST(test_crc16_known_vector_123456789);
     RUN_TEST(test_crc16_empty_input_is_init);
+    RUN_TEST(test_crc16_engines_check_value);
+    RUN_TEST(test_crc16_engines_agree_on_every_length_and_offset);
+    RUN_TEST(test_crc16_update_is_incremental);
 
     RUN_TEST(test_encode_empty_payload);
     RUN_TEST(test_encode_then_decode_roundtrip);
@@ -704,6 +1579,9 @@ int main(void)
     RUN_TEST(test_encode_bad_type_rejected);
     RUN_TEST(test_encode_buf_too_small_rejected);
 
+    RUN_TEST(test_encoder_matches_frame_encode_for_any_split_and_cap);
+    RUN_TEST(test_encoder_begin_errors_leave_it_done);
+
     RUN_TEST(test_decoder_init_null_args);
     RUN_TEST(test_decoder_init_oversize_buf_rejected);
     RUN_TEST(test_decoder_feed_null_args_safe);
@@ -719,6 +1597,15 @@ int main(void)
     RUN_TEST(test_decoder_max_payload_round_trip);
     RUN_TEST(test_decoder_reset_clears_in_progress_frame);
 
+    RUN_TEST(test_swar_encode_matches_reference);
+    RUN_TEST(test_swar_decode_stream_in_random_chunks);
+
+    RUN_TEST(test_cobs_golden_vectors);
+    RUN_TEST(test_cobs_encode_matches_reference);
+    RUN_TEST(test_cobs_overhead_is_bounded);
+    RUN_TEST(test_cobs_mode_errors);
+    RUN_TEST(test_cobs_decode_stream_in_random_chunks);
+
     RUN_TEST(test_link_init_null_args);
     RUN_TEST(test_link_send_then_ack_advances_seq);
     RUN_TEST(test_link_send_overlap_rejected);
@@ -727,8 +1614,15 @@ int main(void)
     RUN_TEST(test_link_send_write_failure_keeps_state_idle);
     RUN_TEST(test_link_nack_triggers_retransmit);
     RUN_TEST(test_link_tick_retransmits_after_timeout);
+    RUN_TEST(test_link_rto_tracks_measured_rtt);
+    RUN_TEST(test_link_rto_is_clamped);
+    RUN_TEST(test_link_karn_skips_retransmitted_samples);
+    RUN_TEST(test_link_backoff_saturates);
+    RUN_TEST(test_link_stats_count_rx_events);
     RUN_TEST(test_link_tick_idle_link_is_noop);
+    RUN_TEST(test_link_abandon_moves_to_the_next_seq);
     RUN_TEST(test_link_on_rx_dedups_repeated_seq);
+    RUN_TEST(test_link_sendv_streams_in_small_chunks);
 
     return UNITY_END();
 }
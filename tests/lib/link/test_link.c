@@ -0,0 +1,436 @@
+#include "link.h"
+#include "unity.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* ------------------------------------------------------------------------
+ * Simulated transport: two link ends, A and B, on a full-duplex serial line
+ * with a virtual microsecond clock. Each direction serialises bytes at
+ * SIM_BAUD (10 bits per byte), delivers them SIM_LATENCY_US after they left,
+ * and can flip a bit in a byte with probability `corrupt`.
+ * ------------------------------------------------------------------------ */
+
+#define SIM_BAUD        115200u
+#define SIM_BYTE_US     (10u * 1000000u / SIM_BAUD)
+#define SIM_LATENCY_US  1000u
+#define SIM_STEP_US     100u
+#define LINE_CAP        (1u << 16)
+
+#define BLOCK           257u       /* 256-byte messages */
+#define BLOCKS          32u
+#define WIN             8u
+#define MAX_SEQ_CH      4u
+
+typedef struct {
+    uint8_t  b[LINE_CAP];
+    uint64_t at[LINE_CAP];
+    size_t   head, count;
+    uint64_t free_us;              /* when the line is next idle */
+    double   corrupt;
+} sim_line_t;
+
+typedef struct end {
+    link_t      link;
+    sim_line_t *tx;
+    uint8_t     pool[BLOCKS * BLOCK];
+    uint8_t     rx_buf[BLOCK];
+    uint8_t     rx_store[WIN * BLOCK];
+
+    /* Delivered messages: the next expected counter per channel. */
+    uint32_t    next[MAX_SEQ_CH];
+    uint32_t    got[MAX_SEQ_CH];
+    uint64_t    last_latency_us[MAX_SEQ_CH];
+    uint64_t    max_latency_us[MAX_SEQ_CH];
+} end_t;
+
+static uint64_t   g_now_us;
+static uint64_t   g_rng = 0x9E3779B97F4A7C15ull;
+static sim_line_t g_ab, g_ba;
+static end_t      g_a, g_b;
+
+static double sim_uniform(void)
+{
+    g_rng ^= g_rng >> 12;
+    g_rng ^= g_rng << 25;
+    g_rng ^= g_rng >> 27;
+    return (double)((g_rng * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int sim_write(const uint8_t *bytes, size_t n, void *user)
+{
+    sim_line_t *l = ((end_t *)user)->tx;
+    uint64_t t = (l->free_us > g_now_us) ? l->free_us : g_now_us;
+    for (size_t i = 0; i < n; ++i) {
+        TEST_ASSERT_TRUE(l->count < LINE_CAP);
+        const size_t k = (l->head + l->count) % LINE_CAP;
+        t += SIM_BYTE_US;
+        l->b[k]  = bytes[i];
+        l->at[k] = t + SIM_LATENCY_US;
+        if (l->corrupt > 0.0 && sim_uniform() < l->corrupt) {
+            l->b[k] ^= (uint8_t)(1u << (g_rng & 7u));
+        }
+        l->count++;
+    }
+    l->free_us = t;
+    return 0;
+}
+
+static uint32_t sim_now_ms(void *user)
+{
+    (void)user;
+    return (uint32_t)(g_now_us / 1000u);
+}
+
+/* Messages carry [counter:4][submit time in us:8][filler]. */
+static void sim_rx(uint8_t channel, const uint8_t *payload, size_t len, void *user)
+{
+    end_t *e = (end_t *)user;
+    TEST_ASSERT_TRUE(channel < MAX_SEQ_CH);
+    TEST_ASSERT_TRUE(len >= 12u);
+    uint32_t seq;
+    uint64_t sent_us;
+    memcpy(&seq, payload, sizeof(seq));
+    memcpy(&sent_us, &payload[4], sizeof(sent_us));
+    TEST_ASSERT_EQUAL_UINT32(e->next[channel], seq);
+    for (size_t k = 12; k < len; ++k) {
+        TEST_ASSERT_EQUAL_HEX8((uint8_t)(seq + k), payload[k]);
+    }
+    e->next[channel]++;
+    e->got[channel]++;
+    const uint64_t lat = g_now_us - sent_us;
+    e->last_latency_us[channel] = lat;
+    if (lat > e->max_latency_us[channel]) {
+        e->max_latency_us[channel] = lat;
+    }
+}
+
+static link_config_t base_config(end_t *e)
+{
+    link_config_t cfg = {
+        .write = sim_write, .now_ms = sim_now_ms, .rx = sim_rx, .user = e,
+        .timeout_ms = 200, .max_retries = 20, .window = WIN,
+        .mode = FRAME_MODE_HDLC,
+        .pool = e->pool, .block_size = BLOCK, .block_count = BLOCKS,
+        .rx_buf = e->rx_buf, .rx_store = e->rx_store,
+        .channel_count = 1,
+    };
+    return cfg;
+}
+
+/* Both ends with the same channel table; the lines start empty and clean. */
+static void sim_init(const link_channel_config_t *chans, uint8_t n, double corrupt)
+{
+    memset(&g_ab, 0, sizeof(g_ab));
+    memset(&g_ba, 0, sizeof(g_ba));
+    g_ab.corrupt = corrupt;
+    g_ba.corrupt = corrupt;
+    g_now_us = 0;
+    end_t *ends[2] = {&g_a, &g_b};
+    sim_line_t *tx[2] = {&g_ab, &g_ba};
+    for (int i = 0; i < 2; ++i) {
+        memset(ends[i], 0, sizeof(*ends[i]));
+        ends[i]->tx = tx[i];
+        link_config_t cfg = base_config(ends[i]);
+        cfg.channel_count = n;
+        memcpy(cfg.channels, chans, n * sizeof(chans[0]));
+        TEST_ASSERT_EQUAL_INT(LINK_OK, link_init(&ends[i]->link, &cfg));
+    }
+}
+
+static void line_deliver(sim_line_t *l, end_t *to)
+{
+    uint8_t buf[256];
+    size_t n = 0;
+    while (l->count > 0 && l->at[l->head] <= g_now_us) {
+        buf[n++] = l->b[l->head];
+        l->head = (l->head + 1u) % LINE_CAP;
+        l->count--;
+        if (n == sizeof(buf)) {
+            link_on_rx_bytes(&to->link, buf, n);
+            n = 0;
+        }
+    }
+    if (n > 0) {
+        link_on_rx_bytes(&to->link, buf, n);
+    }
+}
+
+static void sim_step(void)
+{
+    g_now_us += SIM_STEP_US;
+    line_deliver(&g_ab, &g_b);
+    line_deliver(&g_ba, &g_a);
+    TEST_ASSERT_TRUE(link_poll(&g_a.link) >= 0);
+    TEST_ASSERT_TRUE(link_poll(&g_b.link) >= 0);
+}
+
+static uint32_t g_sent[MAX_SEQ_CH];
+
+/* Queue A's next message on a channel; returns the link_send() result. */
+static link_err_t sim_send(uint8_t channel, size_t len)
+{
+    uint8_t msg[BLOCK];
+    const uint32_t seq = g_sent[channel];
+    memcpy(msg, &seq, sizeof(seq));
+    memcpy(&msg[4], &g_now_us, sizeof(g_now_us));
+    for (size_t k = 12; k < len; ++k) {
+        msg[k] = (uint8_t)(seq + k);
+    }
+    link_err_t rc = link_send(&g_a.link, channel, msg, len);
+    if (rc == LINK_OK) {
+        g_sent[channel]++;
+    }
+    return rc;
+}
+
+static void sim_reset_counters(void)
+{
+    memset(g_sent, 0, sizeof(g_sent));
+}
+
+/* ------------------------------------------------------------------------
+ * Tests
+ * ------------------------------------------------------------------------ */
+
+void test_link_init_validates_config(void)
+{
+    link_t l;
+    link_config_t cfg = base_config(&g_a);
+    TEST_ASSERT_EQUAL_INT(LINK_OK, link_init(&l, &cfg));
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NULL_ARG, link_init(NULL, &cfg));
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NULL_ARG, link_init(&l, NULL));
+
+    cfg.pool = NULL;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NULL_ARG, link_init(&l, &cfg));
+    cfg = base_config(&g_a);
+    cfg.rx_store = NULL;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NULL_ARG, link_init(&l, &cfg));
+    cfg.window = 1;      /* stop-and-wait needs no reorder store */
+    TEST_ASSERT_EQUAL_INT(LINK_OK, link_init(&l, &cfg));
+
+    cfg = base_config(&g_a);
+    cfg.window = 3;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg = base_config(&g_a);
+    cfg.mode = FRAME_MODE__MAX + 1u;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg = base_config(&g_a);
+    cfg.channel_count = 0;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg.channel_count = LINK_MAX_CHANNELS + 1u;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg = base_config(&g_a);
+    cfg.block_size = LINK_CHAN_OVERHEAD;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg.block_size = FRAME_MAX_PAYLOAD + 1u;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg = base_config(&g_a);
+    cfg.block_count = 0;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+    cfg.block_count = LINK_MAX_BLOCKS + 1u;
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CONFIG, link_init(&l, &cfg));
+
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NULL_ARG, link_send(NULL, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NULL_ARG, link_poll(NULL));
+    TEST_ASSERT_EQUAL_size_t(0, link_queued(NULL, 0));
+    TEST_ASSERT_EQUAL_size_t(0, link_free_blocks(NULL));
+    TEST_ASSERT_NULL(link_channel_stats(NULL, 0));
+}
+
+/* Quotas keep one channel from taking the whole pool; acks give it back. */
+void test_link_pool_quota_and_reclaim(void)
+{
+    const link_channel_config_t chans[3] = {
+        { .priority = 0, .max_queued = 20 },
+        { .priority = 0, .max_queued = 0 },
+        { .priority = 0, .max_queued = 4 },
+    };
+    sim_init(chans, 3, 0.0);
+    sim_reset_counters();
+
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_BAD_CHANNEL, sim_send(3, 16));
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_OVERSIZE, sim_send(0, BLOCK));
+
+    for (int i = 0; i < 20; ++i) {
+        TEST_ASSERT_EQUAL_INT(LINK_OK, sim_send(0, 64));
+    }
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NO_BUFFER, sim_send(0, 64));
+    TEST_ASSERT_EQUAL_size_t(20u - WIN, link_queued(&g_a.link, 0));
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL_INT(LINK_OK, sim_send(2, 64));
+    }
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NO_BUFFER, sim_send(2, 64));
+    for (int i = 0; i < 8; ++i) {
+        TEST_ASSERT_EQUAL_INT(LINK_OK, sim_send(1, 64));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, link_free_blocks(&g_a.link));
+    TEST_ASSERT_EQUAL_INT(LINK_ERR_NO_BUFFER, sim_send(1, 64));
+    TEST_ASSERT_EQUAL_UINT32(1, link_channel_stats(&g_a.link, 0)->no_buffer);
+    TEST_ASSERT_EQUAL_UINT32(1, link_channel_stats(&g_a.link, 1)->no_buffer);
+
+    for (int t = 0; t < 20000 && link_free_blocks(&g_a.link) < BLOCKS; ++t) {
+        sim_step();
+    }
+    TEST_ASSERT_EQUAL_size_t(BLOCKS, link_free_blocks(&g_a.link));
+    TEST_ASSERT_EQUAL_UINT32(20, g_b.got[0]);
+    TEST_ASSERT_EQUAL_UINT32(8, g_b.got[1]);
+    TEST_ASSERT_EQUAL_UINT32(4, g_b.got[2]);
+    TEST_ASSERT_EQUAL_UINT32(20u * 64u, link_channel_stats(&g_b.link, 0)->rx_bytes);
+}
+
+/*
+ * Bulk (256-byte blocks, kept full) and telemetry (16 bytes every 20 ms)
+ * share the line. As one FIFO channel, telemetry queues behind the bulk
+ * backlog; on its own urgent channel, with bulk capped below the window, it
+ * waits for at most the frames already on the wire.
+ */
+static uint64_t telemetry_max_latency(int separate)
+{
+    const link_channel_config_t chans[2] = {
+        { .priority = 1, .max_queued = 24, .max_in_flight = 2 },
+        { .priority = 0, .max_queued = 4 },
+    };
+    sim_init(chans, 2, 0.0);
+    sim_reset_counters();
+    const uint8_t tele = separate ? 1u : 0u;
+    uint32_t tele_sent = 0;
+
+    for (uint64_t t = 0; t < 2000000u; t += SIM_STEP_US) {
+        while (sim_send(0, BLOCK - 1u) == LINK_OK) {
+        }
+        if (t % 20000u == 0u) {
+            if (separate) {
+                TEST_ASSERT_EQUAL_INT(LINK_OK, sim_send(tele, 16));
+            } else {
+                /* Same channel: telemetry waits for a free slot like bulk. */
+                while (sim_send(tele, 16) != LINK_OK) {
+                    sim_step();
+                }
+            }
+            tele_sent++;
+        }
+        sim_step();
+    }
+    for (int t = 0; t < 100000 && link_free_blocks(&g_a.link) < BLOCKS; ++t) {
+        sim_step();
+    }
+    TEST_ASSERT_EQUAL_size_t(BLOCKS, link_free_blocks(&g_a.link));
+    TEST_ASSERT_EQUAL_UINT32(g_sent[0], g_b.got[0]);
+    if (separate) {
+        TEST_ASSERT_EQUAL_UINT32(tele_sent, g_b.got[1]);
+    }
+    const uint64_t lat = separate ? g_b.max_latency_us[1] : g_b.max_latency_us[0];
+
+    /* Bulk still gets most of the line. */
+    const double bulk_Bps = (double)link_channel_stats(&g_b.link, 0)->rx_bytes * 1e6 /
+                            (double)g_now_us;
+    char line[96];
+    snprintf(line, sizeof(line), "%s: telemetry max latency %.1f ms, bulk %.0f B/s",
+             separate ? "prioritised" : "one FIFO", (double)lat / 1000.0, bulk_Bps);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(bulk_Bps > 0.80 * SIM_BAUD / 10.0);
+    return lat;
+}
+
+void test_link_priority_keeps_telemetry_latency_low_under_bulk(void)
+{
+    const uint64_t fifo = telemetry_max_latency(0);
+    const uint64_t prio = telemetry_max_latency(1);
+
+    /* Two bulk frames on the wire, the telemetry frame, and its latency. */
+    const uint64_t frame_us = (2u + 2u * (FRAME_FIXED_OVERHEAD + BLOCK)) * SIM_BYTE_US;
+    TEST_ASSERT_TRUE(prio < 3u * frame_us + SIM_LATENCY_US);
+    TEST_ASSERT_TRUE(fifo > 5u * prio);
+}
+
+/* Equal priority: saturated channels share the line by their quanta. */
+void test_link_drr_splits_bandwidth_by_quantum(void)
+{
+    const link_channel_config_t chans[2] = {
+        { .priority = 0, .max_queued = 16, .quantum = 512 },
+        { .priority = 0, .max_queued = 16, .quantum = 256 },
+    };
+    sim_init(chans, 2, 0.0);
+    sim_reset_counters();
+    for (uint64_t t = 0; t < 5000000u; t += SIM_STEP_US) {
+        while (sim_send(0, 128) == LINK_OK) {
+        }
+        while (sim_send(1, 128) == LINK_OK) {
+        }
+        sim_step();
+    }
+    const double r = (double)link_channel_stats(&g_a.link, 0)->tx_bytes /
+                     (double)link_channel_stats(&g_a.link, 1)->tx_bytes;
+    char line[64];
+    snprintf(line, sizeof(line), "quantum 512:256, bytes sent %.2f:1", r);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(r > 1.9 && r < 2.1);
+}
+
+/* Bit errors on both directions: every message still arrives once, in order. */
+void test_link_recovers_from_bit_errors_on_every_channel(void)
+{
+    const link_channel_config_t chans[3] = {
+        { .priority = 2, .max_queued = 12, .max_in_flight = 4 },
+        { .priority = 1, .max_queued = 8 },
+        { .priority = 0, .max_queued = 4 },
+    };
+    sim_init(chans, 3, 2e-4);
+    sim_reset_counters();
+    for (uint64_t t = 0; t < 6000000u; t += SIM_STEP_US) {
+        while (g_sent[0] < 200u && sim_send(0, 200) == LINK_OK) {
+        }
+        if (t % 20000u == 0u && g_sent[1] < 300u) {
+            (void)sim_send(1, 40);
+        }
+        if (t % 50000u == 0u && g_sent[2] < 50u) {
+            (void)sim_send(2, 12);
+        }
+        sim_step();
+    }
+    for (int t = 0; t < 200000 && link_free_blocks(&g_a.link) < BLOCKS; ++t) {
+        sim_step();
+    }
+    TEST_ASSERT_TRUE(g_b.link.stats.crc_errors + g_b.link.stats.rx_errors > 0u);
+    TEST_ASSERT_TRUE(g_a.link.arq.stats.retransmits > 0u);
+    for (uint8_t c = 0; c < 3; ++c) {
+        TEST_ASSERT_EQUAL_UINT32(g_sent[c], g_b.got[c]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(200, g_sent[0]);
+    TEST_ASSERT_EQUAL_size_t(BLOCKS, link_free_blocks(&g_a.link));
+}
+
+/* Sequenced frames that are not CHAN, or name no channel, are dropped. */
+void test_link_drops_foreign_frames(void)
+{
+    const link_channel_config_t chans[1] = {{ .priority = 0 }};
+    sim_init(chans, 1, 0.0);
+    uint8_t wire[64];
+    const uint8_t bad_chan[3] = {5, 0, 0};
+    int n = frame_encode(0, FRAME_TYPE_DATA, bad_chan, sizeof(bad_chan), wire, sizeof(wire));
+    link_on_rx_bytes(&g_b.link, wire, (size_t)n);
+    n = frame_encode(1, FRAME_TYPE_CHAN, bad_chan, sizeof(bad_chan), wire, sizeof(wire));
+    link_on_rx_bytes(&g_b.link, wire, (size_t)n);
+    TEST_ASSERT_EQUAL_UINT32(2, g_b.link.stats.rx_bad_frames);
+    TEST_ASSERT_EQUAL_UINT32(0, g_b.got[0]);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_link_init_validates_config);
+    RUN_TEST(test_link_pool_quota_and_reclaim);
+    RUN_TEST(test_link_priority_keeps_telemetry_latency_low_under_bulk);
+    RUN_TEST(test_link_drr_splits_bandwidth_by_quantum);
+    RUN_TEST(test_link_recovers_from_bit_errors_on_every_channel);
+    RUN_TEST(test_link_drops_foreign_frames);
+
+    return UNITY_END();
+}
@@ -0,0 +1,292 @@
+#include "lz.h"
+#include "unity.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* ------------------------------------------------------------------------
+ * Sink: collects the output and the longest run handed over at once.
+ * ------------------------------------------------------------------------ */
+
+#define OUT_CAP  (512u * 1024u)
+
+static uint8_t g_out[OUT_CAP];
+static size_t  g_out_len;
+static size_t  g_max_run;
+static size_t  g_calls;
+static size_t  g_fail_after;   /* refuse once this many bytes are out; 0 = never */
+
+static int sink(const uint8_t *bytes, size_t n, void *user)
+{
+    (void)user;
+    TEST_ASSERT_TRUE(n > 0u);
+    if (g_fail_after != 0u && g_out_len + n > g_fail_after) {
+        return 1;
+    }
+    TEST_ASSERT_TRUE(g_out_len + n <= OUT_CAP);
+    memcpy(&g_out[g_out_len], bytes, n);
+    g_out_len += n;
+    g_calls++;
+    if (n > g_max_run) {
+        g_max_run = n;
+    }
+    return 0;
+}
+
+static uint8_t g_window[LZ_WINDOW_MAX];
+
+static void reset_sink(void)
+{
+    g_out_len   = 0;
+    g_max_run   = 0;
+    g_calls     = 0;
+    g_fail_after = 0;
+}
+
+static lz_decoder_t new_decoder(size_t window_size)
+{
+    lz_decoder_t d;
+    reset_sink();
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_init(&d, g_window, window_size, sink, NULL));
+    return d;
+}
+
+static const uint8_t HDR8[]  = {'L', 'Z', 8, 0};
+static const uint8_t HDR12[] = {'L', 'Z', 12, 0};
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc((size_t)n + 1u);
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_EQUAL_size_t((size_t)n, fread(buf, 1, (size_t)n, f));
+    fclose(f);
+    *len = (size_t)n;
+    return buf;
+}
+
+/* ------------------------------------------------------------------------
+ * Configuration and header
+ * ------------------------------------------------------------------------ */
+
+void test_lz_init_validates_window(void)
+{
+    lz_decoder_t d;
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_NULL_ARG, lz_decoder_init(NULL, g_window, 256, sink, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_NULL_ARG, lz_decoder_init(&d, NULL, 256, sink, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_NULL_ARG, lz_decoder_init(&d, g_window, 256, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_BAD_CONFIG, lz_decoder_init(&d, g_window, 128, sink, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_BAD_CONFIG, lz_decoder_init(&d, g_window, 3000, sink, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_BAD_CONFIG,
+                          lz_decoder_init(&d, g_window, 2u * LZ_WINDOW_MAX, sink, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_init(&d, g_window, 256, sink, NULL));
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_init(&d, g_window, LZ_WINDOW_MAX, sink, NULL));
+
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_NULL_ARG, lz_decoder_feed(NULL, HDR8, 4));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_NULL_ARG, lz_decoder_feed(&d, NULL, 4));
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_feed(&d, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_NULL_ARG, lz_decoder_finish(NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, lz_decoder_total(NULL));
+}
+
+void test_lz_rejects_bad_headers(void)
+{
+    static const uint8_t bad[][4] = {
+        {'L', 'Y', 8, 0},
+        {'l', 'Z', 8, 0},
+        {'L', 'Z', 7, 0},
+        {'L', 'Z', 13, 0},
+        {'L', 'Z', 8, 1},
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+        lz_decoder_t d = new_decoder(LZ_WINDOW_MAX);
+        TEST_ASSERT_EQUAL_INT(LZ_ERR_BAD_HEADER, lz_decoder_feed(&d, bad[i], 4));
+        /* Sticky until re-initialised. */
+        TEST_ASSERT_EQUAL_INT(LZ_ERR_BAD_HEADER, lz_decoder_feed(&d, HDR8, 4));
+        TEST_ASSERT_EQUAL_INT(LZ_ERR_BAD_HEADER, lz_decoder_finish(&d));
+    }
+
+    /* A 4 KB stream window does not fit a 256-byte decoder. */
+    lz_decoder_t d = new_decoder(256);
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_WINDOW, lz_decoder_feed(&d, HDR12, 4));
+
+    /* An empty stream is just the header; half a header is truncated. */
+    d = new_decoder(256);
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_feed(&d, HDR8, 2));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_TRUNC, lz_decoder_finish(&d));
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_feed(&d, &HDR8[2], 2));
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_finish(&d));
+    TEST_ASSERT_EQUAL_size_t(0, g_out_len);
+}
+
+/* ------------------------------------------------------------------------
+ * Hand-built streams
+ * ------------------------------------------------------------------------ */
+
+/* Literals, a short match, and an overlapping run with extension bytes. */
+void test_lz_literals_matches_and_long_runs(void)
+{
+    static const uint8_t s[] = {
+        'L', 'Z', 8, 0,
+        0x07,                      /* items 0..2 literals, 3..4 matches */
+        'a', 'b', 'c',
+        0x02, 0x20,                /* distance 3, length 2 + 3 = 5: "abcab" */
+        0x00, 0xF0, 0xFF, 0x0A,    /* distance 1, length 15 + 3 + 255 + 10 */
+    };
+    lz_decoder_t d = new_decoder(256);
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_feed(&d, s, sizeof(s)));
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_finish(&d));
+
+    const size_t run = 15u + 3u + 255u + 10u;
+    TEST_ASSERT_EQUAL_size_t(3u + 5u + run, g_out_len);
+    TEST_ASSERT_EQUAL_UINT32(3u + 5u + run, lz_decoder_total(&d));
+    TEST_ASSERT_EQUAL_MEMORY("abcabcab", g_out, 8);
+    for (size_t k = 0; k < run; ++k) {
+        TEST_ASSERT_EQUAL_HEX8('b', g_out[8 + k]);
+    }
+    /* The 256-byte window was flushed as it wrapped. */
+    TEST_ASSERT_TRUE(g_calls >= 2u);
+    TEST_ASSERT_TRUE(g_max_run <= 256u);
+}
+
+void test_lz_rejects_matches_before_the_start(void)
+{
+    static const uint8_t s[] = {'L', 'Z', 8, 0, 0x01, 'x', 0x01, 0x00};  /* distance 2 */
+    lz_decoder_t d = new_decoder(256);
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_CORRUPT, lz_decoder_feed(&d, s, sizeof(s)));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_CORRUPT, lz_decoder_finish(&d));
+
+    /* A distance past the stream's own window is corrupt too, even when
+     * the decoder's window would hold it. */
+    uint8_t big[4 + 40 * 9 + 3];
+    size_t n = 0;
+    memcpy(big, HDR8, 4);
+    n = 4;
+    for (int g = 0; g < 40; ++g) {
+        big[n++] = 0xFF;
+        for (int k = 0; k < 8; ++k) {
+            big[n++] = (uint8_t)(g * 8 + k);
+        }
+    }
+    big[n++] = 0x00;
+    big[n++] = 0x00;               /* distance 256 + 1 */
+    big[n++] = 0x01;
+    d = new_decoder(LZ_WINDOW_MAX);
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_CORRUPT, lz_decoder_feed(&d, big, n));
+}
+
+void test_lz_finish_reports_a_cut_item(void)
+{
+    static const uint8_t s[] = {'L', 'Z', 8, 0, 0x01, 'x', 0x00, 0xF0, 0xFF, 0x01};
+    /* Cut after FLAGS, a literal, D_lo, the L = 15 byte, an EXT 255. */
+    static const struct { size_t len; lz_err_t want; } cuts[] = {
+        {5, LZ_OK}, {6, LZ_OK}, {7, LZ_ERR_TRUNC}, {8, LZ_ERR_TRUNC},
+        {9, LZ_ERR_TRUNC}, {10, LZ_OK},
+    };
+    for (size_t i = 0; i < sizeof(cuts) / sizeof(cuts[0]); ++i) {
+        lz_decoder_t d = new_decoder(256);
+        TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_feed(&d, s, cuts[i].len));
+        TEST_ASSERT_EQUAL_INT(cuts[i].want, lz_decoder_finish(&d));
+    }
+    TEST_ASSERT_EQUAL_size_t(1u + 15u + 3u + 255u + 1u, g_out_len);
+}
+
+void test_lz_sink_refusal_stops_the_decoder(void)
+{
+    static const uint8_t s[] = {'L', 'Z', 8, 0, 0x01, 'x', 0x00, 0xF0, 0xFF, 0xFF, 0x00};
+    lz_decoder_t d = new_decoder(256);
+    g_fail_after = 300;
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_SINK, lz_decoder_feed(&d, s, sizeof(s)));
+    TEST_ASSERT_EQUAL_INT(LZ_ERR_SINK, lz_decoder_feed(&d, s, 1));
+    TEST_ASSERT_EQUAL_size_t(256, g_out_len);
+}
+
+/* ------------------------------------------------------------------------
+ * Round trip with tools/_lz.py
+ * ------------------------------------------------------------------------ */
+
+/* Decode `lz` in pieces of `piece` bytes (0: random sizes up to 300). */
+static void decode_in_pieces(const uint8_t *lz, size_t lz_len, size_t window, size_t piece)
+{
+    lz_decoder_t d = new_decoder(window);
+    uint32_t rng = 12345u;
+    for (size_t at = 0; at < lz_len;) {
+        size_t n = piece;
+        if (n == 0u) {
+            rng = rng * 1664525u + 1013904223u;
+            n = 1u + (rng >> 16) % 300u;
+        }
+        if (n > lz_len - at) {
+            n = lz_len - at;
+        }
+        TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_feed(&d, &lz[at], n));
+        at += n;
+    }
+    TEST_ASSERT_EQUAL_INT(LZ_OK, lz_decoder_finish(&d));
+    TEST_ASSERT_TRUE(g_max_run <= window);
+}
+
+static void check_round_trip(const char *orig_path, const char *lz_path, size_t window)
+{
+    size_t orig_len, lz_len;
+    uint8_t *orig = read_file(orig_path, &orig_len);
+    uint8_t *lz   = read_file(lz_path, &lz_len);
+
+    static const size_t pieces[] = {SIZE_MAX, 1, 0};
+    for (size_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); ++i) {
+        decode_in_pieces(lz, lz_len, window, pieces[i]);
+        TEST_ASSERT_EQUAL_size_t(orig_len, g_out_len);
+        TEST_ASSERT_EQUAL_MEMORY(orig, g_out, orig_len);
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "%s: %zu -> %zu bytes (%.1f%%), %zu-byte window",
+             orig_path, orig_len, lz_len, 100.0 * (double)lz_len / (double)orig_len, window);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(lz_len < orig_len);
+    free(orig);
+    free(lz);
+}
+
+void test_lz_decodes_python_compressed_object_file(void)
+{
+    check_round_trip(OBJ_PATH, OBJ_LZ_PATH, LZ_WINDOW_MAX);
+}
+
+void test_lz_decodes_python_compressed_text(void)
+{
+    check_round_trip(TEXT_PATH, TEXT_LZ_PATH, LZ_WINDOW_MAX);
+}
+
+/* A stream made for a 256-byte window decodes in a 256-byte window. */
+void test_lz_decodes_small_window_stream(void)
+{
+    check_round_trip(OBJ_PATH, OBJ_LZ_W8_PATH, 256);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lz_init_validates_window);
+    RUN_TEST(test_lz_rejects_bad_headers);
+    RUN_TEST(test_lz_literals_matches_and_long_runs);
+    RUN_TEST(test_lz_rejects_matches_before_the_start);
+    RUN_TEST(test_lz_finish_reports_a_cut_item);
+    RUN_TEST(test_lz_sink_refusal_stops_the_decoder);
+    RUN_TEST(test_lz_decodes_python_compressed_object_file);
+    RUN_TEST(test_lz_decodes_python_compressed_text);
+    RUN_TEST(test_lz_decodes_small_window_stream);
+
+    return UNITY_END();
+}
@@ -0,0 +1,201 @@
+#include "unity.h"
+#include "agc.h"
+#include "costas.h"
+#include "awgn.h"
+#include "bpsk.h"
+#include "prbs.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const double TWO_PI = 6.28318530717958647692;
+
+#define N_SAMP 4000
+
+static q15_t g_x[N_SAMP];
+static q15_t g_y[N_SAMP];
+
+/* Random BPSK symbols at amplitude amp (fraction of full scale). */
+static void make_bpsk(q15_t *x, size_t n, double amp)
+{
+    prbs_t p;
+    prbs_init(&p, PRBS15, 0x55u);
+    for (size_t k = 0; k < n; k++) {
+        x[k] = q15_from_float((float)(prbs_next_bit(&p) ? amp : -amp));
+    }
+}
+
+static double rms_db(const q15_t *x, size_t n)
+{
+    double acc = 0.0;
+    for (size_t k = 0; k < n; k++) {
+        acc += (double)x[k] * x[k];
+    }
+    return 10.0 * log10(acc / n / (32768.0 * 32768.0));
+}
+
+/* --- level normalisation ------------------------------------------------- */
+
+/*
+ * From 0 dB down to -40 dB input, the output must settle to the target level
+ * (-12 dBFS for the 0.25 default) and the gain must be the inverse of the
+ * input level.
+ */
+static void test_settles_to_target_over_40db(void)
+{
+    const double target_db = 20.0 * log10(AGC_DEFAULT_TARGET_RMS);
+    for (int att_db = 0; att_db <= 40; att_db += 10) {
+        double amp = 0.9 * pow(10.0, -att_db / 20.0);
+        make_bpsk(g_x, N_SAMP, amp);
+
+        agc_t agc;
+        agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT,
+                 AGC_DEFAULT_MU_SHIFT);
+        agc_run(&agc, g_x, N_SAMP);
+
+        TEST_ASSERT_DOUBLE_WITHIN(0.5, target_db, rms_db(g_x + N_SAMP / 2, N_SAMP / 2));
+        double want_gain_db = target_db - 20.0 * log10(amp);
+        TEST_ASSERT_DOUBLE_WITHIN(0.5, want_gain_db, agc_gain_db(&agc));
+    }
+}
+
+/* Acquisition from the worst case (-40 dB) completes within ~1000 samples. */
+static void test_acquisition_time(void)
+{
+    make_bpsk(g_x, N_SAMP, 0.009);
+    agc_t agc;
+    agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT,
+             AGC_DEFAULT_MU_SHIFT);
+    agc_run(&agc, g_x, 1000);
+    const double target_db = 20.0 * log10(AGC_DEFAULT_TARGET_RMS);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0, target_db, rms_db(g_x + 900, 100));
+}
+
+/*
+ * A signal that jumps from -40 dB to near full scale drives the settled
+ * (high) gain deep into clipping; the fast-attack path must pull it out within
+ * a few tens of samples rather than the power filter's time constant.
+ */
+static void test_fast_attack_on_level_step(void)
+{
+    make_bpsk(g_x, N_SAMP / 2, 0.009);
+    make_bpsk(g_x + N_SAMP / 2, N_SAMP / 2, 0.9);
+    agc_t agc;
+    agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT,
+             AGC_DEFAULT_MU_SHIFT);
+    agc_run(&agc, g_x, N_SAMP / 2);
+    TEST_ASSERT_EQUAL_UINT32(0u, agc.clips);
+
+    agc_run(&agc, g_x + N_SAMP / 2, N_SAMP / 2);
+    TEST_ASSERT_GREATER_THAN_UINT32(0u, agc.clips);
+    TEST_ASSERT_LESS_THAN_UINT32(60u, agc.clips);
+    for (size_t k = N_SAMP / 2 + 100; k < N_SAMP; k++) {
+        TEST_ASSERT_TRUE(g_x[k] != Q15_MAX && g_x[k] != Q15_MIN);
+    }
+}
+
+static void test_gain_is_clamped(void)
+{
+    /* Silence would drive the gain up forever; it must stop at the clamp. */
+    for (size_t k = 0; k < N_SAMP; k++) {
+        g_x[k] = 0;
+    }
+    agc_t agc;
+    agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT, 0u);
+    agc_run(&agc, g_x, N_SAMP);
+    TEST_ASSERT_EQUAL_INT32(AGC_GAIN_MAX, agc.gain);
+
+    /* Full-scale square wave with an aggressive loop: floor holds. */
+    for (size_t k = 0; k < N_SAMP; k++) {
+        g_x[k] = (k & 1u) ? Q15_MAX : Q15_MIN;
+    }
+    agc_init(&agc, 0.01f, AGC_DEFAULT_ALPHA_SHIFT, 0u);
+    agc_run(&agc, g_x, N_SAMP);
+    TEST_ASSERT_TRUE(agc.gain >= AGC_GAIN_MIN);
+}
+
+/* --- BER across the input range ------------------------------------------ */
+
+/*
+ * Receiver front end over a 40 dB input range: unit-energy BPSK plus complex
+ * AWGN at Eb/N0 = 6 dB, rotated by a carrier offset, then attenuated by
+ * att_db and quantised to q15 as an ADC would. AGC (complex) -> Costas ->
+ * slice on I. The Costas loop's gain depends on signal amplitude, so without
+ * the AGC a -40 dB input would leave it ~100x too slow to lock; with it, BER
+ * must sit on coherent BPSK theory at every level.
+ */
+static double ber_at_level(double att_db, float ebn0_db, uint32_t seed)
+{
+    enum { SKIP = 3000, N = 150000 };
+    const double amp   = 0.3 * pow(10.0, -att_db / 20.0);
+    const double sigma = channel_awgn_sigma(ebn0_db);
+    const double cfo   = 4e-4;
+
+    prbs_t tx;
+    prbs_check_t chk;
+    awgn_prng_t rng;
+    agc_t agc;
+    costas_t loop;
+    prbs_init(&tx, PRBS15, 0x3C3Cu);
+    prbs_check_init(&chk, PRBS15, 0x3C3Cu);
+    awgn_prng_seed(&rng, seed);
+    agc_init(&agc, AGC_DEFAULT_TARGET_RMS, AGC_DEFAULT_ALPHA_SHIFT,
+             AGC_DEFAULT_MU_SHIFT);
+    /* Post-AGC symbol amplitude: complex power 2 * 0.25^2 split 1 : 2 sigma^2. */
+    float sym_amp = (float)sqrt(2.0 * 0.0625 / (1.0 + 2.0 * sigma * sigma));
+    costas_init(&loop, COSTAS_BPSK, 0.005f, 0.707f, sym_amp);
+
+    for (int k = 0; k < N; k++) {
+        double s  = prbs_next_bit(&tx) ? 1.0 : -1.0;
+        double ri = s + sigma * awgn_prng_gauss(&rng);
+        double rq = sigma * awgn_prng_gauss(&rng);
+        double ph = TWO_PI * cfo * k + 0.7;
+        q15_t i = q15_from_float((float)(amp * (ri * cos(ph) - rq * sin(ph))));
+        q15_t q = q15_from_float((float)(amp * (ri * sin(ph) + rq * cos(ph))));
+
+        agc_run_iq(&agc, &i, &q, 1);
+        costas_step(&loop, &i, &q);
+        prbs_check_bit(&chk, bpsk_slice(i));
+        if (k == SKIP) {
+            chk.errors = 0;
+            chk.total  = 0;
+        }
+    }
+    return (double)chk.errors / (double)chk.total;
+}
+
+static void test_ber_at_theory_over_40db_range(void)
+{
+    const float ebn0_db = 6.0f;
+    double theory = channel_awgn_theory_ber(ebn0_db);
+    for (int att_db = 0; att_db <= 40; att_db += 10) {
+        double ber = ber_at_level(att_db, ebn0_db, 17u + (uint32_t)att_db);
+        TEST_ASSERT_DOUBLE_WITHIN(theory * 0.25, theory, ber);
+    }
+}
+
+static void test_iq_null_args_safe(void)
+{
+    agc_t agc;
+    q15_t x = 100;
+    agc_init(NULL, 0.25f, 5u, 2u);
+    agc_init(&agc, 0.25f, 5u, 2u);
+    agc_run(NULL, &x, 1);
+    agc_run(&agc, NULL, 1);
+    agc_run_iq(&agc, &x, NULL, 1);
+    agc_run_iq(&agc, g_y, g_y, 0);
+    TEST_PASS();
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_settles_to_target_over_40db);
+    RUN_TEST(test_acquisition_time);
+    RUN_TEST(test_fast_attack_on_level_step);
+    RUN_TEST(test_gain_is_clamped);
+    RUN_TEST(test_ber_at_theory_over_40db_range);
+    RUN_TEST(test_iq_null_args_safe);
+    return UNITY_END();
+}
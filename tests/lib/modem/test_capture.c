@@ -0,0 +1,152 @@
+#include "unity.h"
+#include "capture.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static capture_t g_cap;
+static q15_t g_i[4096];
+static q15_t g_q[4096];
+static q15_t g_out_i[CAPTURE_RING];
+static q15_t g_out_q[CAPTURE_RING];
+
+/* Sample k carries its own index (mod 2^15) on I and its negation on Q. */
+static void fill_ramp(size_t n)
+{
+    for (size_t k = 0; k < n; k++) {
+        g_i[k] = (q15_t)(k & 0x7FFFu);
+        g_q[k] = (q15_t)-(q15_t)(k & 0x7FFFu);
+    }
+}
+
+/* Push g_i/g_q[0..n) in ragged blocks, as a chain would. */
+static void push_ragged(size_t n, size_t first)
+{
+    size_t k = 0, step = first;
+    while (k < n) {
+        size_t m = (n - k < step) ? n - k : step;
+        capture_push(&g_cap, &g_i[k], &g_q[k], m);
+        k += m;
+        step = (step * 7u + 3u) % 97u + 1u;
+    }
+}
+
+static void test_arm_validates(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0u, capture_arm(NULL, 64u, 8u));
+    TEST_ASSERT_EQUAL_UINT16(0u, capture_arm(&g_cap, 0u, 0u));
+    TEST_ASSERT_EQUAL_UINT16(0u, capture_arm(&g_cap, CAPTURE_RING + 1u, 0u));
+    TEST_ASSERT_EQUAL_UINT16(0u, capture_arm(&g_cap, 64u, 64u));
+    TEST_ASSERT_EQUAL_UINT16(64u, capture_arm(&g_cap, 64u, 63u));
+    TEST_ASSERT_EQUAL(CAPTURE_ARMED, capture_state(&g_cap));
+
+    /* Nothing to read until the window is frozen. */
+    TEST_ASSERT_EQUAL_size_t(0u, capture_read(&g_cap, g_out_i, NULL, NULL));
+    capture_disarm(&g_cap);
+    TEST_ASSERT_EQUAL(CAPTURE_IDLE, capture_state(&g_cap));
+    TEST_ASSERT_EQUAL_UINT8(0u, capture_trigger(&g_cap, 10u));
+}
+
+/* A trigger known up front: the window lands exactly around it. */
+static void test_window_around_early_trigger(void)
+{
+    fill_ramp(4096u);
+    capture_arm(&g_cap, 256u, 100u);
+    TEST_ASSERT_EQUAL_UINT8(1u, capture_trigger(&g_cap, 2000u));
+    TEST_ASSERT_EQUAL_UINT8(0u, capture_trigger(&g_cap, 3000u));   /* one shot */
+    push_ragged(4096u, 13u);
+    TEST_ASSERT_EQUAL(CAPTURE_DONE, capture_state(&g_cap));
+    TEST_ASSERT_EQUAL_UINT32(2156u, g_cap.head);                    /* froze */
+
+    uint16_t trig = 0;
+    TEST_ASSERT_EQUAL_size_t(256u, capture_read(&g_cap, g_out_i, g_out_q, &trig));
+    TEST_ASSERT_EQUAL_UINT16(100u, trig);
+    for (size_t k = 0; k < 256u; k++) {
+        TEST_ASSERT_EQUAL_INT16(g_i[1900u + k], g_out_i[k]);
+        TEST_ASSERT_EQUAL_INT16(g_q[1900u + k], g_out_q[k]);
+    }
+}
+
+/*
+ * A trigger found after the fact (the chain's first bit error): the block
+ * holding it has not been pushed yet, but earlier ones have. Whatever is
+ * still in the ring is captured; a window already overwritten is refused.
+ */
+static void test_late_trigger_from_ring(void)
+{
+    fill_ramp(4096u);
+    capture_arm(&g_cap, 512u, 256u);
+    capture_push(&g_cap, g_i, g_q, 1500u);
+    TEST_ASSERT_EQUAL_UINT8(1u, capture_trigger(&g_cap, 1600u));
+    capture_push(&g_cap, &g_i[1500], &g_q[1500], 1500u);
+    TEST_ASSERT_EQUAL(CAPTURE_DONE, capture_state(&g_cap));
+
+    uint16_t trig = 0;
+    TEST_ASSERT_EQUAL_size_t(512u, capture_read(&g_cap, g_out_i, g_out_q, &trig));
+    TEST_ASSERT_EQUAL_UINT16(256u, trig);
+    for (size_t k = 0; k < 512u; k++) {
+        TEST_ASSERT_EQUAL_INT16(g_i[1344u + k], g_out_i[k]);
+    }
+
+    /* Entirely in the past but still in the ring: done at once. */
+    capture_arm(&g_cap, 128u, 64u);
+    capture_push(&g_cap, g_i, g_q, 1000u);
+    TEST_ASSERT_EQUAL_UINT8(1u, capture_trigger(&g_cap, 500u));
+    TEST_ASSERT_EQUAL(CAPTURE_DONE, capture_state(&g_cap));
+    TEST_ASSERT_EQUAL_size_t(128u, capture_read(&g_cap, g_out_i, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT16(g_i[436], g_out_i[0]);
+
+    /* Overwritten: refused, and the capture stays armed. */
+    capture_arm(&g_cap, 128u, 64u);
+    capture_push(&g_cap, g_i, g_q, 4000u);
+    TEST_ASSERT_EQUAL_UINT8(0u, capture_trigger(&g_cap, 500u));
+    TEST_ASSERT_EQUAL(CAPTURE_ARMED, capture_state(&g_cap));
+}
+
+/* Near the start the pre-trigger part is cut; a single rail reads Q as 0. */
+static void test_window_cut_at_start_single_rail(void)
+{
+    fill_ramp(512u);
+    capture_arm(&g_cap, 64u, 32u);
+    capture_trigger(&g_cap, 10u);
+    capture_push(&g_cap, g_i, NULL, 512u);
+    TEST_ASSERT_EQUAL(CAPTURE_DONE, capture_state(&g_cap));
+
+    uint16_t trig = 0;
+    g_out_q[0] = 1;
+    TEST_ASSERT_EQUAL_size_t(42u, capture_read(&g_cap, g_out_i, g_out_q, &trig));
+    TEST_ASSERT_EQUAL_UINT16(10u, trig);
+    TEST_ASSERT_EQUAL_INT16(0, g_out_i[0]);
+    TEST_ASSERT_EQUAL_INT16(41, g_out_i[41]);
+    TEST_ASSERT_EQUAL_INT16(0, g_out_q[0]);
+    TEST_ASSERT_EQUAL_UINT8(0u, g_cap.has_q);
+}
+
+/* Pushes while idle or frozen change nothing. */
+static void test_idle_and_done_ignore_pushes(void)
+{
+    fill_ramp(256u);
+    capture_arm(&g_cap, 16u, 8u);
+    capture_trigger(&g_cap, 20u);
+    capture_push(&g_cap, g_i, g_q, 64u);
+    uint32_t head = g_cap.head;
+    capture_push(&g_cap, &g_i[64], &g_q[64], 64u);
+    TEST_ASSERT_EQUAL_UINT32(head, g_cap.head);
+    capture_read(&g_cap, g_out_i, NULL, NULL);
+    TEST_ASSERT_EQUAL_INT16(12, g_out_i[0]);
+
+    capture_disarm(&g_cap);
+    capture_push(&g_cap, g_i, g_q, 64u);
+    TEST_ASSERT_EQUAL_UINT32(head, g_cap.head);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_arm_validates);
+    RUN_TEST(test_window_around_early_trigger);
+    RUN_TEST(test_late_trigger_from_ring);
+    RUN_TEST(test_window_cut_at_start_single_rail);
+    RUN_TEST(test_idle_and_done_ignore_pushes);
+    return UNITY_END();
+}
@@ -0,0 +1,252 @@
+#include "unity.h"
+#include "costas.h"
+#include "cfo.h"
+#include "awgn.h"
+#include "bpsk.h"
+#include "prbs.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const double TWO_PI = 6.28318530717958647692;
+
+/*
+ * Phase error between the true channel phase and the loop's estimate, both
+ * 32-bit phase words, wrapped to the constellation's ambiguity: mod pi for
+ * BPSK, mod pi/2 for QPSK. Returned in radians.
+ */
+static double phase_err_rad(uint32_t truth, uint32_t est, costas_mode_t mode)
+{
+    unsigned fold = (mode == COSTAS_QPSK) ? 2u : 1u;
+    int32_t d = (int32_t)((truth - est) << fold);
+    return (double)d * TWO_PI / 4294967296.0 / (double)(1u << fold);
+}
+
+#define N_SYMS 20000
+
+static q15_t g_i[N_SYMS];
+static q15_t g_q[N_SYMS];
+
+/* Random BPSK (on I) or QPSK symbols, deterministic from the PRBS. */
+static void make_symbols(costas_mode_t mode, size_t n, q15_t amp)
+{
+    prbs_t p;
+    prbs_init(&p, PRBS15, 0x1234u);
+    for (size_t k = 0; k < n; k++) {
+        g_i[k] = prbs_next_bit(&p) ? amp : (q15_t)-amp;
+        g_q[k] = 0;
+        if (mode == COSTAS_QPSK) {
+            g_q[k] = prbs_next_bit(&p) ? amp : (q15_t)-amp;
+        }
+    }
+}
+
+typedef struct {
+    size_t lock_sym;     /* first symbol after which |err| stays < 0.1 rad */
+    double jitter_rms;   /* RMS phase error after lock, radians            */
+    float  freq_est;     /* loop frequency estimate at the end             */
+} loop_result_t;
+
+/*
+ * Run `mode` symbols through a CFO channel (freq_norm, phase_rad) plus optional
+ * complex AWGN and a Costas loop of bandwidth bn_t, tracking the true phase in
+ * lockstep so the estimate can be scored symbol by symbol.
+ */
+static loop_result_t run_loop(costas_mode_t mode, float bn_t, float freq_norm,
+                              float phase_rad, int noisy, float ebn0_db)
+{
+    const q15_t amp = (mode == COSTAS_QPSK) ? 23170 : 32767;
+    make_symbols(mode, N_SYMS, amp);
+
+    channel_cfo_t cfo;
+    channel_cfo_init(&cfo, freq_norm, phase_rad);
+    costas_t loop;
+    costas_init(&loop, mode, bn_t, 0.707f, (float)amp / 32768.0f);
+
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, 99u);
+
+    static double err[N_SYMS];
+    uint32_t truth = cfo.rot.phase;
+    uint32_t step  = cfo.rot.step;
+    for (size_t k = 0; k < N_SYMS; k++) {
+        channel_cfo_apply(&cfo, &g_i[k], &g_q[k], 1);
+        if (noisy) {
+            channel_awgn_apply(&g_i[k], 1, ebn0_db, &rng);
+            channel_awgn_apply(&g_q[k], 1, ebn0_db, &rng);
+        }
+        err[k] = phase_err_rad(truth, loop.phase, mode);
+        costas_step(&loop, &g_i[k], &g_q[k]);
+        truth += step;
+    }
+
+    loop_result_t r;
+    r.lock_sym = 0;
+    for (size_t k = 0; k < N_SYMS; k++) {
+        if (fabs(err[k]) >= 0.1) {
+            r.lock_sym = k + 1;
+        }
+    }
+    /* Jitter over the second half, long after any pull-in transient. */
+    double acc = 0.0;
+    for (size_t k = N_SYMS / 2; k < N_SYMS; k++) {
+        acc += err[k] * err[k];
+    }
+    r.jitter_rms = sqrt(acc / (N_SYMS / 2));
+    r.freq_est = costas_freq(&loop);
+    return r;
+}
+
+/* --- channel impairment -------------------------------------------------- */
+
+static void test_cfo_rotates_at_configured_rate(void)
+{
+    /* A DC input (1, 0) comes out as a phasor turning at freq_norm. */
+    enum { N = 400 };
+    static q15_t i[N], q[N];
+    for (int k = 0; k < N; k++) {
+        i[k] = 30000;
+        q[k] = 0;
+    }
+    channel_cfo_t cfo;
+    channel_cfo_init(&cfo, 0.01f, 0.5f);
+    channel_cfo_apply(&cfo, i, q, N / 2);
+    channel_cfo_apply(&cfo, i + N / 2, q + N / 2, N / 2);   /* continues */
+    for (int k = 0; k < N; k++) {
+        double ph = 0.5 + TWO_PI * 0.01 * k;
+        TEST_ASSERT_INT_WITHIN(3, (int)lrint(30000.0 * cos(ph)), i[k]);
+        TEST_ASSERT_INT_WITHIN(3, (int)lrint(30000.0 * sin(ph)), q[k]);
+    }
+}
+
+/* --- acquisition --------------------------------------------------------- */
+
+static void test_static_phase_offset_is_removed(void)
+{
+    loop_result_t r = run_loop(COSTAS_BPSK, 0.01f, 0.0f, 0.6f, 0, 0.0f);
+    TEST_ASSERT_LESS_THAN(2000, r.lock_sym);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, r.freq_est);
+}
+
+static void test_bpsk_tracks_frequency_offset(void)
+{
+    /* 1e-3 cycles/symbol is 1 kHz at 1 Msym/s: a ~25 ppm crystal at 40 MHz. */
+    loop_result_t r = run_loop(COSTAS_BPSK, 0.01f, 1e-3f, -1.0f, 0, 0.0f);
+    TEST_ASSERT_LESS_THAN(3000, r.lock_sym);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1e-3f, r.freq_est);
+    /* Type-2 loop: no steady-state phase error on a frequency step. */
+    TEST_ASSERT_LESS_THAN(0.01, r.jitter_rms);
+}
+
+static void test_qpsk_tracks_frequency_offset(void)
+{
+    loop_result_t r = run_loop(COSTAS_QPSK, 0.01f, -7e-4f, 0.3f, 0, 0.0f);
+    TEST_ASSERT_LESS_THAN(3000, r.lock_sym);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -7e-4f, r.freq_est);
+    TEST_ASSERT_LESS_THAN(0.01, r.jitter_rms);
+}
+
+/*
+ * Lock time scales as ~1/BnT: quadrupling the bandwidth must cut the pull-in
+ * time by well over half.
+ */
+static void test_lock_time_shrinks_with_bandwidth(void)
+{
+    loop_result_t narrow = run_loop(COSTAS_BPSK, 0.005f, 5e-4f, 1.0f, 0, 0.0f);
+    loop_result_t wide   = run_loop(COSTAS_BPSK, 0.02f,  5e-4f, 1.0f, 0, 0.0f);
+    TEST_ASSERT_LESS_THAN(N_SYMS / 2, narrow.lock_sym);
+    TEST_ASSERT_LESS_THAN(narrow.lock_sym / 2, wide.lock_sym);
+}
+
+/* --- noise --------------------------------------------------------------- */
+
+/*
+ * Residual jitter under AWGN follows the linear-PLL result
+ * sigma_phi^2 = BnT / (Es/N0): wider loops pass more noise. Check both
+ * bandwidths land within 35% of theory (in RMS) at Eb/N0 = 10 dB, where
+ * decision errors in the detector are negligible.
+ */
+static void test_jitter_follows_loop_bandwidth(void)
+{
+    const float ebn0_db = 10.0f;
+    const double esn0 = pow(10.0, ebn0_db / 10.0);
+    const float bws[] = {0.005f, 0.02f};
+    double prev = 0.0;
+    for (unsigned b = 0; b < 2; b++) {
+        loop_result_t r = run_loop(COSTAS_BPSK, bws[b], 2e-4f, 0.4f, 1, ebn0_db);
+        double theory = sqrt(bws[b] / esn0);
+        TEST_ASSERT_DOUBLE_WITHIN(0.35 * theory, theory, r.jitter_rms);
+        TEST_ASSERT_GREATER_THAN(prev, r.jitter_rms);
+        prev = r.jitter_rms;
+    }
+}
+
+/*
+ * End to end: BPSK through a CFO + complex-AWGN channel, de-rotated by the
+ * loop and sliced on I, must still meet coherent BPSK theory once locked.
+ */
+static void test_ber_with_cfo_tracks_theory(void)
+{
+    const float ebn0_db = 6.0f;
+    enum { SKIP = 2000, N = 200000 };
+    prbs_t tx;
+    prbs_check_t chk;
+    awgn_prng_t rng;
+    channel_cfo_t cfo;
+    costas_t loop;
+    prbs_init(&tx, PRBS15, 0xACE1u);
+    prbs_check_init(&chk, PRBS15, 0xACE1u);
+    awgn_prng_seed(&rng, 5u);
+    channel_cfo_init(&cfo, 3e-4f, 0.2f);
+    costas_init(&loop, COSTAS_BPSK, 0.005f, 0.707f, 1.0f);
+
+    for (int k = 0; k < N; k++) {
+        q15_t i = bpsk_map(prbs_next_bit(&tx));
+        q15_t q = 0;
+        channel_cfo_apply(&cfo, &i, &q, 1);
+        channel_awgn_apply(&i, 1, ebn0_db, &rng);
+        channel_awgn_apply(&q, 1, ebn0_db, &rng);
+        costas_step(&loop, &i, &q);
+        uint8_t bit = bpsk_slice(i);
+        if (k < SKIP) {
+            /* Keep the checker in step but don't score the pull-in. */
+            prbs_check_bit(&chk, bit);
+            chk.errors = 0;
+            chk.total  = 0;
+        } else {
+            prbs_check_bit(&chk, bit);
+        }
+    }
+    double ber = (double)chk.errors / (double)chk.total;
+    double theory = channel_awgn_theory_ber(ebn0_db);
+    TEST_ASSERT_DOUBLE_WITHIN(theory * 0.25, theory, ber);
+}
+
+static void test_null_args_safe(void)
+{
+    q15_t x = 0;
+    costas_init(NULL, COSTAS_BPSK, 0.01f, 0.707f, 1.0f);
+    costas_reset(NULL);
+    costas_t c;
+    costas_init(&c, COSTAS_BPSK, 0.01f, 0.707f, 1.0f);
+    costas_run(&c, NULL, &x, 1);
+    costas_run(NULL, &x, &x, 1);
+    channel_cfo_init(NULL, 0.1f, 0.0f);
+    channel_cfo_apply(NULL, &x, &x, 1);
+    TEST_PASS();
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cfo_rotates_at_configured_rate);
+    RUN_TEST(test_static_phase_offset_is_removed);
+    RUN_TEST(test_bpsk_tracks_frequency_offset);
+    RUN_TEST(test_qpsk_tracks_frequency_offset);
+    RUN_TEST(test_lock_time_shrinks_with_bandwidth);
+    RUN_TEST(test_jitter_follows_loop_bandwidth);
+    RUN_TEST(test_ber_with_cfo_tracks_theory);
+    RUN_TEST(test_null_args_safe);
+    return UNITY_END();
+}
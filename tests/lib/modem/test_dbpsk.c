@@ -0,0 +1,199 @@
+#include "unity.h"
+#include "dbpsk.h"
+#include "awgn.h"
+#include "prbs.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define BLOCK 1024u
+
+/*
+ * The BER runs transmit at half amplitude so the rotated, noisy samples stay
+ * clear of q15 clipping; the AWGN stage is told about the 6.02 dB so Eb/N0
+ * keeps its meaning.
+ */
+#define BACKOFF_DB 6.0206f
+
+static dbpsk_t g_tx;
+static dbpsk_t g_rx;
+static uint8_t g_bits[BLOCK];
+static uint8_t g_out[BLOCK];
+static q15_t   g_i[BLOCK];
+static q15_t   g_q[BLOCK];
+
+/* Rotate I (Q zero) by theta0 + 2 pi f k, from symbol k0 on, into g_i/g_q. */
+static void rotate(const q15_t *sym, size_t n, size_t k0, double theta0, double f)
+{
+    for (size_t k = 0; k < n; k++) {
+        double th = theta0 + 2.0 * M_PI * f * (double)(k0 + k);
+        double s  = sym[k] / 32768.0;
+        g_i[k] = (q15_t)lrint(s * cos(th) * 32767.0);
+        g_q[k] = (q15_t)lrint(s * sin(th) * 32767.0);
+    }
+}
+
+/* Half-amplitude copy of the symbols. */
+static void halve(q15_t *x, size_t n)
+{
+    for (size_t k = 0; k < n; k++) {
+        x[k] = (q15_t)(x[k] / 2);
+    }
+}
+
+/*
+ * nbits through DBPSK in complex AWGN (N0/2 per rail) with a carrier phase
+ * theta0 and offset f cycles/symbol; q_rail 0 detects on I alone.
+ */
+static double run_ber(float ebn0_db, uint32_t nbits, double theta0, double f,
+                      int q_rail)
+{
+    static q15_t sym[BLOCK];
+    prbs_t p;
+    prbs_check_t chk;
+    awgn_prng_t rng;
+    prbs_init(&p, PRBS15, 1u);
+    prbs_check_init(&chk, PRBS15, 1u);
+    awgn_prng_seed(&rng, 7u);
+    dbpsk_init(&g_tx);
+    dbpsk_init(&g_rx);
+    g_rx.rx_i = BPSK_SYM_HI / 2;
+
+    uint32_t errors = 0;
+    for (uint32_t done = 0; done < nbits; done += BLOCK) {
+        prbs_next_bits(&p, g_bits, BLOCK);
+        dbpsk_mod_block(&g_tx, g_bits, sym, BLOCK);
+        halve(sym, BLOCK);
+        rotate(sym, BLOCK, done, theta0, f);
+        channel_awgn_apply(g_i, BLOCK, ebn0_db + BACKOFF_DB, &rng);
+        channel_awgn_apply(g_q, BLOCK, ebn0_db + BACKOFF_DB, &rng);
+        dbpsk_demod_block(&g_rx, g_i, q_rail ? g_q : NULL, g_out, BLOCK);
+        for (size_t k = 0; k < BLOCK; k++) {
+            errors += !prbs_check_bit(&chk, g_out[k]);
+        }
+    }
+    return (double)errors / (double)nbits;
+}
+
+/* Bit 1 keeps the phase, bit 0 flips it, starting from +1. */
+static void test_encoding_rule(void)
+{
+    static const uint8_t bits[6]  = {1u, 0u, 0u, 1u, 0u, 1u};
+    static const q15_t   want[6]  = {BPSK_SYM_HI, BPSK_SYM_LO, BPSK_SYM_HI,
+                                     BPSK_SYM_HI, BPSK_SYM_LO, BPSK_SYM_LO};
+    q15_t sym[6];
+    dbpsk_init(&g_tx);
+    dbpsk_mod_block(&g_tx, bits, sym, 3u);
+    dbpsk_mod_block(&g_tx, &bits[3], &sym[3], 3u);   /* state carries */
+    for (size_t k = 0; k < 6u; k++) {
+        TEST_ASSERT_EQUAL_INT16(want[k], sym[k]);
+    }
+
+    /* Full-scale products are exact, ties go to 1. */
+    TEST_ASSERT_EQUAL_UINT8(1u, dbpsk_detect(Q15_MIN, Q15_MIN, Q15_MIN, Q15_MIN));
+    TEST_ASSERT_EQUAL_UINT8(0u, dbpsk_detect(Q15_MIN, Q15_MIN, Q15_MAX, Q15_MAX));
+    TEST_ASSERT_EQUAL_UINT8(1u, dbpsk_detect(0, 0, Q15_MAX, 0));
+}
+
+/*
+ * Noiseless loopback through any fixed carrier phase, including the pi that
+ * would invert every coherent BPSK decision, and a small frequency offset:
+ * every bit comes back, across ragged calls. Only the first bit depends on
+ * the phase (the detector's reference is +1 on I), so it is skipped.
+ */
+static void test_loopback_is_phase_blind(void)
+{
+    static const double thetas[4] = {0.0, 1.0, M_PI, -2.5};
+    static q15_t sym[BLOCK];
+    for (size_t t = 0; t < 4u; t++) {
+        prbs_t p;
+        prbs_init(&p, PRBS9, 3u);
+        prbs_next_bits(&p, g_bits, BLOCK);
+        dbpsk_init(&g_tx);
+        dbpsk_init(&g_rx);
+        dbpsk_mod_block(&g_tx, g_bits, sym, BLOCK);
+        rotate(sym, BLOCK, 0u, thetas[t], 0.01);
+        size_t k = 0, step = 1u;
+        while (k < BLOCK) {
+            size_t m = (BLOCK - k < step) ? BLOCK - k : step;
+            dbpsk_demod_block(&g_rx, &g_i[k], &g_q[k], &g_out[k], m);
+            k += m;
+            step = step * 3u % 37u + 1u;
+        }
+        for (k = 1; k < BLOCK; k++) {
+            TEST_ASSERT_EQUAL_UINT8(g_bits[k], g_out[k]);
+        }
+    }
+}
+
+/*
+ * Measured BER in complex AWGN against 0.5 exp(-Eb/N0), with an arbitrary
+ * carrier phase and no recovery, and always worse than coherent BPSK
+ * (channel_awgn_theory_ber()) at the same Eb/N0.
+ */
+static void test_ber_matches_theory(void)
+{
+    static const float    dbs[3]  = {4.0f, 6.0f, 8.0f};
+    static const uint32_t bits[3] = {200u * BLOCK, 400u * BLOCK, 2000u * BLOCK};
+    static const double   tol[3]  = {0.06, 0.10, 0.20};
+    for (size_t k = 0; k < 3u; k++) {
+        double ber    = run_ber(dbs[k], bits[k], 0.7, 0.0, 1);
+        double theory = dbpsk_theory_ber(dbs[k]);
+        TEST_ASSERT_DOUBLE_WITHIN(tol[k] * theory, theory, ber);
+        TEST_ASSERT_TRUE(ber > channel_awgn_theory_ber(dbs[k]));
+    }
+}
+
+/*
+ * The cost against coherent BPSK is about 1 dB at low error rates: at the
+ * same BER, DBPSK needs between 0.5 and 1.5 dB more Eb/N0 for 1e-4..1e-6.
+ */
+static void test_theory_gap_to_bpsk(void)
+{
+    static const float bpsk_db[3] = {8.4f, 9.6f, 10.5f};   /* ~1e-4, 1e-5, 1e-6 */
+    for (size_t k = 0; k < 3u; k++) {
+        double pb = channel_awgn_theory_ber(bpsk_db[k]);
+        TEST_ASSERT_TRUE(dbpsk_theory_ber(bpsk_db[k] + 0.5f) > pb);
+        TEST_ASSERT_TRUE(dbpsk_theory_ber(bpsk_db[k] + 1.5f) < pb);
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.5 * exp(-pow(10.0, 0.6)), dbpsk_theory_ber(6.0f));
+
+    /* Fading: Rayleigh is 1 / (2 (1 + g)); large K tends to the AWGN curve. */
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.5 / (1.0 + pow(10.0, 1.0)),
+                              dbpsk_fading_theory_ber(10.0f, 0.0f));
+    TEST_ASSERT_DOUBLE_WITHIN(0.05 * dbpsk_theory_ber(6.0f), dbpsk_theory_ber(6.0f),
+                              dbpsk_fading_theory_ber(6.0f, 1e4f));
+}
+
+/*
+ * A frequency offset costs its phase step: at 0.02 cycles/symbol the
+ * decision statistic shrinks by cos(0.04 pi), a fraction of a dB.
+ */
+static void test_cfo_costs_little(void)
+{
+    double ber    = run_ber(6.0f, 400u * BLOCK, 0.3, 0.02, 1);
+    double theory = dbpsk_theory_ber(6.0f);
+    TEST_ASSERT_TRUE(ber > 0.95 * theory);
+    TEST_ASSERT_TRUE(ber < dbpsk_theory_ber(6.0f - 0.5f));
+}
+
+/* I-only detection with no offset: 2p(1 - p), p the coherent BPSK BER. */
+static void test_real_only_detection(void)
+{
+    double ber = run_ber(6.0f, 400u * BLOCK, 0.0, 0.0, 0);
+    double p   = channel_awgn_theory_ber(6.0f);
+    TEST_ASSERT_DOUBLE_WITHIN(0.10 * 2.0 * p * (1.0 - p), 2.0 * p * (1.0 - p), ber);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_encoding_rule);
+    RUN_TEST(test_loopback_is_phase_blind);
+    RUN_TEST(test_ber_matches_theory);
+    RUN_TEST(test_theory_gap_to_bpsk);
+    RUN_TEST(test_cfo_costs_little);
+    RUN_TEST(test_real_only_detection);
+    return UNITY_END();
+}
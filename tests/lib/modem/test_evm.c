@@ -0,0 +1,172 @@
+#include "unity.h"
+#include "evm.h"
+#include "awgn.h"
+#include "prbs.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/* Half-scale symbols so the noise is never clipped at q15 full scale. */
+#define AMP 0.5f
+
+/* n noisy BPSK symbols at Eb/N0 (I only), sliced through evm. */
+static uint32_t run_awgn(evm_t *evm, float ebn0_db, uint32_t n, uint32_t seed)
+{
+    prbs_t p;
+    prbs_init(&p, PRBS15, (uint16_t)seed);
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, seed);
+    const float sigma = channel_awgn_sigma(ebn0_db) * AMP * 32768.0f;
+    uint32_t errors = 0;
+    evm_reset(evm);
+    for (uint32_t k = 0; k < n; k++) {
+        uint8_t bit = prbs_next_bit(&p);
+        float y = (bit ? AMP : -AMP) * 32768.0f + sigma * awgn_prng_gauss(&rng);
+        errors += evm_slice(evm, q15_sat((q31_t)lrintf(y)), 0) != bit;
+    }
+    return errors;
+}
+
+static void test_clean_constellation(void)
+{
+    evm_t evm;
+    evm_reset(&evm);
+    const q15_t in[4] = {16384, -16384, -16384, 16384};
+    uint8_t bits[4];
+    evm_slice_block(&evm, in, NULL, bits, 4);
+    TEST_ASSERT_EQUAL_UINT8(1u, bits[0]);
+    TEST_ASSERT_EQUAL_UINT8(0u, bits[1]);
+
+    evm_stats_t st;
+    TEST_ASSERT_EQUAL_UINT8(1u, evm_report(&evm, &st));
+    TEST_ASSERT_EQUAL_UINT32(4u, st.symbols);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, st.centroid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, st.evm_rms_pct);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, st.evm_peak_pct);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, EVM_MER_CAP_DB, st.mer_db);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, st.clip_pct);
+}
+
+/* Full-scale samples (either rail polarity) are counted as clipped. */
+static void test_counts_clipping(void)
+{
+    evm_t evm;
+    evm_reset(&evm);
+    const q15_t in[4] = {Q15_MAX, Q15_MIN, 30000, -30000};
+    uint8_t bits[4];
+    evm_slice_block(&evm, in, NULL, bits, 4);
+    evm_stats_t st;
+    evm_report(&evm, &st);
+    TEST_ASSERT_EQUAL_UINT32(2u, evm.clipped);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 50.0f, st.clip_pct);
+}
+
+/* Above ~6 dB the decision-directed MER matches 2*Eb/N0 to a fraction of a dB. */
+static void test_mer_tracks_ebn0(void)
+{
+    static const float points[] = {6.0f, 9.0f, 12.0f, 15.0f};
+    for (size_t k = 0; k < sizeof(points) / sizeof(points[0]); k++) {
+        evm_t evm;
+        run_awgn(&evm, points[k], 20000u, 7u + (uint32_t)k);
+        evm_stats_t st;
+        evm_report(&evm, &st);
+        TEST_ASSERT_FLOAT_WITHIN(0.3f, points[k], st.ebn0_db);
+        TEST_ASSERT_FLOAT_WITHIN(0.3f, points[k] + 3.01f, st.mer_db);
+        /* EVM and MER are the same measurement. */
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, -20.0f * log10f(st.evm_rms_pct / 100.0f),
+                                 st.mer_db);
+    }
+}
+
+/*
+ * The point of the metric: at 6 dB, 2000 symbols (a handful of bit errors)
+ * already pin MER to about a tenth of a dB across seeds, while the error
+ * counts from the same symbols scatter by more than a factor of two.
+ */
+static void test_low_variance_vs_ber(void)
+{
+    double m1 = 0.0, m2 = 0.0;
+    uint32_t emin = UINT32_MAX, emax = 0u;
+    for (uint32_t s = 1; s <= 12u; s++) {
+        evm_t evm;
+        uint32_t e = run_awgn(&evm, 6.0f, 2000u, s);
+        evm_stats_t st;
+        evm_report(&evm, &st);
+        m1 += st.mer_db;
+        m2 += (double)st.mer_db * st.mer_db;
+        emin = (e < emin) ? e : emin;
+        emax = (e > emax) ? e : emax;
+    }
+    double mean = m1 / 12.0;
+    double sd   = sqrt(m2 / 12.0 - mean * mean);
+    TEST_ASSERT_TRUE(sd < 0.25);
+    TEST_ASSERT_TRUE(emax >= 2u * emin + 1u);
+}
+
+/* A constant phase error shows up as Q power: MER = cot^2(theta). */
+static void test_phase_error_shows_in_q(void)
+{
+    evm_t evm;
+    evm_reset(&evm);
+    const float th = 0.1f;
+    const q15_t i = q15_from_float(0.5f * cosf(th));
+    const q15_t q = q15_from_float(0.5f * sinf(th));
+    for (int k = 0; k < 100; k++) {
+        evm_slice(&evm, (k & 1) ? i : (q15_t)-i, (k & 1) ? q : (q15_t)-q);
+    }
+    evm_stats_t st;
+    evm_report(&evm, &st);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 20.0f * log10f(1.0f / tanf(th)), st.mer_db);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.5f * sinf(th), st.q_rms);
+}
+
+static void test_block_matches_single(void)
+{
+    static q15_t in_i[64], in_q[64];
+    for (int k = 0; k < 64; k++) {
+        in_i[k] = (q15_t)((k * 2654435761u) >> 16);
+        in_q[k] = (q15_t)((k * 40503u) & 0x0FFFu) - 2048;
+    }
+    evm_t a, b;
+    evm_reset(&a);
+    evm_reset(&b);
+    uint8_t bits[64];
+    evm_slice_block(&a, in_i, in_q, bits, 64);
+    for (int k = 0; k < 64; k++) {
+        TEST_ASSERT_EQUAL_UINT8(bits[k], evm_slice(&b, in_i[k], in_q[k]));
+    }
+    TEST_ASSERT_EQUAL_UINT32(b.n, a.n);
+    TEST_ASSERT_TRUE(a.sum_d == b.sum_d && a.sum_d2 == b.sum_d2 && a.sum_q2 == b.sum_q2);
+    TEST_ASSERT_EQUAL_UINT16(b.min_d, a.min_d);
+    TEST_ASSERT_EQUAL_UINT16(b.max_d, a.max_d);
+    TEST_ASSERT_EQUAL_UINT32(b.clipped, a.clipped);
+}
+
+static void test_empty_and_null(void)
+{
+    evm_t evm;
+    evm_stats_t st;
+    evm_reset(&evm);
+    TEST_ASSERT_EQUAL_UINT8(0u, evm_report(&evm, &st));
+    TEST_ASSERT_EQUAL_UINT8(0u, evm_report(NULL, &st));
+    evm_reset(NULL);
+    uint8_t bit;
+    q15_t x = 0;
+    evm_slice_block(NULL, &x, NULL, &bit, 1);
+    evm_slice_block(&evm, NULL, NULL, &bit, 1);
+    TEST_ASSERT_EQUAL_UINT32(0u, evm.n);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_constellation);
+    RUN_TEST(test_counts_clipping);
+    RUN_TEST(test_mer_tracks_ebn0);
+    RUN_TEST(test_low_variance_vs_ber);
+    RUN_TEST(test_phase_error_shows_in_q);
+    RUN_TEST(test_block_matches_single);
+    RUN_TEST(test_empty_and_null);
+    return UNITY_END();
+}
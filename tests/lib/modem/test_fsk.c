@@ -0,0 +1,123 @@
+#include "unity.h"
+#include "fsk.h"
+#include "awgn.h"
+#include "prbs.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define BLOCK_BITS 1024u
+
+static fsk_t   g_fsk;
+static uint8_t g_tx[BLOCK_BITS];
+static uint8_t g_rx[BLOCK_BITS];
+static q15_t   g_wave[BLOCK_BITS * 16u];
+
+static void test_init_validates(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(NULL, 4u, 16u, 2u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(&g_fsk, 3u, 16u, 2u, 0.5f));  /* M   */
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(&g_fsk, 4u, 12u, 2u, 0.5f));  /* N   */
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(&g_fsk, 4u, 128u, 2u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(&g_fsk, 4u, 16u, 0u, 0.5f));  /* DC  */
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(&g_fsk, 4u, 16u, 5u, 0.5f));  /* N/2 */
+    TEST_ASSERT_EQUAL_UINT8(0u, fsk_init(&g_fsk, 4u, 16u, 2u, 1.5f));
+    TEST_ASSERT_EQUAL_UINT8(2u, fsk_init(&g_fsk, 4u, 16u, 2u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(3u, fsk_init(&g_fsk, 8u, 32u, 4u, 0.5f));
+
+    /* Eb = 1: 4 tones x 16 samples needs A = 0.5. */
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, fsk_unit_eb_amp(4u, 16u));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, fsk_unit_eb_amp(5u, 16u));
+
+    fsk_init(&g_fsk, 4u, 16u, 2u, 0.5f);
+    TEST_ASSERT_EQUAL_size_t(0u, fsk_modulate(&g_fsk, g_tx, 3u, g_wave));
+    TEST_ASSERT_EQUAL_size_t(0u, fsk_demodulate(&g_fsk, g_wave, 15u, g_rx));
+}
+
+/* Symbol energy: a tone of amplitude A over N samples holds N*A^2/2. */
+static void test_tone_energy(void)
+{
+    fsk_init(&g_fsk, 4u, 16u, 2u, fsk_unit_eb_amp(4u, 16u));
+    const uint8_t bits[2] = {1u, 0u};   /* symbol 2: bin 4 */
+    TEST_ASSERT_EQUAL_size_t(16u, fsk_modulate(&g_fsk, bits, 2u, g_wave));
+    double es = 0.0;
+    for (size_t t = 0; t < 16u; t++) {
+        double v = g_wave[t] / 32768.0;
+        es += v * v;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 2.0, es);   /* Es = 2 Eb, Eb = 1 */
+    /* Four whole cycles per symbol: starts at the peak, ends just before it. */
+    TEST_ASSERT_INT_WITHIN(2, 16384, g_wave[0]);
+    TEST_ASSERT_INT_WITHIN(2, 16384, g_wave[4]);
+}
+
+static void test_clean_loopback_every_m(void)
+{
+    static const uint8_t ms[3] = {2u, 4u, 8u};
+    for (size_t i = 0; i < 3u; i++) {
+        prbs_t p;
+        prbs_init(&p, PRBS9, 1u);
+        fsk_init(&g_fsk, ms[i], 32u, 3u, 0.9f);
+        const size_t nbits = 510u;   /* whole symbols for 1, 2 and 3 bits */
+        prbs_next_bits(&p, g_tx, nbits);
+        size_t ns = fsk_modulate(&g_fsk, g_tx, nbits, g_wave);
+        TEST_ASSERT_EQUAL_size_t(nbits / g_fsk.bits * 32u, ns);
+        TEST_ASSERT_EQUAL_size_t(nbits, fsk_demodulate(&g_fsk, g_wave, ns, g_rx));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(g_tx, g_rx, nbits);
+    }
+}
+
+static void test_theory_closed_forms(void)
+{
+    /* M = 2 reduces to 0.5 * exp(-Eb/N0 / 2). */
+    for (float db = 0.0f; db <= 12.0f; db += 3.0f) {
+        double ebn0 = pow(10.0, db / 10.0);
+        TEST_ASSERT_FLOAT_WITHIN(1e-12, 0.5 * exp(-ebn0 / 2.0), fsk_theory_ber(2u, db));
+    }
+    /* More tones, same Eb: better. */
+    TEST_ASSERT_TRUE(fsk_theory_ber(4u, 8.0f) < fsk_theory_ber(2u, 8.0f));
+    TEST_ASSERT_TRUE(fsk_theory_ber(8u, 8.0f) < fsk_theory_ber(4u, 8.0f));
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, fsk_theory_ber(3u, 8.0f));
+}
+
+/*
+ * 4-FSK, N = 16, Eb = 1 through the same AWGN channel the BPSK chain uses:
+ * measured BER within 15% of the non-coherent theory.
+ */
+static void test_ber_tracks_theory(void)
+{
+    static const float dbs[2] = {6.0f, 8.0f};
+    for (size_t i = 0; i < 2u; i++) {
+        prbs_t p;
+        prbs_init(&p, PRBS15, 1u);
+        awgn_prng_t rng;
+        awgn_prng_seed(&rng, 5u + (uint32_t)i);
+        fsk_init(&g_fsk, 4u, 16u, 2u, fsk_unit_eb_amp(4u, 16u));
+        uint64_t bits = 0, errors = 0;
+        while (errors < 2000u) {
+            prbs_next_bits(&p, g_tx, BLOCK_BITS);
+            size_t ns = fsk_modulate(&g_fsk, g_tx, BLOCK_BITS, g_wave);
+            channel_awgn_apply(g_wave, ns, dbs[i], &rng);
+            fsk_demodulate(&g_fsk, g_wave, ns, g_rx);
+            for (size_t k = 0; k < BLOCK_BITS; k++) {
+                errors += g_tx[k] != g_rx[k];
+            }
+            bits += BLOCK_BITS;
+        }
+        double ber = (double)errors / (double)bits;
+        double th  = fsk_theory_ber(4u, dbs[i]);
+        TEST_ASSERT_FLOAT_WITHIN(0.15 * th, th, ber);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_validates);
+    RUN_TEST(test_tone_energy);
+    RUN_TEST(test_clean_loopback_every_m);
+    RUN_TEST(test_theory_closed_forms);
+    RUN_TEST(test_ber_tracks_theory);
+    return UNITY_END();
+}
@@ -0,0 +1,263 @@
+#include "unity.h"
+#include "lms_eq.h"
+#include "rrc.h"
+#include "awgn.h"
+#include "prbs.h"
+#include <math.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define AMP 0.5
+
+/* --- plumbing ------------------------------------------------------------ */
+
+static void test_init_validates_and_sets_delay(void)
+{
+    lms_eq_t eq;
+    TEST_ASSERT_EQUAL_UINT8(0u, lms_eq_init(&eq, 16u, 3u, 7u, 14u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, lms_eq_init(&eq, 3u, 2u, 7u, 14u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, lms_eq_init(&eq, 33u, 1u, 7u, 14u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, lms_eq_init(&eq, 16u, 2u, 0u, 14u, 0.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, lms_eq_init(&eq, 16u, 2u, 7u, 14u, 1.5f));
+    TEST_ASSERT_EQUAL_UINT8(0u, lms_eq_init(NULL, 16u, 2u, 7u, 14u, 0.5f));
+
+    TEST_ASSERT_EQUAL_UINT8(9u, lms_eq_init(&eq, 9u, 1u, 7u, 14u, 0.5f));
+    TEST_ASSERT_EQUAL_size_t(4u, lms_eq_delay(&eq));
+    TEST_ASSERT_EQUAL_UINT8(16u, lms_eq_init(&eq, 16u, 2u, 7u, 14u, 0.5f));
+    TEST_ASSERT_EQUAL_size_t(3u, lms_eq_delay(&eq));
+}
+
+/* Before adaptation the centre spike is a pure delay of lms_eq_delay(). */
+static void test_initial_taps_are_pure_delay(void)
+{
+    static const uint8_t cfg[][2] = {{9u, 1u}, {16u, 2u}, {13u, 2u}};
+    for (size_t c = 0; c < 3; c++) {
+        lms_eq_t eq;
+        lms_eq_init(&eq, cfg[c][0], cfg[c][1], 30u, 0u, 0.5f);
+        const size_t sps = cfg[c][1], d = lms_eq_delay(&eq);
+        q15_t in[64 * 2], out[64];
+        for (size_t k = 0; k < 64 * sps; k++) {
+            in[k] = (q15_t)(((k * 7919u) % 2001u) * 8u) - 8000;
+        }
+        lms_eq_run(&eq, in, out, 64, NULL);
+        for (size_t m = d; m < 64; m++) {
+            /* Symbol m - d's first (on-time) sample, scaled by Q15_MAX. */
+            TEST_ASSERT_INT_WITHIN(1, in[(m - d) * sps], out[m]);
+        }
+    }
+}
+
+/* --- symbol-spaced convergence ------------------------------------------- */
+
+/*
+ * Noiseless symbol-rate ISI channel h = [1, 0.45, 0.2] at half scale (its
+ * inverse decays as 0.45^k, well inside 11 taps): the raw eye keeps only 35%
+ * of its opening.
+ * Training drives the MSE below -30 dB, and decision-directed operation then
+ * holds it there with zero errors.
+ */
+static void test_symbol_spaced_training_then_dd(void)
+{
+    enum { N = 6000, TRAIN = 2000 };
+    static q15_t in[N], out[N], ref[N];
+    prbs_t p;
+    prbs_init(&p, PRBS15, 0x1234u);
+    q15_t s1 = 0, s2 = 0;
+    for (size_t k = 0; k < N; k++) {
+        q15_t s = q15_from_float(prbs_next_bit(&p) ? (float)AMP : -(float)AMP);
+        in[k] = q15_sat((q31_t)s + (((q31_t)s1 * 14746) >> 15)    /* +0.45 */
+                                 + (((q31_t)s2 * 6554) >> 15));   /* +0.20 */
+        ref[k] = s;
+        s2 = s1;
+        s1 = s;
+    }
+
+    lms_eq_t eq;
+    lms_eq_init(&eq, 11u, 1u, 6u, 0u, (float)AMP);
+    const size_t d = lms_eq_delay(&eq);
+    static q15_t train[N];
+    for (size_t m = 0; m < N; m++) {
+        train[m] = (m >= d) ? ref[m - d] : 0;
+    }
+    lms_eq_run(&eq, in, out, TRAIN, train);
+    TEST_ASSERT_TRUE(lms_eq_mse_db(&eq) < -30.0f);
+
+    lms_eq_run(&eq, in + TRAIN, out + TRAIN, N - TRAIN, NULL);
+    TEST_ASSERT_TRUE(lms_eq_mse_db(&eq) < -30.0f);
+    for (size_t m = TRAIN; m < N; m++) {
+        TEST_ASSERT_EQUAL_INT(ref[m - d] > 0, out[m] > 0);
+    }
+}
+
+/* --- fractionally spaced, through the RRC chain -------------------------- */
+
+/*
+ * BPSK -> RRC TX (sps 4) -> sample-rate echo -> AWGN -> RRC matched filter ->
+ * two samples per symbol. The echo (unit energy: 0.88, 0.40 at 3/4 symbol,
+ * -0.25 at 2 symbols) leaves ISI the matched filter cannot remove. Returns the
+ * BER of either the raw symbol-instant slicer (eq_on = 0) or the T/2 LMS
+ * equaliser, trained for the first 1000 symbols then decision-directed.
+ */
+#define CH_SPS    4u
+#define CH_SPAN   8u
+#define N_SYM     60000u
+#define TRAIN_SYM 1000u
+
+static const struct { uint8_t lag; float h; } k_echo[] = {
+    {0u, 0.88f}, {3u, 0.40f}, {8u, -0.25f},
+};
+
+static double fse_ber(float ebn0_db, int eq_on, uint32_t seed)
+{
+    static rrc_t tx, rx;
+    rrc_design(&tx, 0.35f, CH_SPS, CH_SPAN);
+    rrc_design(&rx, 0.35f, CH_SPS, CH_SPAN);
+    const size_t delay = rrc_chain_delay(&tx);
+
+    prbs_t src;
+    prbs_init(&src, PRBS15, (uint16_t)seed);
+    awgn_prng_t rng;
+    awgn_prng_seed(&rng, seed);
+    const float sigma = channel_awgn_sigma(ebn0_db) * (float)(AMP * 32768.0);
+
+    lms_eq_t eq;
+    lms_eq_init(&eq, LMS_EQ_DEFAULT_TAPS, 2u, LMS_EQ_DEFAULT_MU_SHIFT,
+                LMS_EQ_DEFAULT_LEAK_SHIFT, (float)AMP);
+    const size_t d = lms_eq_delay(&eq);
+
+    q15_t hist[16] = {0};
+    q15_t pair[2];
+    uint8_t ref_ring[32];
+    size_t errors = 0, counted = 0, nout = 0;
+    const size_t total = (size_t)(N_SYM + 20u) * CH_SPS;
+
+    for (size_t n = 0; n < total; n++) {
+        /* TX: symbol on the first phase, zero-stuffed otherwise. */
+        q15_t s = 0;
+        if (n % CH_SPS == 0u) {
+            uint8_t bit = prbs_next_bit(&src);
+            ref_ring[(n / CH_SPS) & 31u] = bit;
+            s = q15_from_float(bit ? (float)AMP : -(float)AMP);
+        }
+        q15_t v = rrc_push(&tx, s);
+
+        /* Echo channel, then noise. */
+        for (size_t k = 15; k > 0; k--) {
+            hist[k] = hist[k - 1];
+        }
+        hist[0] = v;
+        float acc = 0.0f;
+        for (size_t t = 0; t < sizeof(k_echo) / sizeof(k_echo[0]); t++) {
+            acc += k_echo[t].h * hist[k_echo[t].lag];
+        }
+        acc += sigma * awgn_prng_gauss(&rng);
+        q15_t r = rrc_push(&rx, q15_sat((q31_t)lrintf(acc)));
+
+        if (n < delay || (n - delay) % 2u != 0u) {
+            continue;
+        }
+        size_t half = (n - delay) / 2u;        /* T/2 sample index           */
+        pair[half & 1u] = r;
+        if (!eq_on) {
+            if ((half & 1u) == 0u && half / 2u < N_SYM) {
+                size_t sym = half / 2u;
+                errors += ((r > 0) != ref_ring[sym & 31u]);
+                counted++;
+            }
+            continue;
+        }
+        if ((half & 1u) == 0u) {
+            continue;
+        }
+        /* One symbol's pair (on-time, +T/2) is complete. */
+        size_t m = nout++;
+        q15_t train;
+        const q15_t *tp = NULL;
+        if (m >= d && m < TRAIN_SYM) {
+            train = ref_ring[(m - d) & 31u] ? eq.level : (q15_t)-eq.level;
+            tp = &train;
+        }
+        q15_t y = lms_eq_step(&eq, pair, tp);
+        if (m >= TRAIN_SYM && m - d < N_SYM) {
+            errors += ((y > 0) != ref_ring[(m - d) & 31u]);
+            counted++;
+        }
+    }
+    return (double)errors / (double)counted;
+}
+
+static void test_fse_recovers_multipath_ber(void)
+{
+    const float ebn0_db = 7.0f;
+    double theory = channel_awgn_theory_ber(ebn0_db);
+    double raw = fse_ber(ebn0_db, 0, 21u);
+    double eqd = fse_ber(ebn0_db, 1, 21u);
+    /* Unequalised, the echo costs an order of magnitude ... */
+    TEST_ASSERT_TRUE(raw > 8.0 * theory);
+    /* ... the equaliser brings it back to within ~1 dB of the AWGN bound. */
+    TEST_ASSERT_TRUE(eqd < 2.5 * theory);
+}
+
+/* --- leak ---------------------------------------------------------------- */
+
+/*
+ * Feed only the on-time sample of each T/2 pair (the +T/2 sample is zero), so
+ * the even taps, which see the +T/2 samples, are never excited. Left-over
+ * weight there (as if from an earlier drift) stays put in plain LMS; the leak
+ * must bleed it away while the excited taps keep equalising.
+ */
+static void run_unexcited(lms_eq_t *eq)
+{
+    prbs_t p;
+    prbs_init(&p, PRBS15, 0x0BEEu);
+    for (size_t k = 0; k < eq->ntaps; k += 2u) {
+        eq->wq30[k] = 1 << 26;                  /* 1/16 */
+        eq->w[k]    = 1 << 11;
+    }
+    q15_t pair[2] = {0, 0};
+    for (size_t m = 0; m < 150000u; m++) {
+        pair[0] = prbs_next_bit(&p) ? 16384 : -16384;
+        lms_eq_step(eq, pair, NULL);
+    }
+}
+
+static void test_leak_bleeds_unexcited_taps(void)
+{
+    lms_eq_t plain, leaky;
+    lms_eq_init(&plain, 16u, 2u, LMS_EQ_DEFAULT_MU_SHIFT, 0u, 0.5f);
+    lms_eq_init(&leaky, 16u, 2u, LMS_EQ_DEFAULT_MU_SHIFT,
+                LMS_EQ_DEFAULT_LEAK_SHIFT, 0.5f);
+    run_unexcited(&plain);
+    run_unexcited(&leaky);
+    for (size_t k = 0; k < 16u; k += 2u) {
+        TEST_ASSERT_EQUAL_INT16(1 << 11, plain.w[k]);
+        TEST_ASSERT_INT_WITHIN(2, 0, leaky.w[k]);
+    }
+    /* The leak's bias on the excited taps is small at the default ratio. */
+    TEST_ASSERT_TRUE(lms_eq_mse_db(&leaky) < -20.0f);
+}
+
+static void test_null_args_safe(void)
+{
+    lms_eq_t eq;
+    q15_t x[2] = {0, 0};
+    lms_eq_init(&eq, 16u, 2u, 7u, 14u, 0.5f);
+    lms_eq_reset(NULL);
+    lms_eq_run(NULL, x, x, 1, NULL);
+    lms_eq_run(&eq, NULL, x, 1, NULL);
+    lms_eq_run(&eq, x, NULL, 1, NULL);
+    TEST_PASS();
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_validates_and_sets_delay);
+    RUN_TEST(test_initial_taps_are_pure_delay);
+    RUN_TEST(test_symbol_spaced_training_then_dd);
+    RUN_TEST(test_fse_recovers_multipath_ber);
+    RUN_TEST(test_leak_bleeds_unexcited_taps);
+    RUN_TEST(test_null_args_safe);
+    return UNITY_END();
+}
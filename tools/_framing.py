@@ -22,6 +22,21 @@ ESC = 0x7D
 ESC_XOR = 0x20
 
 MAX_PAYLOAD = 1024
+FIXED_OVERHEAD = 6
+
+# Framing modes — must match `frame_mode_t` in lib/framing/inc/framing.h.
+MODE_HDLC = 0
+MODE_COBS = 1
+MODE_COBSR = 2
+
+MODE_NAMES = {
+    MODE_HDLC: "hdlc",
+    MODE_COBS: "cobs",
+    MODE_COBSR: "cobsr",
+}
+
+COBS_DELIM = 0x00
+COBS_BLOCK_MAX = 254
 
 # Frame types — must match `frame_type_t` in lib/framing/inc/framing.h.
 TYPE_DATA = 0
@@ -33,6 +48,9 @@ TYPE_OTA_END = 5
 TYPE_PING = 6
 TYPE_PONG = 7
 TYPE_STATUS = 8
+TYPE_CAPTURE = 9
+TYPE_AGG = 10
+TYPE_CHAN = 11
 
 TYPE_NAMES = {
     TYPE_DATA: "DATA",
@@ -44,6 +62,9 @@ TYPE_NAMES = {
     TYPE_PING: "PING",
     TYPE_PONG: "PONG",
     TYPE_STATUS: "STATUS",
+    TYPE_CAPTURE: "CAPTURE",
+    TYPE_AGG: "AGG",
+    TYPE_CHAN: "CHAN",
 }
 
 # OTA STATUS payload byte values — must match `ota_status_t` in
@@ -62,11 +83,15 @@ STATUS_NAMES = {
     STATUS_ROLLBACK_REJECTED: "rollback_rejected",
 }
 
+# Optional OTA_BEGIN flags byte — must match OTA_BEGIN_F_* in
+# apps/bootloader/loader/ota.h.
+OTA_BEGIN_F_LZ = 0x01  # OTA_CHUNK data is one lib/lz stream (tools/_lz.py)
+
 
 def crc16_ccitt(buf: bytes) -> int:
     """CRC-16-CCITT, poly 0x1021, init 0xFFFF, no final XOR.
 
-    Bytewise loop, mirrors lib/framing/src/framing.c::frame_crc16. Reference
+    Bitwise loop, mirrors lib/framing/src/crc16.c::frame_crc16. Reference
     vector: crc16("123456789") == 0x29B1.
     """
     crc = 0xFFFF
@@ -86,12 +111,83 @@ def _stuff(byte: int) -> bytes:
     return bytes([byte])
 
 
-def encode_frame(seq: int, type_: int, payload: bytes = b"") -> bytes:
+def cobs_encode(data: bytes, reduced: bool = False) -> bytes:
+    """COBS-encode data (no delimiters); COBS-R when reduced.
+
+    Mirrors the block rules of the C encoder: a block is at most 254
+    non-zero bytes; a zero always starts another block (even an empty last
+    one); a full block at the very end takes no extra code byte. COBS-R
+    sends the last byte as the final code byte when it is larger than the
+    code it replaces.
+    """
+    out = bytearray()
+    i, n = 0, len(data)
+    while True:
+        j = i
+        while j < n and data[j] != 0 and j - i < COBS_BLOCK_MAX:
+            j += 1
+        block = data[i:j]
+        if len(block) == COBS_BLOCK_MAX:
+            out.append(0xFF)
+            out += block
+            i = j
+            if i == n:
+                return bytes(out)
+        elif j == n:
+            if reduced and block and block[-1] > len(block) + 1:
+                out.append(block[-1])
+                out += block[:-1]
+            else:
+                out.append(len(block) + 1)
+                out += block
+            return bytes(out)
+        else:
+            out.append(len(block) + 1)
+            out += block
+            i = j + 1
+
+
+def cobs_decode(data: bytes, reduced: bool = False) -> bytes | None:
+    """Reverse cobs_encode(); None if data is not a complete encoding."""
+    out = bytearray()
+    i, n = 0, len(data)
+    while i < n:
+        code = data[i]
+        i += 1
+        if code == 0:
+            return None
+        if i + code - 1 > n:
+            if not reduced:
+                return None
+            # COBS-R: the block runs to the end, then the code byte itself.
+            out += data[i:]
+            out.append(code)
+            return bytes(out)
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < n:
+            out.append(0)
+    return bytes(out)
+
+
+def encoded_max(mode: int, payload_len: int) -> int:
+    """Worst-case frame size, as `frame_encoded_max` in framing.c."""
+    body = FIXED_OVERHEAD + payload_len
+    if mode == MODE_HDLC:
+        return 2 + 2 * body
+    if mode in MODE_NAMES:
+        return 2 + body + (body + COBS_BLOCK_MAX - 1) // COBS_BLOCK_MAX
+    raise ValueError(f"unknown framing mode: {mode}")
+
+
+def encode_frame(seq: int, type_: int, payload: bytes = b"",
+                 mode: int = MODE_HDLC) -> bytes:
     """Encode (seq, type, payload) into the on-wire framing format.
 
-    Mirrors `frame_encode` in lib/framing/src/framing.c byte-for-byte:
+    Mirrors `frame_encode_mode` in lib/framing/src/framing.c byte-for-byte:
     body = [seq, type, len_lo, len_hi, payload]; CRC-16-CCITT over body;
-    body + CRC bytes are stuffed; full frame is wrapped in FLAG bytes.
+    body + CRC bytes are stuffed; full frame is wrapped in FLAG bytes. In
+    the COBS modes body + CRC are COBS-encoded between 0x00 delimiters.
     """
     if not (0 <= seq <= 0xFF):
         raise ValueError(f"seq out of range: {seq}")
@@ -99,6 +195,8 @@ def encode_frame(seq: int, type_: int, payload: bytes = b"") -> bytes:
         raise ValueError(f"unknown frame type: {type_}")
     if len(payload) > MAX_PAYLOAD:
         raise ValueError(f"payload too large: {len(payload)} > {MAX_PAYLOAD}")
+    if mode not in MODE_NAMES:
+        raise ValueError(f"unknown framing mode: {mode}")
 
     header = bytes(
         [seq, type_, len(payload) & 0xFF, (len(payload) >> 8) & 0xFF]
@@ -106,6 +204,10 @@ def encode_frame(seq: int, type_: int, payload: bytes = b"") -> bytes:
     crc = crc16_ccitt(header + payload)
     crc_bytes = bytes([crc & 0xFF, (crc >> 8) & 0xFF])
 
+    if mode != MODE_HDLC:
+        body = cobs_encode(header + payload + crc_bytes, mode == MODE_COBSR)
+        return bytes([COBS_DELIM]) + body + bytes([COBS_DELIM])
+
     out = bytearray([FLAG])
     for b in header:
         out += _stuff(b)
@@ -117,6 +219,46 @@ def encode_frame(seq: int, type_: int, payload: bytes = b"") -> bytes:
     return bytes(out)
 
 
+AGG_SUB_OVERHEAD = 3
+_AGG_BAD_SUB_TYPES = (TYPE_ACK, TYPE_NACK, TYPE_AGG)
+
+
+def agg_pack(messages: list[tuple[int, bytes]]) -> bytes:
+    """Pack (type, payload) messages into a TYPE_AGG payload.
+
+    Mirrors lib/framing/src/frame_agg.c: each sub-message is
+    [type, len_lo, len_hi, payload].
+    """
+    out = bytearray()
+    for type_, payload in messages:
+        if type_ not in TYPE_NAMES or type_ in _AGG_BAD_SUB_TYPES:
+            raise ValueError(f"type not allowed in an AGG frame: {type_}")
+        out += bytes([type_, len(payload) & 0xFF, (len(payload) >> 8) & 0xFF])
+        out += payload
+    if len(out) > MAX_PAYLOAD:
+        raise ValueError(f"AGG payload too large: {len(out)} > {MAX_PAYLOAD}")
+    return bytes(out)
+
+
+def agg_split(payload: bytes) -> list[tuple[int, bytes]] | None:
+    """Unpack a TYPE_AGG payload, as `frame_agg_split`; None if malformed."""
+    out = []
+    off = 0
+    while off < len(payload):
+        if len(payload) - off < AGG_SUB_OVERHEAD:
+            return None
+        type_ = payload[off]
+        n = payload[off + 1] | (payload[off + 2] << 8)
+        start = off + AGG_SUB_OVERHEAD
+        if n > len(payload) - start:
+            return None
+        if type_ not in TYPE_NAMES or type_ in _AGG_BAD_SUB_TYPES:
+            return None
+        out.append((type_, bytes(payload[start:start + n])))
+        off = start + n
+    return out
+
+
 @dataclass
 class DecodedFrame:
     seq: int
@@ -130,10 +272,13 @@ class Decoder:
     Feed bytes via `feed()`; complete frames are returned via the iterator.
     Behaviour intentionally matches the C side: bad CRC drops the frame
     silently (the Python caller can inspect `crc_errors` or `truncations`),
-    and the decoder resyncs on the next FLAG.
+    and the decoder resyncs on the next FLAG (0x00 in the COBS modes).
     """
 
-    def __init__(self) -> None:
+    def __init__(self, mode: int = MODE_HDLC) -> None:
+        if mode not in MODE_NAMES:
+            raise ValueError(f"unknown framing mode: {mode}")
+        self.mode = mode
         self._buf = bytearray()
         self._in_frame = False
         self._in_escape = False
@@ -143,6 +288,8 @@ class Decoder:
         self.bad_types = 0
 
     def feed(self, data: bytes) -> list[DecodedFrame]:
+        if self.mode != MODE_HDLC:
+            return self._feed_cobs(data)
         out: list[DecodedFrame] = []
         for b in data:
             if b == FLAG:
@@ -168,6 +315,26 @@ class Decoder:
             self._buf.append(b)
         return out
 
+    def _feed_cobs(self, data: bytes) -> list[DecodedFrame]:
+        out: list[DecodedFrame] = []
+        for b in data:
+            if b != COBS_DELIM:
+                if self._in_frame:
+                    self._buf.append(b)
+                continue
+            if self._in_frame and self._buf:
+                body = cobs_decode(bytes(self._buf), self.mode == MODE_COBSR)
+                if body is None:
+                    self.truncations += 1
+                else:
+                    self._buf = bytearray(body)
+                    frame = self._finalize()
+                    if frame is not None:
+                        out.append(frame)
+            self._buf = bytearray()
+            self._in_frame = True
+        return out
+
     def _finalize(self) -> DecodedFrame | None:
         if self._dropping:
             self.truncations += 1
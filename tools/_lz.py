@@ -0,0 +1,149 @@
+"""Pure-Python LZSS compressor for lib/lz — host side of compressed transfers.
+
+Single Python source of truth for the stream format defined in
+lib/lz/inc/lz.h. Used by tools/lz_compress.py and tools/ota_send.py
+(--compress). tests/lib/lz runs the C decoder on this module's output, so
+drift between the two fails host-tests.
+
+Stream:
+    header  = b"LZ" + bytes([window_bits, 0])
+    group   = FLAGS byte, then up to 8 items; FLAGS bit i (LSB first)
+              is 1 for a literal, 0 for a match
+    literal = one byte
+    match   = [D_lo] [L << 4 | D_hi] [EXT]*: copy L + 3 bytes from
+              distance D + 1; L = 15 adds EXT bytes, each 255 continuing
+
+Dependencies: stdlib only.
+"""
+
+from __future__ import annotations
+
+MAGIC = b"LZ"
+HEADER_SIZE = 4
+MIN_MATCH = 3
+WINDOW_BITS_MIN = 8
+WINDOW_BITS_MAX = 12
+
+_LEN_EXT = 15                 # L value that is followed by EXT bytes
+_MAX_MATCH = 1 << 16          # compressor cap; the format has none
+_CHAIN = 48                   # hash-chain candidates tried per position
+
+
+def _match_bytes(dist: int, length: int) -> bytes:
+    d = dist - 1
+    code = length - MIN_MATCH
+    out = bytearray([d & 0xFF])
+    if code < _LEN_EXT:
+        out.append((code << 4) | (d >> 8))
+        return bytes(out)
+    out.append((_LEN_EXT << 4) | (d >> 8))
+    code -= _LEN_EXT
+    while code >= 255:
+        out.append(255)
+        code -= 255
+    out.append(code)
+    return bytes(out)
+
+
+def compress(data: bytes, window_bits: int = WINDOW_BITS_MAX) -> bytes:
+    """Compress `data` for a decoder window of 1 << window_bits bytes."""
+    if not WINDOW_BITS_MIN <= window_bits <= WINDOW_BITS_MAX:
+        raise ValueError(f"window_bits must be {WINDOW_BITS_MIN}..{WINDOW_BITS_MAX}")
+    window = 1 << window_bits
+    n = len(data)
+    head: dict[bytes, int] = {}
+    prev = [-1] * n
+
+    def insert(i: int) -> None:
+        if i + MIN_MATCH <= n:
+            key = data[i:i + MIN_MATCH]
+            prev[i] = head.get(key, -1)
+            head[key] = i
+
+    def longest(i: int) -> tuple[int, int]:
+        if i + MIN_MATCH > n:
+            return 0, 0
+        best_len, best_dist = 0, 0
+        limit = min(n - i, _MAX_MATCH)
+        j = head.get(data[i:i + MIN_MATCH], -1)
+        tries = _CHAIN
+        while j >= 0 and i - j <= window and tries > 0:
+            if data[j + best_len] == data[i + best_len]:
+                k = 0
+                while k < limit and data[j + k] == data[i + k]:
+                    k += 1
+                if k > best_len:
+                    best_len, best_dist = k, i - j
+                    if k == limit:
+                        break
+            j = prev[j]
+            tries -= 1
+        return (best_len, best_dist) if best_len >= MIN_MATCH else (0, 0)
+
+    out = bytearray(MAGIC + bytes([window_bits, 0]))
+    flags_at = -1
+    item = 8
+    i = 0
+    while i < n:
+        if item == 8:
+            flags_at = len(out)
+            out.append(0)
+            item = 0
+        length, dist = longest(i)
+        if length and length < 32:
+            # Lazy matching: a longer match one byte on wins over this one.
+            insert(i)
+            nxt_len, _ = longest(i + 1)
+            if nxt_len > length + 1:
+                length = 0
+        else:
+            insert(i)
+        if length:
+            out += _match_bytes(dist, length)
+            for k in range(i + 1, i + length):
+                insert(k)
+            i += length
+        else:
+            out[flags_at] |= 1 << item
+            out.append(data[i])
+            i += 1
+        item += 1
+    return bytes(out)
+
+
+def decompress(stream: bytes) -> bytes:
+    """Reference decoder; raises ValueError where lz_decoder_* would fail."""
+    if len(stream) < HEADER_SIZE or stream[:2] != MAGIC or stream[3] != 0 \
+            or not WINDOW_BITS_MIN <= stream[2] <= WINDOW_BITS_MAX:
+        raise ValueError("bad header")
+    window = 1 << stream[2]
+    out = bytearray()
+    i = HEADER_SIZE
+    while i < len(stream):
+        flags = stream[i]
+        i += 1
+        for bit in range(8):
+            if i >= len(stream):
+                break
+            if flags >> bit & 1:
+                out.append(stream[i])
+                i += 1
+                continue
+            if i + 2 > len(stream):
+                raise ValueError("truncated match")
+            dist = (stream[i] | (stream[i + 1] & 0x0F) << 8) + 1
+            length = (stream[i + 1] >> 4) + MIN_MATCH
+            i += 2
+            if length == _LEN_EXT + MIN_MATCH:
+                while True:
+                    if i >= len(stream):
+                        raise ValueError("truncated match")
+                    length += stream[i]
+                    i += 1
+                    if stream[i - 1] != 255:
+                        break
+            if dist > window or dist > len(out):
+                raise ValueError("corrupt distance")
+            for _ in range(length):
+                out.append(out[-dist])
+    return bytes(out)
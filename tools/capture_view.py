@@ -0,0 +1,356 @@
+#!/usr/bin/env python3
+"""Decode a modem_sim sample capture and draw its eye diagram or constellation.
+
+Plan 002 sub-track B0 host side of `modem run ... --capture` / `modem dump`
+(apps/dsp/modem_sim.c). The target freezes a window of samples around a
+trigger in the lib/modem snapshot ring; `modem dump` streams it as
+FRAME_TYPE_CAPTURE frames (lib/framing, decoded here with _framing.py):
+
+  seq 0    header:  [0][version][sps][rails][count u16][trig u16][sym u32][on_err]
+  seq 1..  samples: [1][offset u16] then I q15 (and Q q15 if rails == 2) ...
+
+All fields little-endian. `trig` is the trigger's offset in the window and is
+a symbol decision instant, so symbol peaks sit at trig + k*sps.
+
+- rails == 1 (the --shape chain, matched-filter output at sps samples per
+  symbol): an eye diagram, two symbols wide, folded on the decision instants.
+- rails == 2 (the --cfo/--chan chain, post-Costas I/Q at one sample per
+  symbol): a constellation.
+
+Both are printed as ASCII density plots, with the eye opening or the I/Q
+spread, so the tool works over SSH; --png also renders them with matplotlib.
+
+Usage:
+  # Run a capture on the target and pull it in one go:
+  python3 tools/capture_view.py --port /dev/ttyACM0 \\
+      --run "modem run --shape --snr 4 --capture err"
+
+  # Dump whatever the last run captured; keep the raw bytes:
+  python3 tools/capture_view.py --port /dev/ttyACM0 --save cap.bin
+
+  # Offline, from saved bytes (a raw serial log works too):
+  python3 tools/capture_view.py --in cap.bin --csv cap.csv --png cap.png
+
+Exit codes:
+    0  capture decoded and drawn.
+    1  invalid arguments / usage.
+    2  serial open / I/O failure.
+    3  no complete capture in the input (missing header or samples).
+
+Dependencies: pyserial for --port (`pip install pyserial`); matplotlib for
+--png only. Decoding and the ASCII plots are stdlib only.
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+import time
+from dataclasses import dataclass, field
+from pathlib import Path
+
+# Allow running as both a script (python3 tools/capture_view.py) and as a module.
+sys.path.insert(0, str(Path(__file__).resolve().parent))
+import _framing as fr  # noqa: E402
+
+DEFAULT_BAUD = 115200
+RUN_TIMEOUT_S = 30.0    # a 100k-bit shaped run takes a few seconds
+DUMP_TIMEOUT_S = 5.0
+
+CAPTURE_VERSION = 1
+KIND_HEADER = 0
+KIND_SAMPLES = 1
+HEADER_FMT = "<BBBBHHIB"
+
+DENSITY = " .:-=+*#%@"
+EYE_ROWS = 21
+EYE_COLS_PER_SAMPLE = 8
+CONST_ROWS = 21
+CONST_COLS = 43
+
+
+@dataclass
+class Capture:
+    sps: int
+    rails: int
+    count: int
+    trig: int
+    sym: int
+    on_err: bool
+    i: list[int] = field(default_factory=list)
+    q: list[int] = field(default_factory=list)
+
+
+# ---------------------------------------------------------------------------
+# Decoding
+# ---------------------------------------------------------------------------
+
+
+class CaptureAssembler:
+    """Collect FRAME_TYPE_CAPTURE frames into a Capture.
+
+    A new header restarts the capture, so a stream holding several dumps
+    yields the last one.
+    """
+
+    def __init__(self) -> None:
+        self.decoder = fr.Decoder()
+        self.cap: Capture | None = None
+        self._have: set[int] = set()
+
+    def feed(self, data: bytes) -> None:
+        for frame in self.decoder.feed(data):
+            if frame.type == fr.TYPE_CAPTURE and frame.payload:
+                self._on_frame(frame.payload)
+
+    def _on_frame(self, p: bytes) -> None:
+        if p[0] == KIND_HEADER and len(p) >= struct.calcsize(HEADER_FMT):
+            _, ver, sps, rails, count, trig, sym, on_err = struct.unpack_from(
+                HEADER_FMT, p
+            )
+            if ver != CAPTURE_VERSION or rails not in (1, 2) or sps == 0:
+                return
+            self.cap = Capture(sps, rails, count, trig, sym, bool(on_err),
+                               [0] * count, [0] * count)
+            self._have = set()
+        elif p[0] == KIND_SAMPLES and self.cap is not None and len(p) >= 3:
+            cap = self.cap
+            off = p[1] | (p[2] << 8)
+            vals = struct.unpack_from(f"<{(len(p) - 3) // 2}h", p, 3)
+            n = len(vals) // cap.rails
+            for k in range(n):
+                if off + k >= cap.count:
+                    break
+                cap.i[off + k] = vals[k * cap.rails]
+                if cap.rails == 2:
+                    cap.q[off + k] = vals[k * cap.rails + 1]
+                self._have.add(off + k)
+
+    def complete(self) -> bool:
+        return self.cap is not None and len(self._have) == self.cap.count
+
+
+# ---------------------------------------------------------------------------
+# Rendering
+# ---------------------------------------------------------------------------
+
+
+def _shade(grid: list[list[int]]) -> list[str]:
+    peak = max((v for row in grid for v in row), default=0)
+    lines = []
+    for row in grid:
+        chars = []
+        for v in row:
+            if v == 0 or peak == 0:
+                chars.append(" ")
+            else:
+                idx = 1 + (v * (len(DENSITY) - 2)) // peak
+                chars.append(DENSITY[min(idx, len(DENSITY) - 1)])
+        lines.append("".join(chars))
+    return lines
+
+
+def eye_traces(cap: Capture) -> list[list[float]]:
+    """Two-symbol traces (2*sps + 1 samples), each centred on a decision
+    instant, in fractions of full scale."""
+    sps = cap.sps
+    traces = []
+    k = cap.trig % sps + sps
+    while k + sps < cap.count:
+        traces.append([cap.i[j] / 32768.0 for j in range(k - sps, k + sps + 1)])
+        k += sps
+    return traces
+
+
+def render_eye(cap: Capture) -> list[str]:
+    traces = eye_traces(cap)
+    if not traces:
+        return ["(window too short for an eye)"]
+    lim = max(abs(v) for t in traces for v in t) or 1.0
+    cols = 2 * cap.sps * EYE_COLS_PER_SAMPLE + 1
+    grid = [[0] * cols for _ in range(EYE_ROWS)]
+    for t in traces:
+        for c in range(cols):
+            x = c / EYE_COLS_PER_SAMPLE
+            j = min(int(x), len(t) - 2)
+            v = t[j] + (t[j + 1] - t[j]) * (x - j)
+            r = int(round((lim - v) / (2.0 * lim) * (EYE_ROWS - 1)))
+            grid[r][c] += 1
+    lines = _shade(grid)
+    mid = cap.sps * EYE_COLS_PER_SAMPLE
+    out = [f"{lim:+.3f} |{lines[0]}|"]
+    out += [f"{'':6} |{ln}|" for ln in lines[1:-1]]
+    out.append(f"{-lim:+.3f} |{lines[-1]}|")
+    out.append(f"{'':6}  {'^':>{mid + 1}}  decision instant")
+
+    # Eye opening: inner edges of the two rails at the decision instant.
+    peaks = [t[cap.sps] for t in traces]
+    hi = [v for v in peaks if v >= 0.0]
+    lo = [v for v in peaks if v < 0.0]
+    if hi and lo:
+        level = (sum(hi) / len(hi) - sum(lo) / len(lo)) / 2.0
+        opening = (min(hi) - max(lo)) / (2.0 * level) if level > 0 else 0.0
+        out.append(f"eye: {len(traces)} traces  level={level:.4f} FS  "
+                   f"opening={100.0 * opening:.1f}% of 2x level")
+    return out
+
+
+def render_constellation(cap: Capture) -> list[str]:
+    pts = [(cap.i[k] / 32768.0, cap.q[k] / 32768.0) for k in range(cap.count)]
+    lim = max(max(abs(a), abs(b)) for a, b in pts) or 1.0
+    grid = [[0] * CONST_COLS for _ in range(CONST_ROWS)]
+    for a, b in pts:
+        c = int(round((a + lim) / (2.0 * lim) * (CONST_COLS - 1)))
+        r = int(round((lim - b) / (2.0 * lim) * (CONST_ROWS - 1)))
+        grid[r][c] += 1
+    lines = _shade(grid)
+    out = [f"Q {lim:+.3f} |{lines[0]}|"]
+    out += [f"{'':8} |{ln}|" for ln in lines[1:-1]]
+    out.append(f"  {-lim:+.3f} |{lines[-1]}|")
+    out.append(f"{'':9} I: {-lim:+.3f} .. {lim:+.3f}")
+
+    n = len(pts)
+    mean_abs_i = sum(abs(a) for a, _ in pts) / n
+    q_rms = (sum(b * b for _, b in pts) / n) ** 0.5
+    out.append(f"constellation: {n} symbols  |I| mean={mean_abs_i:.4f} FS  "
+               f"Q rms={q_rms:.4f} FS")
+    return out
+
+
+def write_png(cap: Capture, path: str) -> None:
+    import matplotlib  # noqa: PLC0415 - optional dependency
+
+    matplotlib.use("Agg")
+    import matplotlib.pyplot as plt  # noqa: PLC0415
+
+    fig, ax = plt.subplots(figsize=(6, 5))
+    if cap.rails == 1:
+        for t in eye_traces(cap):
+            xs = [(j - cap.sps) / cap.sps for j in range(len(t))]
+            ax.plot(xs, t, color="C0", alpha=0.3, linewidth=0.8)
+        ax.set_xlabel("time (symbols from decision instant)")
+        ax.set_ylabel("matched-filter output (FS)")
+        ax.set_title(f"eye, sps={cap.sps}, trigger sym {cap.sym}")
+    else:
+        ax.scatter([v / 32768.0 for v in cap.i], [v / 32768.0 for v in cap.q],
+                   s=4, alpha=0.5)
+        ax.set_aspect("equal")
+        ax.set_xlabel("I (FS)")
+        ax.set_ylabel("Q (FS)")
+        ax.set_title(f"constellation, trigger sym {cap.sym}")
+    ax.grid(True, alpha=0.3)
+    fig.savefig(path, dpi=120, bbox_inches="tight")
+
+
+# ---------------------------------------------------------------------------
+# Serial
+# ---------------------------------------------------------------------------
+
+
+def _read_for(ser, seconds: float, until=None) -> bytes:
+    deadline = time.time() + seconds
+    buf = bytearray()
+    while time.time() < deadline:
+        chunk = ser.read(1024)
+        if chunk:
+            buf += chunk
+            if until is not None and until(buf, chunk):
+                break
+    return bytes(buf)
+
+
+def fetch(port: str, baud: int, run_cmd: str | None) -> bytes:
+    try:
+        import serial  # noqa: PLC0415
+    except ImportError:
+        print("pyserial not installed. Run: pip3 install pyserial", file=sys.stderr)
+        raise SystemExit(2)
+    try:
+        ser = serial.Serial(port, baud, timeout=0.2)
+    except serial.SerialException as e:
+        print(f"serial open failed: {e}", file=sys.stderr)
+        raise SystemExit(2)
+
+    with ser:
+        ser.reset_input_buffer()
+        if run_cmd:
+            ser.write(run_cmd.encode() + b"\r")
+            out = _read_for(ser, RUN_TIMEOUT_S, lambda b, _c: b.endswith(b"\n> "))
+            sys.stdout.write(out.decode(errors="replace"))
+        ser.write(b"modem dump\r")
+        asm = CaptureAssembler()
+
+        def done(_buf: bytes, chunk: bytes) -> bool:
+            asm.feed(chunk)
+            return asm.complete()
+
+        return _read_for(ser, DUMP_TIMEOUT_S, done)
+
+
+# ---------------------------------------------------------------------------
+# Main
+# ---------------------------------------------------------------------------
+
+
+def main(argv: list[str] | None = None) -> int:
+    p = argparse.ArgumentParser(
+        description="Decode and draw a modem_sim --capture window."
+    )
+    src = p.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port of the target running modem_sim")
+    src.add_argument("--in", dest="infile", help="raw bytes saved earlier (--save)")
+    p.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    p.add_argument("--run", help="modem_sim command to run first, e.g. "
+                   "\"modem run --shape --snr 4 --capture err\"")
+    p.add_argument("--save", help="write the raw bytes received to this file")
+    p.add_argument("--csv", help="write the samples as CSV (index,i,q)")
+    p.add_argument("--png", help="also render with matplotlib to this file")
+    args = p.parse_args(argv)
+
+    if args.run and not args.port:
+        p.error("--run needs --port")
+
+    if args.port:
+        data = fetch(args.port, args.baud, args.run)
+    else:
+        try:
+            data = Path(args.infile).read_bytes()
+        except OSError as e:
+            print(f"read failed: {e}", file=sys.stderr)
+            return 2
+    if args.save:
+        Path(args.save).write_bytes(data)
+
+    asm = CaptureAssembler()
+    asm.feed(data)
+    if not asm.complete():
+        print("no complete capture in the input (did the run trigger?)",
+              file=sys.stderr)
+        return 3
+    cap = asm.cap
+    assert cap is not None
+
+    trig = "first error" if cap.on_err else "requested"
+    print(f"capture: {cap.count} samples  sps={cap.sps}  rails={cap.rails}  "
+          f"trigger sym {cap.sym} ({trig}) at sample {cap.trig}")
+    lines = render_eye(cap) if cap.rails == 1 else render_constellation(cap)
+    print("\n".join(lines))
+
+    if args.csv:
+        with open(args.csv, "w", encoding="ascii") as f:
+            f.write("index,i,q\n")
+            for k in range(cap.count):
+                f.write(f"{k - cap.trig},{cap.i[k]},{cap.q[k]}\n")
+    if args.png:
+        try:
+            write_png(cap, args.png)
+        except ImportError:
+            print("matplotlib not installed. Run: pip3 install matplotlib",
+                  file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
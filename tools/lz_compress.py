@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Compress a payload into a lib/lz stream and report the wire-time saving.
+
+Host side of lib/lz (see tools/_lz.py for the format). Use it to check how
+well a firmware image or bulk payload compresses before sending it, or to
+produce a stream for a receiver that decompresses with lz_decoder_feed().
+tools/ota_send.py --compress does the same internally.
+
+Usage:
+  python3 tools/lz_compress.py --in build/.../cli_simple_b.signed.bin \\
+      --out image.lz [--window-bits 12] [--baud 115200]
+
+  # Decompress (e.g. to check a stream from elsewhere):
+  python3 tools/lz_compress.py -d --in image.lz --out image.bin
+
+Prints the sizes, the ratio, and the raw vs compressed payload time at the
+given baud (10 bits per byte, framing overhead not included).
+
+Exit codes:
+    0  done.
+    1  invalid arguments / usage, or a malformed stream with -d.
+    2  input read / output write failure.
+
+Dependencies: stdlib only.
+"""
+
+from __future__ import annotations
+
+import argparse
+import sys
+import time
+from pathlib import Path
+
+# Allow running as both a script (python3 tools/lz_compress.py) and as a module.
+sys.path.insert(0, str(Path(__file__).resolve().parent))
+import _lz  # noqa: E402
+
+
+def main(argv: list[str] | None = None) -> int:
+    p = argparse.ArgumentParser(description="Compress a payload for lib/lz.")
+    p.add_argument("--in", dest="inp", required=True, help="Input file")
+    p.add_argument("--out", help="Output file (omit to only report)")
+    p.add_argument("-d", "--decompress", action="store_true",
+                   help="Decompress a stream instead")
+    p.add_argument("--window-bits", type=int, default=_lz.WINDOW_BITS_MAX,
+                   help="Decoder window 1 << N bytes, "
+                        f"{_lz.WINDOW_BITS_MIN}..{_lz.WINDOW_BITS_MAX} "
+                        f"(default {_lz.WINDOW_BITS_MAX})")
+    p.add_argument("--baud", type=int, default=115200,
+                   help="Line rate for the wire-time estimate (default 115200)")
+    args = p.parse_args(argv)
+
+    if not _lz.WINDOW_BITS_MIN <= args.window_bits <= _lz.WINDOW_BITS_MAX:
+        print(f"--window-bits must be {_lz.WINDOW_BITS_MIN}..{_lz.WINDOW_BITS_MAX}",
+              file=sys.stderr)
+        return 1
+
+    try:
+        data = Path(args.inp).read_bytes()
+    except OSError as e:
+        print(f"could not read {args.inp}: {e}", file=sys.stderr)
+        return 2
+
+    t0 = time.time()
+    if args.decompress:
+        try:
+            out = _lz.decompress(data)
+        except ValueError as e:
+            print(f"bad stream: {e}", file=sys.stderr)
+            return 1
+        raw, packed = out, data
+    else:
+        out = _lz.compress(data, args.window_bits)
+        raw, packed = data, out
+    elapsed = time.time() - t0
+
+    if args.out:
+        try:
+            Path(args.out).write_bytes(out)
+        except OSError as e:
+            print(f"could not write {args.out}: {e}", file=sys.stderr)
+            return 2
+
+    byte_s = args.baud / 10.0
+    ratio = len(packed) / len(raw) if raw else 1.0
+    print(f"{len(raw)} -> {len(packed)} bytes ({100.0 * ratio:.1f}%) in {elapsed:.2f} s")
+    print(f"at {args.baud} baud: {len(raw) / byte_s:.1f} s raw, "
+          f"{len(packed) / byte_s:.1f} s compressed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -9,6 +9,9 @@ Flow:
   2. Send PING; expect PONG. Confirms the chip is in OTA mode.
   3. Send OTA_BEGIN { slot, total_size }; expect ACK.
   4. Stream OTA_CHUNK { offset, data[N] } frames; expect ACK after each.
+     With --compress, OTA_BEGIN carries the LZ flag and the chunks carry
+     the image compressed by tools/_lz.py (offsets into the compressed
+     stream); the bootloader decompresses into the slot as they arrive.
   5. Send OTA_END; expect STATUS.
   6. Print STATUS, return non-zero exit code on failure.
 
@@ -17,7 +20,8 @@ Usage:
       --port /dev/ttyACM0 \\
       --image build/apps/cli/cli_simple_b/cli_simple_b.signed.bin \\
       --slot B \\
-      --baud 115200
+      --baud 115200 \\
+      --compress
 
 The chip must already be in OTA mode before this tool runs — issue the
 `ota_request` CLI command (or write RTC_BKP_DR0 = 0x4F544131 some other
@@ -44,6 +48,7 @@ from pathlib import Path
 # Allow running as both a script (python3 tools/ota_send.py) and as a module.
 sys.path.insert(0, str(Path(__file__).resolve().parent))
 import _framing as fr  # noqa: E402
+import _lz  # noqa: E402
 
 DEFAULT_BAUD = 115200
 DEFAULT_CHUNK_SIZE = 256
@@ -131,9 +136,13 @@ def stage_ping(ser, decoder: fr.Decoder) -> None:
     print(f"[ping] PONG seq={frame.seq}")
 
 
-def stage_begin(ser, decoder: fr.Decoder, slot: int, total_size: int) -> int:
+def stage_begin(ser, decoder: fr.Decoder, slot: int, total_size: int,
+                flags: int = 0) -> int:
     payload = struct.pack("<BI", slot, total_size)
-    print(f"[begin] slot={'A' if slot == SLOT_A else 'B'} size={total_size} bytes")
+    if flags:
+        payload += struct.pack("<B", flags)
+    print(f"[begin] slot={'A' if slot == SLOT_A else 'B'} size={total_size} bytes"
+          + (" (lz)" if flags & fr.OTA_BEGIN_F_LZ else ""))
     seq = 1
     _send_and_await(
         ser, decoder, seq=seq, type_=fr.TYPE_OTA_BEGIN, payload=payload,
@@ -146,7 +155,10 @@ def stage_begin(ser, decoder: fr.Decoder, slot: int, total_size: int) -> int:
 def stage_chunks(
     ser, decoder: fr.Decoder, image: bytes, start_seq: int, chunk_size: int,
 ) -> tuple[int, int]:
-    """Stream the image in OTA_CHUNK frames. Returns (next_seq, retx_count)."""
+    """Stream the image (or its LZ stream) in OTA_CHUNK frames.
+
+    Returns (next_seq, retx_count).
+    """
     total = len(image)
     sent = 0
     retx = 0
@@ -211,6 +223,9 @@ def main(argv: list[str] | None = None) -> int:
                    help=f"Serial baud rate (default {DEFAULT_BAUD})")
     p.add_argument("--chunk", type=int, default=DEFAULT_CHUNK_SIZE,
                    help=f"Bytes per OTA_CHUNK (default {DEFAULT_CHUNK_SIZE})")
+    p.add_argument("--compress", action="store_true",
+                   help="Send the image LZ-compressed (needs a bootloader "
+                        "built with OTA_LZ=1)")
     args = p.parse_args(argv)
 
     if args.chunk <= 0 or args.chunk > fr.MAX_PAYLOAD - 4:
@@ -228,6 +243,16 @@ def main(argv: list[str] | None = None) -> int:
 
     slot_id = SLOT_A if args.slot == "A" else SLOT_B
 
+    stream, flags = image, 0
+    if args.compress:
+        packed = _lz.compress(image)
+        print(f"[lz] {len(image)} -> {len(packed)} bytes "
+              f"({100.0 * len(packed) / len(image):.0f}%)")
+        if len(packed) < len(image):
+            stream, flags = packed, fr.OTA_BEGIN_F_LZ
+        else:
+            print("[lz] no gain; sending the image uncompressed")
+
     try:
         import serial
     except ImportError:
@@ -247,8 +272,8 @@ def main(argv: list[str] | None = None) -> int:
 
         try:
             stage_ping(ser, decoder)
-            seq = stage_begin(ser, decoder, slot_id, len(image))
-            seq, _retx = stage_chunks(ser, decoder, image, seq, args.chunk)
+            seq = stage_begin(ser, decoder, slot_id, len(image), flags)
+            seq, _retx = stage_chunks(ser, decoder, stream, seq, args.chunk)
             status = stage_end(ser, decoder, seq)
         except RuntimeError as e:
             print(f"OTA failed: {e}", file=sys.stderr)